@@ -28,6 +28,8 @@
 #include "LobbyState.hpp"
 #include "GameState.hpp"
 #include "FontManager.hpp"
+#include "AssetLoader.hpp"
+#include "FighterCache.hpp"
 #include "GUI.hpp"
 #include "GamepadManager.hpp"
 #include "Game.hpp"
@@ -49,6 +51,9 @@ m_pAppStateManager(nullptr)
 	new FontManager();
 	FontManager::getSingletonPtr()->reloadAll();
 
+	new AssetLoader();
+	new FighterCache();
+
 	new GUITheme();
 	Config e(Engine::getSingletonPtr()->getSettingsFile());
 	if (e.isLoaded()){
@@ -85,6 +90,8 @@ App::~App(void)
 	delete Game::getSingletonPtr();
 	delete GamepadManager::getSingletonPtr();
 	delete FontManager::getSingletonPtr();
+	delete AssetLoader::getSingletonPtr();
+	delete FighterCache::getSingletonPtr();
 	delete GUITheme::getSingletonPtr();
 
 	// Engine must be available for prior destructors.
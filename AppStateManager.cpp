@@ -25,6 +25,7 @@
 #include "Engine.hpp"
 #include "MessageRouter.hpp"
 #include "Timer.hpp"
+#include "AssetLoader.hpp"
 
 // ================================================ //
 
@@ -115,6 +116,7 @@ void AppStateManager::start(AppState* pState)
 
 			// Perform global updates.
 			MessageRouter::getSingletonPtr()->update();
+			AssetLoader::getSingletonPtr()->update();
 			m_activeStateStack.back()->update(dt);
 
 			// Regulate the maximum frame rate (in case VSync is off).
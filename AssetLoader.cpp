@@ -0,0 +1,157 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: AssetLoader.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements AssetLoader singleton class.
+// ================================================ //
+
+#include "AssetLoader.hpp"
+#include "ThreadPool.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+template<> AssetLoader* Singleton<AssetLoader>::msSingleton = nullptr;
+
+// ================================================ //
+
+namespace{
+	// A texture moving from a worker to the render thread.
+	struct TextureLoad{
+		std::string file;
+		std::shared_ptr<SDL_Surface> pSurface;
+		std::promise<std::shared_ptr<SDL_Texture>> promise;
+		AssetLoader::TextureCallback callback;
+	};
+
+	// Destroys a texture once nothing uses it.
+	void DestroyTexture(SDL_Texture* pTexture)
+	{
+		if (pTexture != nullptr && Engine::getSingletonPtr() != nullptr){
+			Engine::getSingletonPtr()->destroyTexture(pTexture);
+		}
+	}
+}
+
+// ================================================ //
+
+AssetLoader::AssetLoader(const uint32_t numThreads) :
+m_completed(),
+m_mutex(),
+m_pPool(new ThreadPool(numThreads)),
+m_numStarted(0),
+m_numCompleted(0)
+{
+	Log::getSingletonPtr()->logMessage("AssetLoader started with " + 
+		Engine::toString(m_pPool->getNumThreads()) + " worker thread(s)");
+}
+
+// ================================================ //
+
+AssetLoader::~AssetLoader(void)
+{
+	// Join the workers before dropping what they finished.
+	m_pPool.reset();
+	m_completed.clear();
+}
+
+// ================================================ //
+
+TextureFuture AssetLoader::loadTexture(const std::string& file, const TextureCallback& callback)
+{
+	std::shared_ptr<TextureLoad> pLoad(new TextureLoad());
+	pLoad->file = file;
+	pLoad->callback = callback;
+	TextureFuture future = pLoad->promise.get_future().share();
+
+	this->run([pLoad](){
+		pLoad->pSurface = AssetLoader::LoadSurface(pLoad->file);
+	},
+	[pLoad](){
+		std::shared_ptr<SDL_Texture> pTexture = AssetLoader::CreateTexture(pLoad->pSurface);
+		pLoad->pSurface.reset();
+		pLoad->promise.set_value(pTexture);
+		if (pLoad->callback){
+			pLoad->callback(pTexture);
+		}
+	});
+
+	return future;
+}
+
+// ================================================ //
+
+void AssetLoader::run(const Job& work, const Job& onComplete)
+{
+	++m_numStarted;
+	m_pPool->enqueue([this, work, onComplete](){
+		work();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_completed.push_back(onComplete);
+	});
+}
+
+// ================================================ //
+
+void AssetLoader::update(void)
+{
+	std::vector<Job> completed;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		completed.swap(m_completed);
+	}
+
+	for (std::vector<Job>::iterator itr = completed.begin(); itr != completed.end(); ++itr){
+		(*itr)();
+		++m_numCompleted;
+	}
+
+	// Start counting progress from zero for the next batch.
+	if (m_numCompleted == m_numStarted){
+		m_numStarted = m_numCompleted = 0;
+	}
+}
+
+// ================================================ //
+
+std::shared_ptr<SDL_Surface> AssetLoader::LoadSurface(const std::string& file)
+{
+	std::shared_ptr<SDL_Surface> pSurface(IMG_Load(file.c_str()), SDL_FreeSurface);
+	if (pSurface == nullptr){
+		Log::getSingletonPtr()->logMessage("Failed to load image from file: \"" + file + "\" (" + 
+			std::string(IMG_GetError()) + ")");
+	}
+
+	return pSurface;
+}
+
+// ================================================ //
+
+std::shared_ptr<SDL_Texture> AssetLoader::CreateTexture(const std::shared_ptr<SDL_Surface>& pSurface)
+{
+	SDL_Texture* pTexture = nullptr;
+	if (pSurface != nullptr){
+		pTexture = SDL_CreateTextureFromSurface(Engine::getSingletonPtr()->getRenderer(), pSurface.get());
+	}
+
+	return std::shared_ptr<SDL_Texture>(pTexture, DestroyTexture);
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,133 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: AssetLoader.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines AssetLoader singleton class.
+// ================================================ //
+
+#ifndef __ASSETLOADER_HPP__
+#define __ASSETLOADER_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+
+#include <functional>
+#include <future>
+#include <mutex>
+
+// ================================================ //
+
+class ThreadPool;
+
+// A texture being loaded by the AssetLoader. Ready once it's been 
+// uploaded, holding nullptr if the image failed to load.
+typedef std::shared_future<std::shared_ptr<SDL_Texture>> TextureFuture;
+
+// ================================================ //
+
+// Loads assets without stalling the render thread. Files are read and 
+// decoded on worker threads; only creating the SDL_Texture from the 
+// decoded SDL_Surface is done on the render thread, in update(), along 
+// with any completion callbacks.
+// Sample usage:
+// TextureFuture tex = AssetLoader::getSingletonPtr()->loadTexture(file);
+// ...each frame, after update():
+// if (AssetLoader::IsReady(tex)) pTexture = tex.get();
+class AssetLoader : public Singleton<AssetLoader>
+{
+public:
+	typedef std::function<void(void)> Job;
+	typedef std::function<void(std::shared_ptr<SDL_Texture>)> TextureCallback;
+
+	// Starts numThreads workers, or one per hardware thread if 0.
+	explicit AssetLoader(const uint32_t numThreads = 0);
+
+	// Finishes the work already started, then drops anything not yet 
+	// uploaded without calling its callbacks.
+	~AssetLoader(void);
+
+	// Reads and decodes the image file on a worker thread. The texture is 
+	// created by the next update() after that, which makes the future 
+	// ready and then calls callback, if given.
+	TextureFuture loadTexture(const std::string& file, const TextureCallback& callback = nullptr);
+
+	// Runs work on a worker thread, then onComplete on the render thread in
+	// the next update() after it finishes. work must not throw.
+	void run(const Job& work, const Job& onComplete);
+
+	// Creates the textures decoded since the last call and runs completion
+	// callbacks. Called once per frame by the AppStateManager.
+	void update(void);
+
+	// Reads and decodes an image. Safe to call from any thread.
+	static std::shared_ptr<SDL_Surface> LoadSurface(const std::string& file);
+
+	// Creates a texture from a decoded image. Must be called on the render
+	// thread. The texture is destroyed once the last reference is released.
+	static std::shared_ptr<SDL_Texture> CreateTexture(const std::shared_ptr<SDL_Surface>& pSurface);
+
+	// Returns true if the future has its value, without blocking.
+	template<typename T>
+	static bool IsReady(const std::shared_future<T>& future);
+
+	// Getters
+
+	// Returns the number of loads started and not yet completed.
+	const Uint32 getNumPending(void) const;
+
+	// Returns the fraction of the loads started since the loader was last 
+	// idle that have completed, or 1 if it's idle.
+	const double getProgress(void) const;
+
+private:
+	// Finished on a worker, waiting for update().
+	std::vector<Job> m_completed;
+	std::mutex m_mutex;
+	std::shared_ptr<ThreadPool> m_pPool;
+
+	// Loads started and completed since the loader was last idle. Only 
+	// used on the render thread.
+	Uint32 m_numStarted, m_numCompleted;
+};
+
+// ================================================ //
+
+template<typename T>
+inline bool AssetLoader::IsReady(const std::shared_future<T>& future){
+	return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 AssetLoader::getNumPending(void) const{
+	return m_numStarted - m_numCompleted;
+}
+
+inline const double AssetLoader::getProgress(void) const{
+	return (m_numStarted == 0) ? 1.0 : static_cast<double>(m_numCompleted) / static_cast<double>(m_numStarted);
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
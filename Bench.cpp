@@ -0,0 +1,228 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: Bench.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements shared benchmark helpers and the ExtMFBench entry point.
+// ================================================ //
+
+#include "Bench.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// ================================================ //
+
+namespace{
+	struct BenchEntry{
+		const char* name;
+		BenchFunc func;
+		const char* description;
+	};
+
+	const BenchEntry Benchmarks[] = {
+		{ "matchstate", Bench::matchState, "MatchState save + restore (target < 1 us)" },
+		{ "sim", Bench::simThroughput, "MatchSim ticks/s, tick time percentiles and allocations" },
+		{ "netcode", Bench::netcode, "Matches over a seeded, conditioned loopback network" },
+		{ "config", Bench::config, "Config file loading, indexed vs rescanning per value" },
+		{ "fighter", Bench::fighter, "Fighter loading, single pass vs searching per value vs compiled" }
+	};
+
+	const int NumBenchmarks = sizeof(Benchmarks) / sizeof(Benchmarks[0]);
+
+	// Heap allocations made by the process. Benchmarks are single threaded.
+	uint64_t Allocations = 0;
+}
+
+// ================================================ //
+
+// Count every allocation so benchmarks can report allocations per operation.
+void* operator new(std::size_t size)
+{
+	++Allocations;
+	void* p = malloc((size == 0) ? 1 : size);
+	if (p == nullptr){
+		throw std::bad_alloc();
+	}
+
+	return p;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+	free(p);
+}
+
+// ================================================ //
+
+std::shared_ptr<FighterData> Bench::createSyntheticFighter(const int framesPerMove)
+{
+	std::shared_ptr<FighterData> pData(new FighterData());
+	pData->name = "Synthetic";
+	pData->w = 100;
+	pData->h = 200;
+	pData->xAccel = 50;
+	pData->xMax = 300;
+	pData->jumpStrength = 150;
+	pData->jumpSpeed = 6;
+	pData->hp = 1200;
+
+	std::shared_ptr<FighterFrameList> pFrames(new FighterFrameList());
+	for (int i = 0; i < FighterState::END_STATES; ++i){
+		FighterMove move;
+		move.id = i;
+		move.frameGap = 3;
+		move.damage = 100;
+		move.hitstun = 18;
+		move.blockstun = 12;
+		move.repeat = (i <= FighterState::WALKING_BACK || i == FighterState::CROUCHED);
+		move.transition = (i == FighterState::ATTACK_LP || i == FighterState::STUNNED_JUMP ||
+						   i == FighterState::UNCROUCHING) ? FighterState::IDLE : 
+						  (i == FighterState::CROUCHING) ? FighterState::CROUCHED : -1;
+
+		move.firstFrame = static_cast<uint32_t>(pFrames->size());
+		move.numFrames = static_cast<uint32_t>(framesPerMove);
+		for (int f = 0; f < framesPerMove; ++f){
+			FighterFrame frame;
+			memset(&frame, 0, sizeof(frame));
+			frame.src.x = f * pData->w;
+			frame.src.y = i * pData->h;
+			frame.src.w = pData->w;
+			frame.src.h = pData->h;
+			frame.gap = move.frameGap;
+			for (int h = SimHitbox::HBOX_LOWER; h <= SimHitbox::HBOX_HEAD; ++h){
+				frame.hitboxes[h].y = 60 - (h * 40);
+				frame.hitboxes[h].w = 60;
+				frame.hitboxes[h].h = 40;
+			}
+			if (i == FighterState::ATTACK_LP && f == framesPerMove / 2){
+				frame.hitboxes[SimHitbox::DBOX1].x = 60;
+				frame.hitboxes[SimHitbox::DBOX1].y = -40;
+				frame.hitboxes[SimHitbox::DBOX1].w = 80;
+				frame.hitboxes[SimHitbox::DBOX1].h = 20;
+			}
+			pFrames->push_back(frame);
+		}
+
+		pData->moves.push_back(move);
+	}
+	pData->setFrames(pFrames);
+
+	return pData;
+}
+
+// ================================================ //
+
+int Bench::getIntArg(const std::vector<std::string>& args, const std::string& name, const int def)
+{
+	const std::string value = Bench::getStringArg(args, name, "");
+	return (value.empty()) ? def : atoi(value.c_str());
+}
+
+// ================================================ //
+
+std::string Bench::getStringArg(const std::vector<std::string>& args, const std::string& name,
+								const std::string& def)
+{
+	const std::string prefix = "--" + name + "=";
+	for (std::vector<std::string>::const_iterator itr = args.begin(); itr != args.end(); ++itr){
+		if (itr->compare(0, prefix.size(), prefix) == 0){
+			return itr->substr(prefix.size());
+		}
+	}
+
+	return def;
+}
+
+// ================================================ //
+
+uint64_t Bench::getAllocations(void)
+{
+	return Allocations;
+}
+
+// ================================================ //
+
+std::string Bench::escapeJson(const std::string& str)
+{
+	std::string escaped;
+	escaped.reserve(str.size());
+	for (std::string::const_iterator itr = str.begin(); itr != str.end(); ++itr){
+		const unsigned char c = static_cast<unsigned char>(*itr);
+		if (c == '\\' || c == '"'){
+			escaped += '\\';
+			escaped += *itr;
+		}
+		else if (c < 0x20){
+			char code[8];
+			sprintf(code, "\\u%04x", c);
+			escaped += code;
+		}
+		else{
+			escaped += *itr;
+		}
+	}
+
+	return escaped;
+}
+
+// ================================================ //
+
+int main(int argc, char** argv)
+{
+	if (argc < 2){
+		printf("Usage: %s <benchmark|all> [--option=value ...]\n\n", argv[0]);
+		for (int i = 0; i < NumBenchmarks; ++i){
+			printf("  %-12s %s\n", Benchmarks[i].name, Benchmarks[i].description);
+		}
+		return 1;
+	}
+
+	const std::string name = argv[1];
+	const std::vector<std::string> args(argv + 2, argv + argc);
+
+	int ret = 0;
+	bool found = false;
+	for (int i = 0; i < NumBenchmarks; ++i){
+		if (name == "all" || name == Benchmarks[i].name){
+			found = true;
+			if (Benchmarks[i].func(args) != 0){
+				ret = 1;
+			}
+		}
+	}
+
+	if (!found){
+		printf("Unknown benchmark \"%s\"\n", name.c_str());
+		return 1;
+	}
+
+	return ret;
+}
+
+// ================================================ //
\ No newline at end of file
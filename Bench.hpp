@@ -0,0 +1,91 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: Bench.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Declares the benchmarks run by the ExtMFBench executable, along
+// with helpers they share.
+// ================================================ //
+
+#ifndef __BENCH_HPP__
+#define __BENCH_HPP__
+
+// ================================================ //
+
+#include "FighterData.hpp"
+
+#include <cstdio>
+
+// ================================================ //
+
+// Each benchmark receives the arguments following its name and returns 
+// zero on success, or nonzero if it failed or missed its target.
+typedef int (*BenchFunc)(const std::vector<std::string>& args);
+
+namespace Bench{
+	// Builds a fighter with the given number of frames per move and 
+	// hitboxes on every frame, without loading any files.
+	std::shared_ptr<FighterData> createSyntheticFighter(const int framesPerMove = 4);
+
+	// Returns the integer value of "--name=value" in args, or def.
+	int getIntArg(const std::vector<std::string>& args, const std::string& name, const int def);
+
+	// Returns the string value of "--name=value" in args, or def.
+	std::string getStringArg(const std::vector<std::string>& args, const std::string& name, 
+							 const std::string& def);
+
+	// Returns the number of heap allocations made by the process so far.
+	uint64_t getAllocations(void);
+
+	// Returns str escaped for use inside a JSON string.
+	std::string escapeJson(const std::string& str);
+
+	// Benchmarks.
+
+	// Times MatchSim::save() + MatchSim::load(). Target: under 1 us.
+	int matchState(const std::vector<std::string>& args);
+
+	// Ticks M matches for K ticks each from random or scripted inputs and
+	// reports throughput, tick time percentiles and allocations per tick.
+	int simThroughput(const std::vector<std::string>& args);
+
+	// Plays matches between a MatchInstance and two simulated clients over
+	// a LoopbackNetwork for a number of simulated seconds, with seeded 
+	// latency, jitter and loss. Reports the speedup over real time, 
+	// snapshot delivery and age, and a digest of every decoded snapshot
+	// that only changes if the netcode's behaviour does.
+	int netcode(const std::vector<std::string>& args);
+
+	// Loads the data directory's config files and looks up every value in
+	// them with the indexed Config parser and the rescanning parser it 
+	// replaced. Reports the time per load and fails if any value differs.
+	int config(const std::vector<std::string>& args);
+
+	// Writes a synthetic .fighter file with hundreds of moves and loads 
+	// every move with the single-pass FighterMetadata parser and the 
+	// searching parser it replaced, then compiles it and maps the image. 
+	// Reports the time per load and fails if any move differs, including 
+	// those of the shipped fighter.
+	int fighter(const std::vector<std::string>& args);
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,202 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: BenchConfig.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Benchmarks loading config files with the indexed Config parser against
+// the parser it replaced, which rescanned the file for every value.
+// ================================================ //
+
+#include "Bench.hpp"
+#include "Config.hpp"
+#include "SimClock.hpp"
+
+// ================================================ //
+
+namespace{
+	// The files the game and server load, relative to the data directory.
+	const char* DataFiles[] = {
+		"ExtMF.cfg",
+		"Fighters/fighters.cfg",
+		"Fighters/corpse-explosion.fighter",
+		"GUI/dev.theme",
+		"GUI/gamestate.gui",
+		"GUI/lobbystate.gui",
+		"GUI/menustate.gui",
+		"Stages/lobby.stage",
+		"Stages/menu.stage",
+		"Stages/test.stage",
+		"ButtonMaps/default-xbox360-redplayer.bmap",
+		"ButtonMaps/default-xbox360-blueplayer.bmap"
+	};
+
+	const int NumDataFiles = sizeof(DataFiles) / sizeof(DataFiles[0]);
+
+	typedef std::pair<std::string, std::string> Key;
+
+	// Every section and key in a file, in the order they appear.
+	struct BenchFile{
+		std::string path;
+		std::vector<Key> keys;
+	};
+
+	// Lists the keys in file as the old parser saw them.
+	bool CollectKeys(BenchFile& file)
+	{
+		std::ifstream in(file.path);
+		if (!in.is_open()){
+			return false;
+		}
+
+		std::string line, section;
+		while (std::getline(in, line)){
+			if (!line.empty() && line[line.size() - 1] == '\r'){
+				line.erase(line.size() - 1);
+			}
+			if (line.empty() || line[0] == '#'){
+				continue;
+			}
+			if (line[0] == '['){
+				section = (line[line.size() - 1] == ']') ? line.substr(1, line.size() - 2) : "";
+				continue;
+			}
+			const size_t assign = line.find_first_of('=');
+			if (!section.empty() && assign != std::string::npos){
+				file.keys.push_back(Key(section, line.substr(0, assign)));
+			}
+		}
+
+		return true;
+	}
+
+	// The parser Config used before it indexed files: rewinds the stream
+	// and scans line by line for the section, then for the value.
+	std::string& LegacyParseValue(std::ifstream& file, std::string& buffer, const std::string& section,
+								  const std::string& value)
+	{
+		file.clear();
+		file.seekg(0, file.beg);
+
+		while (!file.eof()){
+			std::getline(file, buffer);
+			if (buffer[0] == '[' && buffer[buffer.size() - 1] == ']'){
+				if (buffer.compare(1, buffer.size() - 2, section) == 0){
+					std::getline(file, buffer);
+					while (buffer[0] != '[' && !file.eof()){
+						if (buffer[0] != '#'){
+							size_t assign = buffer.find_first_of('=');
+							if (buffer.compare(0, assign, value) == 0){
+								buffer = buffer.substr(assign + 1, buffer.size() - value.size() - 1);
+								return buffer;
+							}
+						}
+
+						std::getline(file, buffer);
+					}
+				}
+			}
+		}
+
+		buffer.clear();
+		return buffer;
+	}
+}
+
+// ================================================ //
+
+int Bench::config(const std::vector<std::string>& args)
+{
+	const int iterations = Bench::getIntArg(args, "iterations", 200);
+	const std::string dataDirectory = Bench::getStringArg(args, "data", "../ExtMF/Data");
+	const std::string only = Bench::getStringArg(args, "file", "");
+
+	std::vector<BenchFile> files;
+	for (int i = 0; i < NumDataFiles; ++i){
+		BenchFile file;
+		file.path = (only.empty()) ? dataDirectory + "/" + DataFiles[i] : only;
+		if (!CollectKeys(file)){
+			printf("config: failed to open \"%s\" (use --data=<directory>)\n", file.path.c_str());
+			return 1;
+		}
+		files.push_back(file);
+		if (!only.empty()){
+			break;
+		}
+	}
+
+	size_t numKeys = 0;
+	for (std::vector<BenchFile>::const_iterator itr = files.begin(); itr != files.end(); ++itr){
+		numKeys += itr->keys.size();
+	}
+
+	// Both parsers must agree on every value. The old parser missed the last
+	// line of a file without a trailing newline, so only compare values it found.
+	int mismatches = 0;
+	for (std::vector<BenchFile>::const_iterator itr = files.begin(); itr != files.end(); ++itr){
+		std::ifstream legacy(itr->path);
+		std::string buffer;
+		Config c(itr->path);
+		for (std::vector<Key>::const_iterator key = itr->keys.begin(); key != itr->keys.end(); ++key){
+			const std::string expected = LegacyParseValue(legacy, buffer, key->first, key->second);
+			const std::string actual = c.parseValue(key->first, key->second);
+			if (!expected.empty() && expected != actual){
+				if (mismatches++ < 5){
+					printf("config: %s [%s] %s: \"%s\" (was \"%s\")\n", itr->path.c_str(), key->first.c_str(),
+						   key->second.c_str(), actual.c_str(), expected.c_str());
+				}
+			}
+		}
+	}
+
+	// Open each file and look up every value in it once, as loading a 
+	// state does.
+	uint64_t check = 0;
+	uint64_t start = SimClock::now();
+	for (int i = 0; i < iterations; ++i){
+		for (std::vector<BenchFile>::const_iterator itr = files.begin(); itr != files.end(); ++itr){
+			std::ifstream legacy(itr->path);
+			std::string buffer;
+			for (std::vector<Key>::const_iterator key = itr->keys.begin(); key != itr->keys.end(); ++key){
+				check += LegacyParseValue(legacy, buffer, key->first, key->second).size();
+			}
+		}
+	}
+	const uint64_t legacyElapsed = SimClock::now() - start;
+
+	start = SimClock::now();
+	for (int i = 0; i < iterations; ++i){
+		for (std::vector<BenchFile>::const_iterator itr = files.begin(); itr != files.end(); ++itr){
+			Config c(itr->path);
+			for (std::vector<Key>::const_iterator key = itr->keys.begin(); key != itr->keys.end(); ++key){
+				check += c.parseValue(key->first, key->second).size();
+			}
+		}
+	}
+	const uint64_t indexedElapsed = SimClock::now() - start;
+
+	const double legacyUs = static_cast<double>(legacyElapsed) / iterations;
+	const double indexedUs = static_cast<double>(indexedElapsed) / iterations;
+	printf("config: %u files, %u values, %d iterations [%u]\n", static_cast<unsigned>(files.size()),
+		   static_cast<unsigned>(numKeys), iterations, static_cast<unsigned>(check & 1));
+	printf("config: rescanning %.1f us per load, indexed %.1f us per load (%.1fx), %d mismatches\n",
+		   legacyUs, indexedUs, (indexedUs > 0.0) ? legacyUs / indexedUs : 0.0, mismatches);
+
+	return (mismatches == 0) ? 0 : 1;
+}
+
+// ================================================ //
\ No newline at end of file
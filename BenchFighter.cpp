@@ -0,0 +1,471 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: BenchFighter.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Benchmarks parsing a synthetic .fighter file with the single-pass move
+// parser against the parser it replaced, which searched the file for every
+// move and every value, and against mapping the fighter compiled.
+// ================================================ //
+
+#include "Bench.hpp"
+#include "FighterMetadata.hpp"
+#include "FighterImage.hpp"
+#include "Move.hpp"
+#include "Hitbox.hpp"
+#include "MatchSim.hpp"
+#include "SimFixed.hpp"
+#include "SimClock.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+namespace{
+	// Converts a value authored in milliseconds to simulation ticks, 
+	// keeping -1 (missing) and other negative values as -1.
+	const int MsToTicks(const int ms)
+	{
+		return (ms < 0) ? -1 : static_cast<int>(SimFixed::msToTicks(static_cast<uint32_t>(ms), MatchSim::TickRate));
+	}
+
+	// The move parser FighterMetadata used before it parsed in one pass. 
+	// Finds [moves] and the move from the start of the file, then seeks 
+	// back to the start of the move for every value.
+	class LegacyFighterParser
+	{
+	public:
+		explicit LegacyFighterParser(const std::string& file) :
+		m_file(file),
+		m_buffer(),
+		m_moveBeg()
+		{
+
+		}
+
+		const bool isLoaded(void) const{
+			return m_file.is_open();
+		}
+
+		std::shared_ptr<Move> parseMove(const std::string& name)
+		{
+			m_file.clear();
+			m_file.seekg(0, m_file.beg);
+
+			while (!m_file.eof()){
+				m_file >> m_buffer;
+				if (m_buffer[0] == '[' && m_buffer[m_buffer.size() - 1] == ']' && 
+					m_buffer.compare(1, m_buffer.size() - 2, "moves") == 0){
+					while (!m_file.eof()){
+						m_file >> m_buffer;
+						if (m_buffer[0] == '+' && m_buffer.compare(2, m_buffer.size() - 3, name) == 0){
+							std::shared_ptr<Move> pMove(new Move());
+							pMove->name = name;
+							m_moveBeg = m_file.tellg();
+
+							pMove->numFrames = this->parseMoveIntValue("core", "numFrames");
+							pMove->frames.reserve(pMove->numFrames);
+							pMove->frameGap = MsToTicks(this->parseMoveIntValue("core", "frameGap"));
+
+							m_buffer = this->parseMoveValue("core", "frameData");
+							char c;
+							std::istringstream parse(m_buffer);
+							parse >> pMove->startupFrames;
+							parse >> c;
+							parse >> pMove->hitFrames;
+							parse >> c;
+							parse >> pMove->recoveryFrames;
+
+							pMove->damage = this->parseMoveIntValue("core", "damage");
+							pMove->hitstun = MsToTicks(this->parseMoveIntValue("core", "hitstun"));
+							pMove->blockstun = MsToTicks(this->parseMoveIntValue("core", "blockstun"));
+							pMove->knockback = this->parseMoveIntValue("core", "knockback");
+							pMove->recoil = this->parseMoveIntValue("core", "recoil");
+							pMove->repeat = (this->parseMoveIntValue("core", "repeat") >= 1);
+							if (pMove->repeat)
+								pMove->repeatFrame = this->parseMoveIntValue("core", "repeatFrame");
+							pMove->reverse = (this->parseMoveIntValue("core", "reverse") >= 1);
+							pMove->transition = this->parseMoveIntValue("core", "transition");
+							pMove->xVel = this->parseMoveIntValue("locomotion", "xVel");
+							pMove->yVel = this->parseMoveIntValue("locomotion", "yVel");
+
+							for (int i = 1; i <= pMove->numFrames; ++i){
+								Frame frame;
+								const std::string section = "frame" + Engine::toString(i);
+								frame.x = this->parseMoveIntValue(section, "x");
+								frame.y = this->parseMoveIntValue(section, "y");
+								frame.w = this->parseMoveIntValue(section, "w");
+								frame.h = this->parseMoveIntValue(section, "h");
+								// The first frame's gap was looked up outside the move, so
+								// it was always zero. It's never compared.
+								frame.gap = (i == 1) ? 0 : this->parseMoveIntValue(section, "gap");
+								frame.gap = (frame.gap == -1) ? pMove->frameGap : MsToTicks(frame.gap);
+								frame.rw = this->parseMoveIntValue(section, "rw");
+								frame.rh = this->parseMoveIntValue(section, "rh");
+								if (i == 1){
+									frame.rw = std::max(frame.rw, 0);
+									frame.rh = std::max(frame.rh, 0);
+								}
+								else{
+									const Frame& prev = pMove->frames.back();
+									if (frame.x == -1)
+										frame.x = prev.x;
+									if (frame.y == -1)
+										frame.y = prev.y;
+									if (frame.w == -1)
+										frame.w = prev.w;
+									if (frame.h == -1)
+										frame.h = prev.h;
+									frame.rw = (frame.w - prev.w);
+									frame.rh = (frame.h - prev.h);
+								}
+
+								for (int h = 1; h <= 4; ++h){
+									frame.hitboxes[Hitbox::HBOX_LOWER + h - 1] = this->parseRect(this->parseMoveValue(section, "hbox" + Engine::toString(h)));
+								}
+								frame.hitboxes[Hitbox::TBOX] = this->parseRect(this->parseMoveValue(section, "tbox"));
+								for (int h = 1; h <= 2; ++h){
+									frame.hitboxes[Hitbox::DBOX1 + h - 1] = this->parseRect(this->parseMoveValue(section, "dbox" + Engine::toString(h)));
+								}
+								for (int h = 1; h <= 2; ++h){
+									frame.hitboxes[Hitbox::CBOX1 + h - 1] = this->parseRect(this->parseMoveValue(section, "cbox" + Engine::toString(h)));
+								}
+
+								pMove->frames.push_back(frame);
+							}
+
+							return pMove;
+						}
+					}
+				}
+			}
+
+			return nullptr;
+		}
+
+	private:
+		std::string parseMoveValue(const std::string& section, const std::string& value)
+		{
+			m_file.clear();
+			m_file.seekg(m_moveBeg);
+
+			while (!m_file.eof()){
+				m_file >> m_buffer;
+				if (m_buffer[0] == '[' && m_buffer[m_buffer.size() - 2] == ']'){
+					if (m_buffer.compare(1, m_buffer.size() - 3, section) == 0){
+						while (m_buffer[0] != '}'){
+							m_file >> m_buffer;
+							if (m_buffer[0] != '#'){
+								size_t assign = m_buffer.find_first_of('=');
+								if (m_buffer.compare(0, assign, value) == 0){
+									return m_buffer.substr(assign + 1, m_buffer.size());
+								}
+							}
+						}
+					}
+				}
+				else if (m_buffer[0] == '-'){
+					break;
+				}
+			}
+
+			m_file.clear();
+			return std::string("");
+		}
+
+		const int parseMoveIntValue(const std::string& section, const std::string& value)
+		{
+			const std::string str = this->parseMoveValue(section, value);
+			return (str.empty()) ? -1 : atoi(str.c_str());
+		}
+
+		SDL_Rect parseRect(const std::string& str)
+		{
+			SDL_Rect rc;
+			memset(&rc, 0, sizeof(rc));
+			if (!str.empty()){
+				char c;
+				std::istringstream parse(str);
+				parse >> c >> rc.x >> c >> rc.y >> c >> rc.w >> c >> rc.h;
+			}
+
+			return rc;
+		}
+
+		std::ifstream m_file;
+		std::string m_buffer;
+		std::streampos m_moveBeg;
+	};
+
+	// Returns the name of move i: the core moves first, then made up ones.
+	std::string GetMoveName(const int i)
+	{
+		return (i < MoveID::END_MOVES) ? std::string(MoveID::Name[i]) : "SPECIAL_" + Engine::toString(i);
+	}
+
+	// Writes a fighter with the given number of moves and frames per move.
+	// Some values are left out so frames inherit from the previous one.
+	bool WriteSyntheticFighter(const std::string& file, const int numMoves, const int numFrames)
+	{
+		std::ofstream out(file);
+		if (!out.is_open()){
+			return false;
+		}
+
+		out << "[core]\nuseSpriteSheet=true\nspriteSheet=SpriteSheets/synthetic.png\n\n";
+		out << "[size]\nw=100\nh=200\n\n[physics]\nxAccel=50\nxMax=300\njumpStrength=150\njumpSpeed=6\n\n";
+		out << "[stats]\nHP=1200\n\n[moves]\n";
+		for (int i = 0; i < numMoves; ++i){
+			const std::string name = GetMoveName(i);
+			out << "+(" << name << ")\n";
+			out << "\t[core]{\n";
+			out << "\t\tnumFrames=" << numFrames << "\n";
+			out << "\t\tframeGap=" << (50 + i % 7) << "\n";
+			out << "\t\tframeData=" << (i % 3) << "/" << (i % 5) << "/" << (i % 4) << "\n";
+			out << "\t\tdamage=" << (i * 3) % 200 << "\n";
+			out << "\t\thitstun=" << 200 + i % 100 << "\n";
+			out << "\t\tblockstun=" << 100 + i % 50 << "\n";
+			out << "\t\tknockback=" << i % 30 << "\n";
+			out << "\t\trepeat=" << i % 2 << "\n";
+			out << "\t\trepeatFrame=" << i % numFrames << "\n";
+			out << "\t\treverse=0\n";
+			out << "\t\ttransition=" << ((i % 3 == 0) ? 0 : -1) << "\n";
+			out << "\t}\n\n";
+			out << "\t[input]{\n\t\tsequence=0\n\t\t#example Special seq: BACK,BACK,LP\n\t\ttimeout=500\n\t}\n\n";
+			if (i % 2 == 0){
+				out << "\t[locomotion]{\n\t\txVel=" << i % 11 << "\n\t\tyVel=" << -(i % 13) << "\n\t}\n\n";
+			}
+			for (int f = 1; f <= numFrames; ++f){
+				out << "\t[frame" << f << "]{\n";
+				out << "\t\t#src\n";
+				out << "\t\tx=" << 1 + f * 64 << "\n";
+				if (f == 1 || f % 4 == 0){
+					out << "\t\ty=" << 1 + i * 108 << "\n\t\tw=" << 63 + f % 3 << "\n\t\th=107\n";
+				}
+				if (f % 5 == 0){
+					out << "\t\tgap=" << 30 + f << "\n";
+				}
+				out << "\t\t\n";
+				for (int h = 1; h <= 4; ++h){
+					out << "\t\thbox" << h << "=(" << -10 + h << "," << 70 - h * 50 << "," << 100 + f % 10 << ",50)\n";
+				}
+				if (f % 3 == 0){
+					out << "\t\tdbox1=(" << 60 + f << ",-40,80,20)\n\t\tcbox2=(0,0," << f << ",10)\n";
+				}
+				out << "\t}\n\n";
+			}
+			out << "-(" << name << ")\n\n";
+		}
+
+		return true;
+	}
+
+	// Returns the number of differences between two parses of a move.
+	int CompareMoves(const Move& a, const Move& b)
+	{
+		int diffs = 0;
+		diffs += (a.name != b.name) + (a.numFrames != b.numFrames) + (a.frameGap != b.frameGap);
+		diffs += (a.startupFrames != b.startupFrames) + (a.hitFrames != b.hitFrames) + 
+			(a.recoveryFrames != b.recoveryFrames);
+		diffs += (a.damage != b.damage) + (a.hitstun != b.hitstun) + (a.blockstun != b.blockstun);
+		diffs += (a.knockback != b.knockback) + (a.recoil != b.recoil) + (a.repeat != b.repeat) + 
+			(a.repeatFrame != b.repeatFrame) + (a.reverse != b.reverse) + (a.transition != b.transition);
+		diffs += (a.xVel != b.xVel) + (a.yVel != b.yVel) + (a.frames.size() != b.frames.size());
+
+		for (size_t f = 0; f < a.frames.size() && f < b.frames.size(); ++f){
+			const Frame& fa = a.frames[f];
+			const Frame& fb = b.frames[f];
+			diffs += (fa.x != fb.x) + (fa.y != fb.y) + (fa.w != fb.w) + (fa.h != fb.h);
+			diffs += (fa.rw != fb.rw) + (fa.rh != fb.rh) + (f != 0 && fa.gap != fb.gap);
+			for (int h = 0; h < SimHitbox::NUM_HITBOXES; ++h){
+				diffs += (memcmp(&fa.hitboxes[h], &fb.hitboxes[h], sizeof(SDL_Rect)) != 0);
+			}
+		}
+
+		return diffs;
+	}
+
+	// Parses every move in file with both parsers and counts the differences.
+	int CompareParsers(const std::string& file, const std::vector<std::string>& names)
+	{
+		LegacyFighterParser legacy(file);
+		FighterMetadata m(file);
+		int diffs = 0;
+		for (std::vector<std::string>::const_iterator itr = names.begin(); itr != names.end(); ++itr){
+			std::shared_ptr<Move> pExpected = legacy.parseMove(*itr);
+			std::shared_ptr<Move> pActual = m.parseMove(*itr);
+			if (pExpected == nullptr || pActual == nullptr){
+				diffs += (pExpected != pActual);
+				continue;
+			}
+
+			const int moveDiffs = CompareMoves(*pExpected, *pActual);
+			if (moveDiffs != 0){
+				printf("fighter: %s: move \"%s\" differs in %d values\n", file.c_str(), itr->c_str(), moveDiffs);
+			}
+			diffs += moveDiffs;
+		}
+
+		return diffs;
+	}
+
+	// Compiles file to imageFile and counts the differences between what 
+	// the mapped image and the text load.
+	int CompareImage(const std::string& file, const std::string& imageFile)
+	{
+		FighterImage::Compile(file, imageFile);
+		std::shared_ptr<FighterImage> pImage(new FighterImage(imageFile));
+		if (!pImage->isLoaded()){
+			printf("fighter: %s: %s\n", imageFile.c_str(), pImage->getError().c_str());
+			return 1;
+		}
+
+		std::vector<std::shared_ptr<Move>> expectedMoves, actualMoves;
+		std::shared_ptr<FighterData> pExpected = FighterMetadata(file).parseFighterData(&expectedMoves);
+		std::shared_ptr<FighterData> pActual = FighterImage::CreateFighterData(pImage);
+		pImage->createMoves(actualMoves);
+
+		int diffs = 0;
+		diffs += (pExpected->w != pActual->w) + (pExpected->h != pActual->h) + (pExpected->hp != pActual->hp);
+		diffs += (pExpected->xAccel != pActual->xAccel) + (pExpected->xMax != pActual->xMax) + 
+			(pExpected->jumpStrength != pActual->jumpStrength) + (pExpected->jumpSpeed != pActual->jumpSpeed);
+		diffs += (pExpected->moves.size() != pActual->moves.size()) + (expectedMoves.size() != actualMoves.size());
+
+		for (size_t i = 0; i < pExpected->moves.size() && i < pActual->moves.size(); ++i){
+			const FighterMove& a = pExpected->moves[i];
+			const FighterMove& b = pActual->moves[i];
+			diffs += (a.id != b.id) + (a.frameGap != b.frameGap) + (a.damage != b.damage);
+			diffs += (a.hitstun != b.hitstun) + (a.blockstun != b.blockstun) + (a.knockback != b.knockback);
+			diffs += (a.recoil != b.recoil) + (a.repeat != b.repeat) + (a.repeatFrame != b.repeatFrame);
+			diffs += (a.transition != b.transition) + (a.xVel != b.xVel) + (a.yVel != b.yVel);
+			diffs += (a.numFrames != b.numFrames);
+			for (uint32_t f = 0; f < a.numFrames && f < b.numFrames; ++f){
+				diffs += (memcmp(&pExpected->getFrame(a, f), &pActual->getFrame(b, f), sizeof(FighterFrame)) != 0);
+			}
+		}
+		for (size_t i = 0; i < expectedMoves.size() && i < actualMoves.size(); ++i){
+			diffs += CompareMoves(*expectedMoves[i], *actualMoves[i]);
+		}
+		if (diffs != 0){
+			printf("fighter: %s: compiled fighter differs in %d values\n", imageFile.c_str(), diffs);
+		}
+
+		return diffs;
+	}
+}
+
+// ================================================ //
+
+int Bench::fighter(const std::vector<std::string>& args)
+{
+	const int numMoves = std::max(Bench::getIntArg(args, "moves", 300), static_cast<int>(MoveID::END_MOVES));
+	const int numFrames = std::max(Bench::getIntArg(args, "frames", 16), 1);
+	const int iterations = std::max(Bench::getIntArg(args, "iterations", 3), 1);
+	const std::string file = Bench::getStringArg(args, "out", "synthetic.fighter");
+	const std::string dataDirectory = Bench::getStringArg(args, "data", "../ExtMF/Data");
+
+	if (!WriteSyntheticFighter(file, numMoves, numFrames)){
+		printf("fighter: failed to write \"%s\"\n", file.c_str());
+		return 1;
+	}
+
+	std::vector<std::string> names;
+	for (int i = 0; i < numMoves; ++i){
+		names.push_back(GetMoveName(i));
+	}
+
+	// Both parsers must build the same moves, from the synthetic fighter and
+	// from the shipped one if it can be found.
+	int diffs = CompareParsers(file, names);
+	const std::string shipped = dataDirectory + "/Fighters/corpse-explosion.fighter";
+	if (LegacyFighterParser(shipped).isLoaded()){
+		diffs += CompareParsers(shipped, std::vector<std::string>(MoveID::Name, MoveID::Name + MoveID::END_MOVES));
+		diffs += CompareImage(shipped, FighterImage::GetImageFile("shipped.fighter"));
+	}
+	else{
+		printf("fighter: \"%s\" not found, only comparing the synthetic fighter (use --data=<directory>)\n", 
+			   shipped.c_str());
+	}
+
+	// Load every move, as character select and reloading do.
+	size_t check = 0;
+	uint64_t start = SimClock::now();
+	for (int i = 0; i < iterations; ++i){
+		LegacyFighterParser legacy(file);
+		for (std::vector<std::string>::const_iterator itr = names.begin(); itr != names.end(); ++itr){
+			check += legacy.parseMove(*itr)->frames.size();
+		}
+	}
+	const uint64_t legacyElapsed = SimClock::now() - start;
+
+	start = SimClock::now();
+	for (int i = 0; i < iterations; ++i){
+		FighterMetadata m(file);
+		for (std::vector<std::string>::const_iterator itr = names.begin(); itr != names.end(); ++itr){
+			check += m.parseMove(*itr)->frames.size();
+		}
+	}
+	const uint64_t singleElapsed = SimClock::now() - start;
+
+	// Load the FighterData and Moves the game needs, from the text and 
+	// from the compiled fighter, as Player::loadFighterData does.
+	const std::string imageFile = FighterImage::GetImageFile(file);
+	diffs += CompareImage(file, imageFile);
+
+	const int loads = iterations * 100;
+	start = SimClock::now();
+	for (int i = 0; i < iterations; ++i){
+		std::vector<std::shared_ptr<Move>> moves;
+		check += FighterMetadata(file).parseFighterData(&moves)->moves.size();
+	}
+	const uint64_t textElapsed = SimClock::now() - start;
+
+	start = SimClock::now();
+	for (int i = 0; i < loads; ++i){
+		std::vector<std::shared_ptr<Move>> moves;
+		std::shared_ptr<FighterImage> pImage(new FighterImage(imageFile));
+		check += FighterImage::CreateFighterData(pImage)->moves.size();
+		pImage->createMoves(moves);
+	}
+	const uint64_t imageElapsed = SimClock::now() - start;
+
+	// The server only needs the FighterData.
+	start = SimClock::now();
+	for (int i = 0; i < loads; ++i){
+		std::shared_ptr<FighterImage> pImage(new FighterImage(imageFile));
+		check += FighterImage::CreateFighterData(pImage)->moves.size();
+	}
+	const uint64_t dataElapsed = SimClock::now() - start;
+
+	const double legacyMs = static_cast<double>(legacyElapsed) / (iterations * 1000.0);
+	const double singleMs = static_cast<double>(singleElapsed) / (iterations * 1000.0);
+	printf("fighter: %d moves x %d frames, %d iterations [%u]\n", numMoves, numFrames, iterations,
+		   static_cast<unsigned>(check & 1));
+	printf("fighter: searching %.2f ms per load, single pass %.2f ms per load (%.1fx)\n",
+		   legacyMs, singleMs, (singleMs > 0.0) ? legacyMs / singleMs : 0.0);
+
+	const double textUs = static_cast<double>(textElapsed) / iterations;
+	const double imageUs = static_cast<double>(imageElapsed) / loads;
+	const double dataUs = static_cast<double>(dataElapsed) / loads;
+	printf("fighter: %s %.0f us per load, %s %.1f us per load (%.0fx), %.1f us without Moves\n",
+		   file.c_str(), textUs, imageFile.c_str(), imageUs, (imageUs > 0.0) ? textUs / imageUs : 0.0, dataUs);
+	printf("fighter: %d differences\n", diffs);
+
+	return (diffs == 0) ? 0 : 1;
+}
+
+// ================================================ //
\ No newline at end of file
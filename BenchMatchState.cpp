@@ -0,0 +1,65 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: BenchMatchState.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Benchmarks saving and restoring a MatchState.
+// ================================================ //
+
+#include "Bench.hpp"
+#include "MatchSim.hpp"
+#include "SimClock.hpp"
+
+// ================================================ //
+
+int Bench::matchState(const std::vector<std::string>& args)
+{
+	const int iterations = Bench::getIntArg(args, "iterations", 1000000);
+	const double target = 1000.0;
+
+	SimConfig config;
+	MatchSim sim(Bench::createSyntheticFighter(), Bench::createSyntheticFighter(), config);
+
+	// Advance a little so the state isn't all zeroes.
+	const SimInput inputs[MatchSim::NUM_FIGHTERS] = { SimButton::RIGHT, SimButton::LEFT };
+	for (int i = 0; i < 30; ++i){
+		sim.step(inputs);
+	}
+
+	MatchState saved;
+	uint32_t check = 0;
+
+	const uint64_t start = SimClock::now();
+	for (int i = 0; i < iterations; ++i){
+		sim.save(saved);
+		// Touch the copy so the save can't be optimized away.
+		saved.tick += i;
+		sim.load(saved);
+		check += sim.getTick();
+	}
+	const uint64_t elapsed = SimClock::now() - start;
+
+	const double ns = (static_cast<double>(elapsed) * 1000.0) / iterations;
+	printf("matchstate: sizeof(MatchState)=%u bytes, %d iterations, %.1f ns per save+restore "
+		   "(target < %.0f ns) [%u]\n", static_cast<unsigned>(sizeof(MatchState)), iterations, ns, target, 
+		   check & 1);
+
+	return (ns < target) ? 0 : 1;
+}
+
+// ================================================ //
\ No newline at end of file
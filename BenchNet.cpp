@@ -0,0 +1,326 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: BenchNet.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Benchmarks the netcode over a conditioned loopback network.
+// ================================================ //
+
+#include "Bench.hpp"
+#include "MatchInstance.hpp"
+#include "LoopbackTransport.hpp"
+#include "Client.hpp"
+#include "NetMessage.hpp"
+#include "SimClock.hpp"
+
+#include <algorithm>
+
+// ================================================ //
+
+namespace{
+	// Resolution of the simulated clock (us). Packets are delivered at 
+	// most this late, and snapshot ages are measured to it.
+	const uint64_t StepMicroseconds = 1000;
+
+	// Buttons the simulated players pick from, held for a random time.
+	const SimInput RandomInputs[] = {
+		0, SimButton::RIGHT, SimButton::LEFT, SimButton::UP, SimButton::DOWN, SimButton::LP,
+		SimButton::RIGHT | SimButton::LP, SimButton::LEFT | SimButton::LP, SimButton::DOWN | SimButton::LP
+	};
+
+	const int NumRandomInputs = sizeof(RandomInputs) / sizeof(RandomInputs[0]);
+
+	// A player's end of a match: sends CLIENT_INPUT every tick and decodes
+	// and acknowledges WORLD_SNAPSHOT, as Client does.
+	struct SimulatedClient{
+		std::shared_ptr<LoopbackTransport> pTransport;
+		SnapshotChannel snapshots;
+		uint32_t seed;
+		SimInput buttons;
+		uint32_t hold;
+		Uint32 seq;
+		Uint8 recent[Client::InputRedundancy];
+		Uint8 numRecent;
+		// Newest snapshot tick decoded, shown as the opponent's view tick, 
+		// and its sequence, so repeats are ignored.
+		Uint32 viewTick;
+		Uint16 newestSeq;
+		bool hasSeq;
+		// Snapshots decoded and dropped, and their total and worst age (us).
+		uint64_t received, undecodable;
+		uint64_t totalAge, maxAge;
+		// FNV-1a of every decoded snapshot, in the order decoded.
+		uint32_t digest;
+	};
+
+	// Xorshift, so runs are the same on every platform.
+	uint32_t random(uint32_t& seed){
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+
+	void hash(uint32_t& digest, const int32_t value){
+		for (int i = 0; i < 4; ++i){
+			digest = (digest ^ ((static_cast<uint32_t>(value) >> (i * 8)) & 0xff)) * 16777619u;
+		}
+	}
+
+	void sendInput(SimulatedClient& client, const RakNet::SystemAddress& server){
+		if (client.hold == 0){
+			client.buttons = RandomInputs[random(client.seed) % NumRandomInputs];
+			client.hold = 1 + (random(client.seed) % 20);
+		}
+		--client.hold;
+
+		for (int i = Client::InputRedundancy - 1; i > 0; --i){
+			client.recent[i] = client.recent[i - 1];
+		}
+		client.recent[0] = static_cast<Uint8>(client.buttons);
+		if (client.numRecent < Client::InputRedundancy){
+			++client.numRecent;
+		}
+
+		RakNet::BitStream bit;
+		Client::WriteInputs(bit, ++client.seq, client.viewTick, client.viewTick, client.recent, 
+			client.numRecent, 0);
+		client.pTransport->send(bit, IMMEDIATE_PRIORITY, UNRELIABLE, server);
+	}
+
+	// Receives everything that has arrived, acknowledging each snapshot and
+	// measuring its age against when the current match started.
+	void receive(SimulatedClient& client, const uint64_t now, const uint64_t matchStart){
+		for (RakNet::Packet* packet = client.pTransport->receive();
+			packet;
+			client.pTransport->deallocatePacket(packet), packet = client.pTransport->receive()){
+			if (packet->data[0] == NetMessage::SERVER_STARTING_GAME){
+				client.snapshots.reset();
+				client.viewTick = 0;
+				client.hasSeq = false;
+				continue;
+			}
+			if (packet->data[0] != NetMessage::WORLD_SNAPSHOT){
+				continue;
+			}
+
+			RakNet::BitStream bit(packet->data, packet->length, false);
+			bit.IgnoreBytes(sizeof(RakNet::MessageID));
+			WorldSnapshot snapshot;
+			Uint16 seq = 0;
+			if (!client.snapshots.read(bit, snapshot, seq)){
+				++client.undecodable;
+				continue;
+			}
+			if (client.hasSeq && static_cast<Sint16>(seq - client.newestSeq) <= 0){
+				continue;
+			}
+			client.newestSeq = seq;
+			client.hasSeq = true;
+
+			RakNet::BitStream ack;
+			ack.Write(static_cast<RakNet::MessageID>(NetMessage::SNAPSHOT_ACK));
+			ack.Write(seq);
+			client.pTransport->send(ack, HIGH_PRIORITY, UNRELIABLE, packet->systemAddress);
+
+			// Tick n of a match is simulated n - 1 ticks after it starts.
+			const uint64_t sentAt = matchStart + 
+				static_cast<uint64_t>((snapshot.tick > 0) ? snapshot.tick - 1 : 0) * MatchSim::TickMicroseconds;
+			const uint64_t age = (now > sentAt) ? now - sentAt : 0;
+			++client.received;
+			client.totalAge += age;
+			client.maxAge = std::max(client.maxAge, age);
+			client.viewTick = std::max(client.viewTick, snapshot.tick);
+
+			hash(client.digest, snapshot.tick);
+			hash(client.digest, snapshot.cameraPanX);
+			for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+				const PlayerUpdate& player = snapshot.players[i];
+				hash(client.digest, player.x);
+				hash(client.digest, player.y);
+				hash(client.digest, player.xVel);
+				hash(client.digest, player.state);
+				hash(client.digest, player.hp);
+				hash(client.digest, player.lastProcessedInput);
+			}
+		}
+	}
+}
+
+// ================================================ //
+
+int Bench::netcode(const std::vector<std::string>& args)
+{
+	const int seconds = std::max(1, Bench::getIntArg(args, "seconds", 60));
+	const uint32_t seed = static_cast<uint32_t>(Bench::getIntArg(args, "seed", 1));
+	const bool json = (Bench::getIntArg(args, "json", 0) != 0);
+	const bool fixed = (Bench::getIntArg(args, "fixed", 0) != 0);
+
+	// Times are given in ms and chances in percent.
+	NetworkConditions conditions;
+	conditions.latency = static_cast<uint64_t>(std::max(0, Bench::getIntArg(args, "latency", 50))) * 1000;
+	conditions.jitter = static_cast<uint64_t>(std::max(0, Bench::getIntArg(args, "jitter", 5))) * 1000;
+	conditions.spikeChance = Bench::getIntArg(args, "spike", 0) / 100.0;
+	conditions.spikeLatency = conditions.latency * 4;
+	conditions.reorderChance = Bench::getIntArg(args, "reorder", 0) / 100.0;
+	conditions.reorderDelay = conditions.latency / 2;
+	conditions.duplicateChance = Bench::getIntArg(args, "dup", 0) / 100.0;
+	conditions.lossChance = Bench::getIntArg(args, "loss", 2) / 100.0;
+	conditions.burstLength = std::max(1, Bench::getIntArg(args, "burst", 2));
+	conditions.bandwidth = static_cast<Uint32>(std::max(0, Bench::getIntArg(args, "bandwidth", 0)));
+
+	LoopbackNetwork network(seed);
+	network.setDefaultConditions(conditions);
+	std::shared_ptr<LoopbackTransport> pServer = network.createEndpoint();
+	SimulatedClient clients[MatchSim::NUM_FIGHTERS];
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		SimulatedClient& client = clients[i];
+		client.pTransport = network.createEndpoint();
+		client.seed = (seed * 2654435761u) + i + 1;
+		client.buttons = 0;
+		client.hold = 0;
+		client.seq = 0;
+		client.numRecent = 0;
+		client.viewTick = 0;
+		client.newestSeq = 0;
+		client.hasSeq = false;
+		client.received = client.undecodable = 0;
+		client.totalAge = client.maxAge = 0;
+		client.digest = 2166136261u;
+	}
+
+	// A fixed rate sends one snapshot per tick to everyone, as before adaptation.
+	SimConfig config;
+	SnapshotRateConfig rateConfig;
+	if (fixed){
+		rateConfig.minInterval = rateConfig.maxInterval = 1000 / MatchSim::TickRate;
+		rateConfig.maxRedundancy = 1;
+	}
+	std::shared_ptr<FighterData> pFighter = Bench::createSyntheticFighter();
+	MatchPlayer red, blue;
+	red.addr = clients[MatchSim::RED].pTransport->getAddress();
+	red.username = "red";
+	red.fighter = 0;
+	blue.addr = clients[MatchSim::BLUE].pTransport->getAddress();
+	blue.username = "blue";
+	blue.fighter = 0;
+
+	std::shared_ptr<MatchInstance> pMatch;
+	uint64_t matchStart = 0, nextTick = 0;
+	Uint32 matches = 0;
+	uint64_t snapshotsSent = 0, snapshotBytes = 0;
+	MatchStats stats;
+
+	const uint64_t end = static_cast<uint64_t>(seconds) * 1000000;
+	const uint64_t start = SimClock::nowNs();
+	for (uint64_t now = 0; now < end; now += StepMicroseconds){
+		network.setTime(now);
+
+		// Server: route packets to the match, then run its ticks.
+		for (RakNet::Packet* packet = pServer->receive(); 
+			packet; 
+			pServer->deallocatePacket(packet), packet = pServer->receive()){
+			if (pMatch && packet->data[0] == NetMessage::CLIENT_INPUT){
+				pMatch->handleInput(packet);
+			}
+			else if (pMatch && packet->data[0] == NetMessage::SNAPSHOT_ACK){
+				pMatch->handleAck(packet);
+			}
+		}
+
+		if (now >= nextTick){
+			// Start another match when one ends, as a server would.
+			if (!pMatch || pMatch->isOver()){
+				if (pMatch){
+					stats = pMatch->getStats();
+					snapshotsSent += stats.snapshots.packets;
+					snapshotBytes += stats.snapshots.packedBytes;
+				}
+				pMatch.reset(new MatchInstance(++matches, pServer.get(), red, blue, pFighter, pFighter, config, rateConfig));
+				pMatch->start();
+				matchStart = now;
+			}
+
+			pMatch->tick(SimClock::now());
+			nextTick += MatchSim::TickMicroseconds;
+
+			for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+				sendInput(clients[i], pServer->getAddress());
+			}
+		}
+
+		for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+			receive(clients[i], now, matchStart);
+		}
+	}
+	const uint64_t elapsed = SimClock::nowNs() - start;
+
+	stats = pMatch->getStats();
+	snapshotsSent += stats.snapshots.packets;
+	snapshotBytes += stats.snapshots.packedBytes;
+
+	uint64_t received = 0, undecodable = 0, totalAge = 0, maxAge = 0;
+	uint32_t digest = 0;
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		received += clients[i].received;
+		undecodable += clients[i].undecodable;
+		totalAge += clients[i].totalAge;
+		maxAge = std::max(maxAge, clients[i].maxAge);
+		digest = (digest * 31) ^ clients[i].digest;
+	}
+
+	const double wallSeconds = elapsed / 1000000000.0;
+	const double speedup = (elapsed > 0) ? (end * 1000.0) / elapsed : 0.0;
+	const double meanAge = (received > 0) ? static_cast<double>(totalAge) / received / 1000.0 : 0.0;
+	const double delivered = (snapshotsSent > 0) ? (100.0 * received) / snapshotsSent : 0.0;
+
+	if (json){
+		printf("{\"benchmark\":\"netcode\",\"seconds\":%d,\"seed\":%u,\"latencyMs\":%u,\"jitterMs\":%u,"
+			   "\"lossPercent\":%.1f,\"burst\":%.1f,\"wallSeconds\":%.6f,\"speedup\":%.1f,\"matches\":%u,"
+			   "\"snapshotsSent\":%llu,\"snapshotBytes\":%llu,\"snapshotsReceived\":%llu,\"undecodable\":%llu,"
+			   "\"meanAgeMs\":%.2f,\"maxAgeMs\":%.2f,\"digest\":\"%08x\"}\n",
+			   seconds, seed, static_cast<unsigned>(conditions.latency / 1000), 
+			   static_cast<unsigned>(conditions.jitter / 1000), conditions.lossChance * 100.0, 
+			   conditions.burstLength, wallSeconds, speedup, matches, 
+			   static_cast<unsigned long long>(snapshotsSent), static_cast<unsigned long long>(snapshotBytes), 
+			   static_cast<unsigned long long>(received), static_cast<unsigned long long>(undecodable),
+			   meanAge, maxAge / 1000.0, digest);
+	}
+	else{
+		printf("netcode: %d s simulated in %.3f s (%.1fx real time), %u matches, seed %u\n"
+			   "netcode: %llu snapshots sent (%llu bytes), %llu decoded (%.1f%%), %llu undecodable\n"
+			   "netcode: snapshot age mean %.2f ms, max %.2f ms, digest %08x\n",
+			   seconds, wallSeconds, speedup, matches, seed,
+			   static_cast<unsigned long long>(snapshotsSent), static_cast<unsigned long long>(snapshotBytes),
+			   static_cast<unsigned long long>(received), delivered, static_cast<unsigned long long>(undecodable),
+			   meanAge, maxAge / 1000.0, digest);
+		for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+			const RakNet::SystemAddress& addr = clients[i].pTransport->getAddress();
+			printf("netcode: server -> %s: %s\n", (i == MatchSim::RED) ? "red" : "blue",
+				   NetworkConditioner::FormatStats(network.getStats(pServer->getAddress(), addr)).c_str());
+			printf("netcode: %s -> server: %s\n", (i == MatchSim::RED) ? "red" : "blue",
+				   NetworkConditioner::FormatStats(network.getStats(addr, pServer->getAddress())).c_str());
+			printf("netcode: snapshots to %s (last match): %s\n", (i == MatchSim::RED) ? "red" : "blue",
+				   SnapshotRate::FormatStats(stats.rates[i]).c_str());
+		}
+	}
+
+	return 0;
+}
+
+// ================================================ //
\ No newline at end of file
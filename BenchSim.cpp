@@ -0,0 +1,287 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: BenchSim.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Benchmarks MatchSim throughput over many matches.
+// ================================================ //
+
+#include "Bench.hpp"
+#include "MatchSim.hpp"
+#include "SimClock.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// ================================================ //
+
+namespace{
+	// Both fighters' buttons, held for a number of ticks.
+	struct ScriptStep{
+		uint32_t ticks;
+		SimInput inputs[MatchSim::NUM_FIGHTERS];
+	};
+
+	typedef std::vector<ScriptStep> InputScript;
+
+	// Button combinations the random stream picks from, so fighters walk,
+	// jump, crouch and attack rather than mashing every button at once.
+	const SimInput RandomInputs[] = {
+		0, 0, SimButton::RIGHT, SimButton::LEFT, SimButton::UP, SimButton::DOWN, SimButton::LP,
+		SimButton::RIGHT | SimButton::LP, SimButton::LEFT | SimButton::LP, SimButton::RIGHT | SimButton::UP, 
+		SimButton::LEFT | SimButton::UP, SimButton::DOWN | SimButton::LP
+	};
+
+	const int NumRandomInputs = sizeof(RandomInputs) / sizeof(RandomInputs[0]);
+
+	// Longest a random input is held (ticks).
+	const uint32_t MaxRandomHold = 20;
+
+	// Supplies one match's inputs each tick, either by looping an input 
+	// script or from a seeded random stream.
+	class InputStream
+	{
+	public:
+		explicit InputStream(const InputScript* pScript, const uint32_t seed) :
+		m_pScript(pScript),
+		m_step(0),
+		m_remaining(0),
+		m_seed((seed == 0) ? 1 : seed)
+		{
+			memset(m_inputs, 0, sizeof(m_inputs));
+			memset(m_hold, 0, sizeof(m_hold));
+
+			// Start on the first step, held for its full tick count.
+			if (m_pScript){
+				m_remaining = (*m_pScript)[0].ticks;
+			}
+		}
+
+		// Fills inputs with the next tick's input for each fighter.
+		void next(SimInput inputs[MatchSim::NUM_FIGHTERS]){
+			if (m_pScript){
+				memcpy(inputs, (*m_pScript)[m_step].inputs, sizeof(m_inputs));
+
+				// Move on once this step has been used up.
+				if (--m_remaining == 0){
+					m_step = (m_step + 1) % m_pScript->size();
+					m_remaining = (*m_pScript)[m_step].ticks;
+				}
+				return;
+			}
+
+			for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+				if (m_hold[i] == 0){
+					m_inputs[i] = RandomInputs[this->random() % NumRandomInputs];
+					m_hold[i] = 1 + (this->random() % MaxRandomHold);
+				}
+				--m_hold[i];
+				inputs[i] = m_inputs[i];
+			}
+		}
+
+	private:
+		// Xorshift, so streams are the same on every platform.
+		uint32_t random(void){
+			m_seed ^= m_seed << 13;
+			m_seed ^= m_seed >> 17;
+			m_seed ^= m_seed << 5;
+			return m_seed;
+		}
+
+		const InputScript* m_pScript;
+		size_t m_step;
+		uint32_t m_remaining;
+		uint32_t m_seed;
+		SimInput m_inputs[MatchSim::NUM_FIGHTERS];
+		uint32_t m_hold[MatchSim::NUM_FIGHTERS];
+	};
+
+	// Parses buttons such as "RIGHT+LP", "NONE" or a number (e.g., "0x88").
+	bool parseButtons(const std::string& str, SimInput& input){
+		static const struct{ const char* name; SimInput button; } Buttons[] = {
+			{ "UP", SimButton::UP }, { "DOWN", SimButton::DOWN }, { "LEFT", SimButton::LEFT },
+			{ "RIGHT", SimButton::RIGHT }, { "START", SimButton::START }, { "SELECT", SimButton::SELECT },
+			{ "BACK", SimButton::BACK }, { "LP", SimButton::LP }
+		};
+
+		input = 0;
+		if (str == "NONE" || str == "-"){
+			return true;
+		}
+		if (isdigit(str[0])){
+			input = static_cast<SimInput>(strtoul(str.c_str(), nullptr, 0));
+			return true;
+		}
+
+		std::stringstream ss(str);
+		std::string name;
+		while (std::getline(ss, name, '+')){
+			bool found = false;
+			for (int i = 0; i < sizeof(Buttons) / sizeof(Buttons[0]); ++i){
+				if (name == Buttons[i].name){
+					input |= Buttons[i].button;
+					found = true;
+					break;
+				}
+			}
+			if (!found){
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Loads an input script. Each line is "<ticks> <red buttons> <blue buttons>",
+	// and lines starting with '#' are comments. The script loops when it ends.
+	bool loadScript(const std::string& file, InputScript& script){
+		std::ifstream in(file.c_str());
+		if (!in.is_open()){
+			printf("sim: Failed to open input script \"%s\"\n", file.c_str());
+			return false;
+		}
+
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(in, line)){
+			++lineNumber;
+			if (line.empty() || line[0] == '#'){
+				continue;
+			}
+
+			std::stringstream ss(line);
+			ScriptStep step;
+			std::string red, blue;
+			if (!(ss >> step.ticks >> red >> blue) || step.ticks == 0 ||
+				!parseButtons(red, step.inputs[MatchSim::RED]) ||
+				!parseButtons(blue, step.inputs[MatchSim::BLUE])){
+				printf("sim: Invalid input script line %d: \"%s\"\n", lineNumber, line.c_str());
+				return false;
+			}
+			script.push_back(step);
+		}
+
+		if (script.empty()){
+			printf("sim: Input script \"%s\" is empty\n", file.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	// Returns the p-th percentile (0 to 1) of sorted values.
+	uint32_t percentile(const std::vector<uint32_t>& sorted, const double p){
+		size_t i = static_cast<size_t>(p * sorted.size());
+		return sorted[std::min(i, sorted.size() - 1)];
+	}
+}
+
+// ================================================ //
+
+int Bench::simThroughput(const std::vector<std::string>& args)
+{
+	const int matches = std::max(1, Bench::getIntArg(args, "matches", 64));
+	const int ticks = std::max(1, Bench::getIntArg(args, "ticks", 3600));
+	const int frames = std::max(1, Bench::getIntArg(args, "frames", 4));
+	const uint32_t seed = static_cast<uint32_t>(Bench::getIntArg(args, "seed", 1));
+	const std::string scriptFile = Bench::getStringArg(args, "script", "");
+	const bool json = (Bench::getIntArg(args, "json", 0) != 0);
+	const int target = Bench::getIntArg(args, "target", 0);
+
+	InputScript script;
+	if (!scriptFile.empty() && !loadScript(scriptFile, script)){
+		return 1;
+	}
+
+	SimConfig config;
+	std::shared_ptr<FighterData> pFighter = Bench::createSyntheticFighter(frames);
+
+	std::vector<std::shared_ptr<MatchSim>> sims;
+	std::vector<InputStream> streams;
+	for (int i = 0; i < matches; ++i){
+		sims.push_back(std::shared_ptr<MatchSim>(new MatchSim(pFighter, pFighter, config)));
+		streams.push_back(InputStream((script.empty()) ? nullptr : &script, seed + i));
+	}
+
+	const size_t total = static_cast<size_t>(matches) * ticks;
+	std::vector<uint32_t> times;
+	times.reserve(total);
+	uint32_t rounds = 0;
+
+	// Matches are interleaved tick by tick, as a server hosting them would.
+	const uint64_t allocations = Bench::getAllocations();
+	const uint64_t start = SimClock::nowNs();
+	for (int t = 0; t < ticks; ++t){
+		for (int m = 0; m < matches; ++m){
+			SimInput inputs[MatchSim::NUM_FIGHTERS];
+			streams[m].next(inputs);
+
+			const uint64_t tickStart = SimClock::nowNs();
+			MatchSim& sim = *sims[m];
+			sim.step(inputs);
+			// Start a new round on a knockout, as a real match would.
+			if (sim.getFighterState(MatchSim::RED).hp <= 0 || sim.getFighterState(MatchSim::BLUE).hp <= 0){
+				sim.reset();
+				++rounds;
+			}
+			times.push_back(static_cast<uint32_t>(SimClock::nowNs() - tickStart));
+		}
+	}
+	const uint64_t elapsed = SimClock::nowNs() - start;
+	const double allocationsPerTick = static_cast<double>(Bench::getAllocations() - allocations) / total;
+
+	// A checksum of every final state, to catch changes in behaviour.
+	uint32_t checksum = 0;
+	for (int i = 0; i < matches; ++i){
+		checksum = (checksum * 31) ^ MatchSim::Checksum(sims[i]->getState());
+	}
+
+	uint64_t simTime = 0;
+	for (size_t i = 0; i < times.size(); ++i){
+		simTime += times[i];
+	}
+	std::sort(times.begin(), times.end());
+
+	const double mean = static_cast<double>(simTime) / total;
+	const double ticksPerSecond = (simTime > 0) ? (total * 1000000000.0) / simTime : 0.0;
+	const std::string inputs = (script.empty()) ? "random" : scriptFile;
+
+	if (json){
+		printf("{\"benchmark\":\"sim\",\"matches\":%d,\"ticks\":%d,\"frames\":%d,\"inputs\":\"%s\",\"seed\":%u,"
+			   "\"totalTicks\":%u,\"wallSeconds\":%.6f,\"ticksPerSecond\":%.0f,\"meanNs\":%.1f,"
+			   "\"p50Ns\":%u,\"p99Ns\":%u,\"p999Ns\":%u,\"maxNs\":%u,\"allocationsPerTick\":%.4f,"
+			   "\"rounds\":%u,\"checksum\":\"%08x\"}\n",
+			   matches, ticks, frames, Bench::escapeJson(inputs).c_str(), seed, static_cast<unsigned>(total), elapsed / 1000000000.0,
+			   ticksPerSecond, mean, percentile(times, 0.5), percentile(times, 0.99), percentile(times, 0.999), 
+			   times.back(), allocationsPerTick, rounds, checksum);
+	}
+	else{
+		printf("sim: %d matches x %d ticks (%s inputs), %u ticks in %.3f s\n"
+			   "sim: %.0f ticks/s, tick time mean %.1f ns, p50 %u ns, p99 %u ns, p99.9 %u ns, max %u ns\n"
+			   "sim: %.4f allocations per tick, %u rounds, checksum %08x\n",
+			   matches, ticks, inputs.c_str(), static_cast<unsigned>(total), elapsed / 1000000000.0,
+			   ticksPerSecond, mean, percentile(times, 0.5), percentile(times, 0.99), percentile(times, 0.999),
+			   times.back(), allocationsPerTick, rounds, checksum);
+	}
+
+	return (target > 0 && mean > target) ? 1 : 0;
+}
+
+// ================================================ //
\ No newline at end of file
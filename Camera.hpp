@@ -52,6 +52,12 @@ public:
 	// Returne true if Camera is not at either edge of stage.
 	const bool isBetweenBounds(void) const;
 
+	// Returns the pan speed (pixels per second).
+	const int getSpeed(void) const;
+
+	// Sets the current position directly, without panning.
+	void setPosition(const int x, const int y);
+
 	// Sets the right edge at which camera.x + camera.w can be at.
 	void setRightBound(const int bound);
 
@@ -98,6 +104,15 @@ inline const bool Camera::isBetweenBounds(void) const{
 	return (m_panX > 0 && m_panX < m_rightBound);
 }
 
+inline const int Camera::getSpeed(void) const{
+	return m_speed;
+}
+
+inline void Camera::setPosition(const int x, const int y){
+	m_x = x;
+	m_y = y;
+}
+
 inline void Camera::setRightBound(const int bound){
 	m_rightBound = bound;
 }
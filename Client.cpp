@@ -30,6 +30,8 @@
 #include "PlayerManager.hpp"
 #include "StageManager.hpp"
 #include "Stage.hpp"
+#include "MatchSim.hpp"
+#include "SpectatorChannel.hpp"
 
 // ================================================ //
 
@@ -39,15 +41,24 @@ template<> Client* Singleton<Client>::msSingleton = nullptr;
 
 Client::Client(const std::string& server, const int port) :
 m_peer(RakNet::RakPeerInterface::GetInstance()),
+m_pTransport(new RakNetTransport(m_peer)),
 m_packet(nullptr),
 m_server(server),
 m_port(port),
 m_connected(false),
-m_inputSeq(0),
+m_inputSeq(1),
 m_pendingInputs(),
 m_pendingStageShifts(),
 m_stageShiftSeq(0),
-m_timeout(10000)
+m_timeout(10000),
+m_inputAccumulator(0.0),
+m_recentInputs(),
+m_numRecentInputs(0),
+m_snapshots(),
+m_newestSnapshot(0),
+m_hasSnapshot(false),
+m_clock(),
+m_viewTick(0)
 {
 	Log::getSingletonPtr()->logMessage("Initializing Client...");
 
@@ -84,6 +95,14 @@ bool Client::update(void)
 	case NetMessage::PLAYING_BLUE:
 		Game::getSingletonPtr()->setPlaying(Game::PLAYING_BLUE);
 		break;
+
+	case NetMessage::CLOCK_PONG:
+		{
+			RakNet::BitStream bit(m_packet->data, m_packet->length, false);
+			bit.IgnoreBytes(sizeof(RakNet::MessageID));
+			m_clock.readPong(bit, SimClock::now());
+		}
+		break;
 	}
 
 	return true;
@@ -93,7 +112,7 @@ bool Client::update(void)
 
 Uint32 Client::send(const RakNet::BitStream& bit, const PacketPriority priority, const PacketReliability reliability)
 {
-	return m_peer->Send(&bit, priority, reliability, 0, m_serverAddr, false);
+	return m_pTransport->send(bit, priority, reliability, m_serverAddr);
 }
 
 // ================================================ //
@@ -115,6 +134,7 @@ void Client::disconnect(void)
 	// Send this with immediate priority because the peer connection 
 	// will be closed soon after this function is called.
 	m_peer->CloseConnection(m_serverAddr, true, 0, IMMEDIATE_PRIORITY);
+	m_connected = false;
 }
 
 // ================================================ //
@@ -141,14 +161,32 @@ Uint32 Client::ready(const Uint32 fighter)
 
 // ================================================ //
 
-Uint32 Client::sendInput(const Uint32 input, const bool value, const double dt)
+void Client::updateInput(const SimInput buttons, const double dt)
+{
+	m_inputAccumulator += dt;
+
+	int ticks = 0;
+	while (m_inputAccumulator >= MatchSim::TickLength){
+		if (ticks >= PlayerManager::MaxTicksPerUpdate){
+			m_inputAccumulator = 0.0;
+			break;
+		}
+
+		this->sendInput(buttons, MatchSim::TickLength);
+		m_inputAccumulator -= MatchSim::TickLength;
+		++ticks;
+	}
+}
+
+// ================================================ //
+
+Uint32 Client::sendInput(const SimInput buttons, const double dt)
 {
 	const Uint32 seq = m_inputSeq++;
 
 	// Save input for later reconciliation.
 	ClientInput clientInput;
-	clientInput.input = input;
-	clientInput.value = value;
+	clientInput.buttons = buttons;
 	clientInput.seq = seq;
 	clientInput.dt = dt;
 	if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_RED){
@@ -160,20 +198,112 @@ Uint32 Client::sendInput(const Uint32 input, const bool value, const double dt)
 
 	m_pendingInputs.push_back(clientInput);
 
-	// Create packet and send.
+	// Keep the last few inputs to resend with the next ones.
+	for (int i = Client::InputRedundancy - 1; i > 0; --i){
+		m_recentInputs[i] = m_recentInputs[i - 1];
+	}
+	m_recentInputs[0].seq = seq;
+	m_recentInputs[0].buttons = buttons;
+	if (m_numRecentInputs < Client::InputRedundancy){
+		++m_numRecentInputs;
+	}
+
+	Uint8 recent[Client::InputRedundancy];
+	for (int i = 0; i < m_numRecentInputs; ++i){
+		recent[i] = static_cast<Uint8>(m_recentInputs[i].buttons);
+	}
+
+	RakNet::BitStream bit;
+	Client::WriteInputs(bit, seq, this->getServerTick(), m_viewTick, recent, 
+		static_cast<Uint8>(m_numRecentInputs), m_stageShiftSeq);
+
+	return this->send(bit, IMMEDIATE_PRIORITY, UNRELIABLE);
+}
+
+// ================================================ //
+
+Uint32 Client::sendPeerInput(const Uint32 frame, const SimInput input)
+{
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::PEER_INPUT));
+	bit.Write(frame);
+	bit.Write(input);
+
+	return this->send(bit, HIGH_PRIORITY, RELIABLE_ORDERED);
+}
+
+// ================================================ //
+
+bool Client::readSnapshot(RakNet::BitStream& bit, WorldSnapshot& snapshot)
+{
+	Uint16 seq = 0;
+	if (!m_snapshots.read(bit, snapshot, seq)){
+		return false;
+	}
+	if (m_hasSnapshot && static_cast<Sint16>(seq - m_newestSnapshot) <= 0){
+		return false;
+	}
+	m_newestSnapshot = seq;
+	m_hasSnapshot = true;
+
+	// Let the server use this snapshot as the baseline for its next ones.
+	RakNet::BitStream ack;
+	ack.Write(static_cast<RakNet::MessageID>(NetMessage::SNAPSHOT_ACK));
+	ack.Write(seq);
+	this->send(ack, HIGH_PRIORITY, UNRELIABLE);
+
+	return true;
+}
+
+// ================================================ //
+
+int Client::readSpectatorBatch(RakNet::BitStream& bit, WorldSnapshot* snapshots, const int max)
+{
+	Uint8 count = 0;
+	if (!SpectatorChannel::ReadCount(bit, count)){
+		return 0;
+	}
+
+	// Each packet is read in place; spectators never acknowledge them.
+	int n = 0;
+	for (int i = 0; i < count && n < max; ++i){
+		unsigned char* data = nullptr;
+		Uint32 length = 0;
+		if (!SpectatorChannel::ReadPacket(bit, data, length)){
+			break;
+		}
+
+		RakNet::BitStream packet(data, length, false);
+		packet.IgnoreBytes(sizeof(RakNet::MessageID));
+		Uint16 seq = 0;
+		if (m_snapshots.read(packet, snapshots[n], seq)){
+			++n;
+		}
+	}
+
+	return n;
+}
+
+// ================================================ //
+
+void Client::resetSnapshots(void)
+{
+	m_snapshots.reset();
+	m_hasSnapshot = false;
+}
+
+// ================================================ //
+
+void Client::updateClock(void)
+{
+	if (!m_connected){
+		return;
+	}
+
 	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_INPUT));
-	NetInput netInput;
-	netInput.input = input;
-	netInput.value = value;
-	netInput.seq = seq;
-	netInput.dt = dt;
-	bit.Write(netInput);
-
-	// Write stage shift sequence.
-	bit.Write(m_stageShiftSeq);
-
-	return this->send(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
+	if (m_clock.writePing(bit, SimClock::now())){
+		this->send(bit, HIGH_PRIORITY, UNRELIABLE);
+	}
 }
 
 // ================================================ //
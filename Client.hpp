@@ -28,6 +28,11 @@
 
 #include "stdafx.hpp"
 #include "Input.hpp"
+#include "SnapshotChannel.hpp"
+#include "ClockSync.hpp"
+#include "SimClock.hpp"
+#include "Transport.hpp"
+#include "NetMessage.hpp"
 
 // ================================================ //
 
@@ -66,14 +71,42 @@ public:
 	// Sends a READY packet to server.
 	Uint32 ready(const Uint32 fighter);
 
-	// Sends an input value to the server.
-	Uint32 sendInput(const Uint32 input, const bool value, const double dt);
+	// Called every frame with the local player's buttons. Sends them once 
+	// per simulation tick with sendInput().
+	void updateInput(const SimInput buttons, const double dt);
+
+	// Sends an unreliable CLIENT_INPUT with the buttons held this tick and
+	// the last InputRedundancy - 1 ticks, so a lost packet is covered by the
+	// next one instead of being resent.
+	Uint32 sendInput(const SimInput buttons, const double dt);
+
+	// Sends all buttons for a rollback or lockstep frame to the server, 
+	// which relays it to the other peer.
+	Uint32 sendPeerInput(const Uint32 frame, const SimInput input);
+
+	// Decodes the payload of a WORLD_SNAPSHOT message and acknowledges it.
+	// Returns false if it can't be decoded, or is a repeat of one already 
+	// decoded, and should be ignored.
+	bool readSnapshot(RakNet::BitStream& bit, WorldSnapshot& snapshot);
+
+	// Decodes the payload of a SPECTATOR_BATCH message into snapshots, 
+	// oldest first. Returns how many were decoded, at most max.
+	int readSpectatorBatch(RakNet::BitStream& bit, WorldSnapshot* snapshots, const int max);
+
+	// Forgets all decoded snapshots, called when a game starts.
+	void resetSnapshots(void);
+
+	// Sends a CLOCK_PING when one is due. Called every frame while connected.
+	void updateClock(void);
 
 	// Getters
 
 	// Returns pointer to internal RakNet RakPeerInterface.
 	RakNet::RakPeerInterface* getPeer(void);
 
+	// Returns the transport packets are sent and received on.
+	Transport* getTransport(void);
+
 	// Returns pointer to internal RakNet Packet.
 	RakNet::Packet* getPacket(void);
 
@@ -81,28 +114,58 @@ public:
 	// the first byte).
 	const char* getPacketStrData(void) const;
 
+	// Returns the estimate of the server's clock.
+	const ClockSync& getClock(void) const;
+
+	// Returns the server's current simulation tick, as estimated by the 
+	// clock sync (0 until the first pong).
+	const Uint32 getServerTick(void) const;
+
 	Uint32 m_inputSeq;
 	
 
 	// Setters
 
+	// Sets the server tick the other fighter is being shown at, sent with
+	// each input so the server can test its hits where this client saw it.
+	void setViewTick(const Uint32 tick);
+
 	// --- //
 
+	// The buttons held during one client tick, numbered by seq. tick is the
+	// server tick the client estimated it was on when sending them, and 
+	// viewTick the tick it was showing the other fighter at.
 	typedef struct{
-		Uint32 input;
-		bool value;
 		Uint32 seq;
-		double dt;
+		SimInput buttons;
+		Uint32 tick;
+		Uint32 viewTick;
 	} NetInput;
 
 	typedef struct{
-		Uint32 input;
-		bool value;
+		SimInput buttons;
 		Uint32 seq;
 		double dt;
 		int32_t xVel;
 	} ClientInput;
 
+	// Writes a CLIENT_INPUT packet: the newest seq, the server tick it was 
+	// sent on and the tick the other fighter was shown at, then one byte of
+	// buttons per tick, newest first, then the stage shift sequence.
+	static void WriteInputs(RakNet::BitStream& bit, const Uint32 seq, const Uint32 tick, 
+							const Uint32 viewTick, const Uint8* buttons, const Uint8 count, 
+							const Uint32 stageShiftSeq);
+
+	// Reads a CLIENT_INPUT packet. Fills inputs (room for InputRedundancy)
+	// with the ticks newer than lastSeq, oldest first, and returns how many
+	// there are. stageShiftSeq is only set if the packet is valid.
+	static int ReadInputs(const RakNet::Packet* packet, const Uint32 lastSeq, 
+						  NetInput* inputs, Uint32& stageShiftSeq);
+
+	// Ticks of input in each CLIENT_INPUT packet (the current one, and 
+	// redundant copies of the ones before it).
+	static const int InputRedundancy = 8;
+
 	typedef struct{
 		int shift;
 		int playerShift;
@@ -115,6 +178,7 @@ public:
 
 public:
 	RakNet::RakPeerInterface* m_peer;
+	std::shared_ptr<Transport> m_pTransport;
 	RakNet::Packet* m_packet;
 	RakNet::SystemAddress m_serverAddr;
 	std::string m_server;
@@ -123,6 +187,22 @@ public:
 	Uint32 m_stageShiftSeq;
 	
 	int m_timeout;
+
+private:
+	// Time not yet covered by a sent input (seconds).
+	double m_inputAccumulator;
+	// The most recently sent inputs, newest at m_recentInputs[0].
+	NetInput m_recentInputs[InputRedundancy];
+	int m_numRecentInputs;
+
+	// Decodes WORLD_SNAPSHOT messages, and the newest one decoded; the 
+	// server repeats snapshots on lossy connections.
+	SnapshotChannel m_snapshots;
+	Uint16 m_newestSnapshot;
+	bool m_hasSnapshot;
+
+	ClockSync m_clock;
+	Uint32 m_viewTick;
 };
 
 // ================================================ //
@@ -133,10 +213,80 @@ inline RakNet::RakPeerInterface* Client::getPeer(void){
 	return m_peer;
 }
 
+inline Transport* Client::getTransport(void){
+	return m_pTransport.get();
+}
+
 inline RakNet::Packet* Client::getPacket(void){
 	return m_packet;
 }
 
+inline const ClockSync& Client::getClock(void) const{
+	return m_clock;
+}
+
+inline const Uint32 Client::getServerTick(void) const{
+	return m_clock.getServerTick(SimClock::now());
+}
+
+// Setters
+
+inline void Client::setViewTick(const Uint32 tick){
+	m_viewTick = tick;
+}
+
+// ================================================ //
+
+inline void Client::WriteInputs(RakNet::BitStream& bit, const Uint32 seq, const Uint32 tick, 
+							   const Uint32 viewTick, const Uint8* buttons, const Uint8 count, 
+							   const Uint32 stageShiftSeq){
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_INPUT));
+	bit.Write(seq);
+	bit.Write(tick);
+	bit.Write(viewTick);
+	bit.Write(count);
+	for (int i = 0; i < count; ++i){
+		bit.Write(buttons[i]);
+	}
+	bit.Write(stageShiftSeq);
+}
+
+// ================================================ //
+
+inline int Client::ReadInputs(const RakNet::Packet* packet, const Uint32 lastSeq, 
+							  NetInput* inputs, Uint32& stageShiftSeq){
+	RakNet::BitStream bit(packet->data, packet->length, false);
+	bit.IgnoreBytes(sizeof(RakNet::MessageID));
+
+	Uint32 seq = 0, tick = 0, viewTick = 0;
+	Uint8 count = 0;
+	Uint8 buttons[InputRedundancy];
+	if (!bit.Read(seq) || !bit.Read(tick) || !bit.Read(viewTick) || !bit.Read(count) || 
+		count == 0 || count > InputRedundancy){
+		return 0;
+	}
+	for (int i = 0; i < count; ++i){
+		if (!bit.Read(buttons[i])){
+			return 0;
+		}
+	}
+	bit.Read(stageShiftSeq);
+
+	// The newest tick is first in the packet.
+	int n = 0;
+	for (int i = count - 1; i >= 0; --i){
+		if (static_cast<Uint32>(i) < seq && seq - i > lastSeq){
+			inputs[n].seq = seq - i;
+			inputs[n].buttons = buttons[i];
+			inputs[n].tick = (static_cast<Uint32>(i) < tick) ? tick - i : 0;
+			inputs[n].viewTick = (static_cast<Uint32>(i) < viewTick) ? viewTick - i : 0;
+			++n;
+		}
+	}
+
+	return n;
+}
+
 // ================================================ //
 
 #endif
@@ -0,0 +1,140 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: ClockSync.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements ClockSync class.
+// ================================================ //
+
+#include "ClockSync.hpp"
+#include "NetMessage.hpp"
+#include "MatchSim.hpp"
+
+// ================================================ //
+
+ClockSync::ClockSync(void)
+{
+	this->reset();
+}
+
+// ================================================ //
+
+ClockSync::~ClockSync(void)
+{
+
+}
+
+// ================================================ //
+
+void ClockSync::reset(void)
+{
+	memset(m_window, 0, sizeof(m_window));
+	m_samples = 0;
+	m_best = 0;
+	m_lastPing = 0;
+	m_tickTime = 0;
+	m_tick = 0;
+}
+
+// ================================================ //
+
+bool ClockSync::writePing(RakNet::BitStream& bit, const uint64_t now)
+{
+	uint64_t interval = ClockSync::PingInterval;
+	if (m_samples < static_cast<Uint32>(ClockSync::Window)){
+		interval = ClockSync::FastPingInterval;
+	}
+	if (m_lastPing != 0 && now - m_lastPing < interval){
+		return false;
+	}
+	m_lastPing = now;
+
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLOCK_PING));
+	bit.Write(now);
+
+	return true;
+}
+
+// ================================================ //
+
+bool ClockSync::readPong(RakNet::BitStream& bit, const uint64_t now)
+{
+	uint64_t sent = 0, serverTime = 0;
+	Uint32 tick = 0;
+	if (!bit.Read(sent) || !bit.Read(serverTime) || !bit.Read(tick) || sent > now){
+		return false;
+	}
+
+	// Assume the server stamped the pong halfway through the round trip.
+	Sample& sample = m_window[m_samples % ClockSync::Window];
+	sample.rtt = now - sent;
+	sample.offset = static_cast<int64_t>(serverTime) - static_cast<int64_t>(sent + sample.rtt / 2);
+	++m_samples;
+
+	// Select the sample delayed least by queuing.
+	const int count = (m_samples < static_cast<Uint32>(ClockSync::Window)) ? static_cast<int>(m_samples) : ClockSync::Window;
+	m_best = 0;
+	for (int i = 1; i < count; ++i){
+		if (m_window[i].rtt < m_window[m_best].rtt){
+			m_best = i;
+		}
+	}
+
+	m_tickTime = serverTime;
+	m_tick = tick;
+
+	return true;
+}
+
+// ================================================ //
+
+bool ClockSync::WritePong(const RakNet::Packet* ping, RakNet::BitStream& pong, 
+						  const uint64_t now, const Uint32 tick)
+{
+	RakNet::BitStream bit(ping->data, ping->length, false);
+	bit.IgnoreBytes(sizeof(RakNet::MessageID));
+	uint64_t sent = 0;
+	if (!bit.Read(sent)){
+		return false;
+	}
+
+	pong.Write(static_cast<RakNet::MessageID>(NetMessage::CLOCK_PONG));
+	pong.Write(sent);
+	pong.Write(now);
+	pong.Write(tick);
+
+	return true;
+}
+
+// ================================================ //
+
+const Uint32 ClockSync::getServerTick(const uint64_t now) const
+{
+	if (m_samples == 0){
+		return 0;
+	}
+
+	const int64_t elapsed = static_cast<int64_t>(this->getServerTime(now)) - static_cast<int64_t>(m_tickTime);
+	if (elapsed <= 0){
+		return m_tick;
+	}
+
+	return m_tick + static_cast<Uint32>(elapsed / MatchSim::TickMicroseconds);
+}
+
+// ================================================ //
\ No newline at end of file
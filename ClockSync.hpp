@@ -0,0 +1,138 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: ClockSync.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines ClockSync class.
+// ================================================ //
+
+#ifndef __CLOCKSYNC_HPP__
+#define __CLOCKSYNC_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+
+// ================================================ //
+
+// Estimates the server's clock and tick from the client. The client sends
+// a CLOCK_PING with its send time every so often, and the server answers 
+// with a CLOCK_PONG carrying the same time, its own time and its current
+// simulation tick. Each round trip gives an RTT and a clock offset that 
+// assumes the path is symmetric. As in NTP's clock filter, the offset is
+// taken from the sample with the smallest RTT among the last few, since it
+// was delayed least by queuing. All times are SimClock::now() microseconds.
+class ClockSync
+{
+public:
+	// Starts unsynchronized.
+	explicit ClockSync(void);
+
+	// Empty destructor.
+	~ClockSync(void);
+
+	// Forgets all samples.
+	void reset(void);
+
+	// Client: if a ping is due at now, writes a CLOCK_PING to bit and 
+	// returns true. Pings are sent quickly until the window is full.
+	bool writePing(RakNet::BitStream& bit, const uint64_t now);
+
+	// Client: reads a CLOCK_PONG (after the message ID) received at now.
+	// Returns false if it is malformed.
+	bool readPong(RakNet::BitStream& bit, const uint64_t now);
+
+	// Server: writes the CLOCK_PONG answering the CLOCK_PING packet, with
+	// the server's time now and current tick. Returns false if the ping is
+	// malformed.
+	static bool WritePong(const RakNet::Packet* ping, RakNet::BitStream& pong, 
+						  const uint64_t now, const Uint32 tick);
+
+	// Getters
+
+	// Returns true once at least one pong has been received.
+	const bool isSynced(void) const;
+
+	// Returns the round trip time of the selected sample.
+	const uint64_t getRTT(void) const;
+
+	// Returns the server's clock minus the local clock.
+	const int64_t getOffset(void) const;
+
+	// Returns the server's time at the local time now.
+	const uint64_t getServerTime(const uint64_t now) const;
+
+	// Returns the server's simulation tick at the local time now, or 0 if
+	// not synced.
+	const Uint32 getServerTick(const uint64_t now) const;
+
+	// Returns the number of pongs received.
+	const Uint32 getSamples(void) const;
+
+	// Round trips the offset is chosen from.
+	static const int Window = 8;
+	// Time between pings once the window is full, and before.
+	static const uint64_t PingInterval = 1000000;
+	static const uint64_t FastPingInterval = 100000;
+
+private:
+	struct Sample{
+		uint64_t rtt;
+		int64_t offset;
+	};
+
+	Sample m_window[Window];
+	Uint32 m_samples;
+	// Index of the selected (lowest RTT) sample in m_window.
+	int m_best;
+	uint64_t m_lastPing;
+
+	// The newest pong's server time and tick, to extrapolate the tick from.
+	uint64_t m_tickTime;
+	Uint32 m_tick;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const bool ClockSync::isSynced(void) const{
+	return (m_samples > 0);
+}
+
+inline const uint64_t ClockSync::getRTT(void) const{
+	return (m_samples > 0) ? m_window[m_best].rtt : 0;
+}
+
+inline const int64_t ClockSync::getOffset(void) const{
+	return (m_samples > 0) ? m_window[m_best].offset : 0;
+}
+
+inline const uint64_t ClockSync::getServerTime(const uint64_t now) const{
+	return static_cast<uint64_t>(static_cast<int64_t>(now) + this->getOffset());
+}
+
+inline const Uint32 ClockSync::getSamples(void) const{
+	return m_samples;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
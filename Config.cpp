@@ -24,12 +24,50 @@
 #include "Config.hpp"
 #include "Engine.hpp"
 
+#include <cstdlib>
+
+// ================================================ //
+
+namespace{
+	// Reads up to count integers from [p, end), skipping anything between 
+	// them such as "(" and ",". Returns the number read.
+	int ParseInts(const char* p, const char* end, int* out, const int count)
+	{
+		int n = 0;
+		while (p < end && n < count){
+			if ((*p >= '0' && *p <= '9') || *p == '-'){
+				char* next = nullptr;
+				const long i = strtol(p, &next, 10);
+				if (next == p){
+					// A "-" that isn't a sign.
+					++p;
+					continue;
+				}
+				if (next > end){
+					break;
+				}
+				out[n++] = static_cast<int>(i);
+				p = next;
+			}
+			else{
+				++p;
+			}
+		}
+
+		return n;
+	}
+}
+
 // ================================================ //
 
 Config::Config(const ConfigType type) :	
 m_file(),
 m_type(type),
-m_loaded(false)
+m_loaded(false),
+m_fileName(),
+m_data(),
+m_index(),
+m_buffer()
 {
 
 }
@@ -39,7 +77,11 @@ m_loaded(false)
 Config::Config(const std::string& file, const ConfigType type) :	
 m_file(),
 m_type(type),
-m_loaded(false)
+m_loaded(false),
+m_fileName(),
+m_data(),
+m_index(),
+m_buffer()
 {
 	this->loadFile(file);
 }
@@ -55,21 +97,43 @@ Config::~Config(void)
 
 void Config::loadFile(const std::string& file)
 {
-	Log::getSingletonPtr()->logMessage("Opening file \"" + std::string(file) + "\"");
-	if (m_loaded){
+	// Tools and benchmarks read configs without a log.
+	Log* pLog = Log::getSingletonPtr();
+	if (pLog != nullptr){
+		pLog->logMessage("Opening file \"" + std::string(file) + "\"");
+	}
+	if (m_file.is_open()){
 		m_file.close();
-		m_loaded = false;
 	}
+	m_loaded = false;
+	m_fileName = file;
+	m_data.clear();
+	m_index.clear();
 
 	m_file.open(file);
 
 	if (m_file.is_open()){
+		// Read everything in one go. In text mode the size may overestimate
+		// what's read, so trim to the count actually read.
+		m_file.seekg(0, m_file.end);
+		const std::streamoff size = m_file.tellg();
+		m_file.seekg(0, m_file.beg);
+		if (size > 0){
+			m_data.resize(static_cast<size_t>(size));
+			m_file.read(&m_data[0], size);
+			m_data.resize(static_cast<size_t>(m_file.gcount()));
+		}
+
+		this->buildIndex();
 		m_loaded = true;
-		Log::getSingletonPtr()->logMessage("File loaded!");
-		
+		m_file.close();
+
+		if (pLog != nullptr){
+			pLog->logMessage("File loaded!");
+		}
 	}
-	else{
-		Log::getSingletonPtr()->logMessage("ERROR: Failed to load file!");
+	else if (pLog != nullptr){
+		pLog->logMessage("ERROR: Failed to load file!");
 	}
 }
 
@@ -83,53 +147,110 @@ void Config::resetFilePointer(void)
 
 // ================================================ //
 
+void Config::buildIndex(void)
+{
+	m_index.clear();
+
+	Entry entry;
+	memset(&entry, 0, sizeof(entry));
+	bool inSection = false;
+
+	const char* p = m_data.c_str();
+	const char* end = p + m_data.size();
+	while (p < end){
+		const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+		if (eol == nullptr){
+			eol = end;
+		}
+		// Files saved on Windows may still have a carriage return.
+		const char* last = (eol > p && *(eol - 1) == '\r') ? eol - 1 : eol;
+		const size_t size = last - p;
+
+		if (size > 0 && p[0] == '['){
+			// Any line starting with "[" ends the current section, but only 
+			// "[section]" starts a new one.
+			inSection = (size >= 2 && *(last - 1) == ']');
+			entry.section.data = p + 1;
+			entry.section.size = (inSection) ? size - 2 : 0;
+		}
+		else if (inSection && size > 0 && p[0] != '#'){
+			// Everything before the first "=" is the key, everything after
+			// is the value.
+			const char* assign = static_cast<const char*>(memchr(p, '=', size));
+			if (assign != nullptr){
+				entry.key.data = p;
+				entry.key.size = assign - p;
+				entry.value.data = assign + 1;
+				entry.value.size = last - (assign + 1);
+				m_index.push_back(entry);
+			}
+		}
+
+		p = eol + 1;
+	}
+
+	std::stable_sort(m_index.begin(), m_index.end(), &Config::CompareEntries);
+}
+
+// ================================================ //
+
+const Config::Span* Config::findValue(const std::string& section, const std::string& key) const
+{
+	Entry find;
+	find.section.data = section.c_str();
+	find.section.size = section.size();
+	find.key.data = key.c_str();
+	find.key.size = key.size();
+
+	std::vector<Entry>::const_iterator itr = std::lower_bound(m_index.begin(), m_index.end(), find, 
+		&Config::CompareEntries);
+	if (itr != m_index.end() && Config::CompareSpans(itr->section, find.section) == 0 && 
+		Config::CompareSpans(itr->key, find.key) == 0){
+		return &itr->value;
+	}
+
+	return nullptr;
+}
+
+// ================================================ //
+
+const int Config::CompareSpans(const Span& a, const Span& b)
+{
+	const int c = memcmp(a.data, b.data, std::min(a.size, b.size));
+	if (c != 0){
+		return c;
+	}
+
+	return (a.size < b.size) ? -1 : (a.size > b.size) ? 1 : 0;
+}
+
+// ================================================ //
+
+bool Config::CompareEntries(const Entry& a, const Entry& b)
+{
+	const int c = Config::CompareSpans(a.section, b.section);
+	return (c < 0 || (c == 0 && Config::CompareSpans(a.key, b.key) < 0));
+}
+
+// ================================================ //
+
 std::string& Config::parseValue(const std::string& section, const std::string& value, const bool quotations)
 {
-	if (!m_loaded){
+	const Span* pValue = this->findValue(section, value);
+	if (pValue == nullptr){
+		// Value not found.
 		m_buffer.clear();
 		return m_buffer;
 	}
 
-	// Always start scanning from the first line.
-	this->resetFilePointer();
-
-	while(!m_file.eof()){
-		std::getline(m_file, m_buffer);
-		// Find the right section first.
-		if (m_buffer[0] == '[' && m_buffer[m_buffer.size() - 1] == ']'){
-			std::string compare(section);
-			if (m_buffer.compare(1, m_buffer.size() - 2, compare) == 0){
-				// Section found, now find the value.
-				std::getline(m_file, m_buffer);
-				while(m_buffer[0] != '[' && !m_file.eof()){ // TODO: There must always be a \n at the end of a config file with !m_file.eof().
-					
-					// Skip comments.
-					if (m_buffer[0] != '#'){
-						// Find location of assignment operator.
-						size_t assign = m_buffer.find_first_of('=');
-
-						// See if pos 0 to the assignment operator matches value name.
-						if (m_buffer.compare(0, assign, value) == 0){
-							// Trim string to only contain the value.
-							if (quotations){
-								m_buffer = m_buffer.substr(assign + 2, m_buffer.size() - value.size() - 3);
-							}
-							else{
-								m_buffer = m_buffer.substr(assign + 1, m_buffer.size() - value.size() - 1);
-							}
-
-							return m_buffer;
-						}
-					}
-
-					std::getline(m_file, m_buffer);
-				} 
-			}
-		}
+	// Trim the quotation marks if there are any.
+	if (quotations && pValue->size >= 2){
+		m_buffer.assign(pValue->data + 1, pValue->size - 2);
+	}
+	else{
+		m_buffer.assign(pValue->data, pValue->size);
 	}
 
-	// Value not found.
-	m_buffer.clear();
 	return m_buffer;
 }
 
@@ -137,24 +258,14 @@ std::string& Config::parseValue(const std::string& section, const std::string& v
 
 const int Config::parseIntValue(const std::string& section, const std::string& value)
 {
-	std::string str = this->parseValue(section, value);
-	if (!str.empty()){
-		return std::stoi(str);
-	}
-
-	return 0;
+	return this->getInt(section, value, 0);
 }
 
 // ================================================ //
 
 const double Config::parseDoubleValue(const std::string& section, const std::string& value)
 {
-	std::string str = this->parseValue(section, value);
-	if (!str.empty()){
-		return std::stod(str);
-	}
-
-	return 0.0;
+	return this->getDouble(section, value, 0.0);
 }
 
 // ================================================ //
@@ -164,51 +275,137 @@ SDL_Rect Config::parseRect(const std::string& section, const std::string& value)
 	SDL_Rect rc;
 	memset(&rc, 0, sizeof(rc));
 
-	std::string str = this->parseValue(section, value);
+	return this->getRect(section, value, rc);
+}
+
+// ================================================ //
+
+SDL_Color Config::parseColor(const std::string& section, const std::string& value)
+{
+	const SDL_Color color = { 255, 255, 255, 255 };
+
+	return this->getColor(section, value, color);
+}
+
+// ================================================ //
+
+const bool Config::hasValue(const std::string& section, const std::string& value) const
+{
+	return (this->findValue(section, value) != nullptr);
+}
+
+// ================================================ //
+
+std::string Config::getString(const std::string& section, const std::string& value, const std::string& def) const
+{
+	const Span* pValue = this->findValue(section, value);
+	if (pValue == nullptr || pValue->size == 0){
+		return def;
+	}
+
+	if (pValue->size >= 2 && pValue->data[0] == '"' && pValue->data[pValue->size - 1] == '"'){
+		return std::string(pValue->data + 1, pValue->size - 2);
+	}
+
+	return std::string(pValue->data, pValue->size);
+}
+
+// ================================================ //
+
+const int Config::getInt(const std::string& section, const std::string& value, const int def) const
+{
+	const Span* pValue = this->findValue(section, value);
+	if (pValue == nullptr || pValue->size == 0){
+		return def;
+	}
+
+	// The value isn't terminated, but strtol() stops at the end of the line.
+	char* end = nullptr;
+	const long i = strtol(pValue->data, &end, 10);
+	if (end == pValue->data || end > pValue->data + pValue->size){
+		return def;
+	}
+
+	return static_cast<int>(i);
+}
+
+// ================================================ //
+
+const double Config::getDouble(const std::string& section, const std::string& value, const double def) const
+{
+	const Span* pValue = this->findValue(section, value);
+	if (pValue == nullptr || pValue->size == 0){
+		return def;
+	}
 
-	if (!str.empty()){
-		// str should look like "(0,0,100,100)".
-		char c;
-		std::istringstream parse(str);
-		parse >> c; // eat "(".
-		parse >> rc.x;
-		parse >> c; // eat ",".
-		parse >> rc.y;
-		parse >> c; // eat ",".
-		parse >> rc.w;
-		parse >> c; // eat ",".
-		parse >> rc.h;
+	char* end = nullptr;
+	const double d = strtod(pValue->data, &end);
+	if (end == pValue->data || end > pValue->data + pValue->size){
+		return def;
 	}
 
+	return d;
+}
+
+// ================================================ //
+
+const bool Config::getBool(const std::string& section, const std::string& value, const bool def) const
+{
+	const Span* pValue = this->findValue(section, value);
+	if (pValue == nullptr || pValue->size == 0){
+		return def;
+	}
+
+	if (pValue->size == 4 && memcmp(pValue->data, "true", 4) == 0){
+		return true;
+	}
+	if (pValue->size == 5 && memcmp(pValue->data, "false", 5) == 0){
+		return false;
+	}
+
+	return (this->getInt(section, value, (def) ? 1 : 0) != 0);
+}
+
+// ================================================ //
+
+SDL_Rect Config::getRect(const std::string& section, const std::string& value, const SDL_Rect& def) const
+{
+	const Span* pValue = this->findValue(section, value);
+	if (pValue == nullptr || pValue->size == 0){
+		return def;
+	}
+
+	// Missing components are zero, as they were when parsed with a stream.
+	int i[4] = { 0, 0, 0, 0 };
+	ParseInts(pValue->data, pValue->data + pValue->size, i, 4);
+
+	SDL_Rect rc;
+	rc.x = i[0];
+	rc.y = i[1];
+	rc.w = i[2];
+	rc.h = i[3];
+
 	return rc;
 }
 
 // ================================================ //
 
-SDL_Color Config::parseColor(const std::string& section, const std::string& value)
+SDL_Color Config::getColor(const std::string& section, const std::string& value, const SDL_Color& def) const
 {
-	SDL_Color color = { 255, 255, 255, 255 };
-
-	std::string str = this->parseValue(section, value);
-	if (!str.empty()){
-		// str should look like "(255,255,255,255)"
-		char c;
-		int i = 0;
-		std::istringstream parse(str);
-		parse >> c; // eat "(".
-		parse >> i;
-		color.r = static_cast<Uint8>(i);
-		parse >> c; // eat ",".
-		parse >> i;
-		color.g = static_cast<Uint8>(i);
-		parse >> c; // eat ",".
-		parse >> i;
-		color.b = static_cast<Uint8>(i);
-		parse >> c; // eat ",".
-		parse >> i;
-		color.a = static_cast<Uint8>(i);
+	const Span* pValue = this->findValue(section, value);
+	if (pValue == nullptr || pValue->size == 0){
+		return def;
 	}
 
+	int i[4] = { def.r, def.g, def.b, def.a };
+	ParseInts(pValue->data, pValue->data + pValue->size, i, 4);
+
+	SDL_Color color;
+	color.r = static_cast<Uint8>(i[0]);
+	color.g = static_cast<Uint8>(i[1]);
+	color.b = static_cast<Uint8>(i[2]);
+	color.a = static_cast<Uint8>(i[3]);
+
 	return color;
 }
 
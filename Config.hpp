@@ -31,7 +31,9 @@
 // ================================================ //
 
 // Provides config file reading/writing tools. Has basic INI parsing
-// functions, supporting multiple types.
+// functions, supporting multiple types. The file is read once when it's 
+// loaded and every key is indexed by section, so each lookup is a binary
+// search over the index instead of a scan through the file.
 class Config
 {
 public:
@@ -50,41 +52,102 @@ public:
 	// Closes the file handle.
 	virtual ~Config(void);
 
-	// Opens file handle to specified filename. Closes the handle first if
-	// it's already open.
+	// Reads the whole file into memory and indexes it. Any file loaded 
+	// before is discarded.
 	virtual void loadFile(const std::string& file);
 
 	// Clears the file handle and seeks to position zero.
 	virtual void resetFilePointer(void);
 
-	// Resets the file pointer and scans line by line looking for the section 
-	// (such as [gamesettings]), then looks in that section for the value. Returns
-	// the value in std::string format. The parameter quotations should be true
-	// if the value is inside quotation marks.
+	// Looks up the value in the section (such as [gamesettings]). Returns 
+	// the value in std::string format, or an empty string if it's missing. 
+	// The parameter quotations should be true if the value is inside 
+	// quotation marks.
 	virtual std::string& parseValue(const std::string& section, const std::string& value, const bool quotations = false);
 
-	// Wraps parseValue(), converts the std::string to an int.
+	// Wraps getInt(), returns 0 if the value is missing.
 	virtual const int parseIntValue(const std::string& section, const std::string& value);
 
-	// Wraps parseValue(), converts the std::string to a double.
+	// Wraps getDouble(), returns 0.0 if the value is missing.
 	virtual const double parseDoubleValue(const std::string& section, const std::string& value);
 
-	// Wraps parseValue(), converts the std::string to a SDL_Rect.
+	// Wraps getRect(), returns an empty SDL_Rect if the value is missing.
 	virtual SDL_Rect parseRect(const std::string& section, const std::string& value);
 
-	// Wraps parseValue(), converts the std::string to a SDL_Color.
+	// Wraps getColor(), returns white if the value is missing.
 	virtual SDL_Color parseColor(const std::string& section, const std::string& value);
 
+	// Typed accessors. Each returns def if the value is missing, empty or
+	// can't be converted, and none of them copy the file's text.
+
+	// Returns true if the section has the value, even if it's empty.
+	const bool hasValue(const std::string& section, const std::string& value) const;
+
+	// Returns the value with any surrounding quotation marks removed.
+	std::string getString(const std::string& section, const std::string& value, 
+						  const std::string& def = std::string()) const;
+
+	const int getInt(const std::string& section, const std::string& value, const int def = 0) const;
+
+	const double getDouble(const std::string& section, const std::string& value, const double def = 0.0) const;
+
+	// "true" and non-zero integers are true, "false" and zero are false.
+	const bool getBool(const std::string& section, const std::string& value, const bool def = false) const;
+
+	// The value should look like "(0,0,100,100)".
+	SDL_Rect getRect(const std::string& section, const std::string& value, const SDL_Rect& def) const;
+
+	// The value should look like "(255,255,255,255)".
+	SDL_Color getColor(const std::string& section, const std::string& value, const SDL_Color& def) const;
+
 	// Getters
 
-	// Returns true if the file handle is open.
+	// Returns true if the file was read.
 	const bool isLoaded(void) const;
 
+	// Returns the name of the file last loaded.
+	const std::string& getFileName(void) const;
+
+	// Returns the number of values in the file.
+	const size_t getNumValues(void) const;
+
 protected:
+	// A view of part of m_data.
+	typedef struct{
+		const char* data;
+		size_t size;
+	} Span;
+
+	// One line of the form "value=..." and the section it's in.
+	typedef struct{
+		Span section;
+		Span key;
+		Span value;
+	} Entry;
+
+	// Scans m_data once, adding every value in every section to m_index, 
+	// then sorts the index by section and key. Values that appear more 
+	// than once keep the order they appear in the file.
+	void buildIndex(void);
+
+	// Returns the first value of key in section, or nullptr if missing.
+	const Span* findValue(const std::string& section, const std::string& key) const;
+
+	// Orders spans by their bytes, then by size.
+	static const int CompareSpans(const Span& a, const Span& b);
+
+	// Orders entries by section, then by key.
+	static bool CompareEntries(const Entry& a, const Entry& b);
+
 	std::ifstream	m_file;
 	ConfigType		m_type;
 	bool			m_loaded;
 
+	// The file's name and contents, and the index into them.
+	std::string			m_fileName;
+	std::string			m_data;
+	std::vector<Entry>	m_index;
+
 	// Used for returning string values.
 	std::string		m_buffer;
 };
@@ -97,6 +160,14 @@ inline const bool Config::isLoaded(void) const{
 	return m_loaded; 
 }
 
+inline const std::string& Config::getFileName(void) const{
+	return m_fileName;
+}
+
+inline const size_t Config::getNumValues(void) const{
+	return m_index.size();
+}
+
 // ================================================ //
 
 #endif
@@ -0,0 +1,465 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: DedicatedServer.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements DedicatedServer singleton class.
+// ================================================ //
+
+#include "DedicatedServer.hpp"
+#include "NetMessage.hpp"
+#include "Engine.hpp"
+#include "Config.hpp"
+#include "FighterImage.hpp"
+#include "FighterData.hpp"
+#include "MatchHost.hpp"
+#include "SimClock.hpp"
+
+#include <thread>
+#include <chrono>
+
+// ================================================ //
+
+template<> DedicatedServer* Singleton<DedicatedServer>::msSingleton = nullptr;
+
+// ================================================ //
+
+DedicatedServer::DedicatedServer(void) :
+m_peer(RakNet::RakPeerInterface::GetInstance()),
+m_pTransport(new RakNetTransport(m_peer)),
+m_dataDirectory("Data"),
+m_username("Server"),
+m_tickRate(120),
+m_running(false),
+m_clients(),
+m_readyQueue(),
+m_fighterFiles(),
+m_fighterData(),
+m_pMatchHost(nullptr)
+{
+	Log::getSingletonPtr()->logMessage("Initializing DedicatedServer...");
+
+	// Find location of settings file, as the engine does.
+	Config ini("config.ini");
+	if (ini.isLoaded()){
+		m_dataDirectory = ini.parseValue("core", "data", true);
+	}
+
+	const std::string settingsFile = m_dataDirectory + "/ExtMF.cfg";
+	Config c(settingsFile);
+	if (!c.isLoaded()){
+		throw std::exception(std::string("Failed to load \"" + settingsFile + "\"").c_str());
+	}
+
+	int port = c.parseIntValue("net", "port");
+	if (port == 0){
+		port = 666;
+	}
+	m_username = c.parseValue("net", "username.server", true);
+
+	Uint32 tick = c.parseIntValue("net", "serverTickRate");
+	if (tick != 0){
+		m_tickRate = tick;
+	}
+
+	Uint32 maxMatches = c.parseIntValue("server", "maxMatches");
+	if (maxMatches == 0){
+		maxMatches = DedicatedServer::DefaultMaxMatches;
+	}
+
+	// Load the list of fighters clients can pick.
+	Config fighters(m_dataDirectory + "/Fighters/fighters.cfg");
+	const int numFighters = fighters.parseIntValue("core", "numFighters");
+	for (int i = 1; i <= numFighters; ++i){
+		std::string fighterName = "fighter" + Engine::toString(i);
+		m_fighterFiles.push_back(fighters.parseValue(fighterName.c_str(), "file", true));
+	}
+
+	m_pMatchHost.reset(new MatchHost(m_pTransport.get(), this->createSimConfig(c), 
+		this->createSnapshotRateConfig(c), maxMatches, 
+		c.parseIntValue("net", "matchWorkers")));
+
+	RakNet::SocketDescriptor sd(port, 0);
+	m_peer->Startup(Server::MaxClients, &sd, 1);
+	m_peer->SetMaximumIncomingConnections(Server::MaxClients);
+
+	Log::getSingletonPtr()->logMessage("DedicatedServer listening on port " + Engine::toString(port) + 
+		" at " + Engine::toString(m_tickRate) + " ticks per second");
+}
+
+// ================================================ //
+
+DedicatedServer::~DedicatedServer(void)
+{
+	// Stop hosted matches before the peer they send on is destroyed.
+	m_pMatchHost.reset();
+	m_peer->Shutdown(300);
+	RakNet::RakPeerInterface::DestroyInstance(m_peer);
+}
+
+// ================================================ //
+
+void DedicatedServer::run(void)
+{
+	const uint64_t interval = 1000000 / m_tickRate;
+	uint64_t deadline = SimClock::now();
+
+	m_running = true;
+	while (m_running){
+		this->update();
+
+		// Sleep until the next tick is due.
+		deadline += interval;
+		const uint64_t now = SimClock::now();
+		if (now < deadline){
+			std::this_thread::sleep_for(std::chrono::microseconds(deadline - now));
+		}
+		else if (now - deadline > interval * DedicatedServer::MaxTicksBehind){
+			Log::getSingletonPtr()->logMessage("DedicatedServer: Fell " + 
+				Engine::toString((now - deadline) / interval) + " ticks behind, skipping ahead");
+			deadline = now;
+		}
+	}
+
+	Log::getSingletonPtr()->logMessage("DedicatedServer stopped.");
+}
+
+// ================================================ //
+
+void DedicatedServer::stop(void)
+{
+	m_running = false;
+}
+
+// ================================================ //
+
+void DedicatedServer::update(void)
+{
+	for (RakNet::Packet* packet = m_pTransport->receive(); 
+		packet;
+		m_pTransport->deallocatePacket(packet), packet = m_pTransport->receive()){
+		// Inputs from players in hosted matches go straight to their match.
+		if (!m_pMatchHost->handlePacket(packet)){
+			this->handlePacket(packet);
+		}
+	}
+
+	this->startMatches();
+	m_pMatchHost->update();
+}
+
+// ================================================ //
+
+void DedicatedServer::handlePacket(const RakNet::Packet* packet)
+{
+	switch (packet->data[0]){
+	default:
+		break;
+
+	case ID_DISCONNECTION_NOTIFICATION:
+		this->removeClient(packet->systemAddress, NetMessage::CLIENT_DISCONNECTED);
+		break;
+
+	case ID_CONNECTION_LOST:
+		this->removeClient(packet->systemAddress, NetMessage::CLIENT_LOST_CONNECTION);
+		break;
+
+	case NetMessage::CLOCK_PING:
+	{
+		// No match is running for clients in the lobby.
+		RakNet::BitStream pong;
+		if (ClockSync::WritePong(packet, pong, SimClock::now(), 0)){
+			m_pTransport->send(pong, IMMEDIATE_PRIORITY, UNRELIABLE, packet->systemAddress);
+		}
+	}
+		break;
+
+	case NetMessage::SET_USERNAME:
+	{
+		RakNet::BitStream bit(packet->data, packet->length, false);
+		RakNet::RakString rs;
+		bit.IgnoreBytes(sizeof(RakNet::MessageID));
+		bit.Read(rs);
+
+		if (this->isUsernameInUse(rs.C_String())){
+			RakNet::BitStream reject;
+			reject.Write(static_cast<RakNet::MessageID>(NetMessage::USERNAME_IN_USE));
+
+			m_pTransport->send(reject, HIGH_PRIORITY, RELIABLE, packet->systemAddress);
+		}
+		else{
+			Log::getSingletonPtr()->logMessage("SERVER: Client [" + std::string(packet->systemAddress.ToString()) +
+				"] connected with username \"" + rs.C_String() + "\"");
+
+			// Send a list of players to newly connected client.
+			this->sendPlayerList(packet->systemAddress);
+
+			ClientConnection client;
+			client.username = rs.C_String();
+			client.addr = packet->systemAddress;
+			m_clients.push_back(client);
+
+			// Tell everyone else.
+			RakNet::BitStream relay(packet->data, packet->length, false);
+			this->broadcast(relay, HIGH_PRIORITY, RELIABLE, packet->systemAddress);
+		}
+	}
+		break;
+
+	case NetMessage::CHAT:
+	{
+		RakNet::BitStream relay(packet->data, packet->length, false);
+		this->broadcast(relay, HIGH_PRIORITY, RELIABLE_ORDERED, packet->systemAddress);
+	}
+		break;
+
+	case NetMessage::READY:
+	{
+		const int client = this->getClient(packet->systemAddress);
+		if (client == -1){
+			break;
+		}
+
+		RakNet::BitStream data(packet->data, packet->length, false);
+		data.IgnoreBytes(sizeof(RakNet::MessageID));
+		Uint32 fighter;
+		data.Read(fighter);
+
+		// Ignore clients already in the queue.
+		const std::string username = m_clients[client].username;
+		bool queued = false;
+		for (ReadyQueue::iterator itr = m_readyQueue.begin(); itr != m_readyQueue.end(); ++itr){
+			if (itr->username.compare(username) == 0){
+				queued = true;
+				break;
+			}
+		}
+		if (queued){
+			break;
+		}
+
+		ReadyClient ready;
+		ready.username = username;
+		ready.fighter = fighter;
+		m_readyQueue.push_back(ready);
+
+		RakNet::BitStream bit;
+		bit.Write(static_cast<RakNet::MessageID>(NetMessage::READY));
+		bit.Write(username.c_str());
+		bit.Write(fighter);
+		this->broadcast(bit, HIGH_PRIORITY, RELIABLE_ORDERED, packet->systemAddress);
+
+		Log::getSingletonPtr()->logMessage("SERVER: " + username + " is ready");
+	}
+		break;
+	}
+}
+
+// ================================================ //
+
+void DedicatedServer::removeClient(const RakNet::SystemAddress& addr, const RakNet::MessageID msg)
+{
+	const int client = this->getClient(addr);
+	if (client == -1){
+		return;
+	}
+
+	const std::string username = m_clients[client].username;
+	Log::getSingletonPtr()->logMessage("SERVER: Removing client [" + std::string(addr.ToString()) + "]");
+
+	for (ReadyQueue::iterator itr = m_readyQueue.begin(); itr != m_readyQueue.end(); ++itr){
+		if (itr->username.compare(username) == 0){
+			m_readyQueue.erase(itr);
+			break;
+		}
+	}
+	m_clients.erase(m_clients.begin() + client);
+	m_pMatchHost->removePlayer(addr);
+
+	// Tell all other clients.
+	RakNet::BitStream bit;
+	bit.Write(msg);
+	bit.Write(username.c_str());
+	this->broadcast(bit, HIGH_PRIORITY, RELIABLE);
+}
+
+// ================================================ //
+
+void DedicatedServer::startMatches(void)
+{
+	while (m_readyQueue.size() >= 2 &&
+		m_pMatchHost->getNumMatches() < m_pMatchHost->getMaxMatches()){
+		const ReadyClient red = m_readyQueue.front();
+		m_readyQueue.pop_front();
+		const ReadyClient blue = m_readyQueue.front();
+		m_readyQueue.pop_front();
+
+		const int redClient = this->getClient(red.username);
+		const int blueClient = this->getClient(blue.username);
+		if (redClient == -1 || blueClient == -1 ||
+			red.fighter >= m_fighterFiles.size() || blue.fighter >= m_fighterFiles.size()){
+			Log::getSingletonPtr()->logMessage("SERVER: Invalid ready clients " + red.username +
+				" and " + blue.username + ", not starting match.");
+			continue;
+		}
+
+		MatchPlayer redPlayer, bluePlayer;
+		redPlayer.addr = m_clients[redClient].addr;
+		redPlayer.username = red.username;
+		redPlayer.fighter = red.fighter;
+		bluePlayer.addr = m_clients[blueClient].addr;
+		bluePlayer.username = blue.username;
+		bluePlayer.fighter = blue.fighter;
+
+		m_pMatchHost->createMatch(redPlayer, bluePlayer,
+			this->getFighterData(red.fighter), this->getFighterData(blue.fighter));
+	}
+}
+
+// ================================================ //
+
+Uint32 DedicatedServer::sendPlayerList(const RakNet::SystemAddress& addr)
+{
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::PLAYER_LIST));
+
+	// Write number of connected clients, plus the server.
+	bit.Write(m_clients.size() + 1);
+
+	bit.Write(m_username.c_str());
+	for (ClientList::const_iterator itr = m_clients.begin();
+		itr != m_clients.end();
+		++itr){
+		bit.Write(itr->username.c_str());
+	}
+
+	return m_pTransport->send(bit, HIGH_PRIORITY, RELIABLE, addr);
+}
+
+// ================================================ //
+
+Uint32 DedicatedServer::broadcast(const RakNet::BitStream& bit, const PacketPriority priority,
+	const PacketReliability reliability, const RakNet::SystemAddress& exclude)
+{
+	return m_pTransport->send(bit, priority, reliability, exclude, true);
+}
+
+// ================================================ //
+
+const SimConfig DedicatedServer::createSimConfig(Config& c) const
+{
+	SimConfig config;
+
+	if (c.parseIntValue("window", "logicalWidth") != 0){
+		config.viewWidth = c.parseIntValue("window", "logicalWidth");
+		config.viewHeight = c.parseIntValue("window", "logicalHeight");
+	}
+	config.cameraSpeed = c.parseIntValue("camera", "speed");
+	config.lagCompensationTicks = (c.parseIntValue("net", "lagCompensation") * MatchSim::TickRate) / 1000;
+
+	// The client gets the camera bounds from the size of the stage texture, 
+	// which the server never loads, so its width comes from the settings.
+	const std::string stageFile = m_dataDirectory + "/" + c.parseValue("server", "stage");
+	Config stage(stageFile);
+	if (!stage.isLoaded()){
+		throw std::exception(std::string("Failed to load stage file \"" + stageFile + "\"").c_str());
+	}
+
+	const int textureWidth = c.parseIntValue("server", "stageTextureWidth");
+	config.stageViewWidth = stage.parseIntValue("layer1", "w");
+	if (textureWidth > config.stageViewWidth){
+		config.cameraRightBound = textureWidth - config.stageViewWidth;
+		config.cameraStartX = (textureWidth / 2) - (config.stageViewWidth / 2);
+	}
+
+	return config;
+}
+
+// ================================================ //
+
+const SnapshotRateConfig DedicatedServer::createSnapshotRateConfig(Config& c) const
+{
+	SnapshotRateConfig config;
+
+	if (c.parseIntValue("net", "snapshotMinInterval") != 0){
+		config.minInterval = c.parseIntValue("net", "snapshotMinInterval");
+	}
+	if (c.parseIntValue("net", "snapshotMaxInterval") != 0){
+		config.maxInterval = c.parseIntValue("net", "snapshotMaxInterval");
+	}
+	if (c.parseIntValue("net", "snapshotRedundancy") != 0){
+		config.maxRedundancy = c.parseIntValue("net", "snapshotRedundancy");
+	}
+	if (c.parseIntValue("net", "snapshotMaxQueue") != 0){
+		config.maxQueuedBytes = c.parseIntValue("net", "snapshotMaxQueue");
+	}
+
+	return config;
+}
+
+// ================================================ //
+
+std::shared_ptr<const FighterData> DedicatedServer::getFighterData(const Uint32 fighter)
+{
+	std::map<Uint32, std::shared_ptr<const FighterData>>::iterator itr = m_fighterData.find(fighter);
+	if (itr != m_fighterData.end()){
+		return itr->second;
+	}
+
+	const std::string file = m_dataDirectory + "/Fighters/" + m_fighterFiles[fighter];
+	std::shared_ptr<FighterData> pData = FighterImage::LoadFighter(file);
+	pData->name = file;
+	m_fighterData[fighter] = pData;
+
+	return pData;
+}
+
+// ================================================ //
+
+int DedicatedServer::getClient(const RakNet::SystemAddress& addr) const
+{
+	for (unsigned int i = 0; i < m_clients.size(); ++i){
+		if (addr == m_clients[i].addr){
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// ================================================ //
+
+int DedicatedServer::getClient(const std::string& username) const
+{
+	for (unsigned int i = 0; i < m_clients.size(); ++i){
+		if (username.compare(m_clients[i].username) == 0){
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// ================================================ //
+
+const bool DedicatedServer::isUsernameInUse(const std::string& username) const
+{
+	return (username.compare(m_username) == 0 || this->getClient(username) != -1);
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,161 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: DedicatedServer.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines DedicatedServer singleton class.
+// ================================================ //
+
+#ifndef __DEDICATEDSERVER_HPP__
+#define __DEDICATEDSERVER_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+#include "Server.hpp"
+#include "MatchSim.hpp"
+#include "Transport.hpp"
+#include "SnapshotRate.hpp"
+
+#include <atomic>
+
+// ================================================ //
+
+class Config;
+class MatchHost;
+
+// ================================================ //
+
+// Runs the lobby and hosted matches with no display. Takes the place of
+// Engine, the app states and Server in the headless server executable: 
+// there is no window, renderer, font or image loading, and the lobby is
+// updated by a fixed-tick loop that sleeps until each tick's deadline.
+class DedicatedServer : public Singleton<DedicatedServer>
+{
+public:
+	// Loads settings from the data directory named in config.ini and starts
+	// listening for clients.
+	explicit DedicatedServer(void);
+
+	// Stops hosted matches and destroys the peer.
+	~DedicatedServer(void);
+
+	// Runs the fixed-tick loop until stop() is called.
+	void run(void);
+
+	// Makes run() return after the current tick. Safe to call from a 
+	// signal handler.
+	void stop(void);
+
+	// Receives and handles all pending packets, then starts matches for 
+	// ready clients. Called once per tick by run().
+	void update(void);
+
+	// Getters
+
+	// Returns the number of ticks per second of the lobby loop.
+	const Uint32 getTickRate(void) const;
+
+	// Returns the number of connected clients.
+	const Uint32 getNumClients(void) const;
+
+	// Returns the MatchHost.
+	MatchHost* getMatchHost(void) const;
+
+	// Default for [server] maxMatches.
+	static const Uint32 DefaultMaxMatches = 16;
+
+	// The loop skips ahead rather than bursting to catch up if it falls 
+	// more than this many ticks behind.
+	static const Uint32 MaxTicksBehind = 8;
+
+private:
+	// Handles a lobby packet (anything not consumed by a hosted match).
+	void handlePacket(const RakNet::Packet* packet);
+
+	// Removes a disconnected client from the lobby and any hosted match, 
+	// then tells the other clients with the message ID msg.
+	void removeClient(const RakNet::SystemAddress& addr, const RakNet::MessageID msg);
+
+	// Starts a match for each pair of clients in the ready queue while the
+	// MatchHost has room.
+	void startMatches(void);
+
+	// Sends the list of players to a newly connected client.
+	Uint32 sendPlayerList(const RakNet::SystemAddress& addr);
+
+	// Sends to all clients, except the excluded address if specified.
+	Uint32 broadcast(const RakNet::BitStream& bit, const PacketPriority priority,
+		const PacketReliability reliability, const RakNet::SystemAddress& exclude = RakNet::UNASSIGNED_SYSTEM_ADDRESS);
+
+	// Builds the match simulation settings from the settings file and stage
+	// without loading any textures.
+	const SimConfig createSimConfig(Config& c) const;
+
+	// Reads the bounds each player's snapshot rate adapts between.
+	const SnapshotRateConfig createSnapshotRateConfig(Config& c) const;
+
+	// Returns the simulation data for a fighter, loading it the first time.
+	std::shared_ptr<const FighterData> getFighterData(const Uint32 fighter);
+
+	// Returns index of client matching the address or username, or -1.
+	int getClient(const RakNet::SystemAddress& addr) const;
+	int getClient(const std::string& username) const;
+
+	// Returns true if the username is taken by the server or a client.
+	const bool isUsernameInUse(const std::string& username) const;
+
+	RakNet::RakPeerInterface* m_peer;
+	// Sends and receives on m_peer; connections are managed on it directly.
+	std::shared_ptr<Transport> m_pTransport;
+	std::string m_dataDirectory;
+	std::string m_username;
+	Uint32 m_tickRate;
+	std::atomic<bool> m_running;
+
+	ClientList m_clients;
+	ReadyQueue m_readyQueue;
+
+	// Fighter files from fighters.cfg, indexed by fighter ID.
+	std::vector<std::string> m_fighterFiles;
+	std::map<Uint32, std::shared_ptr<const FighterData>> m_fighterData;
+
+	std::shared_ptr<MatchHost> m_pMatchHost;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 DedicatedServer::getTickRate(void) const{
+	return m_tickRate;
+}
+
+inline const Uint32 DedicatedServer::getNumClients(void) const{
+	return m_clients.size();
+}
+
+inline MatchHost* DedicatedServer::getMatchHost(void) const{
+	return m_pMatchHost.get();
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
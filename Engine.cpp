@@ -30,14 +30,6 @@ template<> Engine* Singleton<Engine>::msSingleton = nullptr;
 
 // ================================================ //
 
-// Version 0.01
-const int Engine::VERSION_MAJOR =	0;
-//								    .
-const int Engine::VERSION_MINOR1 =	0;
-const int Engine::VERSION_MINOR2 =	2;
-
-// ================================================ //
-
 Engine::Engine(void) : 
 m_pImpl(new EngineImpl())
 {
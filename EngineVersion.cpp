@@ -0,0 +1,36 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: EngineVersion.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines the Engine version constants. Kept apart from Engine.cpp
+// so the dedicated server can log its version without linking the
+// SDL window and renderer code.
+// ================================================ //
+
+#include "Engine.hpp"
+
+// ================================================ //
+
+// Version 0.01
+const int Engine::VERSION_MAJOR =	0;
+//								    .
+const int Engine::VERSION_MINOR1 =	0;
+const int Engine::VERSION_MINOR2 =	2;
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,223 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: FighterCache.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements FighterDefinition struct and FighterCache singleton class.
+// ================================================ //
+
+#include "FighterCache.hpp"
+#include "FighterImage.hpp"
+#include "AssetLoader.hpp"
+#include "Move.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+template<> FighterCache* Singleton<FighterCache>::msSingleton = nullptr;
+
+// ================================================ //
+
+namespace{
+	// Sets the size and modification time of the fighter's files.
+	void GetFileInfo(FighterDefinition& fighter)
+	{
+		FighterImage::GetFileInfo(fighter.file, fighter.sourceSize, fighter.sourceTime);
+		FighterImage::GetFileInfo(FighterImage::GetImageFile(fighter.file), fighter.imageSize, fighter.imageTime);
+	}
+
+	// Returns true if neither of the fighter's files has changed since it 
+	// was loaded.
+	bool IsCurrent(const FighterDefinition& fighter)
+	{
+		FighterDefinition now;
+		now.file = fighter.file;
+		GetFileInfo(now);
+
+		return (now.sourceSize == fighter.sourceSize && now.sourceTime == fighter.sourceTime &&
+				now.imageSize == fighter.imageSize && now.imageTime == fighter.imageTime);
+	}
+
+	// Loads the fighter's data and moves, and decodes its sprite sheet. 
+	// Safe to call from a worker thread. Throws if the fighter fails to load.
+	std::shared_ptr<SDL_Surface> ReadFighter(FighterDefinition& fighter)
+	{
+		std::shared_ptr<FighterData> pData = FighterImage::LoadFighter(fighter.file, &fighter.moves, &fighter.spriteSheet);
+		pData->name = fighter.file;
+		fighter.pData = pData;
+
+		return AssetLoader::LoadSurface(Engine::getSingletonPtr()->getDataDirectory() + "/" + fighter.spriteSheet);
+	}
+
+	// A fighter moving from an AssetLoader worker to the render thread.
+	struct FighterLoad{
+		std::shared_ptr<FighterDefinition> pFighter;
+		std::shared_ptr<SDL_Surface> pSurface;
+		std::exception_ptr error;
+		std::promise<std::shared_ptr<const FighterDefinition>> promise;
+	};
+}
+
+// ================================================ //
+
+FighterDefinition::FighterDefinition(void) :
+file(),
+sourceSize(0),
+imageSize(0),
+sourceTime(0),
+imageTime(0),
+pData(nullptr),
+moves(),
+spriteSheet(),
+pTexture(nullptr)
+{
+
+}
+
+// ================================================ //
+
+FighterCache::FighterCache(void) :
+m_fighters(),
+m_pending(),
+m_hits(0),
+m_misses(0)
+{
+
+}
+
+// ================================================ //
+
+FighterCache::~FighterCache(void)
+{
+	this->clear();
+}
+
+// ================================================ //
+
+std::shared_ptr<const FighterDefinition> FighterCache::load(const std::string& file)
+{
+	std::shared_ptr<const FighterDefinition> pCached = this->findCurrent(file);
+	if (pCached){
+		++m_hits;
+		return pCached;
+	}
+	if (m_fighters.find(file) != m_fighters.end()){
+		Log::getSingletonPtr()->logMessage("Fighter \"" + file + "\" changed, reloading it");
+	}
+
+	// A loadAsync() of the same file may be in flight; its result is 
+	// dropped in favour of this one when it completes.
+	++m_misses;
+	std::shared_ptr<FighterDefinition> pFighter(new FighterDefinition());
+	pFighter->file = file;
+	GetFileInfo(*pFighter);
+	pFighter->pTexture = AssetLoader::CreateTexture(ReadFighter(*pFighter));
+
+	return this->add(pFighter);
+}
+
+// ================================================ //
+
+FighterFuture FighterCache::loadAsync(const std::string& file)
+{
+	std::shared_ptr<const FighterDefinition> pCached = this->findCurrent(file);
+	if (pCached){
+		++m_hits;
+		std::promise<std::shared_ptr<const FighterDefinition>> promise;
+		promise.set_value(pCached);
+		return promise.get_future().share();
+	}
+
+	PendingMap::iterator pending = m_pending.find(file);
+	if (pending != m_pending.end()){
+		return pending->second;
+	}
+
+	++m_misses;
+	std::shared_ptr<FighterLoad> pLoad(new FighterLoad());
+	pLoad->pFighter.reset(new FighterDefinition());
+	pLoad->pFighter->file = file;
+	GetFileInfo(*pLoad->pFighter);
+
+	FighterFuture future = pLoad->promise.get_future().share();
+	m_pending[file] = future;
+
+	AssetLoader::getSingletonPtr()->run([pLoad](){
+		try{
+			pLoad->pSurface = ReadFighter(*pLoad->pFighter);
+		}
+		catch (std::exception&){
+			pLoad->error = std::current_exception();
+		}
+	},
+	[this, pLoad](){
+		m_pending.erase(pLoad->pFighter->file);
+		if (pLoad->error){
+			pLoad->promise.set_exception(pLoad->error);
+			return;
+		}
+
+		// Skip the upload if load() cached the fighter in the meantime.
+		std::shared_ptr<const FighterDefinition> pFighter = this->findCurrent(pLoad->pFighter->file);
+		if (!pFighter){
+			pLoad->pFighter->pTexture = AssetLoader::CreateTexture(pLoad->pSurface);
+			pFighter = this->add(pLoad->pFighter);
+		}
+		pLoad->pSurface.reset();
+		pLoad->promise.set_value(pFighter);
+	});
+
+	return future;
+}
+
+// ================================================ //
+
+std::shared_ptr<const FighterDefinition> FighterCache::findCurrent(const std::string& file) const
+{
+	FighterMap::const_iterator itr = m_fighters.find(file);
+	if (itr != m_fighters.end() && IsCurrent(*itr->second)){
+		return itr->second;
+	}
+
+	return nullptr;
+}
+
+// ================================================ //
+
+std::shared_ptr<const FighterDefinition> FighterCache::add(const std::shared_ptr<const FighterDefinition>& pFighter)
+{
+	std::shared_ptr<const FighterDefinition> pCached = this->findCurrent(pFighter->file);
+	if (pCached){
+		return pCached;
+	}
+
+	m_fighters[pFighter->file] = pFighter;
+	Log::getSingletonPtr()->logMessage("Fighter \"" + pFighter->file + "\" cached (" + 
+		Engine::toString(m_fighters.size()) + " fighters cached)");
+
+	return pFighter;
+}
+
+// ================================================ //
+
+void FighterCache::clear(void)
+{
+	m_fighters.clear();
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,157 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: FighterCache.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines FighterDefinition struct and FighterCache singleton class.
+// ================================================ //
+
+#ifndef __FIGHTERCACHE_HPP__
+#define __FIGHTERCACHE_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+
+#include <future>
+
+// ================================================ //
+
+struct Move;
+struct FighterData;
+struct FighterDefinition;
+
+// A fighter being loaded by FighterCache::loadAsync(). Holds the exception
+// thrown if it failed to load.
+typedef std::shared_future<std::shared_ptr<const FighterDefinition>> FighterFuture;
+
+// ================================================ //
+
+// Everything about a fighter that doesn't change during a match: its 
+// simulation data, moves and sprite sheet. Loaded once and shared by 
+// every Player and MatchSim using the fighter.
+struct FighterDefinition{
+	// Initializes all data to zero.
+	explicit FighterDefinition(void);
+
+	// The .fighter file.
+	std::string file;
+
+	// Size and modification time of the .fighter and .fighterc files when
+	// loaded, zero if missing.
+	uint32_t sourceSize, imageSize;
+	uint64_t sourceTime, imageTime;
+
+	std::shared_ptr<const FighterData> pData;
+
+	// A Move for each MoveID. Never modified once loaded; each Player keeps
+	// its own current frame.
+	std::vector<std::shared_ptr<Move>> moves;
+
+	// The sprite sheet's file name (relative to the data directory) and 
+	// its texture, or nullptr if it failed to load.
+	std::string spriteSheet;
+	std::shared_ptr<SDL_Texture> pTexture;
+};
+
+// ================================================ //
+
+// Holds every fighter loaded this run, keyed by its .fighter file, so 
+// mirror matches and rematches share the moves, frames and texture loaded 
+// the first time. A fighter is reloaded when its .fighter or .fighterc 
+// file changes. Players still using the old one keep it until they're 
+// destroyed. Only used from the render thread.
+// Sample usage:
+// std::shared_ptr<const FighterDefinition> pFighter = 
+//	FighterCache::getSingletonPtr()->load(file);
+class FighterCache : public Singleton<FighterCache>
+{
+public:
+	// Starts empty.
+	explicit FighterCache(void);
+
+	// Releases every fighter. Textures are destroyed once no Player uses 
+	// them.
+	~FighterCache(void);
+
+	// Returns the fighter in file, loading it if it isn't cached or has 
+	// changed since. Throws if it fails to load.
+	std::shared_ptr<const FighterDefinition> load(const std::string& file);
+
+	// Like load(), but reads the fighter's files and decodes its sprite 
+	// sheet on an AssetLoader worker. The future is ready once the texture
+	// has been uploaded and the fighter cached, after which load() returns 
+	// it without reading anything. Loading the same file twice at once 
+	// shares one load.
+	FighterFuture loadAsync(const std::string& file);
+
+	// Releases every fighter, so each is loaded again the next time.
+	void clear(void);
+
+	// Getters
+
+	// Returns the number of fighters cached.
+	const Uint32 getNumFighters(void) const;
+
+	// Returns the number of loads served from the cache.
+	const Uint32 getNumHits(void) const;
+
+	// Returns the number of loads that read the fighter's files.
+	const Uint32 getNumMisses(void) const;
+
+private:
+	// Returns the cached fighter in file if its files haven't changed since
+	// it was loaded, otherwise nullptr.
+	std::shared_ptr<const FighterDefinition> findCurrent(const std::string& file) const;
+
+	// Caches a newly loaded fighter, unless a current one for the same file
+	// was cached while it loaded (e.g., by load() during a loadAsync()), 
+	// so only one definition of a file is ever handed out. Returns the 
+	// cached fighter.
+	std::shared_ptr<const FighterDefinition> add(const std::shared_ptr<const FighterDefinition>& pFighter);
+
+	typedef std::map<std::string, std::shared_ptr<const FighterDefinition>> FighterMap;
+	typedef std::map<std::string, FighterFuture> PendingMap;
+
+	FighterMap m_fighters;
+	// Fighters being loaded by loadAsync().
+	PendingMap m_pending;
+	Uint32 m_hits, m_misses;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 FighterCache::getNumFighters(void) const{
+	return static_cast<Uint32>(m_fighters.size());
+}
+
+inline const Uint32 FighterCache::getNumHits(void) const{
+	return m_hits;
+}
+
+inline const Uint32 FighterCache::getNumMisses(void) const{
+	return m_misses;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
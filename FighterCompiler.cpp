@@ -0,0 +1,64 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: FighterCompiler.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Entry point of the offline fighter compiler.
+// ================================================ //
+
+#include "stdafx.hpp"
+#include "FighterImage.hpp"
+
+#include <iostream>
+
+// ================================================ //
+
+// Compiles each .fighter file given to a .fighterc beside it.
+int main(int argc, char** argv)
+{
+	if (argc < 2){
+		std::cerr << "Usage: ExtMFCompiler <file.fighter>..." << std::endl;
+		return 1;
+	}
+
+	int failed = 0;
+	for (int i = 1; i < argc; ++i){
+		const std::string source = argv[i];
+		const std::string file = FighterImage::GetImageFile(source);
+		try{
+			FighterImage::Compile(source, file);
+
+			// Map what was written to make sure it loads.
+			FighterImage image(file);
+			if (!image.isLoaded()){
+				throw std::exception(std::string(file + ": " + image.getError()).c_str());
+			}
+
+			std::cout << source << " -> " << file << " (" << image.getHeader().size << " bytes, " << 
+				image.getHeader().numFrames << " frames)" << std::endl;
+		}
+		catch (std::exception& e){
+			std::cerr << e.what() << std::endl;
+			++failed;
+		}
+	}
+
+	return (failed == 0) ? 0 : 1;
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,80 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: FighterData.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements FighterMove and FighterData structs.
+// ================================================ //
+
+#include "FighterData.hpp"
+
+// ================================================ //
+
+FighterMove::FighterMove(void) :
+id(0),
+frameGap(0),
+damage(0),
+hitstun(0),
+blockstun(0),
+knockback(0),
+recoil(0),
+repeat(false),
+repeatFrame(0),
+transition(-1),
+xVel(0),
+yVel(0),
+firstFrame(0),
+numFrames(0)
+{
+
+}
+
+// ================================================ //
+
+FighterData::FighterData(void) :
+name(),
+w(0),
+h(0),
+xAccel(0),
+xMax(0),
+jumpStrength(0),
+jumpSpeed(0),
+hp(0),
+moves(),
+pFrames(nullptr),
+pFrameStorage()
+{
+
+}
+
+// ================================================ //
+
+void FighterData::setFrames(const FighterFrame* frames, const std::shared_ptr<const void>& pStorage)
+{
+	pFrames = frames;
+	pFrameStorage = pStorage;
+}
+
+// ================================================ //
+
+void FighterData::setFrames(const std::shared_ptr<const FighterFrameList>& pFrameList)
+{
+	this->setFrames((pFrameList->empty()) ? nullptr : &pFrameList->front(), pFrameList);
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,126 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: FighterData.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines FighterFrame, FighterMove, and FighterData structs.
+// ================================================ //
+
+#ifndef __FIGHTERDATA_HPP__
+#define __FIGHTERDATA_HPP__
+
+// ================================================ //
+
+#include "SimTypes.hpp"
+
+// ================================================ //
+
+// A single frame of animation, as seen by the simulation.
+struct FighterFrame{
+	// Sprite sheet clipping rect.
+	SimRect src;
+
+	// Amount to widen/heighten the render size when this frame is entered.
+	int32_t rw, rh;
+
+	// Frame gap (ticks).
+	uint32_t gap;
+
+	// Hitboxes relative to the fighter's center, indexed by SimHitbox.
+	SimRect hitboxes[SimHitbox::NUM_HITBOXES];
+};
+
+typedef std::vector<FighterFrame> FighterFrameList;
+
+// ================================================ //
+
+// A move's immutable data. Unlike Move, holds no playback state (the 
+// current frame lives in the fighter's simulation state).
+struct FighterMove{
+	// Initializes all data to zero or false.
+	explicit FighterMove(void);
+
+	int32_t id;
+	// How long to wait between frames (ticks).
+	uint32_t frameGap;
+	int32_t damage;
+	// Stun durations (ticks).
+	int32_t hitstun, blockstun;
+	int32_t knockback;
+	int32_t recoil;
+	bool repeat;
+	int32_t repeatFrame;
+	// The state the fighter transitions to upon completing this move, or -1.
+	int32_t transition;
+	int32_t xVel, yVel;
+
+	// Where this move's frames start in FighterData::pFrames, and how many
+	// there are.
+	uint32_t firstFrame, numFrames;
+};
+
+typedef std::vector<FighterMove> FighterMoveList;
+
+// ================================================ //
+
+// Everything the simulation needs to know about a fighter. Built once 
+// when the .fighter file is loaded and never modified by the simulation.
+struct FighterData{
+	// Initializes all data to zero.
+	explicit FighterData(void);
+
+	std::string name;
+
+	// Default render width and height.
+	int32_t w, h;
+
+	// Physics.
+	int32_t xAccel;
+	int32_t xMax;
+	int32_t jumpStrength;
+	int32_t jumpSpeed;
+
+	// Stats.
+	int32_t hp;
+
+	// Indexed by FighterState (one move per state).
+	FighterMoveList moves;
+
+	// Every move's frames, one move after another. Points into whatever 
+	// pFrameStorage owns: a FighterFrameList when parsed from text, or a 
+	// mapped compiled fighter, whose frames are used in place.
+	const FighterFrame* pFrames;
+	std::shared_ptr<const void> pFrameStorage;
+
+	// Points pFrames at frames, keeping pStorage alive with this data.
+	void setFrames(const FighterFrame* frames, const std::shared_ptr<const void>& pStorage);
+
+	// Uses every frame in the list.
+	void setFrames(const std::shared_ptr<const FighterFrameList>& pFrameList);
+
+	// Returns frame i of move, which must be less than move.numFrames.
+	const FighterFrame& getFrame(const FighterMove& move, const uint32_t i) const{
+		return pFrames[move.firstFrame + i];
+	}
+};
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,478 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: FighterImage.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements FighterImage class.
+// ================================================ //
+
+#include "FighterImage.hpp"
+#include "FighterMetadata.hpp"
+#include "Move.hpp"
+#include "MatchSim.hpp"
+#include "Engine.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// ================================================ //
+
+// Frames are mapped in place, so their layout is part of the format.
+static_assert(sizeof(FighterFrame) == (7 + 4 * SimHitbox::NUM_HITBOXES) * sizeof(uint32_t),
+	"FighterFrame must have no padding; increment FighterImage::Version if it changes");
+static_assert(sizeof(FighterImageHeader) % sizeof(uint32_t) == 0 && sizeof(FighterImageMove) % sizeof(uint32_t) == 0,
+	"Compiled fighter tables must stay 4-byte aligned");
+
+// ================================================ //
+
+namespace{
+	// 32-bit FNV-1a.
+	uint32_t Hash(const Uint8* p, const size_t size)
+	{
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; ++i){
+			hash = (hash ^ p[i]) * 16777619u;
+		}
+
+		return hash;
+	}
+
+	// Returns true if a table of count elements of elementSize bytes at
+	// offset fits in an image of imageSize bytes.
+	bool TableFits(const uint32_t offset, const uint32_t count, const size_t elementSize, const size_t imageSize)
+	{
+		return (offset >= sizeof(FighterImageHeader) && offset % sizeof(uint32_t) == 0 && offset <= imageSize && 
+				count <= (imageSize - offset) / elementSize);
+	}
+
+	// Appends str to the string table and returns its offset.
+	uint32_t AddString(std::string& strings, const std::string& str)
+	{
+		const uint32_t offset = static_cast<uint32_t>(strings.size());
+		strings.append(str.c_str(), str.size() + 1);
+
+		return offset;
+	}
+}
+
+// ================================================ //
+
+FighterImage::FighterImage(const std::string& file) :
+m_pData(nullptr),
+m_size(0),
+m_loaded(false),
+m_error()
+{
+	size_t size = 0;
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE){
+		m_error = "File not found";
+		return;
+	}
+
+	size = GetFileSize(hFile, nullptr);
+	HANDLE hMapping = (size > 0) ? CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+	if (hMapping != nullptr){
+		m_pData = static_cast<const Uint8*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+		// The view keeps the mapping open.
+		CloseHandle(hMapping);
+	}
+	CloseHandle(hFile);
+#else
+	const int fd = open(file.c_str(), O_RDONLY);
+	if (fd == -1){
+		m_error = "File not found";
+		return;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0){
+		size = static_cast<size_t>(st.st_size);
+		void* p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (p != MAP_FAILED){
+			m_pData = static_cast<const Uint8*>(p);
+		}
+	}
+	// The mapping keeps the file open.
+	close(fd);
+#endif
+
+	if (m_pData == nullptr){
+		m_error = "Failed to map file";
+		return;
+	}
+
+	m_size = size;
+	m_error = this->validate();
+	m_loaded = m_error.empty();
+}
+
+// ================================================ //
+
+FighterImage::~FighterImage(void)
+{
+	if (m_pData != nullptr){
+#ifdef _WIN32
+		UnmapViewOfFile(m_pData);
+#else
+		munmap(const_cast<Uint8*>(m_pData), m_size);
+#endif
+	}
+}
+
+// ================================================ //
+
+std::string FighterImage::validate(void) const
+{
+	if (m_size < sizeof(FighterImageHeader)){
+		return "Too small to be a compiled fighter";
+	}
+
+	const FighterImageHeader& header = this->getHeader();
+	if (header.magic != FighterImage::Magic){
+		return "Not a compiled fighter";
+	}
+	if (header.version != FighterImage::Version){
+		return "Compiled as version " + Engine::toString(header.version) + ", expected version " + 
+			Engine::toString(static_cast<uint32_t>(FighterImage::Version));
+	}
+	if (header.size != m_size){
+		return "Expected " + Engine::toString(header.size) + " bytes, found " + Engine::toString(m_size);
+	}
+	if (header.checksum != Hash(m_pData + sizeof(FighterImageHeader), m_size - sizeof(FighterImageHeader))){
+		return "Checksum mismatch";
+	}
+	if (header.tickRate != MatchSim::TickRate){
+		return "Compiled for " + Engine::toString(header.tickRate) + " ticks per second, expected " +
+			Engine::toString(static_cast<uint32_t>(MatchSim::TickRate));
+	}
+
+	if (header.numMoves != MoveID::END_MOVES || 
+		!TableFits(header.movesOffset, header.numMoves, sizeof(FighterImageMove), m_size) ||
+		!TableFits(header.framesOffset, header.numFrames, sizeof(FighterFrame), m_size) ||
+		!TableFits(header.stringsOffset, header.stringsSize, 1, m_size)){
+		return "Table out of bounds";
+	}
+
+	// Every string must end inside the table.
+	if (header.stringsSize == 0 || m_pData[header.stringsOffset + header.stringsSize - 1] != '\0' ||
+		header.spriteSheet >= header.stringsSize){
+		return "Invalid string table";
+	}
+	for (uint32_t i = 0; i < header.numMoves; ++i){
+		const FighterImageMove& move = this->getMove(i);
+		if (move.name >= header.stringsSize || move.numFrames == 0 || move.firstFrame > header.numFrames || 
+			move.numFrames > header.numFrames - move.firstFrame){
+			return "Invalid move " + Engine::toString(i);
+		}
+		// Both are used as indices by MatchSim.
+		if ((move.repeat != 0 && (move.repeatFrame < 0 || static_cast<uint32_t>(move.repeatFrame) >= move.numFrames)) ||
+			move.transition >= static_cast<int32_t>(header.numMoves)){
+			return "Invalid repeat frame or transition in move " + Engine::toString(i);
+		}
+	}
+
+	return std::string();
+}
+
+// ================================================ //
+
+std::shared_ptr<FighterData> FighterImage::CreateFighterData(const std::shared_ptr<const FighterImage>& pImage)
+{
+	const FighterImageHeader& header = pImage->getHeader();
+
+	std::shared_ptr<FighterData> pData(new FighterData());
+	pData->w = header.w;
+	pData->h = header.h;
+	pData->xAccel = header.xAccel;
+	pData->xMax = header.xMax;
+	pData->jumpStrength = header.jumpStrength;
+	pData->jumpSpeed = header.jumpSpeed;
+	pData->hp = header.hp;
+
+	pData->moves.reserve(header.numMoves);
+	for (uint32_t i = 0; i < header.numMoves; ++i){
+		const FighterImageMove& m = pImage->getMove(i);
+
+		FighterMove move;
+		move.id = static_cast<int32_t>(i);
+		move.frameGap = m.frameGap;
+		move.damage = m.damage;
+		move.hitstun = m.hitstun;
+		move.blockstun = m.blockstun;
+		move.knockback = m.knockback;
+		move.recoil = m.recoil;
+		move.repeat = (m.repeat != 0);
+		move.repeatFrame = m.repeatFrame;
+		move.transition = m.transition;
+		move.xVel = m.xVel;
+		move.yVel = m.yVel;
+		move.firstFrame = m.firstFrame;
+		move.numFrames = m.numFrames;
+		pData->moves.push_back(move);
+	}
+
+	pData->setFrames(pImage->getFrames(), pImage);
+
+	return pData;
+}
+
+// ================================================ //
+
+void FighterImage::createMoves(std::vector<std::shared_ptr<Move>>& moves) const
+{
+	const FighterImageHeader& header = this->getHeader();
+	const FighterFrame* frames = this->getFrames();
+
+	for (uint32_t i = 0; i < header.numMoves; ++i){
+		const FighterImageMove& m = this->getMove(i);
+
+		std::shared_ptr<Move> pMove(new Move());
+		pMove->id = static_cast<int>(i);
+		pMove->name = this->getString(m.name);
+		pMove->numFrames = static_cast<int>(m.numFrames);
+		pMove->frameGap = m.frameGap;
+		pMove->startupFrames = m.startupFrames;
+		pMove->hitFrames = m.hitFrames;
+		pMove->recoveryFrames = m.recoveryFrames;
+		pMove->damage = m.damage;
+		pMove->hitstun = m.hitstun;
+		pMove->blockstun = m.blockstun;
+		pMove->knockback = m.knockback;
+		pMove->recoil = m.recoil;
+		pMove->repeat = (m.repeat != 0);
+		pMove->repeatFrame = m.repeatFrame;
+		pMove->reverse = (m.reverse != 0);
+		pMove->transition = m.transition;
+		pMove->xVel = m.xVel;
+		pMove->yVel = m.yVel;
+
+		pMove->frames.resize(m.numFrames);
+		for (uint32_t f = 0; f < m.numFrames; ++f){
+			const FighterFrame& src = frames[m.firstFrame + f];
+			Frame& frame = pMove->frames[f];
+			frame.x = src.src.x;
+			frame.y = src.src.y;
+			frame.w = src.src.w;
+			frame.h = src.src.h;
+			frame.rw = src.rw;
+			frame.rh = src.rh;
+			frame.gap = src.gap;
+			for (int h = 0; h < SimHitbox::NUM_HITBOXES; ++h){
+				frame.hitboxes[h].x = src.hitboxes[h].x;
+				frame.hitboxes[h].y = src.hitboxes[h].y;
+				frame.hitboxes[h].w = src.hitboxes[h].w;
+				frame.hitboxes[h].h = src.hitboxes[h].h;
+			}
+		}
+
+		moves.push_back(pMove);
+	}
+}
+
+// ================================================ //
+
+const bool FighterImage::isCurrent(const std::string& file) const
+{
+	uint32_t size = 0;
+	uint64_t time = 0;
+	if (!FighterImage::GetFileInfo(file, size, time)){
+		return true;
+	}
+
+	const FighterImageHeader& header = this->getHeader();
+	return (size == header.sourceSize && static_cast<uint32_t>(time) == header.sourceTimeLow && 
+			static_cast<uint32_t>(time >> 32) == header.sourceTimeHigh);
+}
+
+// ================================================ //
+
+void FighterImage::Compile(const std::string& source, const std::string& file)
+{
+	FighterMetadata metadata(source);
+	if (!metadata.isLoaded()){
+		throw std::exception(std::string("Failed to load fighter file " + source).c_str());
+	}
+
+	// Parsing the FighterData checks every MoveID is there.
+	std::vector<std::shared_ptr<Move>> moves;
+	std::shared_ptr<FighterData> pData = metadata.parseFighterData(&moves);
+
+	FighterImageHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = FighterImage::Magic;
+	header.version = FighterImage::Version;
+	header.tickRate = MatchSim::TickRate;
+
+	uint64_t time = 0;
+	FighterImage::GetFileInfo(source, header.sourceSize, time);
+	header.sourceTimeLow = static_cast<uint32_t>(time);
+	header.sourceTimeHigh = static_cast<uint32_t>(time >> 32);
+
+	header.w = pData->w;
+	header.h = pData->h;
+	header.xAccel = pData->xAccel;
+	header.xMax = pData->xMax;
+	header.jumpStrength = pData->jumpStrength;
+	header.jumpSpeed = pData->jumpSpeed;
+	header.hp = pData->hp;
+
+	// Offset zero is the empty string.
+	std::string strings(1, '\0');
+	header.spriteSheet = AddString(strings, metadata.parseValue("core", "spriteSheet"));
+
+	std::vector<FighterImageMove> imageMoves;
+	uint32_t numFrames = 0;
+	for (size_t i = 0; i < pData->moves.size(); ++i){
+		const FighterMove& move = pData->moves[i];
+		const Move& src = *moves[i];
+
+		FighterImageMove image;
+		memset(&image, 0, sizeof(image));
+		image.name = AddString(strings, src.name);
+		image.frameGap = move.frameGap;
+		image.startupFrames = src.startupFrames;
+		image.hitFrames = src.hitFrames;
+		image.recoveryFrames = src.recoveryFrames;
+		image.damage = move.damage;
+		image.hitstun = move.hitstun;
+		image.blockstun = move.blockstun;
+		image.knockback = move.knockback;
+		image.recoil = move.recoil;
+		image.repeat = (move.repeat) ? 1 : 0;
+		image.repeatFrame = move.repeatFrame;
+		image.reverse = (src.reverse) ? 1 : 0;
+		image.transition = move.transition;
+		image.xVel = move.xVel;
+		image.yVel = move.yVel;
+		image.firstFrame = move.firstFrame;
+		image.numFrames = move.numFrames;
+		imageMoves.push_back(image);
+
+		numFrames = std::max(numFrames, move.firstFrame + move.numFrames);
+	}
+
+	// Lay out the header, moves, frames and strings, padding the end to 4 bytes.
+	strings.resize((strings.size() + 3) & ~static_cast<size_t>(3), '\0');
+	header.numMoves = static_cast<uint32_t>(imageMoves.size());
+	header.movesOffset = sizeof(FighterImageHeader);
+	header.numFrames = numFrames;
+	header.framesOffset = header.movesOffset + header.numMoves * sizeof(FighterImageMove);
+	header.stringsSize = static_cast<uint32_t>(strings.size());
+	header.stringsOffset = header.framesOffset + header.numFrames * sizeof(FighterFrame);
+	header.size = header.stringsOffset + header.stringsSize;
+
+	std::vector<Uint8> image(header.size);
+	memcpy(&image[header.movesOffset], &imageMoves[0], header.numMoves * sizeof(FighterImageMove));
+	if (numFrames > 0){
+		memcpy(&image[header.framesOffset], pData->pFrames, header.numFrames * sizeof(FighterFrame));
+	}
+	memcpy(&image[header.stringsOffset], strings.data(), strings.size());
+	header.checksum = Hash(&image[sizeof(FighterImageHeader)], image.size() - sizeof(FighterImageHeader));
+	memcpy(&image[0], &header, sizeof(header));
+
+	std::ofstream out(file, std::ios::out | std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&image[0]), image.size());
+	if (!out.good()){
+		throw std::exception(std::string("Failed to write " + file).c_str());
+	}
+}
+
+// ================================================ //
+
+bool FighterImage::GetFileInfo(const std::string& file, uint32_t& size, uint64_t& time)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(file.c_str(), GetFileExInfoStandard, &data)){
+		return false;
+	}
+	size = data.nFileSizeLow;
+	time = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+	struct stat st;
+	if (stat(file.c_str(), &st) != 0){
+		return false;
+	}
+	size = static_cast<uint32_t>(st.st_size);
+	time = static_cast<uint64_t>(st.st_mtime);
+#endif
+
+	return true;
+}
+
+// ================================================ //
+
+std::string FighterImage::GetImageFile(const std::string& file)
+{
+	return file + "c";
+}
+
+// ================================================ //
+
+std::shared_ptr<FighterData> FighterImage::LoadFighter(const std::string& file, std::vector<std::shared_ptr<Move>>* pMoves,
+													   std::string* pSpriteSheet)
+{
+	Log* pLog = Log::getSingletonPtr();
+	const std::string imageFile = FighterImage::GetImageFile(file);
+
+	std::shared_ptr<FighterImage> pImage(new FighterImage(imageFile));
+	if (pImage->isLoaded() && pImage->isCurrent(file)){
+		if (pMoves){
+			pImage->createMoves(*pMoves);
+		}
+		if (pSpriteSheet){
+			*pSpriteSheet = pImage->getString(pImage->getHeader().spriteSheet);
+		}
+		if (pLog != nullptr){
+			pLog->logMessage("Mapped compiled fighter \"" + imageFile + "\"");
+		}
+
+		return FighterImage::CreateFighterData(pImage);
+	}
+
+	if (pLog != nullptr){
+		if (pImage->isLoaded()){
+			pLog->logMessage("\"" + imageFile + "\" is older than \"" + file + "\", recompile it with ExtMFCompiler");
+		}
+		else if (pImage->getError() != "File not found"){
+			pLog->logMessage("Ignoring \"" + imageFile + "\": " + pImage->getError());
+		}
+	}
+
+	// Fall back to the text.
+	FighterMetadata m(file);
+	if (!m.isLoaded()){
+		throw std::exception(std::string("Failed to load fighter file " + file).c_str());
+	}
+	if (pSpriteSheet){
+		*pSpriteSheet = m.parseValue("core", "spriteSheet");
+	}
+
+	return m.parseFighterData(pMoves);
+}
+
+// ================================================ //
\ No newline at end of file
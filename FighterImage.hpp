@@ -0,0 +1,203 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: FighterImage.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines FighterImageHeader, FighterImageMove and FighterImage classes.
+// ================================================ //
+
+#ifndef __FIGHTERIMAGE_HPP__
+#define __FIGHTERIMAGE_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+#include "FighterData.hpp"
+
+// ================================================ //
+
+struct Move;
+
+// ================================================ //
+
+// The start of a compiled fighter. Every field of the image is 32 bits 
+// wide, so its layout doesn't depend on the compiler. Offsets are in 
+// bytes from the start of the image.
+struct FighterImageHeader{
+	// FighterImage::Magic and FighterImage::Version.
+	uint32_t magic;
+	uint32_t version;
+	// Size of the whole image, and an FNV-1a hash of everything after 
+	// the header.
+	uint32_t size;
+	uint32_t checksum;
+	// Simulation tick rate the frame gaps and stun were converted at.
+	uint32_t tickRate;
+	// Size and modification time of the .fighter file compiled, to tell 
+	// when it has changed since.
+	uint32_t sourceSize;
+	uint32_t sourceTimeLow, sourceTimeHigh;
+
+	// Size, physics and stats.
+	int32_t w, h;
+	int32_t xAccel, xMax, jumpStrength, jumpSpeed;
+	int32_t hp;
+
+	// Offset of the sprite sheet's file name in the string table.
+	uint32_t spriteSheet;
+
+	// A table of FighterImageMove indexed by MoveID.
+	uint32_t numMoves, movesOffset;
+	// A table of FighterFrame, each move's frames one after another.
+	uint32_t numFrames, framesOffset;
+	// Null-terminated strings.
+	uint32_t stringsSize, stringsOffset;
+};
+
+// A move in a compiled fighter, with the same values as Move.
+struct FighterImageMove{
+	// Offset of the move's name in the string table.
+	uint32_t name;
+	uint32_t frameGap;
+	int32_t startupFrames, hitFrames, recoveryFrames;
+	int32_t damage, hitstun, blockstun, knockback, recoil;
+	int32_t repeat, repeatFrame, reverse, transition;
+	int32_t xVel, yVel;
+	// Where the move's frames start in the frame table, and how many.
+	uint32_t firstFrame, numFrames;
+};
+
+// ================================================ //
+
+// A compiled fighter (.fighterc), mapped read-only. Compiled offline from
+// a .fighter file by ExtMFCompiler, so loading one is a map and a few 
+// checks with no parsing. The frames are used in place by the FighterData
+// created from it, and every process that maps the same file shares the 
+// same physical pages.
+class FighterImage
+{
+public:
+	// Maps the file and validates it. Check isLoaded() after.
+	explicit FighterImage(const std::string& file);
+
+	// Unmaps the file.
+	~FighterImage(void);
+
+	enum{
+		// "EXFC" when read as little-endian.
+		Magic = 0x43465845,
+		// Increment when the layout of any table changes, or when the 
+		// values compiled from a .fighter file do.
+		Version = 2
+	};
+
+	// Creates the FighterData of the image. Its frames point into the 
+	// image, which it keeps mapped.
+	static std::shared_ptr<FighterData> CreateFighterData(const std::shared_ptr<const FighterImage>& pImage);
+
+	// Appends a Move for each MoveID to moves, copying its frames from the
+	// image.
+	void createMoves(std::vector<std::shared_ptr<Move>>& moves) const;
+
+	// Returns true if the image was compiled from file as it is now. Also 
+	// true if file doesn't exist, so only compiled fighters can be shipped.
+	const bool isCurrent(const std::string& file) const;
+
+	// Parses the .fighter file source and writes it compiled to file. 
+	// Throws if source is malformed or can't be written.
+	static void Compile(const std::string& source, const std::string& file);
+
+	// Returns the name of the compiled file for the .fighter file.
+	static std::string GetImageFile(const std::string& file);
+
+	// Gets the size and modification time of file. Returns false if it 
+	// doesn't exist.
+	static bool GetFileInfo(const std::string& file, uint32_t& size, uint64_t& time);
+
+	// Loads the fighter in the .fighter file, from its compiled image if 
+	// there is a current one and from the text otherwise. If pMoves isn't 
+	// null, a Move is appended for each MoveID. If pSpriteSheet isn't null,
+	// it's set to the sprite sheet's file name. Throws if neither loads.
+	static std::shared_ptr<FighterData> LoadFighter(const std::string& file, 
+													std::vector<std::shared_ptr<Move>>* pMoves = nullptr,
+													std::string* pSpriteSheet = nullptr);
+
+	// Getters
+
+	// Returns true if the file was mapped and is a valid image.
+	const bool isLoaded(void) const;
+
+	// Returns why the image didn't load.
+	const std::string& getError(void) const;
+
+	// Returns the header. Only valid if loaded.
+	const FighterImageHeader& getHeader(void) const;
+
+	// Returns the move with MoveID i.
+	const FighterImageMove& getMove(const uint32_t i) const;
+
+	// Returns the frame table.
+	const FighterFrame* getFrames(void) const;
+
+	// Returns the string at offset in the string table.
+	const char* getString(const uint32_t offset) const;
+
+private:
+	// Checks the header, tables and checksum. Returns an empty string if 
+	// the image is valid, otherwise what's wrong with it.
+	std::string validate(void) const;
+
+	const Uint8* m_pData;
+	size_t m_size;
+	bool m_loaded;
+	std::string m_error;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const bool FighterImage::isLoaded(void) const{
+	return m_loaded;
+}
+
+inline const std::string& FighterImage::getError(void) const{
+	return m_error;
+}
+
+inline const FighterImageHeader& FighterImage::getHeader(void) const{
+	return *reinterpret_cast<const FighterImageHeader*>(m_pData);
+}
+
+inline const FighterImageMove& FighterImage::getMove(const uint32_t i) const{
+	return reinterpret_cast<const FighterImageMove*>(m_pData + this->getHeader().movesOffset)[i];
+}
+
+inline const FighterFrame* FighterImage::getFrames(void) const{
+	return reinterpret_cast<const FighterFrame*>(m_pData + this->getHeader().framesOffset);
+}
+
+inline const char* FighterImage::getString(const uint32_t offset) const{
+	return reinterpret_cast<const char*>(m_pData + this->getHeader().stringsOffset + offset);
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
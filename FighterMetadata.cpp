@@ -26,12 +26,191 @@
 #include "Move.hpp"
 #include "Hitbox.hpp"
 #include "Player.hpp"
+#include "FighterData.hpp"
+#include "MatchSim.hpp"
+#include "SimFixed.hpp"
+
+#include <cstdlib>
+
+// ================================================ //
+
+namespace{
+	// A value read from a move, and the line it was on. Missing values are
+	// -1 on line 0.
+	struct MoveValue{
+		int value;
+		int line;
+	};
+
+	struct RectValue{
+		SDL_Rect rc;
+		int line;
+	};
+
+	// Everything read from one [frameN] section.
+	struct FrameValues{
+		MoveValue x, y, w, h, gap, rw, rh;
+		// Indexed by the Hitbox enum.
+		RectValue hitboxes[Hitbox::CBOX2 + 1];
+	};
+
+	// Everything read between +(NAME) and -(NAME).
+	struct MoveValues{
+		MoveValue numFrames, frameGap, startupFrames, hitFrames, recoveryFrames;
+		MoveValue damage, hitstun, blockstun, knockback, recoil;
+		MoveValue repeat, repeatFrame, reverse, transition;
+		MoveValue xVel, yVel;
+		std::vector<FrameValues> frames;
+	};
+
+	struct MoveField{
+		const char* key;
+		MoveValue MoveValues::* field;
+	};
+
+	struct FrameField{
+		const char* key;
+		MoveValue FrameValues::* field;
+	};
+
+	const MoveField CoreFields[] = {
+		{ "numFrames", &MoveValues::numFrames },
+		{ "frameGap", &MoveValues::frameGap },
+		{ "damage", &MoveValues::damage },
+		{ "hitstun", &MoveValues::hitstun },
+		{ "blockstun", &MoveValues::blockstun },
+		{ "knockback", &MoveValues::knockback },
+		{ "recoil", &MoveValues::recoil },
+		{ "repeat", &MoveValues::repeat },
+		{ "repeatFrame", &MoveValues::repeatFrame },
+		{ "reverse", &MoveValues::reverse },
+		{ "transition", &MoveValues::transition }
+	};
+
+	const MoveField LocomotionFields[] = {
+		{ "xVel", &MoveValues::xVel },
+		{ "yVel", &MoveValues::yVel }
+	};
+
+	const FrameField FrameFields[] = {
+		{ "x", &FrameValues::x },
+		{ "y", &FrameValues::y },
+		{ "w", &FrameValues::w },
+		{ "h", &FrameValues::h },
+		{ "gap", &FrameValues::gap },
+		{ "rw", &FrameValues::rw },
+		{ "rh", &FrameValues::rh }
+	};
+
+	// Indexed by the Hitbox enum.
+	const char* HitboxKeys[] = {
+		"hbox1", "hbox2", "hbox3", "hbox4", "tbox", "dbox1", "dbox2", "cbox1", "cbox2"
+	};
+
+	const int NumCoreFields = sizeof(CoreFields) / sizeof(CoreFields[0]);
+	const int NumLocomotionFields = sizeof(LocomotionFields) / sizeof(LocomotionFields[0]);
+	const int NumFrameFields = sizeof(FrameFields) / sizeof(FrameFields[0]);
+	const int NumHitboxKeys = sizeof(HitboxKeys) / sizeof(HitboxKeys[0]);
+
+	// More frames than any move could use, to catch typos like [frame1000].
+	const int MaxFrames = 4096;
+
+	const bool Equals(const char* p, const size_t size, const char* str)
+	{
+		return (strlen(str) == size && memcmp(p, str, size) == 0);
+	}
+
+	const bool IsSpace(const char c)
+	{
+		return (c == ' ' || c == '\t' || c == '\r');
+	}
+
+	// Reads an integer at p, skipping leading spaces, and advances p past it.
+	const bool ReadInt(const char*& p, const char* end, int& out)
+	{
+		while (p < end && IsSpace(*p)){
+			++p;
+		}
+		if (p == end || !((*p >= '0' && *p <= '9') || *p == '-' || *p == '+')){
+			return false;
+		}
+
+		char* next = nullptr;
+		const long i = strtol(p, &next, 10);
+		if (next == p || next > end){
+			return false;
+		}
+		out = static_cast<int>(i);
+		p = next;
+
+		return true;
+	}
+
+	// Skips spaces and the character c at p, returning false if c isn't next.
+	const bool ReadChar(const char*& p, const char* end, const char c)
+	{
+		while (p < end && IsSpace(*p)){
+			++p;
+		}
+		if (p == end || *p != c){
+			return false;
+		}
+		++p;
+
+		return true;
+	}
+
+	// Returns true if only spaces are left.
+	const bool AtEnd(const char* p, const char* end)
+	{
+		while (p < end && IsSpace(*p)){
+			++p;
+		}
+
+		return (p == end);
+	}
+
+	// Returns the value, or -1 if it's missing.
+	const int Get(const MoveValue& v)
+	{
+		return (v.line == 0) ? -1 : v.value;
+	}
+
+	// Returns the value converted from milliseconds to simulation ticks, or
+	// -1 if it's missing or negative.
+	const int GetTicks(const MoveValue& v)
+	{
+		const int ms = Get(v);
+		return (ms < 0) ? -1 : static_cast<int>(SimFixed::msToTicks(static_cast<uint32_t>(ms), MatchSim::TickRate));
+	}
+
+	// Marks every value of the frame as missing.
+	void ClearFrame(FrameValues& frame)
+	{
+		memset(&frame, 0, sizeof(frame));
+		frame.x.value = frame.y.value = frame.w.value = frame.h.value = frame.gap.value = 
+			frame.rw.value = frame.rh.value = -1;
+	}
+
+	// Marks every value of the move as missing and removes its frames.
+	void ClearMove(MoveValues& move)
+	{
+		const MoveValue missing = { -1, 0 };
+		move.numFrames = move.frameGap = move.startupFrames = move.hitFrames = move.recoveryFrames = missing;
+		move.damage = move.hitstun = move.blockstun = move.knockback = move.recoil = missing;
+		move.repeat = move.repeatFrame = move.reverse = move.transition = missing;
+		move.xVel = move.yVel = missing;
+		move.frames.clear();
+	}
+}
 
 // ================================================ //
 
 FighterMetadata::FighterMetadata(void) :	
 Config(Config::FIGHTER_METADATA),
-m_moveBeg()
+m_moves(),
+m_moveIndex(),
+m_movesParsed(false)
 {
 
 }
@@ -40,7 +219,9 @@ m_moveBeg()
 
 FighterMetadata::FighterMetadata(const std::string& file) : 
 Config(Config::FIGHTER_METADATA),
-m_moveBeg()
+m_moves(),
+m_moveIndex(),
+m_movesParsed(false)
 {
 	this->loadFile(file);
 }
@@ -54,251 +235,408 @@ FighterMetadata::~FighterMetadata(void)
 
 // ================================================ //
 
-std::shared_ptr<Move> FighterMetadata::parseMove(const std::string& name)
+void FighterMetadata::loadFile(const std::string& file)
 {
-	this->resetFilePointer();
-
-	while(!m_file.eof()){
-		m_file >> m_buffer;
-
-		// Look for moves section.
-		if (m_buffer[0] == '[' && m_buffer[m_buffer.size() - 1] == ']'){
-			if (m_buffer.compare(1, m_buffer.size() - 2, "moves") == 0){
-
-				// In the moves section, now find the move.
-				while(!m_file.eof()){
-					m_file >> m_buffer;
-
-					if (m_buffer[0] == '+'){
-						// Found a move, see if it's the right one (example m_buffer: "+(IDLE)").
-						if (m_buffer.compare(2, m_buffer.size() - 3, name) == 0){
-
-							// Setup Move object for this move.
-							std::shared_ptr<Move> pMove;
-							pMove.reset(new Move());
-							pMove->name = name;
-
-							// Store beginning of this move's data for later.
-							m_moveBeg = m_file.tellg();
-
-							// Get the main data for the move.
-							pMove->numFrames = this->parseMoveIntValue("core", "numFrames");
-							pMove->frames.reserve(pMove->numFrames);
-							pMove->frameGap = this->parseMoveIntValue("core", "frameGap");
-
-							// Get the frame data.
-							m_buffer = this->parseMoveValue("core", "frameData");
-							char c;
-							std::istringstream parse(m_buffer);
-							parse >> pMove->startupFrames;
-							parse >> c;
-							parse >> pMove->hitFrames;
-							parse >> c;
-							parse >> pMove->recoveryFrames;
-
-							// Get other core data.
-							pMove->damage = this->parseMoveIntValue("core", "damage");
-							pMove->hitstun = this->parseMoveIntValue("core", "hitstun");
-							pMove->blockstun = this->parseMoveIntValue("core", "blockstun");
-
-							pMove->knockback = this->parseMoveIntValue("core", "knockback");
-							pMove->recoil = this->parseMoveIntValue("core", "recoil");
-							pMove->repeat = this->parseMoveBoolValue("core", "repeat");
-							if (pMove->repeat)
-								pMove->repeatFrame = this->parseMoveIntValue("core", "repeatFrame");
-							pMove->reverse = this->parseMoveBoolValue("core", "reverse");
-							pMove->transition = this->parseMoveIntValue("core", "transition");
-
-							// Parse any cancels.
-							// ...
-
-							// Get locomotion data.
-							pMove->xVel = this->parseMoveIntValue("locomotion", "xVel");
-							pMove->yVel = this->parseMoveIntValue("locomotion", "yVel");
-
-							// Parse initial frame.
-							Frame frame1;
-							frame1.x = this->parseMoveIntValue("frame1", "x");
-							frame1.y = this->parseMoveIntValue("frame1", "y");
-							frame1.w = this->parseMoveIntValue("frame1", "w");
-							frame1.h = this->parseMoveIntValue("frame1", "h");							
-							if ((frame1.gap = this->parseIntValue("frame1", "gap")) == -1){
-								// Inherit global frame gap.
-								frame1.gap = pMove->frameGap;
-							}
-
-							// Calculate first rw and rh values based on default size.
-							frame1.rw = this->parseMoveIntValue("frame1", "rw");
-							frame1.rh = this->parseMoveIntValue("frame1", "rh");
-							// Only allow expanding of the rendering size on the first frame.
-							if (frame1.rw < 0){
-								frame1.rw = 0;
-							}
-							if (frame1.rh < 0){
-								frame1.rh = 0;
-							}
-
-							pMove->frames.push_back(frame1);
-							this->parseHitboxes(pMove, "frame1");
-
-							// Parse the rest of the frames.
-							for(int i=2; i<=pMove->numFrames; ++i){
-								Frame frame;
-								std::string frameSection = "frame" + Engine::toString(i);
-								frame.x = this->parseMoveIntValue(frameSection.c_str(), "x");
-								frame.y = this->parseMoveIntValue(frameSection.c_str(), "y");
-								frame.w = this->parseMoveIntValue(frameSection.c_str(), "w");
-								frame.h = this->parseMoveIntValue(frameSection.c_str(), "h");								
-								if ((frame.gap = this->parseMoveIntValue(frameSection.c_str(), "gap")) == -1){
-									frame.gap = pMove->frameGap;
-								}
-
-								// See if any values should be inherited (-1 means inherit from previous frame).
-								if (frame.x == -1)
-									frame.x = pMove->frames.back().x;
-								if (frame.y == -1)
-									frame.y = pMove->frames.back().y;
-								if (frame.w == -1)
-									frame.w = pMove->frames.back().w;
-								if (frame.h == -1)
-									frame.h = pMove->frames.back().h;
-
-								// Calculate rw and rh values.
-								frame.rw = (frame.w - pMove->frames.back().w);
-								frame.rh = (frame.h - pMove->frames.back().h);								
-
-								pMove->frames.push_back(frame);
-								this->parseHitboxes(pMove, frameSection.c_str());
-							}
-
-							return pMove;
-						}
-					}
-				}
-			}
-		}
-	}
+	m_moves.clear();
+	m_moveIndex.clear();
+	m_movesParsed = false;
 
-	return nullptr;
+	Config::loadFile(file);
 }
 
 // ================================================ //
 
-std::string FighterMetadata::parseMoveValue(const std::string& section, const std::string& value)
+std::shared_ptr<Move> FighterMetadata::parseMove(const std::string& name)
 {
-	// Reset file pointer to beginning of this move.
-	m_file.clear();
-	m_file.seekg(m_moveBeg);
-
-	while(!m_file.eof()){
-		// Find the section.
-		m_file >> m_buffer;
-
-		if (m_buffer[0] == '[' && m_buffer[m_buffer.size() - 2] == ']'){
-			
-			// Check section name.
-			if (m_buffer.compare(1, m_buffer.size() - 3, section) == 0){
-				while(m_buffer[0] != '}'){
-					m_file >> m_buffer;
-
-					// Skip comments.
-					if (m_buffer[0] != '#'){
-						size_t assign = m_buffer.find_first_of('=');
-
-						// See if this is the value.
-						if (m_buffer.compare(0, assign, value) == 0){
-							// Trim the string to only the value.
-							m_buffer = m_buffer.substr(assign + 1, m_buffer.size());
-
-							return m_buffer;
-						}
-					}
-				}
-			}
-		}
-		else if (m_buffer[0] == '-'){
-			// End of move found.
-			break;
-		}
+	if (!m_movesParsed){
+		this->parseMoves();
 	}
 
-	m_file.clear();
-	return std::string("");
+	std::map<std::string, size_t>::const_iterator itr = m_moveIndex.find(name);
+	if (itr == m_moveIndex.end()){
+		return nullptr;
+	}
+
+	// Players animate their own copy.
+	return std::shared_ptr<Move>(new Move(*m_moves[itr->second]));
 }
 
 // ================================================ //
 
-const int FighterMetadata::parseMoveIntValue(const std::string& section, const std::string& value)
+std::shared_ptr<FighterData> FighterMetadata::parseFighterData(std::vector<std::shared_ptr<Move>>* pMoves)
 {
-	std::string str = this->parseMoveValue(section, value);
-	if (!str.empty()){
-		return std::stoi(str);
+	std::shared_ptr<FighterData> pData(new FighterData());
+
+	pData->w = this->parseIntValue("size", "w");
+	pData->h = this->parseIntValue("size", "h");
+	pData->xAccel = this->parseIntValue("physics", "xAccel");
+	pData->xMax = this->parseIntValue("physics", "xMax");
+	pData->jumpStrength = this->parseIntValue("physics", "jumpStrength");
+	pData->jumpSpeed = this->parseIntValue("physics", "jumpSpeed");
+	pData->hp = this->parseIntValue("stats", "HP");
+
+	// Every move's frames go in one list.
+	std::shared_ptr<FighterFrameList> pFrames(new FighterFrameList());
+	for (int i = 0; i < MoveID::END_MOVES; ++i){
+		std::shared_ptr<Move> pMove = this->parseMove(MoveID::Name[i]);
+		if (pMove == nullptr){
+			throw std::exception(std::string("Unable to load move \"" + std::string(MoveID::Name[i]) + 
+				"\"").c_str());
+		}
+		pMove->id = i;
+		if (pMoves){
+			pMoves->push_back(pMove);
+		}
+
+		FighterMove move;
+		move.id = pMove->id;
+		move.frameGap = pMove->frameGap;
+		move.damage = pMove->damage;
+		move.hitstun = pMove->hitstun;
+		move.blockstun = pMove->blockstun;
+		move.knockback = pMove->knockback;
+		move.recoil = pMove->recoil;
+		move.repeat = pMove->repeat;
+		move.repeatFrame = pMove->repeatFrame;
+		move.transition = pMove->transition;
+		move.xVel = pMove->xVel;
+		move.yVel = pMove->yVel;
+		move.firstFrame = static_cast<uint32_t>(pFrames->size());
+		move.numFrames = static_cast<uint32_t>(pMove->frames.size());
+
+		for (FrameList::iterator f = pMove->frames.begin(); f != pMove->frames.end(); ++f){
+			FighterFrame frame;
+			memset(&frame, 0, sizeof(frame));
+			frame.src.x = f->x;
+			frame.src.y = f->y;
+			frame.src.w = f->w;
+			frame.src.h = f->h;
+			frame.rw = f->rw;
+			frame.rh = f->rh;
+			frame.gap = f->gap;
+			for (int h = 0; h < SimHitbox::NUM_HITBOXES; ++h){
+				frame.hitboxes[h].x = f->hitboxes[h].x;
+				frame.hitboxes[h].y = f->hitboxes[h].y;
+				frame.hitboxes[h].w = f->hitboxes[h].w;
+				frame.hitboxes[h].h = f->hitboxes[h].h;
+			}
+			pFrames->push_back(frame);
+		}
+
+		pData->moves.push_back(move);
 	}
+	pData->setFrames(pFrames);
 
-	return -1;
+	return pData;
 }
 
 // ================================================ //
 
-const bool FighterMetadata::parseMoveBoolValue(const std::string& section, const std::string& value)
+void FighterMetadata::parseMoves(void)
 {
-	return (this->parseMoveIntValue(section, value) >= 1);
-}
+	m_moves.clear();
+	m_moveIndex.clear();
+	m_movesParsed = true;
+
+	enum{
+		// Looking for [moves].
+		FIND_MOVES = 0,
+		// In [moves], between moves.
+		BETWEEN_MOVES,
+		// Between +(NAME) and -(NAME), outside any section.
+		IN_MOVE,
+		// Between [section]{ and }.
+		IN_SECTION
+	};
+
+	int state = FIND_MOVES;
+	MoveValues values;
+	std::string moveName;
+	int moveLine = 0;
+	const char* section = nullptr;
+	size_t sectionSize = 0;
+	FrameValues* pFrame = nullptr;
+
+	const char* p = m_data.c_str();
+	const char* end = p + m_data.size();
+	for (int line = 1; p < end; ++line){
+		const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+		if (eol == nullptr){
+			eol = end;
+		}
 
-// ================================================ //
+		// Trim the line.
+		const char* first = p;
+		const char* last = eol;
+		p = eol + 1;
+		while (first < last && IsSpace(*first)){
+			++first;
+		}
+		while (last > first && IsSpace(*(last - 1))){
+			--last;
+		}
+		const size_t size = last - first;
+		if (size == 0 || first[0] == '#'){
+			continue;
+		}
 
-SDL_Rect FighterMetadata::parseRect(const std::string& str)
-{
-	SDL_Rect rc;
-	memset(&rc, 0, sizeof(rc));
-	
-	if (str.empty()){
-		Log::getSingletonPtr()->logMessage("No hitbox found for \"" + str + "\"");
-		return rc;
-	}
-	
-	// str should look like "(0,0,100,100)".
-	char c;
-	std::istringstream parse(str);
-	parse >> c; // eat "(".
-	parse >> rc.x;
-	parse >> c; // eat ",".
-	parse >> rc.y;
-	parse >> c;
-	parse >> rc.w;
-	parse >> c;
-	parse >> rc.h;
-
-	return rc;
-}
+		switch (state){
+		case FIND_MOVES:
+			if (Equals(first, size, "[moves]")){
+				state = BETWEEN_MOVES;
+			}
+			break;
 
-// ================================================ //
+		case BETWEEN_MOVES:
+			if (first[0] == '+'){
+				if (size < 4 || first[1] != '(' || *(last - 1) != ')'){
+					this->throwError(line, "Expected \"+(MOVE_NAME)\"");
+				}
+				moveName.assign(first + 2, size - 3);
+				if (m_moveIndex.count(moveName) != 0){
+					this->throwError(line, "Move \"" + moveName + "\" is already defined");
+				}
 
-void FighterMetadata::parseHitboxes(std::shared_ptr<Move> pMove, const std::string& frame)
-{
-	// Load all hitbox rects into the frame's hitbox list.
+				ClearMove(values);
+				moveLine = line;
+				state = IN_MOVE;
+			}
+			else if (first[0] == '[' && *(last - 1) == ']'){
+				// Another top-level section ends [moves].
+				state = FIND_MOVES;
+			}
+			else{
+				this->throwError(line, "Expected \"+(MOVE_NAME)\"");
+			}
+			break;
 
-	// Parse normal hitboxes.
-	for (int i = Hitbox::HBOX_LOWER, num = 1; i <= Hitbox::HBOX_HEAD; ++i, ++num){
-		std::string hbox = this->parseMoveValue(frame, std::string("hbox" + Engine::toString(num)).c_str());
-		pMove->frames.back().hitboxes.push_back(this->parseRect(hbox));
-	}
+		case IN_MOVE:
+			if (first[0] == '-'){
+				if (size != moveName.size() + 3 || first[1] != '(' || *(last - 1) != ')' ||
+					moveName.compare(0, moveName.size(), first + 2, moveName.size()) != 0){
+					this->throwError(line, "Expected \"-(" + moveName + ")\"");
+				}
+
+				// Build the move, inheriting missing values as parseMove() always has.
+				if (values.numFrames.line == 0 || values.numFrames.value < 1){
+					this->throwError(moveLine, "Move \"" + moveName + "\" needs numFrames of at least 1");
+				}
+
+				std::shared_ptr<Move> pMove(new Move());
+				pMove->name = moveName;
+				pMove->numFrames = values.numFrames.value;
+				pMove->frames.reserve(pMove->numFrames);
+				// Frame gaps and stun are authored in milliseconds but counted in simulation ticks.
+				pMove->frameGap = GetTicks(values.frameGap);
+				if (values.startupFrames.line != 0){
+					pMove->startupFrames = values.startupFrames.value;
+					pMove->hitFrames = values.hitFrames.value;
+					pMove->recoveryFrames = values.recoveryFrames.value;
+				}
+				pMove->damage = Get(values.damage);
+				pMove->hitstun = GetTicks(values.hitstun);
+				pMove->blockstun = GetTicks(values.blockstun);
+				pMove->knockback = Get(values.knockback);
+				pMove->recoil = Get(values.recoil);
+				pMove->repeat = (Get(values.repeat) >= 1);
+				if (pMove->repeat){
+					pMove->repeatFrame = Get(values.repeatFrame);
+				}
+				pMove->reverse = (Get(values.reverse) >= 1);
+				pMove->transition = Get(values.transition);
+				pMove->xVel = Get(values.xVel);
+				pMove->yVel = Get(values.yVel);
+
+				FrameValues none;
+				ClearFrame(none);
+				for (int i = 0; i < pMove->numFrames; ++i){
+					const FrameValues& v = (i < static_cast<int>(values.frames.size())) ? values.frames[i] : none;
+
+					Frame frame;
+					frame.x = Get(v.x);
+					frame.y = Get(v.y);
+					frame.w = Get(v.w);
+					frame.h = Get(v.h);
+					frame.gap = (Get(v.gap) == -1) ? pMove->frameGap : GetTicks(v.gap);
+
+					if (i == 0){
+						// Only allow expanding of the rendering size on the first frame.
+						frame.rw = std::max(Get(v.rw), 0);
+						frame.rh = std::max(Get(v.rh), 0);
+					}
+					else{
+						// See if any values should be inherited (-1 means inherit from previous frame).
+						const Frame& prev = pMove->frames.back();
+						if (frame.x == -1)
+							frame.x = prev.x;
+						if (frame.y == -1)
+							frame.y = prev.y;
+						if (frame.w == -1)
+							frame.w = prev.w;
+						if (frame.h == -1)
+							frame.h = prev.h;
+
+						frame.rw = (frame.w - prev.w);
+						frame.rh = (frame.h - prev.h);
+					}
+
+					for (int h = 0; h < NumHitboxKeys; ++h){
+						frame.hitboxes[h] = v.hitboxes[h].rc;
+					}
+
+					pMove->frames.push_back(frame);
+				}
+
+				m_moveIndex[moveName] = m_moves.size();
+				m_moves.push_back(pMove);
+				state = BETWEEN_MOVES;
+			}
+			else if (first[0] == '['){
+				// Sections look like "[core]{".
+				const char* close = static_cast<const char*>(memchr(first, ']', size));
+				const char* brace = (close != nullptr) ? close + 1 : last;
+				if (close == nullptr || !ReadChar(brace, last, '{') || !AtEnd(brace, last)){
+					this->throwError(line, "Expected \"[section]{\"");
+				}
+				section = first + 1;
+				sectionSize = close - section;
+				pFrame = nullptr;
+
+				if (sectionSize > 5 && memcmp(section, "frame", 5) == 0){
+					const char* n = section + 5;
+					int frame = 0;
+					if (!ReadInt(n, close, frame) || n != close || frame < 1 || frame > MaxFrames){
+						this->throwError(line, "Invalid frame section \"[" + std::string(section, sectionSize) + "]\"");
+					}
+					if (static_cast<int>(values.frames.size()) < frame){
+						FrameValues none;
+						ClearFrame(none);
+						values.frames.resize(frame, none);
+					}
+					pFrame = &values.frames[frame - 1];
+				}
+				state = IN_SECTION;
+			}
+			else if (first[0] == '+'){
+				this->throwError(line, "Expected \"-(" + moveName + ")\" before the next move");
+			}
+			else{
+				this->throwError(line, "Value outside of a section in move \"" + moveName + "\"");
+			}
+			break;
+
+		case IN_SECTION:
+			if (first[0] == '}' && size == 1){
+				state = IN_MOVE;
+			}
+			else{
+				const char* assign = static_cast<const char*>(memchr(first, '=', size));
+				if (assign == nullptr){
+					this->throwError(line, "Expected \"key=value\" or \"}\"");
+				}
 
-	// Parse throw box.
-	std::string tbox = this->parseMoveValue(frame, "tbox");
-	pMove->frames.back().hitboxes.push_back(this->parseRect(tbox));
+				const char* key = first;
+				const char* keyEnd = assign;
+				while (keyEnd > key && IsSpace(*(keyEnd - 1))){
+					--keyEnd;
+				}
+				const size_t keySize = keyEnd - key;
+				const char* value = assign + 1;
+				if (AtEnd(value, last)){
+					// An empty value is the same as a missing one.
+					break;
+				}
+
+				// Find where the value goes, if anywhere.
+				MoveValue* pValue = nullptr;
+				RectValue* pRect = nullptr;
+				if (pFrame != nullptr){
+					for (int i = 0; i < NumFrameFields && pValue == nullptr; ++i){
+						if (Equals(key, keySize, FrameFields[i].key)){
+							pValue = &(pFrame->*FrameFields[i].field);
+						}
+					}
+					for (int i = 0; i < NumHitboxKeys && pValue == nullptr && pRect == nullptr; ++i){
+						if (Equals(key, keySize, HitboxKeys[i])){
+							pRect = &pFrame->hitboxes[i];
+						}
+					}
+				}
+				else if (Equals(section, sectionSize, "core")){
+					if (Equals(key, keySize, "frameData")){
+						// Looks like "startup/hit/recovery".
+						if (values.startupFrames.line != 0){
+							this->throwError(line, "Duplicate value \"frameData\" (first on line " + 
+								Engine::toString(values.startupFrames.line) + ")");
+						}
+						if (!ReadInt(value, last, values.startupFrames.value) || !ReadChar(value, last, '/') ||
+							!ReadInt(value, last, values.hitFrames.value) || !ReadChar(value, last, '/') ||
+							!ReadInt(value, last, values.recoveryFrames.value) || !AtEnd(value, last)){
+							this->throwError(line, "Expected \"frameData=startup/hit/recovery\"");
+						}
+						values.startupFrames.line = line;
+						break;
+					}
+					for (int i = 0; i < NumCoreFields && pValue == nullptr; ++i){
+						if (Equals(key, keySize, CoreFields[i].key)){
+							pValue = &(values.*CoreFields[i].field);
+						}
+					}
+				}
+				else if (Equals(section, sectionSize, "locomotion")){
+					for (int i = 0; i < NumLocomotionFields && pValue == nullptr; ++i){
+						if (Equals(key, keySize, LocomotionFields[i].key)){
+							pValue = &(values.*LocomotionFields[i].field);
+						}
+					}
+				}
 
-	// Parse damage boxes.
-	for (int i = Hitbox::DBOX1, num = 1; i <= Hitbox::DBOX2; ++i, ++num){
-		std::string dbox = this->parseMoveValue(frame, std::string("dbox" + Engine::toString(num)).c_str());
-		pMove->frames.back().hitboxes.push_back(this->parseRect(dbox));
+				const std::string keyName(key, keySize);
+				if (pValue != nullptr){
+					if (pValue->line != 0){
+						this->throwError(line, "Duplicate value \"" + keyName + "\" (first on line " + 
+							Engine::toString(pValue->line) + ")");
+					}
+					if (!ReadInt(value, last, pValue->value) || !AtEnd(value, last)){
+						this->throwError(line, "Expected an integer for \"" + keyName + "\"");
+					}
+					pValue->line = line;
+				}
+				else if (pRect != nullptr){
+					if (pRect->line != 0){
+						this->throwError(line, "Duplicate value \"" + keyName + "\" (first on line " + 
+							Engine::toString(pRect->line) + ")");
+					}
+					if (!ReadChar(value, last, '(') || !ReadInt(value, last, pRect->rc.x) || 
+						!ReadChar(value, last, ',') || !ReadInt(value, last, pRect->rc.y) || 
+						!ReadChar(value, last, ',') || !ReadInt(value, last, pRect->rc.w) || 
+						!ReadChar(value, last, ',') || !ReadInt(value, last, pRect->rc.h) || 
+						!ReadChar(value, last, ')') || !AtEnd(value, last)){
+						this->throwError(line, "Expected \"" + keyName + "=(x,y,w,h)\"");
+					}
+					pRect->line = line;
+				}
+				// Anything else (e.g., [input]) isn't used yet.
+			}
+			break;
+		}
+	}
+
+	if (state == IN_MOVE || state == IN_SECTION){
+		this->throwError(moveLine, "Move \"" + moveName + "\" has no \"-(" + moveName + ")\"");
 	}
 
-	// Parse counter boxes.
-	for (int i = Hitbox::CBOX1, num = 1; i <= Hitbox::CBOX2; ++i, ++num){
-		std::string cbox = this->parseMoveValue(frame, std::string("cbox" + Engine::toString(num)).c_str());
-		pMove->frames.back().hitboxes.push_back(this->parseRect(cbox));
+	Log* pLog = Log::getSingletonPtr();
+	if (pLog != nullptr){
+		pLog->logMessage("Parsed " + Engine::toString(m_moves.size()) + " moves from \"" + m_fileName + "\"");
 	}
 }
 
+// ================================================ //
+
+void FighterMetadata::throwError(const int line, const std::string& message) const
+{
+	throw std::exception(std::string(m_fileName + ":" + Engine::toString(line) + ": " + message).c_str());
+}
+
 // ================================================ //
\ No newline at end of file
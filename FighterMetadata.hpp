@@ -31,54 +31,89 @@
 // ================================================ //
 
 struct Move;
+struct FighterData;
 
 // ================================================ //
 
 // A specialized config file parser for reading/writing fighter data
-// from a .fighter file.
+// from a .fighter file. The [moves] section is parsed in one pass over the
+// file the first time a move is needed, and moves are copied from there.
 class FighterMetadata : public Config
 {
 public:
 	// Sets the type to FIGHTER_METADATA.
 	explicit FighterMetadata(void);
 
-	// Sets the type to FIGHTER_METADATA and opens the file handle.
+	// Sets the type to FIGHTER_METADATA and loads the file.
 	explicit FighterMetadata(const std::string& file);
 
-	// Empty destructor, parent destructor close the file handle.
+	// Empty destructor.
 	virtual ~FighterMetadata(void);
 
-	// Allocates a Move object and parses all data for it. 
-	// A Move is formatted like so:
+	// Loads the file, discarding any moves parsed from the last one.
+	virtual void loadFile(const std::string& file);
+
+	// Allocates a copy of the Move called name, or returns nullptr if the 
+	// file doesn't have it. A Move is formatted like so:
 	// +(MOVE_NAME)
-	// ... (all data)
+	//	[section]{
+	//		key=value
+	//	}
+	//	... (more sections)
 	// -(MOVE_NAME)
+	// Throws an exception with the file name and line number if the 
+	// [moves] section is malformed.
 	virtual std::shared_ptr<Move> parseMove(const std::string& name);
+
+	// Parses the fighter's size, physics, stats and every move into the 
+	// immutable data used by MatchSim. Does not need a renderer, so it can be
+	// used by the server. If pMoves is not null, the parsed Move objects are
+	// appended to it, indexed by MoveID. Throws if a move is missing.
+	virtual std::shared_ptr<FighterData> parseFighterData(std::vector<std::shared_ptr<Move>>* pMoves = nullptr);
+
+	// Getters
+
+	// Returns the number of moves in the file, parsing them if needed.
+	const size_t getNumMoves(void);
+
+	// Returns move i in the order of the file, parsing them if needed.
+	std::shared_ptr<const Move> getMove(const size_t i);
 	
 private:
-	// Obtains a basic string value from within a move.
-	// Used by parseMove() in case data is out of order.
-	virtual std::string parseMoveValue(const std::string& section, const std::string& value);
+	// Reads every move in the [moves] section in a single pass over the 
+	// file's text, building all of their frames and hitboxes. A value that
+	// is missing is -1, which lets a frame inherit its source rect from the
+	// previous frame, as parseMove() did when it searched for each value.
+	void parseMoves(void);
+
+	// Throws an exception naming the file and line.
+	void throwError(const int line, const std::string& message) const;
+
+	// Every move in the file in order, and the index of each by name.
+	std::vector<std::shared_ptr<Move>> m_moves;
+	std::map<std::string, size_t> m_moveIndex;
+	bool m_movesParsed;
+};
+
+// ================================================ //
 
-	// Wraps parseMoveValue() and converts the std::string to an int. Returns -1 
-	// on failure is to let FighterMetadata::parseMove() know if a frame of 
-	// animation should be inherited from the previous frame, rather than 
-	// assigning its corresponding value(s) to zero. This will no longer be 
-	// necessary once a tool is developed to visually edit fighter data.
-	virtual const int parseMoveIntValue(const std::string& section, const std::string& value);
+// Getters
 
-	// Wraps parseMoveValue() and converts the std::string to a bool.
-	virtual const bool parseMoveBoolValue(const std::string& section, const std::string& value);
+inline const size_t FighterMetadata::getNumMoves(void){
+	if (!m_movesParsed){
+		this->parseMoves();
+	}
 
-	// Parses all hitboxes for a Move's particular frame.
-	virtual void parseHitboxes(std::shared_ptr<Move> pMove, const std::string& frame);
+	return m_moves.size();
+}
 
-	// Same as Config::parseRect(), but directly operates on the str parameter.
-	virtual SDL_Rect FighterMetadata::parseRect(const std::string& str);
+inline std::shared_ptr<const Move> FighterMetadata::getMove(const size_t i){
+	if (!m_movesParsed){
+		this->parseMoves();
+	}
 
-	// Holds the beginning line of a move for going back to parse more.
-	std::streampos m_moveBeg;
-};
+	return m_moves[i];
+}
 
 // ================================================ //
 
@@ -40,13 +40,29 @@ m_redPlayerName(""),
 m_bluePlayerName(""),
 m_useSimulator(false),
 m_simulatedPing(0),
-m_simulatedPacketLoss(0.0f)
+m_simulatedPacketLoss(0.0f),
+m_useRollback(false),
+m_rollbackFrames(8),
+m_useLockstep(false),
+m_inputDelay(2)
 {
 	Config c(Engine::getSingletonPtr()->getSettingsFile());
 
 	m_useSimulator = !!(c.parseIntValue("net", "useSimulator"));
 	m_simulatedPing = c.parseIntValue("net", "simulatedPing");
 	m_simulatedPacketLoss = static_cast<float>(c.parseDoubleValue("net", "simulatedPacketLoss"));
+
+	m_useRollback = !!(c.parseIntValue("net", "rollback"));
+	const int rollbackFrames = c.parseIntValue("net", "rollbackFrames");
+	if (rollbackFrames > 0){
+		m_rollbackFrames = rollbackFrames;
+	}
+
+	m_useLockstep = !!(c.parseIntValue("net", "lockstep"));
+	const int inputDelay = c.parseIntValue("net", "inputDelay");
+	if (inputDelay > 0){
+		m_inputDelay = inputDelay;
+	}
 }
 
 // ================================================ //
@@ -92,6 +92,24 @@ public:
 	// Returns simulated packet loss.
 	const float getNetSimulatedPacketLoss(void) const;
 
+	// Returns true if network matches should use rollback instead of 
+	// server updates and reconciliation.
+	const bool useRollback(void) const;
+
+	// Returns the maximum number of frames a rollback match can rewind.
+	const Uint32 getRollbackFrames(void) const;
+
+	// Returns true if network matches should use delay-based lockstep 
+	// (ignored if rollback is enabled).
+	const bool useLockstep(void) const;
+
+	// Returns the number of ticks a lockstep match delays local input.
+	const Uint32 getInputDelay(void) const;
+
+	// Returns true if the server sends world snapshots, i.e., the 
+	// playing peers aren't simulating the match themselves.
+	const bool useServerUpdates(void) const;
+
 	// Returns last error.
 	const int getError(void) const;
 
@@ -141,6 +159,16 @@ private:
 	Uint32 m_simulatedPing;
 
 	float m_simulatedPacketLoss;
+
+	// Rollback netcode.
+	bool m_useRollback;
+
+	Uint32 m_rollbackFrames;
+
+	// Lockstep netcode.
+	bool m_useLockstep;
+
+	Uint32 m_inputDelay;
 };
 
 // ================================================ //
@@ -179,6 +207,26 @@ inline const float Game::getNetSimulatedPacketLoss(void) const{
 	return m_simulatedPacketLoss;
 }
 
+inline const bool Game::useRollback(void) const{
+	return m_useRollback;
+}
+
+inline const Uint32 Game::getRollbackFrames(void) const{
+	return m_rollbackFrames;
+}
+
+inline const bool Game::useLockstep(void) const{
+	return m_useLockstep;
+}
+
+inline const Uint32 Game::getInputDelay(void) const{
+	return m_inputDelay;
+}
+
+inline const bool Game::useServerUpdates(void) const{
+	return !(m_useRollback || m_useLockstep);
+}
+
 inline const int Game::getError(void) const{
 	return m_error;
 }
@@ -39,6 +39,13 @@
 #include "Game.hpp"
 #include "Timer.hpp"
 #include "Camera.hpp"
+#include "RollbackSession.hpp"
+#include "LockstepSession.hpp"
+#include "SnapshotBuffer.hpp"
+#include "SimClock.hpp"
+#include "PacketDispatcher.hpp"
+#include "SpectatorChannel.hpp"
+#include "AssetLoader.hpp"
 
 // ================================================ //
 
@@ -46,8 +53,13 @@ GameState::GameState(void) :
 m_pObjectManager(new ObjectManager()),
 m_pGUI(nullptr),
 m_pServerUpdateTimer(new Timer()),
-m_pResetServerInputTimer(new Timer())
+m_pResetServerInputTimer(new Timer()),
+m_pPackets(new PacketDispatcher()),
+m_loading(false)
 {
+	m_pRemoteSnapshots[0].reset(new SnapshotBuffer());
+	m_pRemoteSnapshots[1].reset(new SnapshotBuffer());
+
 	Config c(Engine::getSingletonPtr()->getSettingsFile());
 	m_pGUI.reset(new GUIGameState(Engine::getSingletonPtr()->getDataDirectory() + 
 		"/" + c.parseValue("GUI", "gamestate")));
@@ -66,6 +78,21 @@ void GameState::enter(void)
 {
 	Log::getSingletonPtr()->logMessage("Entering GameState...");
 
+	m_pRemoteSnapshots[0]->reset();
+	m_pRemoteSnapshots[1]->reset();
+	this->registerPacketHandlers();
+
+	m_loading = StageManager::getSingletonPtr()->isLoading() || 
+		PlayerManager::getSingletonPtr()->isLoading();
+	if (!m_loading){
+		this->start();
+	}
+}
+
+// ================================================ //
+
+void GameState::start(void)
+{
 	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
 		m_pServerUpdateTimer->restart();
 		m_pResetServerInputTimer->restart();
@@ -85,9 +112,126 @@ void GameState::enter(void)
 
 // ================================================ //
 
+void GameState::updateLoading(void)
+{
+	SDL_Event e;
+	while (SDL_PollEvent(&e)){
+		if (e.type == SDL_QUIT){
+			m_quit = true;
+		}
+	}
+
+	// The MatchSim is created from the stage, so the Players can't be 
+	// created until it's loaded.
+	if (StageManager::getSingletonPtr()->updateLoading()){
+		switch (PlayerManager::getSingletonPtr()->updateLoading()){
+		default:
+		case PlayerManager::LOAD_PENDING:
+			break;
+
+		case PlayerManager::LOAD_DONE:
+			m_loading = false;
+			this->start();
+			return;
+
+		case PlayerManager::LOAD_FAILED:
+			Log::getSingletonPtr()->logMessage("ERROR: Failed to load match, leaving GameState");
+			m_loading = false;
+			m_quit = true;
+			return;
+		}
+	}
+
+	// Draw a progress bar across the middle of the screen.
+	const int w = Engine::getSingletonPtr()->getLogicalWindowWidth();
+	const int h = Engine::getSingletonPtr()->getLogicalWindowHeight();
+	SDL_Rect bar = { w / 8, (h / 2) - 8, (w * 3) / 4, 16 };
+	SDL_Renderer* pRenderer = Engine::getSingletonPtr()->getRenderer();
+
+	Engine::getSingletonPtr()->clearRenderer();
+
+	SDL_SetRenderDrawColor(pRenderer, 60, 60, 60, 255);
+	SDL_RenderFillRect(pRenderer, &bar);
+	bar.w = static_cast<int>(bar.w * AssetLoader::getSingletonPtr()->getProgress());
+	SDL_SetRenderDrawColor(pRenderer, 200, 200, 200, 255);
+	SDL_RenderFillRect(pRenderer, &bar);
+	SDL_SetRenderDrawColor(pRenderer, 0, 0, 0, 255);
+
+	Engine::getSingletonPtr()->renderPresent();
+}
+
+// ================================================ //
+
 void GameState::exit(void)
 {
 	Log::getSingletonPtr()->logMessage("Exiting GameState...");
+	m_pPackets->logStats("GameState");
+
+	// Report how much rollback the match needed.
+	if (PlayerManager::getSingletonPtr()->getRollbackSession() != nullptr){
+		const RollbackStats& stats = PlayerManager::getSingletonPtr()->getRollbackSession()->getStats();
+		Log::getSingletonPtr()->logMessage("Rollback stats: " + Engine::toString(stats.rollbacks) + 
+			" rollbacks, max depth " + Engine::toString(stats.maxDepth) + 
+			", " + Engine::toString(stats.resimulatedFrames) + " frames resimulated in " +
+			Engine::toString(stats.totalResimTime) + "us (max " + Engine::toString(stats.maxResimTime) + 
+			"us), " + Engine::toString(stats.stalls) + " stalls");
+	}
+
+	// Report how long the lockstep match waited on the other peer.
+	if (PlayerManager::getSingletonPtr()->getLockstepSession() != nullptr){
+		const LockstepStats& stats = PlayerManager::getSingletonPtr()->getLockstepSession()->getStats();
+		Log::getSingletonPtr()->logMessage("Lockstep stats: " + Engine::toString(stats.frames) + 
+			" frames, " + Engine::toString(stats.stalls) + " stalls, longest wait " + 
+			Engine::toString(stats.maxStallRun) + " updates");
+	}
+
+	// Report the clock sync estimate.
+	if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
+		const ClockSync& clock = Client::getSingletonPtr()->getClock();
+		Log::getSingletonPtr()->logMessage("Clock sync: RTT " + Engine::toString(clock.getRTT() / 1000) + 
+			"ms, offset " + Engine::toString(clock.getOffset() / 1000) + "ms, " + 
+			Engine::toString(clock.getSamples()) + " samples");
+	}
+
+	// Report how far behind the other fighters were rendered.
+	if (Game::getSingletonPtr()->getMode() == Game::CLIENT && Game::getSingletonPtr()->useServerUpdates()){
+		const std::string names[2] = { "red", "blue" };
+		const int playing[2] = { Game::PLAYING_RED, Game::PLAYING_BLUE };
+		for (int i = 0; i < 2; ++i){
+			if (Game::getSingletonPtr()->getPlaying() == playing[i]){
+				continue;
+			}
+			Log::getSingletonPtr()->logMessage("Interpolation stats (" + names[i] + "): delay " + 
+				Engine::toString(static_cast<int>(m_pRemoteSnapshots[i]->getDelay() * 1000.0)) + "ms, jitter " + 
+				Engine::toString(static_cast<int>(m_pRemoteSnapshots[i]->getJitter() * 1000.0)) + "ms, " + 
+				Engine::toString(m_pRemoteSnapshots[i]->getUnderruns()) + " underruns");
+		}
+	}
+
+	// Report the bandwidth snapshots used.
+	if (Game::getSingletonPtr()->getMode() == Game::SERVER && Game::getSingletonPtr()->useServerUpdates()){
+		Log::getSingletonPtr()->logMessage("Snapshot stats: " + 
+			SnapshotChannel::FormatStats(Server::getSingletonPtr()->getSnapshotStats()));
+		Log::getSingletonPtr()->logMessage("Spectator stats: " + 
+			SpectatorChannel::FormatStats(Server::getSingletonPtr()->getSpectatorStats()));
+
+		const RakNet::SystemAddress addrs[2] = { Server::getSingletonPtr()->m_redAddr, 
+			Server::getSingletonPtr()->m_blueAddr };
+		const std::string names[2] = { "red", "blue" };
+		for (int i = 0; i < 2; ++i){
+			if (addrs[i] != RakNet::UNASSIGNED_SYSTEM_ADDRESS){
+				Log::getSingletonPtr()->logMessage("Snapshot rate (" + names[i] + "): " + 
+					SnapshotRate::FormatStats(Server::getSingletonPtr()->getSnapshotRateStats(addrs[i])));
+			}
+		}
+
+		const MatchSim* pSim = PlayerManager::getSingletonPtr()->getMatchSim();
+		if (pSim != nullptr){
+			Log::getSingletonPtr()->logMessage("Lag compensation: window " + 
+				Engine::toString((pSim->getConfig().lagCompensationTicks * 1000) / MatchSim::TickRate) + "ms, " + 
+				Engine::toString(pSim->getCompensatedHits()) + " hits compensated");
+		}
+	}
 }
 
 // ================================================ //
@@ -142,37 +286,22 @@ void GameState::handleInputDt(SDL_Event& e, double dt)
 
 				case Input::BUTTON_LEFT:
 					PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_LEFT, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_LEFT, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_RIGHT:
 					PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_RIGHT, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_RIGHT, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_UP:
 					PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_UP, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_UP, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_DOWN:
 					PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_DOWN, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_DOWN, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_LP:
 					PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_LP, true);					
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_LP, true, dt);
-					}
 					break;
 				}
 			}
@@ -189,37 +318,22 @@ void GameState::handleInputDt(SDL_Event& e, double dt)
 
 				case Input::BUTTON_LEFT:
 					PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_LEFT, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_LEFT, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_RIGHT:
 					PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_RIGHT, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_RIGHT, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_UP:
 					PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_UP, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_UP, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_DOWN:
 					PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_DOWN, true);
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_DOWN, true, dt);
-					}
 					break;
 
 				case Input::BUTTON_LP:
 					PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_LP, true);					
-					if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-						Client::getSingletonPtr()->sendInput(Input::BUTTON_LP, true, dt);
-					}
 					break;
 				}
 			}
@@ -253,13 +367,10 @@ void GameState::handleInputDt(SDL_Event& e, double dt)
 
 		case SDLK_t:
 			if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-				RakNet::BitStream bit;
-				bit.Write(static_cast<RakNet::MessageID>(NetMessage::SYSTEM_MESSAGE));
-				RakNet::Time time = RakNet::GetTime();
-				printf("Local time: %d\n", time);
-				bit.Write(time);
-
-				Client::getSingletonPtr()->send(bit, HIGH_PRIORITY, RELIABLE);
+				const ClockSync& clock = Client::getSingletonPtr()->getClock();
+				printf("Server tick: %u, RTT: %lldus, offset: %lldus (%u samples)\n", 
+					   Client::getSingletonPtr()->getServerTick(), static_cast<long long>(clock.getRTT()), 
+					   static_cast<long long>(clock.getOffset()), clock.getSamples());
 			}
 			break;
 
@@ -311,38 +422,23 @@ void GameState::handleInputDt(SDL_Event& e, double dt)
 
 			case Input::BUTTON_LEFT:
 				PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_LEFT, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_LEFT, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_RIGHT:
 				PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_RIGHT, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_RIGHT, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_UP:
 				PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_UP, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_UP, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_DOWN:
 				PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_DOWN, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_DOWN, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_LP:
 				PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(Input::BUTTON_LP, false);
 				PlayerManager::getSingletonPtr()->getRedPlayerInput()->setReactivated(Input::BUTTON_LP, true);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_LP, false, dt);
-				}
 				break;
 			}
 		}
@@ -356,38 +452,23 @@ void GameState::handleInputDt(SDL_Event& e, double dt)
 
 			case Input::BUTTON_LEFT:
 				PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_LEFT, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_LEFT, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_RIGHT:
 				PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_RIGHT, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_RIGHT, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_UP:
 				PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_UP, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_UP, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_DOWN:
 				PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_DOWN, false);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_DOWN, false, dt);
-				}
 				break;
 
 			case Input::BUTTON_LP:
 				PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(Input::BUTTON_LP, false);
 				PlayerManager::getSingletonPtr()->getBluePlayerInput()->setReactivated(Input::BUTTON_LP, true);
-				if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-					Client::getSingletonPtr()->sendInput(Input::BUTTON_LP, false, dt);
-				}
 				break;
 			}
 		}
@@ -502,6 +583,11 @@ void GameState::update(double dt)
 		return;
 	}
 
+	if (m_loading){
+		this->updateLoading();
+		return;
+	}
+
 	SDL_Event e;
 
 	while (SDL_PollEvent(&e)){
@@ -560,411 +646,305 @@ void GameState::update(double dt)
 	Engine::getSingletonPtr()->clearRenderer();
 
 	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
-		for (Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->m_peer->Receive();
+		for (Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->getTransport()->receive();
 			Server::getSingletonPtr()->m_packet;
-			Server::getSingletonPtr()->m_peer->DeallocatePacket(Server::getSingletonPtr()->m_packet),
-			Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->m_peer->Receive()){
-			switch (Server::getSingletonPtr()->getPacket()->data[0]){
-			default:
-				break;
-
-			case ID_DISCONNECTION_NOTIFICATION:
-				if (Server::getSingletonPtr()->isClientConnected(Server::getSingletonPtr()->m_packet->systemAddress)){
-					std::string username = Server::getSingletonPtr()->m_clients[Server::getSingletonPtr()->getClient(
-						Server::getSingletonPtr()->m_packet->systemAddress)].username;
-					Log::getSingletonPtr()->logMessage("SERVER: Removing client [" +
-						std::string(Server::getSingletonPtr()->m_packet->systemAddress.ToString()) + "]");
-					Server::getSingletonPtr()->removeFromReadyQueue(username);
-					Server::getSingletonPtr()->removeClient(Server::getSingletonPtr()->m_packet->systemAddress);
-
-					// Send match over packet with proper victor.
-					if (Server::getSingletonPtr()->m_packet->systemAddress == Server::getSingletonPtr()->m_redAddr){
-						// Tell clients the player disconnected before sending match over packet.
-						RakNet::BitStream bit;
-						bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_DISCONNECTED));
-						bit.Write(username.c_str());
-						Server::getSingletonPtr()->broadcast(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
-
-						// Blue is victor now.
-						Server::getSingletonPtr()->matchOver(Game::getSingletonPtr()->getBluePlayerName());
-					}
-					else if (Server::getSingletonPtr()->m_packet->systemAddress == Server::getSingletonPtr()->m_blueAddr){
-						RakNet::BitStream bit;
-						bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_DISCONNECTED));
-						bit.Write(username.c_str());
-						Server::getSingletonPtr()->broadcast(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
-						
-						// Red is victor.
-						Server::getSingletonPtr()->matchOver(Game::getSingletonPtr()->getRedPlayerName());
-					}
-				}
-				break;
-
-			case ID_CONNECTION_LOST:
-				{
-					std::string username = Server::getSingletonPtr()->m_clients[Server::getSingletonPtr()->getClient(
-						Server::getSingletonPtr()->m_packet->systemAddress)].username;
-					Log::getSingletonPtr()->logMessage("SERVER: Removing client [" +
-						std::string(Server::getSingletonPtr()->m_packet->systemAddress.ToString()) + "]");
-					Server::getSingletonPtr()->removeFromReadyQueue(username);
-					Server::getSingletonPtr()->removeClient(Server::getSingletonPtr()->m_packet->systemAddress);
-					
-					// Send match over packet with proper victor.
-					if (Server::getSingletonPtr()->m_packet->systemAddress == Server::getSingletonPtr()->m_redAddr){
-						// Tell clients the player lost connection before sending match over packet.
-						RakNet::BitStream bit;
-						bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_DISCONNECTED));
-						bit.Write(username.c_str());
-						Server::getSingletonPtr()->broadcast(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
-
-						// Blue is victor now.
-						Server::getSingletonPtr()->matchOver(Game::getSingletonPtr()->getBluePlayerName());
-					}
-					else if (Server::getSingletonPtr()->m_packet->systemAddress == Server::getSingletonPtr()->m_blueAddr){
-						RakNet::BitStream bit;
-						bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_DISCONNECTED));
-						bit.Write(username.c_str());
-						Server::getSingletonPtr()->broadcast(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
-
-						// Red is victor.
-						Server::getSingletonPtr()->matchOver(Game::getSingletonPtr()->getRedPlayerName());
-					}
-				}
-				break;
-
-			case NetMessage::SYSTEM_MESSAGE:
-				{
-					RakNet::BitStream bit(Server::getSingletonPtr()->getPacket()->data,
-									  Server::getSingletonPtr()->getPacket()->length,
-									  false);
-					bit.IgnoreBytes(sizeof(RakNet::MessageID));
-					RakNet::Time time;
-					bit.Read(time);
-
-					printf("Client time: %d\n", time);
-				}
-				break;
-
-			case NetMessage::CLIENT_INPUT:
-				// Verify this message is from a playing client (not spectating).
-				if (Server::getSingletonPtr()->getPacket()->systemAddress == Server::getSingletonPtr()->m_redAddr ||
-					Server::getSingletonPtr()->getPacket()->systemAddress == Server::getSingletonPtr()->m_blueAddr){
-					// Read in the NetInput struct from client.
-					RakNet::BitStream bit(Server::getSingletonPtr()->getPacket()->data, 
-						Server::getSingletonPtr()->getPacket()->length, false);
-					bit.IgnoreBytes(sizeof(RakNet::MessageID));
-					Client::NetInput netInput;
-					bit.Read(netInput);
-					Uint32 stageShiftSeq = Server::getSingletonPtr()->m_lastProcessedStageShift;
-					bit.Read(stageShiftSeq);
-					Server::getSingletonPtr()->m_lastProcessedStageShift = stageShiftSeq;
-					
-					// Apply the NetInput struct to the proper player.
-					if (Server::getSingletonPtr()->validateInput(netInput)){
-						if (Server::getSingletonPtr()->getPacket()->systemAddress == Server::getSingletonPtr()->m_redAddr){
-							PlayerManager::getSingletonPtr()->getRedPlayerInput()->setButton(netInput.input, netInput.value);
-							if (netInput.value == false){
-								PlayerManager::getSingletonPtr()->getRedPlayerInput()->setReactivated(netInput.input, true);
-							}
-							// Note: I previously processed input and applied it ONLY here, and didn't call Player::update()
-							// in PlayerManager::update(). I don't remember the exact reason, but now I do the opposite.
-							Server::getSingletonPtr()->m_redLastProcessedInput = netInput.seq;
-						}
-						else if (Server::getSingletonPtr()->getPacket()->systemAddress == Server::getSingletonPtr()->m_blueAddr){
-							PlayerManager::getSingletonPtr()->getBluePlayerInput()->setButton(netInput.input, netInput.value);
-							if (netInput.value == false){
-								PlayerManager::getSingletonPtr()->getBluePlayerInput()->setReactivated(netInput.input, true);
-							}
-							Server::getSingletonPtr()->m_blueLastProcessedInput = netInput.seq;
-						}
-					}
-				}
-				break;
-			}
+			Server::getSingletonPtr()->getTransport()->deallocatePacket(Server::getSingletonPtr()->m_packet),
+			Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->getTransport()->receive()){
+			m_pPackets->dispatch(Server::getSingletonPtr()->getPacket());
 		}
 
-		// Broadcast player updates to all client.
-		if (m_pServerUpdateTimer->getTicks() > Server::getSingletonPtr()->getTickRate()){			
-			switch (PlayerManager::getSingletonPtr()->getRedPlayer()->getCurrentState()){
-			default:
-				Server::getSingletonPtr()->updateRedPlayer(
-					Game::getSingletonPtr()->getPlaying() == Game::PLAYING_RED);
-				break;
-
-			case Player::State::ATTACK_LP:
-			case Player::State::JUMPING:
-			case Player::State::STUNNED_JUMP:
-				// Only update if the server is playing.
-				if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_RED){
-					Server::getSingletonPtr()->updateRedPlayer(true);
-				}
-				break;
-			}
-			switch(PlayerManager::getSingletonPtr()->getBluePlayer()->getCurrentState()){
-			default:
-				Server::getSingletonPtr()->updateBluePlayer(
-					Game::getSingletonPtr()->getPlaying() == Game::PLAYING_BLUE);
-				break;
-
-			case Player::State::ATTACK_LP:
-			case Player::State::JUMPING:
-				if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_BLUE){
-					Server::getSingletonPtr()->updateBluePlayer(true);
-				}
-				break;
-			}
-
-			//Server::getSingletonPtr()->updatePlayers();
+		// Offer a snapshot of the tick to every client. Rollback and lockstep peers simulate the match themselves.
+		if (Game::getSingletonPtr()->useServerUpdates() && 
+			m_pServerUpdateTimer->getTicks() > Server::getSingletonPtr()->getUpdateInterval()){
+			Server::getSingletonPtr()->sendSnapshot();
 			m_pServerUpdateTimer->restart();
 		}
 
 		// Ensure client is synced every so often.
-		if (m_pResetServerInputTimer->getTicks() > 3000){
+		if (Game::getSingletonPtr()->useServerUpdates() && m_pResetServerInputTimer->getTicks() > 3000){
 			Server::getSingletonPtr()->sendLastProcessedInput();
-			Server::getSingletonPtr()->panCamera();
 			m_pResetServerInputTimer->restart();
 		}
 	}
 	else if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
-		if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_RED){
-			if (PlayerManager::getSingletonPtr()->getRedPlayerInput()->getButton(Input::BUTTON_LEFT) == true){
-				Client::getSingletonPtr()->sendInput(Input::BUTTON_LEFT, true, dt);
-			}
-			if (PlayerManager::getSingletonPtr()->getRedPlayerInput()->getButton(Input::BUTTON_RIGHT) == true){
-				Client::getSingletonPtr()->sendInput(Input::BUTTON_RIGHT, true, dt);
-			}
+		Client::getSingletonPtr()->updateClock();
+
+		if (!Game::getSingletonPtr()->useServerUpdates()){
+			// Inputs are sent each tick by PlayerManager.
+		}
+		// Send every held button once per tick.
+		else if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_RED){
+			Client::getSingletonPtr()->updateInput(PlayerManager::getSingletonPtr()->getRedPlayerInput()->getSimInput(), dt);
 		}
 		else if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_BLUE){
-			if (PlayerManager::getSingletonPtr()->getBluePlayerInput()->getButton(Input::BUTTON_LEFT) == true){
-				Client::getSingletonPtr()->sendInput(Input::BUTTON_LEFT, true, dt);
-			}
-			if (PlayerManager::getSingletonPtr()->getBluePlayerInput()->getButton(Input::BUTTON_RIGHT) == true){
-				Client::getSingletonPtr()->sendInput(Input::BUTTON_RIGHT, true, dt);
-			}
+			Client::getSingletonPtr()->updateInput(PlayerManager::getSingletonPtr()->getBluePlayerInput()->getSimInput(), dt);
 		}
 
 		//printf("%d unprocessed inputs / %d\n", Client::getSingletonPtr()->m_pendingInputs.size(), 
 			//(Client::getSingletonPtr()->m_pendingInputs.size() == 0) ? 0 : Client::getSingletonPtr()->m_pendingInputs.front().seq);
 
-		for (Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->m_peer->Receive();
+		for (Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->getTransport()->receive();
 			Client::getSingletonPtr()->m_packet;
-			Client::getSingletonPtr()->m_peer->DeallocatePacket(Client::getSingletonPtr()->m_packet),
-			Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->m_peer->Receive()){
+			Client::getSingletonPtr()->getTransport()->deallocatePacket(Client::getSingletonPtr()->m_packet),
+			Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->getTransport()->receive()){
 			if (Client::getSingletonPtr()->update() == false){
-				switch (Client::getSingletonPtr()->getPacket()->data[0]){
-				default:
-					break;
+				m_pPackets->dispatch(Client::getSingletonPtr()->getPacket());
+			}
+		}
 
-				case NetMessage::UPDATE_RED_PLAYER:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length, false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Server::PlayerUpdate red;
-						bit.Read(red);
-						if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_RED){
-							PlayerManager::getSingletonPtr()->getRedPlayer()->updateFromServer(red);
-						}
-						// Otherwise, update player directly.
-						else{
-							Player* redPlayer = PlayerManager::getSingletonPtr()->getRedPlayer();
-							redPlayer->setPosition(red.x, red.y);
-							redPlayer->setCurrentState(red.state);			
-						}
-					}
-					break;
+		// Local time (seconds) for interpolating snapshots.
+		const double now = static_cast<double>(SimClock::now()) / 1000000.0;
+		Player* players[2] = { PlayerManager::getSingletonPtr()->getRedPlayer(),
+			PlayerManager::getSingletonPtr()->getBluePlayer() };
+		const int playing[2] = { Game::PLAYING_RED, Game::PLAYING_BLUE };
+
+		// Render the other fighters slightly in the past, between the two snapshots around that time.
+		for (int i = 0; i < 2; ++i){
+			Server::PlayerUpdate update;
+			if (Game::getSingletonPtr()->getPlaying() == playing[i] ||
+				!m_pRemoteSnapshots[i]->sample(now, update)){
+				continue;
+			}
 
-				case NetMessage::UPDATE_BLUE_PLAYER:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length, false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Server::PlayerUpdate blue;
-						bit.Read(blue);
-						if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_BLUE){
-							PlayerManager::getSingletonPtr()->getBluePlayer()->updateFromServer(blue);
-						}
-						else{
-							Player* bluePlayer = PlayerManager::getSingletonPtr()->getBluePlayer();
-							bluePlayer->setPosition(blue.x, blue.y);
-							bluePlayer->setCurrentState(blue.state);							
-						}
-					}
-					break;
+			Player* pPlayer = players[i];
+			if ((update.state == Player::State::STUNNED_HIT || update.state == Player::State::STUNNED_BLOCK) &&
+				pPlayer->getCurrentState() != update.state){
+				pPlayer->setStun(update.stun);
+			}
+			pPlayer->setPosition(update.x, update.y);
+			pPlayer->setCurrentState(update.state);
+			if (pPlayer->getCurrentHP() != update.hp){
+				pPlayer->updateHP(update.hp);
+			}
 
-				case NetMessage::UPDATE_PLAYERS:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length, false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Server::PlayerUpdate red;
-						bit.Read(red);
-						Server::PlayerUpdate blue;
-						bit.Read(blue);
-
-						// If this client is playing, enqueue this input for processing.
-						if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_RED){
-							PlayerManager::getSingletonPtr()->getRedPlayer()->updateFromServer(red);
-						}
-						// Otherwise, update player directly.
-						else{
-							Player* redPlayer = PlayerManager::getSingletonPtr()->getRedPlayer();
-							redPlayer->setPosition(red.x, red.y);
-							redPlayer->setCurrentState(red.state);
-							
-
-							// Re-apply player shifts.
-							/*for (std::list<Client::StageShift>::iterator itr = Client::getSingletonPtr()->m_pendingStageShifts.begin();
-								 itr != Client::getSingletonPtr()->m_pendingStageShifts.end();
-								 ++itr){
-								SDL_Rect pos = redPlayer->getPosition();
-								pos.x += itr->playerShift;
-								redPlayer->setPosition(pos);
-							}*/
-						}
-						
-						if (Game::getSingletonPtr()->getPlaying() == Game::PLAYING_BLUE){
-							PlayerManager::getSingletonPtr()->getBluePlayer()->updateFromServer(blue);
-						}
-						else{
-							Player* bluePlayer = PlayerManager::getSingletonPtr()->getBluePlayer();
-							bluePlayer->setPosition(blue.x, blue.y);
-							bluePlayer->setCurrentState(blue.state);
-
-							// Re-apply player shifts.
-							/*for (std::list<Client::StageShift>::iterator itr = Client::getSingletonPtr()->m_pendingStageShifts.begin();
-								 itr != Client::getSingletonPtr()->m_pendingStageShifts.end();
-								 ++itr){
-								SDL_Rect pos = bluePlayer->getPosition();
-								pos.x += itr->playerShift;
-								bluePlayer->setPosition(pos);
-							}*/
-						}
-					}
-					break;
+			// Tell the server where this client's hits should be tested.
+			Client::getSingletonPtr()->setViewTick(m_pRemoteSnapshots[i]->getRenderTick());
+		}
+	}
 
-				case NetMessage::PAN_CAMERA:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length,
-											  false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						int panX = 0;
-						bit.Read(panX);
-						Camera::getSingletonPtr()->panX(panX);
-					}
-					break;
+	// Update and render all game objects and players.
+	StageManager::getSingletonPtr()->update(dt);
+	m_pObjectManager->update(dt);
+	m_pGUI->update(dt);
+	PlayerManager::getSingletonPtr()->update(dt);
 
-				case NetMessage::LAST_PROCESSED_INPUT_SEQUENCE:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length, 
-											  false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Uint32 lastProcessedInput = 0;
-						bit.Read(lastProcessedInput);
-						for (Client::ClientInputList::iterator itr = Client::getSingletonPtr()->m_pendingInputs.begin();
-							itr != Client::getSingletonPtr()->m_pendingInputs.end();){
-							if (itr->seq <= lastProcessedInput){
-								itr = Client::getSingletonPtr()->m_pendingInputs.erase(itr);
-							}
-							else{
-								++itr;
-							}
-						}
-					}
-					break;
+	Engine::getSingletonPtr()->renderPresent();
+}
 
-				case NetMessage::RED_TAKE_HIT:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length,
-											  false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Uint32 hp = 0, stun = 0;
-						bit.Read(hp);
-						bit.Read(stun);
-						PlayerManager::getSingletonPtr()->getRedPlayer()->setStun(stun);
-						PlayerManager::getSingletonPtr()->getRedPlayer()->setCurrentState(Player::State::STUNNED_HIT);
-						PlayerManager::getSingletonPtr()->getRedPlayer()->updateHP(hp);
-					}
-					break;
+// ================================================ //
 
-				case NetMessage::BLUE_TAKE_HIT:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length,
-											  false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Uint32 hp = 0, stun = 0;
-						bit.Read(hp);
-						bit.Read(stun);
-						PlayerManager::getSingletonPtr()->getBluePlayer()->setStun(stun);
-						PlayerManager::getSingletonPtr()->getBluePlayer()->setCurrentState(Player::State::STUNNED_HIT);
-						PlayerManager::getSingletonPtr()->getBluePlayer()->updateHP(hp);
-					}
-					break;
+void GameState::registerPacketHandlers(void)
+{
+	using std::placeholders::_1;
 
-				case NetMessage::RED_TAKE_HIT_BLOCK:			
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length,
-											  false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Uint32 stun = 0;
-						bit.Read(stun);
-						PlayerManager::getSingletonPtr()->getRedPlayer()->setStun(stun);
-						PlayerManager::getSingletonPtr()->getRedPlayer()->setCurrentState(Player::State::STUNNED_BLOCK);
-					}
-					break;
+	m_pPackets->clear();
+	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
+		m_pPackets->registerHandler(ID_DISCONNECTION_NOTIFICATION, "ID_DISCONNECTION_NOTIFICATION", 
+									std::bind(&GameState::handleClientLeft, this, _1));
+		m_pPackets->registerHandler(ID_CONNECTION_LOST, "ID_CONNECTION_LOST", 
+									std::bind(&GameState::handleClientLeft, this, _1));
+		m_pPackets->registerHandler(NetMessage::CLOCK_PING, "CLOCK_PING", 
+									std::bind(&GameState::handleClockPing, this, _1));
+		m_pPackets->registerHandler(NetMessage::CLIENT_INPUT, "CLIENT_INPUT", 
+									std::bind(&GameState::handleClientInput, this, _1));
+		m_pPackets->registerHandler(NetMessage::SNAPSHOT_ACK, "SNAPSHOT_ACK", 
+									std::bind(&GameState::handleSnapshotAck, this, _1));
+		m_pPackets->registerHandler(NetMessage::PEER_INPUT, "PEER_INPUT", 
+									std::bind(&GameState::handlePeerInput, this, _1));
+	}
+	else if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
+		m_pPackets->registerHandler(NetMessage::WORLD_SNAPSHOT, "WORLD_SNAPSHOT", 
+									std::bind(&GameState::handleWorldSnapshot, this, _1));
+		m_pPackets->registerHandler(NetMessage::SPECTATOR_BATCH, "SPECTATOR_BATCH", 
+									std::bind(&GameState::handleSpectatorBatch, this, _1));
+		m_pPackets->registerHandler(NetMessage::LAST_PROCESSED_INPUT_SEQUENCE, "LAST_PROCESSED_INPUT_SEQUENCE", 
+									std::bind(&GameState::handleLastProcessedInput, this, _1));
+		m_pPackets->registerHandler(NetMessage::PEER_INPUT, "PEER_INPUT", 
+									std::bind(&GameState::handlePeerInput, this, _1));
+		m_pPackets->registerHandler(NetMessage::MATCH_OVER, "MATCH_OVER", 
+									std::bind(&GameState::handleMatchOver, this, _1));
+	}
+}
 
-				case NetMessage::BLUE_TAKE_HIT_BLOCK:					
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length,
-											  false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						Uint32 stun = 0;
-						bit.Read(stun);
-						PlayerManager::getSingletonPtr()->getBluePlayer()->setStun(stun);
-						PlayerManager::getSingletonPtr()->getBluePlayer()->setCurrentState(Player::State::STUNNED_BLOCK);
-					}
-					break;
+// ================================================ //
 
-				case NetMessage::MATCH_OVER:
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											  Client::getSingletonPtr()->getPacket()->length, 
-											  false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-
-						RakNet::RakString victor;
-						bit.Read(victor);
-						printf("%s wins!\n", victor.C_String());
-						m_quit = true;
-					}
-					break;
-				}
-			}
+void GameState::handleClientLeft(PacketView& view)
+{
+	if (!Server::getSingletonPtr()->isClientConnected(view.getAddress())){
+		return;
+	}
+
+	const std::string username = Server::getSingletonPtr()->m_clients[Server::getSingletonPtr()->getClient(
+		view.getAddress())].username;
+	Log::getSingletonPtr()->logMessage("SERVER: Removing client [" + std::string(view.getAddress().ToString()) + "]");
+	Server::getSingletonPtr()->removeFromReadyQueue(username);
+	Server::getSingletonPtr()->removeClient(view.getAddress());
+
+	// Only a playing client ends the match.
+	const bool red = (view.getAddress() == Server::getSingletonPtr()->m_redAddr);
+	if (!red && view.getAddress() != Server::getSingletonPtr()->m_blueAddr){
+		return;
+	}
+
+	// Tell clients the player left before sending match over packet.
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_DISCONNECTED));
+	bit.Write(username.c_str());
+	Server::getSingletonPtr()->broadcast(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
+
+	// The other player is victor now.
+	Server::getSingletonPtr()->matchOver((red) ? Game::getSingletonPtr()->getBluePlayerName() :
+										 Game::getSingletonPtr()->getRedPlayerName());
+}
+
+// ================================================ //
+
+void GameState::handleClockPing(PacketView& view)
+{
+	Server::getSingletonPtr()->sendClockPong(view.getPacket(), PlayerManager::getSingletonPtr()->getMatchSim()->getTick());
+}
+
+// ================================================ //
+
+void GameState::handleClientInput(PacketView& view)
+{
+	// Verify this message is from a playing client (not spectating).
+	const bool red = (view.getAddress() == Server::getSingletonPtr()->m_redAddr);
+	if (!red && view.getAddress() != Server::getSingletonPtr()->m_blueAddr){
+		return;
+	}
+
+	InputQueue& queue = (red) ? Server::getSingletonPtr()->m_redInputs : 
+		Server::getSingletonPtr()->m_blueInputs;
+
+	// Read the ticks not seen yet, so redundant copies of earlier ticks are skipped.
+	Client::NetInput inputs[Client::InputRedundancy];
+	Uint32 stageShiftSeq = Server::getSingletonPtr()->m_lastProcessedStageShift;
+	const int count = Client::ReadInputs(view.getPacket(), queue.getLastReceived(), inputs, stageShiftSeq);
+	if (count > 0){
+		Server::getSingletonPtr()->m_lastProcessedStageShift = stageShiftSeq;
+	}
+
+	// Queue them in order; PlayerManager::updateSim() applies one per tick. 
+	// Note: I previously processed input and applied it ONLY here, and didn't
+	// call Player::update() in PlayerManager::update(). I don't remember the exact reason, but now I do the opposite.
+	for (int i = 0; i < count; ++i){
+		if (Server::getSingletonPtr()->validateInput(inputs[i])){
+			queue.push(inputs[i].seq, inputs[i].buttons, inputs[i].viewTick);
 		}
 	}
+}
 
-	// Update and render all game objects and players.
-	StageManager::getSingletonPtr()->update(dt);
-	m_pObjectManager->update(dt);
-	m_pGUI->update(dt);
-	PlayerManager::getSingletonPtr()->update(dt);
+// ================================================ //
 
-	Engine::getSingletonPtr()->renderPresent();
+void GameState::handleSnapshotAck(PacketView& view)
+{
+	Server::getSingletonPtr()->ackSnapshot(view.getPacket());
+}
+
+// ================================================ //
+
+void GameState::handlePeerInput(PacketView& view)
+{
+	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
+		if (view.getAddress() != Server::getSingletonPtr()->m_redAddr &&
+			view.getAddress() != Server::getSingletonPtr()->m_blueAddr){
+			return;
+		}
+
+		// Relay the input to the other peer (and any spectators), then apply it if the server is the other peer.
+		Server::getSingletonPtr()->broadcast(view.getPacket(), HIGH_PRIORITY, RELIABLE_ORDERED, view.getAddress());
+	}
+
+	Uint32 frame = 0;
+	SimInput input = 0;
+	view.getBitStream().Read(frame);
+	view.getBitStream().Read(input);
+	PlayerManager::getSingletonPtr()->addPeerInput(frame, input);
+}
+
+// ================================================ //
+
+void GameState::handleWorldSnapshot(PacketView& view)
+{
+	WorldSnapshot snapshot;
+	if (Client::getSingletonPtr()->readSnapshot(view.getBitStream(), snapshot)){
+		this->applySnapshot(snapshot, static_cast<double>(SimClock::now()) / 1000000.0);
+	}
+}
+
+// ================================================ //
+
+void GameState::handleSpectatorBatch(PacketView& view)
+{
+	// The whole batch arrived at once; the buffers' jitter estimate absorbs the batch interval.
+	WorldSnapshot snapshots[SpectatorChannel::MaxBatch];
+	const int count = Client::getSingletonPtr()->readSpectatorBatch(view.getBitStream(), snapshots, 
+																	 SpectatorChannel::MaxBatch);
+	const double now = static_cast<double>(SimClock::now()) / 1000000.0;
+	for (int i = 0; i < count; ++i){
+		this->applySnapshot(snapshots[i], now);
+	}
+}
+
+// ================================================ //
+
+void GameState::applySnapshot(const WorldSnapshot& snapshot, const double now)
+{
+	Player* players[2] = { PlayerManager::getSingletonPtr()->getRedPlayer(),
+		PlayerManager::getSingletonPtr()->getBluePlayer() };
+	const int playing[2] = { Game::PLAYING_RED, Game::PLAYING_BLUE };
+
+	// The fighter this client plays is reconciled with the whole tick at once.
+	for (int i = 0; i < 2; ++i){
+		const Server::PlayerUpdate& update = snapshot.players[i];
+		Player* pPlayer = players[i];
+		if (Game::getSingletonPtr()->getPlaying() != playing[i]){
+			// Other fighters are rendered from the buffer in update().
+			m_pRemoteSnapshots[i]->push(snapshot.tick, update, now);
+			continue;
+		}
+
+		// A new hit or block starts the stun.
+		if ((update.state == Player::State::STUNNED_HIT || update.state == Player::State::STUNNED_BLOCK) &&
+			pPlayer->getCurrentState() != update.state){
+			pPlayer->setStun(update.stun);
+			pPlayer->setCurrentState(update.state);
+		}
+		pPlayer->updateFromServer(update);
+		if (pPlayer->getCurrentHP() != update.hp){
+			pPlayer->updateHP(update.hp);
+		}
+	}
+
+	if (Camera::getSingletonPtr()->getPanX() != snapshot.cameraPanX){
+		Camera::getSingletonPtr()->panX(snapshot.cameraPanX);
+	}
+}
+
+// ================================================ //
+
+void GameState::handleLastProcessedInput(PacketView& view)
+{
+	Uint32 lastProcessedInput = 0;
+	view.getBitStream().Read(lastProcessedInput);
+	for (Client::ClientInputList::iterator itr = Client::getSingletonPtr()->m_pendingInputs.begin();
+		itr != Client::getSingletonPtr()->m_pendingInputs.end();){
+		if (itr->seq <= lastProcessedInput){
+			itr = Client::getSingletonPtr()->m_pendingInputs.erase(itr);
+		}
+		else{
+			++itr;
+		}
+	}
+}
+
+// ================================================ //
+
+void GameState::handleMatchOver(PacketView& view)
+{
+	printf("%s wins!\n", view.readString().c_str());
+	m_quit = true;
 }
 
 // ================================================ //
\ No newline at end of file
@@ -33,6 +33,10 @@
 class ObjectManager;
 class GUI;
 class Timer;
+class SnapshotBuffer;
+class PacketDispatcher;
+class PacketView;
+struct WorldSnapshot;
 
 // ================================================ //
 
@@ -50,7 +54,9 @@ public:
 	// Registers this AppState.
 	DECLARE_APPSTATE_CLASS(GameState);
 
-	// Logs the entry.
+	// Logs the entry. Shows a loading screen until the stage and fighters
+	// from StageManager::loadAsync() and PlayerManager::loadAsync() are 
+	// loaded.
 	void enter(void);
 
 	// Logs the exit, sets m_quit to false to allow re-entry.
@@ -70,9 +76,48 @@ public:
 	void update(double dt);
 
 private:
+	// Sets up the GUI for the loaded Players.
+	void start(void);
+
+	// Finishes loading the stage, then the fighters, and renders the 
+	// loading screen.
+	void updateLoading(void);
+
+	// Registers the packet handlers for the current game mode.
+	void registerPacketHandlers(void);
+
+	// Server packet handlers. A playing client leaving ends the match.
+	void handleClientLeft(PacketView& view);
+	void handleClockPing(PacketView& view);
+	void handleClientInput(PacketView& view);
+	void handleSnapshotAck(PacketView& view);
+
+	// Relayed by the server to the other peer, and applied by both.
+	void handlePeerInput(PacketView& view);
+
+	// Client packet handlers.
+	void handleWorldSnapshot(PacketView& view);
+	void handleSpectatorBatch(PacketView& view);
+	void handleLastProcessedInput(PacketView& view);
+	void handleMatchOver(PacketView& view);
+
+	// Reconciles the fighter this client plays with a snapshot that arrived 
+	// at now (seconds), and buffers the others for interpolation.
+	void applySnapshot(const WorldSnapshot& snapshot, const double now);
+
 	std::shared_ptr<ObjectManager> m_pObjectManager;
 	std::shared_ptr<GUI> m_pGUI;
 	std::shared_ptr<Timer> m_pServerUpdateTimer, m_pResetServerInputTimer;
+
+	// Snapshots of the fighters this client doesn't play, rendered 
+	// interpolated (indexed by MatchSim::RED and MatchSim::BLUE).
+	std::shared_ptr<SnapshotBuffer> m_pRemoteSnapshots[2];
+
+	// Routes received packets to the handlers above.
+	std::shared_ptr<PacketDispatcher> m_pPackets;
+
+	// True until the stage and fighters are loaded.
+	bool m_loading;
 };
 
 // ================================================ //
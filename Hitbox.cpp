@@ -89,6 +89,7 @@ const bool Hitbox::intersects(const Hitbox* b)
 
 void Hitbox::render(void)
 {
+#ifndef DEDICATED_SERVER
 	// Render the inner translucent box.
 	SDL_SetRenderDrawBlendMode(Engine::getSingletonPtr()->getRenderer(), SDL_BLENDMODE_BLEND);
 	SDL_SetRenderDrawColor(Engine::getSingletonPtr()->getRenderer(), m_color.r, m_color.g, m_color.b, m_color.a);
@@ -97,6 +98,7 @@ void Hitbox::render(void)
 	// Render the opaque outline.
 	SDL_SetRenderDrawColor(Engine::getSingletonPtr()->getRenderer(), m_outline.r, m_outline.g, m_outline.b, 255);
 	SDL_RenderDrawRect(Engine::getSingletonPtr()->getRenderer(), &m_rc);
+#endif
 }
 
 // ================================================ //
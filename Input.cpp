@@ -50,6 +50,33 @@ Input::~Input(void)
 
 // ================================================ //
 
+const SimInput Input::getSimInput(void) const
+{
+	SimInput input = 0;
+	for (int i = 0; i < Input::NUM_BUTTONS; ++i){
+		if (m_buttons[i]){
+			input |= static_cast<SimInput>(1 << i);
+		}
+	}
+
+	return input;
+}
+
+// ================================================ //
+
+void Input::setSimInput(const SimInput input)
+{
+	for (int i = 0; i < Input::NUM_BUTTONS; ++i){
+		const bool state = ((input & (1 << i)) != 0);
+		if (m_buttons[i] && !state){
+			m_reactivated[i] = true;
+		}
+		m_buttons[i] = state;
+	}
+}
+
+// ================================================ //
+
 void Input::loadButtonMap(const std::string& file)
 {
 	Log::getSingletonPtr()->logMessage("Loading button map from \"" + file + "\"");
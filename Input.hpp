@@ -27,6 +27,7 @@
 // ================================================ //
 
 #include "stdafx.hpp"
+#include "SimTypes.hpp"
 
 // ================================================ //
 
@@ -81,6 +82,10 @@ public:
 	// Returns true if a button is reactivated.
 	const bool getReactivated(const int button) const;
 
+	// Returns the state of all buttons packed into a SimInput bitfield
+	// (bit n is set if button n is pressed).
+	const SimInput getSimInput(void) const;
+
 	// Returns the value of the mapped button. Returns the keyboard value if 
 	// gamepad is false, and the gamepad value if gamepad is true.
 	const ButtonValue getMappedButton(const int button, const bool gamepad = false) const;
@@ -107,6 +112,10 @@ public:
 	// Sets the state of a button.
 	void setButton(const int button, const bool state);
 
+	// Sets every button from a SimInput bitfield. Buttons that are released
+	// are marked as reactivated.
+	void setSimInput(const SimInput input);
+
 	// Sets the reactivation status of a button.
 	void setReactivated(const int button, const bool state);
 
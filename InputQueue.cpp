@@ -0,0 +1,91 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: InputQueue.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements InputQueue class.
+// ================================================ //
+
+#include "InputQueue.hpp"
+
+// ================================================ //
+
+InputQueue::InputQueue(void) :
+m_entries(),
+m_last(),
+m_lastReceived(0),
+m_numDropped(0)
+{
+	this->reset();
+}
+
+// ================================================ //
+
+InputQueue::~InputQueue(void)
+{
+
+}
+
+// ================================================ //
+
+void InputQueue::reset(void)
+{
+	m_entries.clear();
+	m_last.seq = 0;
+	m_last.buttons = 0;
+	m_last.viewTick = 0;
+	m_lastReceived = 0;
+	m_numDropped = 0;
+}
+
+// ================================================ //
+
+void InputQueue::push(const Uint32 seq, const SimInput buttons, const Uint32 viewTick)
+{
+	if (seq <= m_lastReceived){
+		return;
+	}
+	m_lastReceived = seq;
+
+	Entry entry;
+	entry.seq = seq;
+	entry.buttons = buttons;
+	entry.viewTick = viewTick;
+	m_entries.push_back(entry);
+
+	// Skip ahead rather than letting the client's inputs lag further behind.
+	while (m_entries.size() > static_cast<size_t>(InputQueue::MaxQueued)){
+		m_last = m_entries.front();
+		m_entries.pop_front();
+		++m_numDropped;
+	}
+}
+
+// ================================================ //
+
+const SimInput InputQueue::pop(void)
+{
+	if (!m_entries.empty()){
+		m_last = m_entries.front();
+		m_entries.pop_front();
+	}
+
+	return m_last.buttons;
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,124 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: InputQueue.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines InputQueue class.
+// ================================================ //
+
+#ifndef __INPUTQUEUE_HPP__
+#define __INPUTQUEUE_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+#include "SimTypes.hpp"
+
+// ================================================ //
+
+// Server-side queue of one client's inputs, one entry per client tick in 
+// seq order. Each CLIENT_INPUT packet repeats the last few ticks, so a 
+// tick is only queued the first time it arrives. The sim consumes exactly
+// one entry per step, so a button pressed for a single tick is never 
+// overwritten by a newer one; when the queue runs dry the last input is 
+// repeated.
+class InputQueue
+{
+public:
+	// Starts empty, with no buttons held.
+	explicit InputQueue(void);
+
+	// Empty destructor.
+	~InputQueue(void);
+
+	// Forgets all inputs.
+	void reset(void);
+
+	// Queues the buttons of client tick seq, and the tick the client showed
+	// the other fighter at. Ticks no newer than the newest queued are 
+	// ignored. If the client gets more than MaxQueued ticks ahead, the 
+	// oldest are dropped.
+	void push(const Uint32 seq, const SimInput buttons, const Uint32 viewTick);
+
+	// Returns the input for the next sim step: the oldest queued one, or the
+	// last one consumed if the queue is empty.
+	const SimInput pop(void);
+
+	// Getters
+
+	// Returns the newest seq received.
+	const Uint32 getLastReceived(void) const;
+
+	// Returns the seq of the input the last pop() returned.
+	const Uint32 getLastConsumed(void) const;
+
+	// Returns the view tick of the input the last pop() returned.
+	const Uint32 getViewTick(void) const;
+
+	// Returns the number of inputs waiting.
+	const Uint32 getSize(void) const;
+
+	// Returns the number of inputs dropped because the queue was full.
+	const Uint32 getNumDropped(void) const;
+
+	// Ticks a client may get ahead of the sim before its oldest inputs are
+	// dropped, bounding the latency the queue adds.
+	static const int MaxQueued = 8;
+
+private:
+	struct Entry{
+		Uint32 seq;
+		SimInput buttons;
+		Uint32 viewTick;
+	};
+
+	std::deque<Entry> m_entries;
+	Entry m_last;
+	Uint32 m_lastReceived;
+	Uint32 m_numDropped;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 InputQueue::getLastReceived(void) const{
+	return m_lastReceived;
+}
+
+inline const Uint32 InputQueue::getLastConsumed(void) const{
+	return m_last.seq;
+}
+
+inline const Uint32 InputQueue::getViewTick(void) const{
+	return m_last.viewTick;
+}
+
+inline const Uint32 InputQueue::getSize(void) const{
+	return static_cast<Uint32>(m_entries.size());
+}
+
+inline const Uint32 InputQueue::getNumDropped(void) const{
+	return m_numDropped;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -32,17 +32,20 @@
 #include "Config.hpp"
 #include "App.hpp"
 #include "Server.hpp"
+#include "MatchHost.hpp"
 #include "Client.hpp"
 #include "NetMessage.hpp"
 #include "Widget.hpp"
 #include "WidgetListbox.hpp"
 #include "Label.hpp"
+#include "PacketDispatcher.hpp"
 
 // ================================================ //
 
 LobbyState::LobbyState(void) :
 m_pGUI(nullptr),
-m_pBackground(nullptr)
+m_pBackground(nullptr),
+m_pPackets(new PacketDispatcher())
 {
 	Config c(Engine::getSingletonPtr()->getSettingsFile());
 	m_pGUI.reset(new GUILobbyState(Engine::getSingletonPtr()->getDataDirectory() + 
@@ -64,6 +67,7 @@ void LobbyState::enter(void)
 
 	m_pBackground.reset(new Stage(Engine::getSingletonPtr()->getDataDirectory() + 
 		"/Stages/lobby.stage"));
+	this->registerPacketHandlers();
 
 	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
 		m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
@@ -95,6 +99,7 @@ void LobbyState::exit(void)
 	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->clear();
 	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->clear();
 
+	m_pPackets->logStats("LobbyState");
 	Log::getSingletonPtr()->logMessage("Exiting LobbyState...");
 }
 
@@ -446,7 +451,8 @@ void LobbyState::processGUIAction(const int type)
 				break;
 
 			case GUILobbyStateLayer::Root::BUTTON_START:
-				StageManager::getSingletonPtr()->load(Engine::getSingletonPtr()->getDataDirectory() + "/Stages/test.stage");
+				// The stage and fighters load in the background while the 
+				// GameState shows a loading screen.
 				if (Game::getSingletonPtr()->getMode() == Game::SERVER){
 					// Load fighters being used by players.
 					if (Server::getSingletonPtr()->getReadyQueueSize() < 2){
@@ -456,9 +462,16 @@ void LobbyState::processGUIAction(const int type)
 					else{
 						ReadyClient red = Server::getSingletonPtr()->getNextRedPlayer();
 						ReadyClient blue = Server::getSingletonPtr()->getNextBluePlayer();
-						if (PlayerManager::getSingletonPtr()->load(red.fighter, blue.fighter)){
-							Game::getSingletonPtr()->setRedPlayerName(red.username);
-							Game::getSingletonPtr()->setBluePlayerName(blue.username);
+						Game::getSingletonPtr()->setRedPlayerName(red.username);
+						Game::getSingletonPtr()->setBluePlayerName(blue.username);
+
+						StageManager::getSingletonPtr()->loadAsync(Engine::getSingletonPtr()->getDataDirectory() + "/Stages/test.stage");
+						PlayerManager::getSingletonPtr()->loadAsync(red.fighter, blue.fighter, 
+							[red, blue](const bool loaded){
+							if (!loaded){
+								Log::getSingletonPtr()->logMessage("Failed to load fighters!");
+								return;
+							}
 
 							// Assign each player's mode, checking for local or net play.
 							if (red.username.compare(Game::getSingletonPtr()->getUsername()) == 0){
@@ -476,20 +489,21 @@ void LobbyState::processGUIAction(const int type)
 								PlayerManager::getSingletonPtr()->getBluePlayer()->setMode(Player::Mode::NET);
 							}
 
+							// Clients start loading once the server has.
 							Server::getSingletonPtr()->startGame();
-							this->pushAppState(this->findByName(GAME_STATE));
-						}
-						else{
-							Log::getSingletonPtr()->logMessage("Failed to load fighters!");
-						}
+						});
+						this->pushAppState(this->findByName(GAME_STATE));
 					}
 				}
 				else if (Game::getSingletonPtr()->getMode() == Game::LOCAL){
-					if (PlayerManager::getSingletonPtr()->load(0, 0)){
-						PlayerManager::getSingletonPtr()->getRedPlayer()->setMode(Player::Mode::LOCAL);
-						PlayerManager::getSingletonPtr()->getBluePlayer()->setMode(Player::Mode::LOCAL);
-						this->pushAppState(this->findByName(GAME_STATE));
-					}
+					StageManager::getSingletonPtr()->loadAsync(Engine::getSingletonPtr()->getDataDirectory() + "/Stages/test.stage");
+					PlayerManager::getSingletonPtr()->loadAsync(0, 0, [](const bool loaded){
+						if (loaded){
+							PlayerManager::getSingletonPtr()->getRedPlayer()->setMode(Player::Mode::LOCAL);
+							PlayerManager::getSingletonPtr()->getBluePlayer()->setMode(Player::Mode::LOCAL);
+						}
+					});
+					this->pushAppState(this->findByName(GAME_STATE));
 				}
 				break;
 
@@ -633,247 +647,292 @@ void LobbyState::update(double dt)
 		break;
 
 	case Game::SERVER:
-		for (Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->getPeer()->Receive();
+		for (Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->getTransport()->receive();
 				Server::getSingletonPtr()->m_packet;
-				Server::getSingletonPtr()->m_peer->DeallocatePacket(Server::getSingletonPtr()->m_packet),
-				Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->m_peer->Receive()){
-			switch (Server::getSingletonPtr()->getPacket()->data[0]){
-			default:
-				break;
+				Server::getSingletonPtr()->getTransport()->deallocatePacket(Server::getSingletonPtr()->m_packet),
+				Server::getSingletonPtr()->m_packet = Server::getSingletonPtr()->getTransport()->receive()){
+			// Inputs from players in hosted matches go straight to their match.
+			if (Server::getSingletonPtr()->getMatchHost() &&
+				Server::getSingletonPtr()->getMatchHost()->handlePacket(Server::getSingletonPtr()->getPacket())){
+				continue;
+			}
 
-			case ID_DISCONNECTION_NOTIFICATION:
-				if (Server::getSingletonPtr()->isClientConnected(Server::getSingletonPtr()->m_packet->systemAddress)){
-					std::string username = Server::getSingletonPtr()->m_clients[Server::getSingletonPtr()->getClient(
-						Server::getSingletonPtr()->m_packet->systemAddress)].username;
-					Log::getSingletonPtr()->logMessage("SERVER: Removing client [" +
-														std::string(Server::getSingletonPtr()->m_packet->systemAddress.ToString()) + "]");
-					Server::getSingletonPtr()->removeFromReadyQueue(username);
-					Server::getSingletonPtr()->removeClient(Server::getSingletonPtr()->m_packet->systemAddress);
-
-					// Tell all other clients.
-					{
-						RakNet::BitStream bit;
-						bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_DISCONNECTED));
-						bit.Write(username.c_str());
-						Server::getSingletonPtr()->broadcast(bit, HIGH_PRIORITY, RELIABLE);
-					}
+			m_pPackets->dispatch(Server::getSingletonPtr()->getPacket());
+		}
 
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-						username + " disconnected!");
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->removeEntry(username);
-				}
-				break;
+		// Pair up ready clients when hosting concurrent matches.
+		Server::getSingletonPtr()->updateHostedMatches();
+		break;
 
-			case ID_CONNECTION_LOST:
-			{
-				std::string username = Server::getSingletonPtr()->m_clients[Server::getSingletonPtr()->getClient(
-					Server::getSingletonPtr()->m_packet->systemAddress)].username;
-				Log::getSingletonPtr()->logMessage("SERVER: Removing client [" +
-													std::string(Server::getSingletonPtr()->m_packet->systemAddress.ToString()) + "]");
-				Server::getSingletonPtr()->removeFromReadyQueue(username);
-				Server::getSingletonPtr()->removeClient(Server::getSingletonPtr()->m_packet->systemAddress);
-				RakNet::BitStream bit;
-				bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_LOST_CONNECTION));
-				bit.Write(username.c_str());
-				Server::getSingletonPtr()->broadcast(bit, HIGH_PRIORITY, RELIABLE);
-
-				m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-					username + " lost connection!");
-				m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->removeEntry(username);
+	case Game::CLIENT:
+		// Keep the server clock estimate fresh for when a match starts.
+		Client::getSingletonPtr()->updateClock();
+
+		for (Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->getTransport()->receive();
+				Client::getSingletonPtr()->m_packet;
+				Client::getSingletonPtr()->getTransport()->deallocatePacket(Client::getSingletonPtr()->m_packet),
+				Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->getTransport()->receive()){
+			if (Client::getSingletonPtr()->update() == false){
+				m_pPackets->dispatch(Client::getSingletonPtr()->getPacket());
 			}
-				break;
+		}
+		break;
+	}
 
-			case NetMessage::SET_USERNAME:
-			{
-				RakNet::BitStream bit(Server::getSingletonPtr()->m_packet->data,
-									Server::getSingletonPtr()->m_packet->length, false);
-				RakNet::RakString rs;
-				bit.IgnoreBytes(sizeof(RakNet::MessageID));
-				bit.Read(rs);
+	Engine::getSingletonPtr()->renderPresent();
+}
 
-				if (Server::getSingletonPtr()->isUsernameInUse(rs.C_String())){
-					RakNet::BitStream reject;
-					reject.Write(static_cast<RakNet::MessageID>(NetMessage::USERNAME_IN_USE));
+// ================================================ //
 
-					Server::getSingletonPtr()->send(reject, Server::getSingletonPtr()->m_packet->systemAddress, HIGH_PRIORITY, RELIABLE);
-				}
-				else{
-					Log::getSingletonPtr()->logMessage("SERVER: Client [" + std::string(
-						Server::getSingletonPtr()->m_packet->systemAddress.ToString()) +
-						"] connected with username \"" + rs.C_String() + "\"");
+void LobbyState::registerPacketHandlers(void)
+{
+	using std::placeholders::_1;
 
-					// Send a list of players to newly connected client.
-					Server::getSingletonPtr()->sendPlayerList(Server::getSingletonPtr()->m_packet->systemAddress);
+	m_pPackets->clear();
+	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
+		m_pPackets->registerHandler(NetMessage::CLOCK_PING, "CLOCK_PING", 
+									std::bind(&LobbyState::handleClockPing, this, _1));
+		m_pPackets->registerHandler(ID_DISCONNECTION_NOTIFICATION, "ID_DISCONNECTION_NOTIFICATION", 
+									std::bind(&LobbyState::handleClientLeft, this, _1));
+		m_pPackets->registerHandler(ID_CONNECTION_LOST, "ID_CONNECTION_LOST", 
+									std::bind(&LobbyState::handleClientLeft, this, _1));
+		m_pPackets->registerHandler(NetMessage::SET_USERNAME, "SET_USERNAME", 
+									std::bind(&LobbyState::handleSetUsername, this, _1));
+		m_pPackets->registerHandler(NetMessage::CHAT, "CHAT", 
+									std::bind(&LobbyState::handleChat, this, _1));
+		m_pPackets->registerHandler(NetMessage::READY, "READY", 
+									std::bind(&LobbyState::handleReady, this, _1));
+	}
+	else if (Game::getSingletonPtr()->getMode() == Game::CLIENT){
+		m_pPackets->registerHandler(ID_CONNECTION_REQUEST_ACCEPTED, "ID_CONNECTION_REQUEST_ACCEPTED", 
+									std::bind(&LobbyState::handleConnectionAccepted, this, _1));
+		m_pPackets->registerHandler(ID_CONNECTION_LOST, "ID_CONNECTION_LOST", 
+									std::bind(&LobbyState::handleConnectionLost, this, _1));
+		m_pPackets->registerHandler(NetMessage::USERNAME_IN_USE, "USERNAME_IN_USE", 
+									std::bind(&LobbyState::handleUsernameInUse, this, _1));
+		m_pPackets->registerHandler(NetMessage::SET_USERNAME, "SET_USERNAME", 
+									std::bind(&LobbyState::handlePlayerJoined, this, _1));
+		m_pPackets->registerHandler(NetMessage::CLIENT_DISCONNECTED, "CLIENT_DISCONNECTED", 
+									std::bind(&LobbyState::handlePlayerLeft, this, _1));
+		m_pPackets->registerHandler(NetMessage::CLIENT_LOST_CONNECTION, "CLIENT_LOST_CONNECTION", 
+									std::bind(&LobbyState::handlePlayerLeft, this, _1));
+		m_pPackets->registerHandler(NetMessage::PLAYER_LIST, "PLAYER_LIST", 
+									std::bind(&LobbyState::handlePlayerList, this, _1));
+		m_pPackets->registerHandler(NetMessage::CHAT, "CHAT", 
+									std::bind(&LobbyState::handleChat, this, _1));
+		m_pPackets->registerHandler(NetMessage::READY, "READY", 
+									std::bind(&LobbyState::handlePlayerReady, this, _1));
+		m_pPackets->registerHandler(NetMessage::SERVER_STARTING_GAME, "SERVER_STARTING_GAME", 
+									std::bind(&LobbyState::handleGameStarting, this, _1));
+	}
+}
 
-					// Add them to the client list.
-					Server::getSingletonPtr()->registerClient(rs.C_String(), Server::getSingletonPtr()->m_packet->systemAddress);
+// ================================================ //
 
-					Server::getSingletonPtr()->broadcast(Server::getSingletonPtr()->m_packet, HIGH_PRIORITY, RELIABLE,
-														Server::getSingletonPtr()->m_packet->systemAddress);
+void LobbyState::handleClockPing(PacketView& view)
+{
+	Server::getSingletonPtr()->sendClockPong(view.getPacket(), 0);
+}
 
-					std::string username = Server::getSingletonPtr()->getPacketStrData();
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-						username + std::string(" connected!"));
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->addString(
-						username);
-				}
-			}
-				break;
+// ================================================ //
 
-			case NetMessage::CHAT:
-				Server::getSingletonPtr()->broadcast(Server::getSingletonPtr()->m_packet,
-														HIGH_PRIORITY, RELIABLE_ORDERED, Server::getSingletonPtr()->m_packet->systemAddress);
-				m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-					Server::getSingletonPtr()->getPacketStrData());
-				break;
+void LobbyState::handleClientLeft(PacketView& view)
+{
+	if (!Server::getSingletonPtr()->isClientConnected(view.getAddress())){
+		return;
+	}
 
-			case NetMessage::READY:
-				// Add username to ready queue and broadcast.
-				if (Server::getSingletonPtr()->isClientConnected(Server::getSingletonPtr()->m_packet->systemAddress)){
-					int client = Server::getSingletonPtr()->getClient(Server::getSingletonPtr()->m_packet->systemAddress);
-					RakNet::BitStream data(Server::getSingletonPtr()->m_packet->data, Server::getSingletonPtr()->m_packet->length, false);
-					data.IgnoreBytes(sizeof(RakNet::MessageID));
-					Uint32 fighter;
-					data.Read(fighter);
-					if (Server::getSingletonPtr()->addToReadyQueue(Server::getSingletonPtr()->m_clients[client].username, fighter)){
-						std::string username = Server::getSingletonPtr()->m_clients[client].username;
-
-						RakNet::BitStream bit;
-						bit.Write(static_cast<RakNet::MessageID>(NetMessage::READY));
-						bit.Write(username.c_str());
-						bit.Write(fighter);
-
-						Server::getSingletonPtr()->broadcast(bit, HIGH_PRIORITY, RELIABLE_ORDERED,
-																Server::getSingletonPtr()->m_packet->systemAddress);
-
-						m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-							std::string(username) + " is ready!");
-					}
-				}
-				break;
-			}
-		}
-		break;
+	const bool lost = (view.getID() == ID_CONNECTION_LOST);
+	const std::string username = Server::getSingletonPtr()->m_clients[Server::getSingletonPtr()->getClient(
+		view.getAddress())].username;
+	Log::getSingletonPtr()->logMessage("SERVER: Removing client [" + std::string(view.getAddress().ToString()) + "]");
+	Server::getSingletonPtr()->removeFromReadyQueue(username);
+	Server::getSingletonPtr()->removeClient(view.getAddress());
+	if (Server::getSingletonPtr()->getMatchHost()){
+		Server::getSingletonPtr()->getMatchHost()->removePlayer(view.getAddress());
+	}
 
-	case Game::CLIENT:
-		for (Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->m_peer->Receive();
-				Client::getSingletonPtr()->m_packet;
-				Client::getSingletonPtr()->m_peer->DeallocatePacket(Client::getSingletonPtr()->m_packet),
-				Client::getSingletonPtr()->m_packet = Client::getSingletonPtr()->m_peer->Receive()){
-			if (Client::getSingletonPtr()->update() == false){
-				switch (Client::getSingletonPtr()->getPacket()->data[0]){
-				default:
-					break;
+	// Tell all other clients.
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>((lost) ? NetMessage::CLIENT_LOST_CONNECTION : NetMessage::CLIENT_DISCONNECTED));
+	bit.Write(username.c_str());
+	Server::getSingletonPtr()->broadcast(bit, HIGH_PRIORITY, RELIABLE);
 
-				case ID_CONNECTION_REQUEST_ACCEPTED:
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString("Connected to server!");
-					{
-						// Store the server system address for future use.
-						Client::getSingletonPtr()->m_serverAddr = Client::getSingletonPtr()->m_packet->systemAddress;
-
-						// Send the server the username.
-						RakNet::BitStream bit;
-						bit.Write(static_cast<RakNet::MessageID>(NetMessage::SET_USERNAME));
-						Log::getSingletonPtr()->logMessage("Sending username \"" +
-															Game::getSingletonPtr()->getUsername() + "\" to server.");
-						bit.Write(Game::getSingletonPtr()->getUsername().c_str());
-						Client::getSingletonPtr()->send(bit, HIGH_PRIORITY, RELIABLE);
-					}
-					break;
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
+		username + ((lost) ? " lost connection!" : " disconnected!"));
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->removeEntry(username);
+}
 
-				case ID_CONNECTION_LOST:
-					Game::getSingletonPtr()->setError(ID_CONNECTION_LOST);
-					m_quit = true;
-					break;
+// ================================================ //
 
-				case NetMessage::SET_USERNAME:
-				{
-					std::string username = Client::getSingletonPtr()->getPacketStrData();
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-						username + std::string(" connected!"));
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->addString(
-						username);
-				}
-					break;
+void LobbyState::handleSetUsername(PacketView& view)
+{
+	const std::string username = view.readString();
+	if (Server::getSingletonPtr()->isUsernameInUse(username)){
+		RakNet::BitStream reject;
+		reject.Write(static_cast<RakNet::MessageID>(NetMessage::USERNAME_IN_USE));
 
-				case NetMessage::USERNAME_IN_USE:
-					Client::getSingletonPtr()->disconnect();
-					Game::getSingletonPtr()->setError(NetMessage::USERNAME_IN_USE);
-					m_quit = true;
-					break;
+		Server::getSingletonPtr()->send(reject, view.getAddress(), HIGH_PRIORITY, RELIABLE);
+		return;
+	}
 
-				case NetMessage::CLIENT_DISCONNECTED:
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-						std::string(Client::getSingletonPtr()->getPacketStrData()) + " disconnected!");
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->removeEntry(
-						std::string(Client::getSingletonPtr()->getPacketStrData()));
-					break;
+	Log::getSingletonPtr()->logMessage("SERVER: Client [" + std::string(view.getAddress().ToString()) +
+		"] connected with username \"" + username + "\"");
 
-				case NetMessage::CLIENT_LOST_CONNECTION:
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-						std::string(Client::getSingletonPtr()->getPacketStrData()) + " lost connection!");
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->removeEntry(
-						std::string(Client::getSingletonPtr()->getPacketStrData()));
-					break;
+	// Send a list of players to newly connected client.
+	Server::getSingletonPtr()->sendPlayerList(view.getAddress());
 
-				case NetMessage::PLAYER_LIST:
-				{
-					// Extract each player username and add to list.										
-					RakNet::BitStream bit(Client::getSingletonPtr()->getPacket()->data,
-											Client::getSingletonPtr()->getPacket()->length, false);
-					bit.IgnoreBytes(sizeof(RakNet::MessageID));
-					Uint32 numPlayers = 0;
-					bit.Read(numPlayers);
-					for (Uint32 i = 0; i < numPlayers; ++i){
-						RakNet::RakString username;
-						bit.Read(username);
-						m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->addString(username.C_String());
-					}
-				}
-					break;
+	// Add them to the client list.
+	Server::getSingletonPtr()->registerClient(username.c_str(), view.getAddress());
 
-				case NetMessage::CHAT:
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-						Client::getSingletonPtr()->getPacketStrData());
-					break;
+	Server::getSingletonPtr()->broadcast(view.getPacket(), HIGH_PRIORITY, RELIABLE, view.getAddress());
 
-				case NetMessage::READY:
-					m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
-						std::string(Client::getSingletonPtr()->getPacketStrData()) + " is ready!");
-					// Show fighter...
-					break;
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
+		username + std::string(" connected!"));
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->addString(
+		username);
+}
 
-				case NetMessage::SERVER_STARTING_GAME:
-					StageManager::getSingletonPtr()->load(Engine::getSingletonPtr()->getDataDirectory() + "/Stages/test.stage");
-					Game::getSingletonPtr()->setPlaying(Game::SPECTATING);
-					// Load the fighters being used this match.
-					{
-						RakNet::BitStream bit(Client::getSingletonPtr()->m_packet->data,
-												Client::getSingletonPtr()->m_packet->length, false);
-						bit.IgnoreBytes(sizeof(RakNet::MessageID));
-						RakNet::RakString redName, blueName;
-						Uint32 red = 0, blue = 0;
-
-						// Set player names.
-						bit.Read(redName);
-						bit.Read(blueName);
-						Game::getSingletonPtr()->setRedPlayerName(redName.C_String());
-						Game::getSingletonPtr()->setBluePlayerName(blueName.C_String());
-
-						// Load fighters for this game.
-						bit.Read(red);
-						bit.Read(blue);
-						PlayerManager::getSingletonPtr()->load(red, blue);
-					}
-					this->pushAppState(this->findByName(GAME_STATE));
-					break;
-				}
-			}
-		}
-		break;
+// ================================================ //
+
+void LobbyState::handleChat(PacketView& view)
+{
+	// The server relays chat to every other client.
+	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
+		Server::getSingletonPtr()->broadcast(view.getPacket(), HIGH_PRIORITY, RELIABLE_ORDERED, view.getAddress());
 	}
 
-	Engine::getSingletonPtr()->renderPresent();
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(view.readString());
+}
+
+// ================================================ //
+
+void LobbyState::handleReady(PacketView& view)
+{
+	if (!Server::getSingletonPtr()->isClientConnected(view.getAddress())){
+		return;
+	}
+
+	// Add username to ready queue and broadcast.
+	const int client = Server::getSingletonPtr()->getClient(view.getAddress());
+	Uint32 fighter = 0;
+	view.getBitStream().Read(fighter);
+	if (Server::getSingletonPtr()->addToReadyQueue(Server::getSingletonPtr()->m_clients[client].username, fighter)){
+		const std::string username = Server::getSingletonPtr()->m_clients[client].username;
+
+		RakNet::BitStream bit;
+		bit.Write(static_cast<RakNet::MessageID>(NetMessage::READY));
+		bit.Write(username.c_str());
+		bit.Write(fighter);
+
+		Server::getSingletonPtr()->broadcast(bit, HIGH_PRIORITY, RELIABLE_ORDERED, view.getAddress());
+
+		m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
+			username + " is ready!");
+	}
+}
+
+// ================================================ //
+
+void LobbyState::handleConnectionAccepted(PacketView& view)
+{
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString("Connected to server!");
+
+	// Store the server system address for future use.
+	Client::getSingletonPtr()->m_serverAddr = view.getAddress();
+	Client::getSingletonPtr()->m_connected = true;
+
+	// Send the server the username.
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::SET_USERNAME));
+	Log::getSingletonPtr()->logMessage("Sending username \"" +
+										Game::getSingletonPtr()->getUsername() + "\" to server.");
+	bit.Write(Game::getSingletonPtr()->getUsername().c_str());
+	Client::getSingletonPtr()->send(bit, HIGH_PRIORITY, RELIABLE);
+}
+
+// ================================================ //
+
+void LobbyState::handleConnectionLost(PacketView& view)
+{
+	Client::getSingletonPtr()->m_connected = false;
+	Game::getSingletonPtr()->setError(ID_CONNECTION_LOST);
+	m_quit = true;
+}
+
+// ================================================ //
+
+void LobbyState::handleUsernameInUse(PacketView& view)
+{
+	Client::getSingletonPtr()->disconnect();
+	Game::getSingletonPtr()->setError(NetMessage::USERNAME_IN_USE);
+	m_quit = true;
+}
+
+// ================================================ //
+
+void LobbyState::handlePlayerJoined(PacketView& view)
+{
+	const std::string username = view.readString();
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
+		username + std::string(" connected!"));
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->addString(
+		username);
+}
+
+// ================================================ //
+
+void LobbyState::handlePlayerLeft(PacketView& view)
+{
+	const std::string username = view.readString();
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(username + 
+		((view.getID() == NetMessage::CLIENT_LOST_CONNECTION) ? " lost connection!" : " disconnected!"));
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->removeEntry(username);
+}
+
+// ================================================ //
+
+void LobbyState::handlePlayerList(PacketView& view)
+{
+	// Extract each player username and add to list.
+	Uint32 numPlayers = 0;
+	view.getBitStream().Read(numPlayers);
+	for (Uint32 i = 0; i < numPlayers; ++i){
+		m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_PLAYERS)->addString(view.readString());
+	}
+}
+
+// ================================================ //
+
+void LobbyState::handlePlayerReady(PacketView& view)
+{
+	m_pGUI->getWidgetPtr(GUILobbyStateLayer::Root::LISTBOX_CHAT)->addString(
+		view.readString() + " is ready!");
+	// Show fighter...
+}
+
+// ================================================ //
+
+void LobbyState::handleGameStarting(PacketView& view)
+{
+	StageManager::getSingletonPtr()->loadAsync(Engine::getSingletonPtr()->getDataDirectory() + "/Stages/test.stage");
+	Game::getSingletonPtr()->setPlaying(Game::SPECTATING);
+	Client::getSingletonPtr()->resetSnapshots();
+
+	// Set player names.
+	RakNet::RakString redName, blueName;
+	view.getBitStream().Read(redName);
+	view.getBitStream().Read(blueName);
+	Game::getSingletonPtr()->setRedPlayerName(redName.C_String());
+	Game::getSingletonPtr()->setBluePlayerName(blueName.C_String());
+
+	// Load fighters for this game.
+	Uint32 red = 0, blue = 0;
+	view.getBitStream().Read(red);
+	view.getBitStream().Read(blue);
+	PlayerManager::getSingletonPtr()->loadAsync(red, blue);
+
+	this->pushAppState(this->findByName(GAME_STATE));
 }
 
 // ================================================ //
\ No newline at end of file
@@ -32,6 +32,8 @@
 
 class GUI;
 class Stage;
+class PacketDispatcher;
+class PacketView;
 
 // ================================================ //
 
@@ -72,8 +74,33 @@ public:
 	void update(double dt);
 
 private:
+	// Registers the packet handlers for the current game mode.
+	void registerPacketHandlers(void);
+
+	// Server packet handlers.
+	void handleClockPing(PacketView& view);
+	void handleClientLeft(PacketView& view);
+	void handleSetUsername(PacketView& view);
+	void handleReady(PacketView& view);
+
+	// Shown by both, and relayed to the other clients by the server.
+	void handleChat(PacketView& view);
+
+	// Client packet handlers.
+	void handleConnectionAccepted(PacketView& view);
+	void handleConnectionLost(PacketView& view);
+	void handleUsernameInUse(PacketView& view);
+	void handlePlayerJoined(PacketView& view);
+	void handlePlayerLeft(PacketView& view);
+	void handlePlayerList(PacketView& view);
+	void handlePlayerReady(PacketView& view);
+	void handleGameStarting(PacketView& view);
+
 	std::shared_ptr<GUI> m_pGUI;
 	std::shared_ptr<Stage> m_pBackground;
+
+	// Routes received packets to the handlers above.
+	std::shared_ptr<PacketDispatcher> m_pPackets;
 };
 
 // ================================================ //
@@ -0,0 +1,139 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: LockstepSession.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements LockstepSession class.
+// ================================================ //
+
+#include "LockstepSession.hpp"
+
+// ================================================ //
+
+LockstepSession::LockstepSession(std::shared_ptr<MatchSim> pSim, const int localFighter,
+								 const uint32_t inputDelay) :
+m_pSim(pSim),
+m_local(localFighter),
+m_remote((localFighter == MatchSim::RED) ? MatchSim::BLUE : MatchSim::RED),
+m_inputDelay(inputDelay),
+m_inputs(),
+m_localFrame(pSim->getTick()),
+m_stats()
+{
+	if (m_inputDelay > LockstepSession::MaxInputDelay){
+		m_inputDelay = LockstepSession::MaxInputDelay;
+	}
+
+	memset(&m_stats, 0, sizeof(m_stats));
+
+	FrameInput empty;
+	memset(&empty, 0, sizeof(empty));
+	empty.frame = UINT32_MAX;
+	m_inputs.resize((m_inputDelay + 1) * 2, empty);
+
+	// Nobody has input for the frames covered by the delay.
+	for (uint32_t i = 0; i < m_inputDelay; ++i){
+		FrameInput& slot = this->getInput(m_localFrame++);
+		slot.hasLocal = slot.hasRemote = true;
+	}
+}
+
+// ================================================ //
+
+LockstepSession::~LockstepSession(void)
+{
+
+}
+
+// ================================================ //
+
+bool LockstepSession::addLocalInput(const SimInput localInput, uint32_t& frame)
+{
+	// Keep exactly inputDelay + 1 local inputs buffered.
+	if (m_localFrame > m_pSim->getTick() + m_inputDelay){
+		return false;
+	}
+
+	FrameInput& slot = this->getInput(m_localFrame);
+	slot.local = localInput;
+	slot.hasLocal = true;
+
+	frame = m_localFrame++;
+	return true;
+}
+
+// ================================================ //
+
+bool LockstepSession::advance(void)
+{
+	const uint32_t frame = m_pSim->getTick();
+	const FrameInput& slot = m_inputs[frame % m_inputs.size()];
+	if (slot.frame != frame || !slot.hasLocal || !slot.hasRemote){
+		++m_stats.stalls;
+		++m_stats.stallRun;
+		if (m_stats.stallRun > m_stats.maxStallRun){
+			m_stats.maxStallRun = m_stats.stallRun;
+		}
+		return false;
+	}
+
+	SimInput inputs[MatchSim::NUM_FIGHTERS];
+	inputs[m_local] = slot.local;
+	inputs[m_remote] = slot.remote;
+	m_pSim->step(inputs);
+
+	++m_stats.frames;
+	m_stats.stallRun = 0;
+
+	return true;
+}
+
+// ================================================ //
+
+void LockstepSession::addRemoteInput(const uint32_t frame, const SimInput input)
+{
+	const uint32_t current = m_pSim->getTick();
+
+	// Ignore old frames and anything the peer couldn't have sent yet.
+	if (frame < current || frame >= current + m_inputs.size()){
+		return;
+	}
+
+	FrameInput& slot = this->getInput(frame);
+	if (slot.hasRemote){
+		return;
+	}
+
+	slot.remote = input;
+	slot.hasRemote = true;
+}
+
+// ================================================ //
+
+LockstepSession::FrameInput& LockstepSession::getInput(const uint32_t frame)
+{
+	FrameInput& slot = m_inputs[frame % m_inputs.size()];
+	if (slot.frame != frame){
+		memset(&slot, 0, sizeof(slot));
+		slot.frame = frame;
+	}
+
+	return slot;
+}
+
+// ================================================ //
\ No newline at end of file
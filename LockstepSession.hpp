@@ -0,0 +1,151 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: LockstepSession.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines LockstepSession class.
+// ================================================ //
+
+#ifndef __LOCKSTEPSESSION_HPP__
+#define __LOCKSTEPSESSION_HPP__
+
+// ================================================ //
+
+#include "MatchSim.hpp"
+
+// ================================================ //
+
+// Counters describing how long a lockstep session has waited on its peer.
+struct LockstepStats{
+	// Frames simulated.
+	uint64_t frames;
+	// Number of calls to advance() that stalled waiting on remote input.
+	uint32_t stalls;
+	// Consecutive stalls in the current wait, and the longest wait.
+	uint32_t stallRun, maxStallRun;
+};
+
+// ================================================ //
+
+// Drives a MatchSim for a peer-to-peer match using delay-based lockstep.
+// Each local input is scheduled inputDelay ticks in the future and sent to
+// the remote peer tagged with that frame; the match only advances once 
+// both inputs for the next frame are known, so both peers simulate the
+// same inputs and no state is ever exchanged. Both peers must use the same
+// input delay. Knows nothing about the transport; the owner sends the 
+// frames returned by addLocalInput() and passes received remote inputs to
+// addRemoteInput().
+class LockstepSession
+{
+public:
+	// Takes control of pSim from its current tick. localFighter is 
+	// MatchSim::RED or MatchSim::BLUE. inputDelay is clamped to 
+	// MaxInputDelay. The first inputDelay frames use empty inputs.
+	explicit LockstepSession(std::shared_ptr<MatchSim> pSim, const int localFighter,
+							 const uint32_t inputDelay = 2);
+
+	// Empty destructor.
+	~LockstepSession(void);
+
+	// Schedules localInput for the frame inputDelay ticks after the current
+	// one. Returns false if that frame already has a local input (the 
+	// session is stalled), otherwise sets frame to the scheduled frame, 
+	// which the owner must send to the remote peer.
+	bool addLocalInput(const SimInput localInput, uint32_t& frame);
+
+	// Advances the match one tick if both inputs for the current frame are
+	// known. Returns false without advancing otherwise (the caller should 
+	// try again next update).
+	bool advance(void);
+
+	// Records the remote fighter's input for frame. Duplicates and frames 
+	// that have already been simulated are ignored.
+	void addRemoteInput(const uint32_t frame, const SimInput input);
+
+	// Getters
+
+	// Returns the next frame to be simulated (the MatchSim's tick).
+	const uint32_t getFrame(void) const;
+
+	// Returns the local fighter (MatchSim::RED or MatchSim::BLUE).
+	const int getLocalFighter(void) const;
+
+	// Returns the number of ticks local inputs are delayed.
+	const uint32_t getInputDelay(void) const;
+
+	// Returns lockstep statistics.
+	const LockstepStats& getStats(void) const;
+
+	// --- //
+
+	// Hard limit on the input delay.
+	static const uint32_t MaxInputDelay = 30;
+
+private:
+	// Inputs for a single frame.
+	struct FrameInput{
+		uint32_t frame;
+		SimInput local;
+		SimInput remote;
+		bool hasLocal;
+		bool hasRemote;
+	};
+
+	// Returns the input ring slot for frame, resetting it if it holds an older frame.
+	FrameInput& getInput(const uint32_t frame);
+
+	std::shared_ptr<MatchSim> m_pSim;
+	int m_local, m_remote;
+	uint32_t m_inputDelay;
+
+	// Ring buffer indexed by frame % size. The remote peer can't be more 
+	// than inputDelay + 1 frames ahead of us, and sends inputs up to 
+	// inputDelay frames ahead of itself.
+	std::vector<FrameInput> m_inputs;
+
+	// The next frame to receive a local input.
+	uint32_t m_localFrame;
+
+	LockstepStats m_stats;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const uint32_t LockstepSession::getFrame(void) const{
+	return m_pSim->getTick();
+}
+
+inline const int LockstepSession::getLocalFighter(void) const{
+	return m_local;
+}
+
+inline const uint32_t LockstepSession::getInputDelay(void) const{
+	return m_inputDelay;
+}
+
+inline const LockstepStats& LockstepSession::getStats(void) const{
+	return m_stats;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
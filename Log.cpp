@@ -31,7 +31,8 @@ template<> Log* Singleton<Log>::msSingleton = nullptr;
 // ================================================ //
 
 Log::Log(void) :
-m_pImpl(new LogImpl())
+m_pImpl(new LogImpl()),
+m_mutex()
 {
 
 }
@@ -47,6 +48,7 @@ Log::~Log(void)
 
 void Log::logMessage(const std::string& str)
 {
+	std::lock_guard<std::mutex> lock(m_mutex);
 	m_pImpl->logMessage(str);
 }
 
@@ -54,6 +56,7 @@ void Log::logMessage(const std::string& str)
 
 void Log::logTime(const bool time, const bool date)
 {
+	std::lock_guard<std::mutex> lock(m_mutex);
 	m_pImpl->logTime(time, date);
 }
 
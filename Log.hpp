@@ -28,13 +28,15 @@
 
 #include "stdafx.hpp"
 
+#include <mutex>
+
 // ================================================ //
 
 class LogImpl;
 
 // ================================================ //
 
-// Writes data to log file.
+// Writes data to log file. Safe to use from worker threads.
 class Log : public Singleton<Log>
 {
 public:
@@ -52,6 +54,7 @@ public:
 
 private:
 	std::shared_ptr<LogImpl> m_pImpl;
+	std::mutex m_mutex;
 };
 
 // ================================================ //
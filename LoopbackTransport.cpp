@@ -0,0 +1,347 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: LoopbackTransport.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements LoopbackNetwork and LoopbackTransport classes.
+// ================================================ //
+
+#include "LoopbackTransport.hpp"
+
+// ================================================ //
+
+LoopbackNetwork::LoopbackNetwork(const uint64_t seed) :
+m_mutex(),
+m_seed(seed),
+m_now(0),
+m_nextOrder(0),
+m_defaultConditions(),
+m_endpoints(),
+m_links()
+{
+
+}
+
+// ================================================ //
+
+LoopbackNetwork::~LoopbackNetwork(void)
+{
+
+}
+
+// ================================================ //
+
+std::shared_ptr<LoopbackTransport> LoopbackNetwork::createEndpoint(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const Uint32 index = static_cast<Uint32>(m_endpoints.size());
+	Endpoint endpoint;
+	endpoint.addr.FromStringExplicitPort("127.0.0.1", BasePort + static_cast<unsigned short>(index));
+	m_endpoints.push_back(endpoint);
+
+	return std::shared_ptr<LoopbackTransport>(new LoopbackTransport(this, index, endpoint.addr));
+}
+
+// ================================================ //
+
+void LoopbackNetwork::setDefaultConditions(const NetworkConditions& conditions)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_defaultConditions = conditions;
+}
+
+// ================================================ //
+
+void LoopbackNetwork::setConditions(const RakNet::SystemAddress& from, const RakNet::SystemAddress& to, 
+									const NetworkConditions& conditions)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const int a = this->findEndpoint(from);
+	const int b = this->findEndpoint(to);
+	if (a == -1 || b == -1){
+		throw std::exception("LoopbackNetwork::setConditions(): unknown endpoint");
+	}
+
+	// Replaces the conditioner, keeping the link's seed.
+	Link& link = this->getLink(a, b);
+	const uint64_t seed = m_seed ^ ((static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b));
+	link.pConditioner.reset(new NetworkConditioner(conditions, seed));
+}
+
+// ================================================ //
+
+void LoopbackNetwork::setTime(const uint64_t now)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (now > m_now){
+		m_now = now;
+	}
+}
+
+// ================================================ //
+
+const uint64_t LoopbackNetwork::getTime(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_now;
+}
+
+// ================================================ //
+
+const ConditionerStats LoopbackNetwork::getStats(const RakNet::SystemAddress& from, 
+												 const RakNet::SystemAddress& to) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	ConditionerStats stats;
+	memset(&stats, 0, sizeof(stats));
+
+	const int a = this->findEndpoint(from);
+	const int b = this->findEndpoint(to);
+	if (a != -1 && b != -1){
+		std::map<std::pair<Uint32, Uint32>, Link>::const_iterator itr = 
+			m_links.find(std::make_pair(static_cast<Uint32>(a), static_cast<Uint32>(b)));
+		if (itr != m_links.end()){
+			stats = itr->second.pConditioner->getStats();
+		}
+	}
+
+	return stats;
+}
+
+// ================================================ //
+
+Uint32 LoopbackNetwork::send(const Uint32 from, const RakNet::BitStream& bit, const PacketReliability reliability,
+							 const RakNet::SystemAddress& addr, const bool broadcast)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (broadcast){
+		for (Uint32 i = 0; i < m_endpoints.size(); ++i){
+			if (i != from && m_endpoints[i].addr != addr){
+				this->sendTo(from, i, bit, reliability);
+			}
+		}
+
+		return 1;
+	}
+
+	const int to = this->findEndpoint(addr);
+	if (to == -1 || static_cast<Uint32>(to) == from){
+		return 0;
+	}
+
+	this->sendTo(from, to, bit, reliability);
+	return 1;
+}
+
+// ================================================ //
+
+RakNet::Packet* LoopbackNetwork::receive(const Uint32 to)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<InFlight>& inbox = m_endpoints[to].inbox;
+	while (!inbox.empty() && inbox.front().arrival <= m_now){
+		std::pop_heap(inbox.begin(), inbox.end(), ArrivesLater());
+		InFlight& in = inbox.back();
+
+		// Drop sequenced packets older than the newest received.
+		if (in.sequenced){
+			Link& link = this->getLink(in.from, to);
+			if (link.hasSequenced && static_cast<Sint32>(in.seq - link.newestSequenced) <= 0){
+				inbox.pop_back();
+				continue;
+			}
+			link.hasSequenced = true;
+			link.newestSequenced = in.seq;
+		}
+
+		RakNet::Packet* packet = new RakNet::Packet();
+		packet->systemAddress = m_endpoints[in.from].addr;
+		packet->guid = RakNet::UNASSIGNED_RAKNET_GUID;
+		packet->length = static_cast<unsigned int>(in.data.size());
+		packet->bitSize = BYTES_TO_BITS(packet->length);
+		packet->data = new unsigned char[packet->length];
+		memcpy(packet->data, &in.data[0], packet->length);
+		packet->deleteData = true;
+		packet->wasGeneratedLocally = false;
+
+		inbox.pop_back();
+		return packet;
+	}
+
+	return nullptr;
+}
+
+// ================================================ //
+
+bool LoopbackNetwork::getConnectionStats(const Uint32 from, const RakNet::SystemAddress& addr, 
+										 ConnectionStats& stats)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const int to = this->findEndpoint(addr);
+	if (to == -1 || static_cast<Uint32>(to) == from){
+		return false;
+	}
+
+	// As RakNet does, loss is measured on what this end sends.
+	const NetworkConditioner& out = *this->getLink(from, to).pConditioner;
+	const NetworkConditioner& in = *this->getLink(to, from).pConditioner;
+	stats.rtt = static_cast<Uint32>((out.getConditions().latency + in.getConditions().latency) / 1000);
+	stats.loss = out.getRecentLoss();
+	stats.queuedBytes = out.getQueuedBytes(m_now);
+
+	return true;
+}
+
+// ================================================ //
+
+int LoopbackNetwork::findEndpoint(const RakNet::SystemAddress& addr) const
+{
+	for (Uint32 i = 0; i < m_endpoints.size(); ++i){
+		if (m_endpoints[i].addr == addr){
+			return static_cast<int>(i);
+		}
+	}
+
+	return -1;
+}
+
+// ================================================ //
+
+void LoopbackNetwork::sendTo(const Uint32 from, const Uint32 to, const RakNet::BitStream& bit, 
+							 const PacketReliability reliability)
+{
+	const Uint32 bytes = static_cast<Uint32>(bit.GetNumberOfBytesUsed());
+	if (bytes == 0){
+		return;
+	}
+
+	const bool reliable = (reliability == RELIABLE || reliability == RELIABLE_ORDERED || 
+						   reliability == RELIABLE_SEQUENCED);
+	const bool sequenced = (reliability == UNRELIABLE_SEQUENCED || reliability == RELIABLE_SEQUENCED);
+
+	Link& link = this->getLink(from, to);
+	uint64_t arrivals[2] = { 0, 0 };
+	const int count = link.pConditioner->schedule(m_now, bytes, reliable, arrivals);
+
+	const Uint32 seq = link.nextSeq++;
+	for (int i = 0; i < count; ++i){
+		InFlight in;
+		in.arrival = arrivals[i];
+		if (reliability == RELIABLE_ORDERED){
+			// Held back until the ordered packets sent before it arrive.
+			if (in.arrival < link.lastOrdered){
+				in.arrival = link.lastOrdered;
+			}
+			link.lastOrdered = in.arrival;
+		}
+		in.order = m_nextOrder++;
+		in.from = from;
+		in.sequenced = sequenced;
+		in.seq = seq;
+		in.data.assign(bit.GetData(), bit.GetData() + bytes);
+
+		std::vector<InFlight>& inbox = m_endpoints[to].inbox;
+		inbox.push_back(in);
+		std::push_heap(inbox.begin(), inbox.end(), ArrivesLater());
+	}
+}
+
+// ================================================ //
+
+LoopbackNetwork::Link& LoopbackNetwork::getLink(const Uint32 from, const Uint32 to)
+{
+	const std::pair<Uint32, Uint32> key(from, to);
+	std::map<std::pair<Uint32, Uint32>, Link>::iterator itr = m_links.find(key);
+	if (itr != m_links.end()){
+		return itr->second;
+	}
+
+	// Each direction of each link gets its own random sequence.
+	Link link;
+	const uint64_t seed = m_seed ^ ((static_cast<uint64_t>(from) << 32) | static_cast<uint64_t>(to));
+	link.pConditioner.reset(new NetworkConditioner(m_defaultConditions, seed));
+	link.lastOrdered = 0;
+	link.nextSeq = 0;
+	link.hasSequenced = false;
+	link.newestSequenced = 0;
+
+	return m_links.insert(std::make_pair(key, link)).first->second;
+}
+
+// ================================================ //
+// ================================================ //
+
+LoopbackTransport::LoopbackTransport(LoopbackNetwork* pNetwork, const Uint32 index, 
+									 const RakNet::SystemAddress& addr) :
+m_pNetwork(pNetwork),
+m_index(index),
+m_addr(addr)
+{
+
+}
+
+// ================================================ //
+
+LoopbackTransport::~LoopbackTransport(void)
+{
+
+}
+
+// ================================================ //
+
+Uint32 LoopbackTransport::send(const RakNet::BitStream& bit, const PacketPriority priority, 
+							   const PacketReliability reliability, const RakNet::SystemAddress& addr, 
+							   const bool broadcast)
+{
+	return m_pNetwork->send(m_index, bit, reliability, addr, broadcast);
+}
+
+// ================================================ //
+
+RakNet::Packet* LoopbackTransport::receive(void)
+{
+	return m_pNetwork->receive(m_index);
+}
+
+// ================================================ //
+
+void LoopbackTransport::deallocatePacket(RakNet::Packet* packet)
+{
+	if (packet != nullptr){
+		delete[] packet->data;
+		delete packet;
+	}
+}
+
+// ================================================ //
+
+bool LoopbackTransport::getConnectionStats(const RakNet::SystemAddress& addr, ConnectionStats& stats)
+{
+	return m_pNetwork->getConnectionStats(m_index, addr, stats);
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,192 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: LoopbackTransport.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines LoopbackNetwork and LoopbackTransport classes.
+// ================================================ //
+
+#ifndef __LOOPBACKTRANSPORT_HPP__
+#define __LOOPBACKTRANSPORT_HPP__
+
+// ================================================ //
+
+#include "Transport.hpp"
+#include "NetworkConditioner.hpp"
+
+#include <mutex>
+
+// ================================================ //
+
+class LoopbackTransport;
+
+// ================================================ //
+
+// An in-process network of LoopbackTransports, running on a simulated 
+// clock instead of sockets, so a server and its clients can share one 
+// process and run faster than real time. Every direction of every link 
+// has its own NetworkConditioner, seeded from the network's seed, so runs 
+// are repeatable. RakNet's guarantees are kept: reliable packets are only
+// delayed, RELIABLE_ORDERED ones arrive in order, and sequenced ones older 
+// than the newest received are dropped. Priorities are ignored.
+class LoopbackNetwork
+{
+public:
+	// Starts at time zero with perfect links.
+	explicit LoopbackNetwork(const uint64_t seed);
+
+	// Empty destructor.
+	~LoopbackNetwork(void);
+
+	// Creates an endpoint with its own address. The network must outlive it.
+	std::shared_ptr<LoopbackTransport> createEndpoint(void);
+
+	// Sets the conditions of links created from now on.
+	void setDefaultConditions(const NetworkConditions& conditions);
+
+	// Sets the conditions of packets sent from one endpoint to another.
+	void setConditions(const RakNet::SystemAddress& from, const RakNet::SystemAddress& to, 
+					   const NetworkConditions& conditions);
+
+	// Advances the simulated clock (us). Packets are received once it 
+	// reaches their arrival time.
+	void setTime(const uint64_t now);
+
+	// Getters
+
+	// Returns the simulated clock (us).
+	const uint64_t getTime(void) const;
+
+	// Returns what was done to the packets sent from one endpoint to another.
+	const ConditionerStats getStats(const RakNet::SystemAddress& from, const RakNet::SystemAddress& to) const;
+
+	// First port given to endpoints, on 127.0.0.1.
+	static const unsigned short BasePort = 20000;
+
+private:
+	friend class LoopbackTransport;
+
+	// Sends on behalf of an endpoint, see Transport::send().
+	Uint32 send(const Uint32 from, const RakNet::BitStream& bit, const PacketReliability reliability,
+				const RakNet::SystemAddress& addr, const bool broadcast);
+
+	// Returns the next packet that has arrived at an endpoint, or nullptr.
+	RakNet::Packet* receive(const Uint32 to);
+
+	// Measures the link from an endpoint to addr, see Transport::getConnectionStats().
+	bool getConnectionStats(const Uint32 from, const RakNet::SystemAddress& addr, ConnectionStats& stats);
+
+	// Returns the endpoint with address addr, or -1.
+	int findEndpoint(const RakNet::SystemAddress& addr) const;
+
+	// Sends to a single endpoint.
+	void sendTo(const Uint32 from, const Uint32 to, const RakNet::BitStream& bit, 
+				const PacketReliability reliability);
+
+	struct InFlight{
+		uint64_t arrival;
+		// Order sent in, so packets arriving at the same time keep it.
+		uint64_t order;
+		Uint32 from;
+		// Sequence number on its link, if sequenced.
+		bool sequenced;
+		Uint32 seq;
+		std::vector<unsigned char> data;
+	};
+
+	// Orders an endpoint's inbox by arrival, as a min-heap.
+	struct ArrivesLater{
+		bool operator()(const InFlight& a, const InFlight& b) const{
+			return (a.arrival != b.arrival) ? (a.arrival > b.arrival) : (a.order > b.order);
+		}
+	};
+
+	// One direction between two endpoints.
+	struct Link{
+		std::shared_ptr<NetworkConditioner> pConditioner;
+		// Arrival of the last ordered packet; later ones can't pass it.
+		uint64_t lastOrdered;
+		// Next sequence number sent, and the newest received.
+		Uint32 nextSeq;
+		bool hasSequenced;
+		Uint32 newestSequenced;
+	};
+
+	// Returns the link from one endpoint to another, creating it if needed.
+	Link& getLink(const Uint32 from, const Uint32 to);
+
+	struct Endpoint{
+		RakNet::SystemAddress addr;
+		std::vector<InFlight> inbox;
+	};
+
+	// Guards everything below; endpoints may be used from any thread.
+	mutable std::mutex m_mutex;
+	uint64_t m_seed;
+	uint64_t m_now;
+	uint64_t m_nextOrder;
+	NetworkConditions m_defaultConditions;
+	std::vector<Endpoint> m_endpoints;
+	std::map<std::pair<Uint32, Uint32>, Link> m_links;
+};
+
+// ================================================ //
+
+// One endpoint of a LoopbackNetwork.
+class LoopbackTransport : public Transport
+{
+public:
+	// Use LoopbackNetwork::createEndpoint().
+	explicit LoopbackTransport(LoopbackNetwork* pNetwork, const Uint32 index, 
+							   const RakNet::SystemAddress& addr);
+
+	// Empty destructor.
+	~LoopbackTransport(void);
+
+	// Transport
+	Uint32 send(const RakNet::BitStream& bit, const PacketPriority priority, 
+				const PacketReliability reliability, const RakNet::SystemAddress& addr, 
+				const bool broadcast = false);
+	RakNet::Packet* receive(void);
+	void deallocatePacket(RakNet::Packet* packet);
+	bool getConnectionStats(const RakNet::SystemAddress& addr, ConnectionStats& stats);
+
+	// Getters
+
+	// Returns the address other endpoints see packets from.
+	const RakNet::SystemAddress& getAddress(void) const;
+
+private:
+	LoopbackNetwork* m_pNetwork;
+	Uint32 m_index;
+	RakNet::SystemAddress m_addr;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const RakNet::SystemAddress& LoopbackTransport::getAddress(void) const{
+	return m_addr;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
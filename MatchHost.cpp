@@ -0,0 +1,313 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: MatchHost.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements MatchHost class.
+// ================================================ //
+
+#include "MatchHost.hpp"
+#include "NetMessage.hpp"
+#include "SimClock.hpp"
+#include "Engine.hpp"
+
+#include <functional>
+
+// ================================================ //
+
+MatchHost::MatchHost(Transport* transport, const SimConfig& config, const SnapshotRateConfig& rateConfig,
+					 const Uint32 maxMatches, const Uint32 numWorkers) :
+m_transport(transport),
+m_config(config),
+m_rateConfig(rateConfig),
+m_maxMatches(maxMatches),
+m_nextID(1),
+m_lastStatsTime(SimClock::now()),
+m_matches(),
+m_mutex(),
+m_wake(),
+m_shutdown(false),
+m_pool(numWorkers),
+m_scheduler()
+{
+	m_scheduler = std::thread(&MatchHost::schedulerLoop, this);
+
+	Log::getSingletonPtr()->logMessage("MatchHost: Hosting up to " + Engine::toString(m_maxMatches) +
+		" matches on " + Engine::toString(m_pool.getNumThreads()) + " worker thread(s)");
+}
+
+// ================================================ //
+
+MatchHost::~MatchHost(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_wake.notify_all();
+	m_scheduler.join();
+	m_pool.wait();
+}
+
+// ================================================ //
+
+Uint32 MatchHost::createMatch(const MatchPlayer& red, const MatchPlayer& blue,
+							  std::shared_ptr<const FighterData> pRedData,
+							  std::shared_ptr<const FighterData> pBlueData)
+{
+	std::shared_ptr<MatchInstance> pMatch;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_matches.size() >= m_maxMatches){
+			return 0;
+		}
+
+		pMatch.reset(new MatchInstance(m_nextID++, m_transport, red, blue, pRedData, pBlueData, m_config, m_rateConfig));
+		pMatch->start();
+
+		HostedMatch hosted;
+		hosted.pMatch = pMatch;
+		hosted.nextTick = SimClock::now();
+		hosted.running = false;
+		m_matches.push_back(hosted);
+	}
+	m_wake.notify_one();
+
+	Log::getSingletonPtr()->logMessage("MatchHost: Started match " + Engine::toString(pMatch->getID()) +
+		" (" + red.username + " vs " + blue.username + ")");
+
+	return pMatch->getID();
+}
+
+// ================================================ //
+
+bool MatchHost::handlePacket(const RakNet::Packet* packet)
+{
+	std::shared_ptr<MatchInstance> pMatch;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end(); ++itr){
+			if (itr->pMatch->hasPlayer(packet->systemAddress)){
+				pMatch = itr->pMatch;
+				break;
+			}
+		}
+	}
+	if (!pMatch){
+		return false;
+	}
+
+	switch (packet->data[0]){
+	default:
+		// Anything else (e.g., chat) is handled by the lobby.
+		return false;
+
+	case NetMessage::CLIENT_INPUT:
+		pMatch->handleInput(packet);
+		break;
+
+	case NetMessage::SNAPSHOT_ACK:
+		pMatch->handleAck(packet);
+		break;
+
+	case NetMessage::CLOCK_PING:
+		pMatch->handlePing(packet);
+		break;
+	}
+
+	return true;
+}
+
+// ================================================ //
+
+bool MatchHost::removePlayer(const RakNet::SystemAddress& addr)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end(); ++itr){
+		if (itr->pMatch->hasPlayer(addr)){
+			itr->pMatch->removePlayer(addr);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// ================================================ //
+
+void MatchHost::update(void)
+{
+	std::vector<std::shared_ptr<MatchInstance>> finished;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end();){
+			if (!itr->running && itr->pMatch->isOver()){
+				finished.push_back(itr->pMatch);
+				itr = m_matches.erase(itr);
+			}
+			else{
+				++itr;
+			}
+		}
+	}
+
+	for (std::vector<std::shared_ptr<MatchInstance>>::iterator itr = finished.begin();
+		 itr != finished.end();
+		 ++itr){
+		this->logMatchStats("MatchHost: Match over ", **itr);
+	}
+
+	const uint64_t now = SimClock::now();
+	if (now - m_lastStatsTime >= MatchHost::StatsInterval){
+		this->logStats();
+		m_lastStatsTime = now;
+	}
+}
+
+// ================================================ //
+
+void MatchHost::logStats(void)
+{
+	std::vector<std::shared_ptr<MatchInstance>> matches;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end(); ++itr){
+			matches.push_back(itr->pMatch);
+		}
+	}
+
+	for (std::vector<std::shared_ptr<MatchInstance>>::iterator itr = matches.begin();
+		 itr != matches.end();
+		 ++itr){
+		this->logMatchStats("MatchHost: ", **itr);
+	}
+}
+
+// ================================================ //
+
+const Uint32 MatchHost::getNumMatches(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_matches.size();
+}
+
+// ================================================ //
+
+const bool MatchHost::isPlaying(const RakNet::SystemAddress& addr)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end(); ++itr){
+		if (itr->pMatch->hasPlayer(addr)){
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// ================================================ //
+
+void MatchHost::getMatchStats(std::vector<std::pair<Uint32, MatchStats>>& stats)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	stats.clear();
+	for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end(); ++itr){
+		stats.push_back(std::make_pair(itr->pMatch->getID(), itr->pMatch->getStats()));
+	}
+}
+
+// ================================================ //
+
+void MatchHost::schedulerLoop(void)
+{
+	const uint64_t tickLength = MatchSim::TickMicroseconds;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_shutdown){
+		const uint64_t now = SimClock::now();
+		uint64_t wait = tickLength;
+
+		for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end(); ++itr){
+			if (itr->running || itr->pMatch->isOver()){
+				continue;
+			}
+
+			if (itr->nextTick > now){
+				wait = std::min(wait, itr->nextTick - now);
+				continue;
+			}
+
+			// Skip ahead rather than trying to catch up on a long stall.
+			const uint64_t behind = (now - itr->nextTick) / tickLength;
+			if (behind > MatchHost::MaxTicksBehind){
+				itr->pMatch->dropTicks(behind);
+				itr->nextTick += behind * tickLength;
+			}
+
+			const uint64_t deadline = itr->nextTick;
+			itr->nextTick += tickLength;
+			itr->running = true;
+			m_pool.enqueue(std::bind(&MatchHost::runTick, this, itr->pMatch, deadline));
+		}
+
+		m_wake.wait_for(lock, std::chrono::microseconds(wait));
+	}
+}
+
+// ================================================ //
+
+void MatchHost::runTick(std::shared_ptr<MatchInstance> pMatch, const uint64_t deadline)
+{
+	pMatch->tick(deadline);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (HostedMatchList::iterator itr = m_matches.begin(); itr != m_matches.end(); ++itr){
+			if (itr->pMatch == pMatch){
+				itr->running = false;
+				break;
+			}
+		}
+	}
+	m_wake.notify_one();
+}
+
+// ================================================ //
+
+void MatchHost::logMatchStats(const std::string& prefix, const MatchInstance& match)
+{
+	const MatchStats stats = match.getStats();
+	const uint64_t ticks = (stats.ticks == 0) ? 1 : stats.ticks;
+
+	Log::getSingletonPtr()->logMessage(prefix + Engine::toString(match.getID()) + 
+		" (" + match.getPlayer(MatchSim::RED).username + " vs " + match.getPlayer(MatchSim::BLUE).username + "): " +
+		Engine::toString(stats.ticks) + " ticks, tick time avg/max " + 
+		Engine::toString(stats.totalTickTime / ticks) + "/" + 
+		Engine::toString(stats.maxTickTime) + " us, jitter avg/max " +
+		Engine::toString(stats.totalJitter / ticks) + "/" + 
+		Engine::toString(stats.maxJitter) + " us, " + 
+		Engine::toString(stats.droppedTicks) + " dropped, " +
+		Engine::toString(stats.compensatedHits) + " hits lag-compensated, " +
+		SnapshotChannel::FormatStats(stats.snapshots));
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		Log::getSingletonPtr()->logMessage(prefix + Engine::toString(match.getID()) + " snapshots to " + 
+			match.getPlayer(i).username + ": " + SnapshotRate::FormatStats(stats.rates[i]));
+	}
+}
+
+// ================================================ //
\ No newline at end of file
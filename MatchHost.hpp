@@ -0,0 +1,149 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: MatchHost.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines MatchHost class.
+// ================================================ //
+
+#ifndef __MATCHHOST_HPP__
+#define __MATCHHOST_HPP__
+
+// ================================================ //
+
+#include "MatchInstance.hpp"
+#include "ThreadPool.hpp"
+
+#include <thread>
+#include <condition_variable>
+
+// ================================================ //
+
+// Hosts many concurrent matches in one process. A scheduler thread sleeps 
+// until the earliest tick deadline and hands each due MatchInstance to a 
+// worker pool, so a slow match only delays itself. Packets are routed to
+// their match from the network thread via handlePacket().
+class MatchHost
+{
+public:
+	// Starts the scheduler and numWorkers worker threads (0 for one per 
+	// hardware thread). At most maxMatches will run at once.
+	explicit MatchHost(Transport* transport, const SimConfig& config, const SnapshotRateConfig& rateConfig,
+					   const Uint32 maxMatches, const Uint32 numWorkers = 0);
+
+	// Stops the scheduler and waits for running ticks to finish.
+	~MatchHost(void);
+
+	// Creates and starts a match between two clients. Returns the match ID,
+	// or 0 if the host is full.
+	Uint32 createMatch(const MatchPlayer& red, const MatchPlayer& blue,
+					   std::shared_ptr<const FighterData> pRedData,
+					   std::shared_ptr<const FighterData> pBlueData);
+
+	// Passes a packet from a player in a hosted match to that match. Returns
+	// true if the packet was consumed.
+	bool handlePacket(const RakNet::Packet* packet);
+
+	// Ends the match of a player who has left. Returns true if they were 
+	// playing in a hosted match.
+	bool removePlayer(const RakNet::SystemAddress& addr);
+
+	// Removes finished matches, logging their stats, and logs the stats of 
+	// running matches every StatsInterval. Call from the network thread.
+	void update(void);
+
+	// Logs the timing stats of every match.
+	void logStats(void);
+
+	// Getters
+
+	// Returns the number of matches being hosted.
+	const Uint32 getNumMatches(void);
+
+	// Returns the maximum number of concurrent matches.
+	const Uint32 getMaxMatches(void) const;
+
+	// Returns the number of worker threads.
+	const Uint32 getNumWorkers(void) const;
+
+	// Returns true if the client at addr is playing in a hosted match.
+	const bool isPlaying(const RakNet::SystemAddress& addr);
+
+	// Fills stats with a copy of each match's ID and timing stats.
+	void getMatchStats(std::vector<std::pair<Uint32, MatchStats>>& stats);
+
+	// A match more than this many ticks behind schedule skips ahead.
+	static const Uint32 MaxTicksBehind = 8;
+
+	// How often update() logs the stats of running matches (microseconds).
+	static const uint64_t StatsInterval = 10000000;
+
+private:
+	struct HostedMatch{
+		std::shared_ptr<MatchInstance> pMatch;
+		// SimClock time the next tick is due.
+		uint64_t nextTick;
+		// True while a worker is running a tick.
+		bool running;
+	};
+
+	typedef std::vector<HostedMatch> HostedMatchList;
+
+	// Dispatches due ticks to the pool until shut down.
+	void schedulerLoop(void);
+
+	// Runs a tick on a worker, then lets the scheduler dispatch the next one.
+	void runTick(std::shared_ptr<MatchInstance> pMatch, const uint64_t deadline);
+
+	// Logs one match's stats with a prefix.
+	void logMatchStats(const std::string& prefix, const MatchInstance& match);
+
+	Transport* m_transport;
+	SimConfig m_config;
+	SnapshotRateConfig m_rateConfig;
+	Uint32 m_maxMatches;
+	Uint32 m_nextID;
+	uint64_t m_lastStatsTime;
+
+	HostedMatchList m_matches;
+	std::mutex m_mutex;
+	// Signalled when a match is added, a tick finishes, or on shutdown.
+	std::condition_variable m_wake;
+	bool m_shutdown;
+
+	ThreadPool m_pool;
+	std::thread m_scheduler;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 MatchHost::getMaxMatches(void) const{
+	return m_maxMatches;
+}
+
+inline const Uint32 MatchHost::getNumWorkers(void) const{
+	return m_pool.getNumThreads();
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
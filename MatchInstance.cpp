@@ -0,0 +1,367 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: MatchInstance.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements MatchInstance class.
+// ================================================ //
+
+#include "MatchInstance.hpp"
+#include "NetMessage.hpp"
+#include "Server.hpp"
+#include "Client.hpp"
+#include "Input.hpp"
+#include "SimFixed.hpp"
+#include "SimClock.hpp"
+
+// ================================================ //
+
+MatchInstance::MatchInstance(const Uint32 id, Transport* transport,
+							 const MatchPlayer& red, const MatchPlayer& blue,
+							 std::shared_ptr<const FighterData> pRedData,
+							 std::shared_ptr<const FighterData> pBlueData,
+							 const SimConfig& config, const SnapshotRateConfig& rateConfig) :
+m_id(id),
+m_transport(transport),
+m_sim(pRedData, pBlueData, config),
+m_inputMutex(),
+m_tick(0),
+m_over(false),
+m_snapshots(),
+m_resyncTicks(0),
+m_statsMutex(),
+m_stats()
+{
+	m_players[MatchSim::RED] = red;
+	m_players[MatchSim::BLUE] = blue;
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		m_lastProcessedInput[i] = 0;
+		m_snapshotAcks[i] = 0;
+		m_hasSnapshotAck[i] = false;
+		// Start at one snapshot per tick.
+		m_pRates[i].reset(new SnapshotRate(rateConfig, 1000 / MatchSim::TickRate));
+	}
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+// ================================================ //
+
+MatchInstance::~MatchInstance(void)
+{
+
+}
+
+// ================================================ //
+
+void MatchInstance::start(void)
+{
+	// Only the two players are told about this match, the rest of the lobby
+	// may be playing other matches.
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::SERVER_STARTING_GAME));
+	bit.Write(m_players[MatchSim::RED].username.c_str());
+	bit.Write(m_players[MatchSim::BLUE].username.c_str());
+	bit.Write(m_players[MatchSim::RED].fighter);
+	bit.Write(m_players[MatchSim::BLUE].fighter);
+	this->send(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
+
+	RakNet::BitStream red;
+	red.Write(static_cast<RakNet::MessageID>(NetMessage::PLAYING_RED));
+	m_transport->send(red, IMMEDIATE_PRIORITY, RELIABLE_ORDERED, m_players[MatchSim::RED].addr);
+
+	RakNet::BitStream blue;
+	blue.Write(static_cast<RakNet::MessageID>(NetMessage::PLAYING_BLUE));
+	m_transport->send(blue, IMMEDIATE_PRIORITY, RELIABLE_ORDERED, m_players[MatchSim::BLUE].addr);
+}
+
+// ================================================ //
+
+void MatchInstance::handleInput(const RakNet::Packet* packet)
+{
+	const int n = (packet->systemAddress == m_players[MatchSim::RED].addr) ? MatchSim::RED : MatchSim::BLUE;
+
+	std::lock_guard<std::mutex> lock(m_inputMutex);
+
+	// Only ticks newer than the last one received, so redundant copies are 
+	// skipped. Each is queued for its own tick.
+	Client::NetInput inputs[Client::InputRedundancy];
+	Uint32 stageShiftSeq = 0;
+	const int count = Client::ReadInputs(packet, m_inputs[n].getLastReceived(), inputs, stageShiftSeq);
+	for (int i = 0; i < count; ++i){
+		if ((inputs[i].buttons >> Input::NUM_BUTTONS) == 0){
+			m_inputs[n].push(inputs[i].seq, inputs[i].buttons, inputs[i].viewTick);
+		}
+	}
+}
+
+// ================================================ //
+
+void MatchInstance::handleAck(const RakNet::Packet* packet)
+{
+	RakNet::BitStream bit(packet->data, packet->length, false);
+	bit.IgnoreBytes(sizeof(RakNet::MessageID));
+	Uint16 seq = 0;
+	if (!bit.Read(seq)){
+		return;
+	}
+
+	const int n = (packet->systemAddress == m_players[MatchSim::RED].addr) ? MatchSim::RED : MatchSim::BLUE;
+
+	std::lock_guard<std::mutex> lock(m_inputMutex);
+	m_snapshotAcks[n] = seq;
+	m_hasSnapshotAck[n] = true;
+}
+
+// ================================================ //
+
+void MatchInstance::handlePing(const RakNet::Packet* packet)
+{
+	Uint32 tick = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_inputMutex);
+		tick = m_tick;
+	}
+
+	RakNet::BitStream pong;
+	if (ClockSync::WritePong(packet, pong, SimClock::now(), tick)){
+		m_transport->send(pong, IMMEDIATE_PRIORITY, UNRELIABLE, packet->systemAddress);
+	}
+}
+
+// ================================================ //
+
+void MatchInstance::removePlayer(const RakNet::SystemAddress& addr)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_inputMutex);
+		if (m_over){
+			return;
+		}
+	}
+
+	// Tell the remaining player before awarding them the match.
+	const int left = (addr == m_players[MatchSim::RED].addr) ? MatchSim::RED : MatchSim::BLUE;
+	const int remaining = (left == MatchSim::RED) ? MatchSim::BLUE : MatchSim::RED;
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::CLIENT_DISCONNECTED));
+	bit.Write(m_players[left].username.c_str());
+	m_transport->send(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED, m_players[remaining].addr);
+
+	this->end(remaining);
+}
+
+// ================================================ //
+
+void MatchInstance::tick(const uint64_t deadline)
+{
+	const uint64_t start = SimClock::now();
+
+	SimInput inputs[MatchSim::NUM_FIGHTERS];
+	{
+		std::lock_guard<std::mutex> lock(m_inputMutex);
+		if (m_over){
+			return;
+		}
+		for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+			inputs[i] = m_inputs[i].pop();
+
+			// Test hits where the player saw the other fighter on that tick.
+			if (m_inputs[i].getLastConsumed() != m_lastProcessedInput[i]){
+				m_lastProcessedInput[i] = m_inputs[i].getLastConsumed();
+				m_sim.setViewTick(i, m_inputs[i].getViewTick());
+			}
+		}
+	}
+
+	m_sim.step(inputs);
+	{
+		std::lock_guard<std::mutex> lock(m_inputMutex);
+		m_tick = m_sim.getTick();
+	}
+
+	this->sendSnapshot();
+	if (m_resyncTicks == 0){
+		this->sendResync();
+		m_resyncTicks = (MatchInstance::ResyncInterval * MatchSim::TickRate) / 1000;
+	}
+	--m_resyncTicks;
+
+	if (m_sim.getFighterState(MatchSim::RED).hp <= 0){
+		this->end(MatchSim::BLUE);
+	}
+	else if (m_sim.getFighterState(MatchSim::BLUE).hp <= 0){
+		this->end(MatchSim::RED);
+	}
+
+	const uint64_t end = SimClock::now();
+	const uint64_t elapsed = end - start;
+	const uint64_t jitter = (start > deadline) ? start - deadline : 0;
+
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	++m_stats.ticks;
+	m_stats.lastTickTime = elapsed;
+	m_stats.totalTickTime += elapsed;
+	if (elapsed > m_stats.maxTickTime){
+		m_stats.maxTickTime = elapsed;
+	}
+	m_stats.lastJitter = jitter;
+	m_stats.totalJitter += jitter;
+	if (jitter > m_stats.maxJitter){
+		m_stats.maxJitter = jitter;
+	}
+
+	m_stats.snapshots = m_snapshots.getStats();
+	m_stats.compensatedHits = m_sim.getCompensatedHits();
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		m_stats.rates[i] = m_pRates[i]->getStats();
+	}
+}
+
+// ================================================ //
+
+void MatchInstance::dropTicks(const uint64_t ticks)
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	m_stats.droppedTicks += ticks;
+}
+
+// ================================================ //
+
+void MatchInstance::send(const RakNet::BitStream& bit, const PacketPriority priority,
+						 const PacketReliability reliability)
+{
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		m_transport->send(bit, priority, reliability, m_players[i].addr);
+	}
+}
+
+// ================================================ //
+
+void MatchInstance::sendSnapshot(void)
+{
+	// Timed by the match's own ticks, which run on schedule.
+	const uint64_t now = static_cast<uint64_t>(m_sim.getTick()) * MatchSim::TickMicroseconds;
+	SnapshotRate::Action actions[MatchSim::NUM_FIGHTERS];
+	bool due = false;
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		m_pRates[i]->update(m_transport, m_players[i].addr, now);
+		actions[i] = m_pRates[i]->poll(now);
+		due |= (actions[i] == SnapshotRate::SEND_NEW);
+	}
+
+	bool hasAck[MatchSim::NUM_FIGHTERS];
+	Uint16 acks[MatchSim::NUM_FIGHTERS];
+	if (due){
+		WorldSnapshot snapshot;
+		{
+			std::lock_guard<std::mutex> lock(m_inputMutex);
+			for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+				snapshot.players[i].lastProcessedInput = m_lastProcessedInput[i];
+				hasAck[i] = m_hasSnapshotAck[i];
+				acks[i] = m_snapshotAcks[i];
+			}
+		}
+
+		snapshot.tick = m_sim.getTick();
+		snapshot.cameraPanX = m_sim.getCamera().panX;
+		for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+			const SimFighterState& f = m_sim.getFighterState(i);
+			PlayerUpdate& update = snapshot.players[i];
+			update.x = f.x;
+			update.y = f.y;
+			update.xVel = SimFixed::toPixelsPerSecond(f.xVel, MatchSim::TickRate);
+			update.state = f.state;
+			update.hp = (f.hp > 0) ? static_cast<Uint32>(f.hp) : 0;
+			update.stun = f.stun;
+		}
+		m_snapshots.push(snapshot);
+	}
+
+	// Both players share one packet when they acknowledged the same snapshot.
+	// Players not due a new one may get their last one again.
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		if (actions[i] == SnapshotRate::SEND_NEW){
+			m_pLastPackets[i] = m_snapshots.getPacket(hasAck[i], acks[i]);
+		}
+		else if (actions[i] == SnapshotRate::SKIP || !m_pLastPackets[i]){
+			continue;
+		}
+		m_transport->send(*m_pLastPackets[i], IMMEDIATE_PRIORITY, UNRELIABLE_SEQUENCED, m_players[i].addr);
+	}
+}
+
+// ================================================ //
+
+void MatchInstance::sendResync(void)
+{
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		Uint32 lastProcessedInput = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_inputMutex);
+			lastProcessedInput = m_lastProcessedInput[i];
+		}
+
+		RakNet::BitStream bit;
+		bit.Write(static_cast<RakNet::MessageID>(NetMessage::LAST_PROCESSED_INPUT_SEQUENCE));
+		bit.Write(lastProcessedInput);
+		m_transport->send(bit, HIGH_PRIORITY, UNRELIABLE, m_players[i].addr);
+	}
+}
+
+// ================================================ //
+
+void MatchInstance::end(const int victor)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_inputMutex);
+		if (m_over){
+			return;
+		}
+		m_over = true;
+	}
+
+	RakNet::BitStream bit;
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::MATCH_OVER));
+	bit.Write(m_players[victor].username.c_str());
+	this->send(bit, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
+}
+
+// ================================================ //
+
+const bool MatchInstance::hasPlayer(const RakNet::SystemAddress& addr) const
+{
+	return (addr == m_players[MatchSim::RED].addr || addr == m_players[MatchSim::BLUE].addr);
+}
+
+// ================================================ //
+
+const bool MatchInstance::isOver(void) const
+{
+	std::lock_guard<std::mutex> lock(m_inputMutex);
+	return m_over;
+}
+
+// ================================================ //
+
+const MatchStats MatchInstance::getStats(void) const
+{
+	std::lock_guard<std::mutex> lock(m_statsMutex);
+	return m_stats;
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,195 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: MatchInstance.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines MatchInstance class.
+// ================================================ //
+
+#ifndef __MATCHINSTANCE_HPP__
+#define __MATCHINSTANCE_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+#include "MatchSim.hpp"
+#include "Transport.hpp"
+#include "SnapshotChannel.hpp"
+#include "SnapshotRate.hpp"
+#include "InputQueue.hpp"
+
+#include <mutex>
+
+// ================================================ //
+
+// A client playing in a hosted match.
+struct MatchPlayer{
+	RakNet::SystemAddress addr;
+	std::string username;
+	Uint32 fighter;
+};
+
+// Server-side timing of a single match. All times are in microseconds.
+struct MatchStats{
+	// Ticks simulated.
+	uint64_t ticks;
+	// Time spent in tick() by the last tick, the longest tick, and in total.
+	// Measured on the worker thread, so it approximates CPU time per match.
+	uint64_t lastTickTime, maxTickTime, totalTickTime;
+	// How late each tick started relative to its deadline (last, worst, total).
+	uint64_t lastJitter, maxJitter, totalJitter;
+	// Ticks dropped because the match fell too far behind its schedule.
+	uint64_t droppedTicks;
+	// Bandwidth used by WORLD_SNAPSHOT, for both players.
+	SnapshotStats snapshots;
+	// Hits that only landed because of lag compensation.
+	uint32_t compensatedHits;
+	// Each player's snapshot rate, indexed by MatchSim::RED and MatchSim::BLUE.
+	SnapshotRateStats rates[MatchSim::NUM_FIGHTERS];
+};
+
+// ================================================ //
+
+// One match hosted by a MatchHost. Owns the connections of its two players,
+// the MatchSim, and its tick deadline. Inputs are queued from the network 
+// thread, while tick() runs on a worker thread; the two only share the 
+// input state, which is guarded by a mutex. Speaks the same protocol as
+// the GameState server loop, so clients can't tell the difference.
+class MatchInstance
+{
+public:
+	// Creates the match simulation. Nothing is sent until start() is called.
+	explicit MatchInstance(const Uint32 id, Transport* transport, 
+						   const MatchPlayer& red, const MatchPlayer& blue,
+						   std::shared_ptr<const FighterData> pRedData, 
+						   std::shared_ptr<const FighterData> pBlueData,
+						   const SimConfig& config, const SnapshotRateConfig& rateConfig);
+
+	// Empty destructor.
+	~MatchInstance(void);
+
+	// Tells both players the match is starting and which side they play.
+	void start(void);
+
+	// Applies the new ticks of a CLIENT_INPUT packet from one of the 
+	// players. Called from the network thread.
+	void handleInput(const RakNet::Packet* packet);
+
+	// Applies a SNAPSHOT_ACK packet from one of the players. Called 
+	// from the network thread.
+	void handleAck(const RakNet::Packet* packet);
+
+	// Answers a CLOCK_PING packet from one of the players with the match's
+	// tick. Called from the network thread.
+	void handlePing(const RakNet::Packet* packet);
+
+	// Ends the match because a player left, awarding it to the other player.
+	// Called from the network thread.
+	void removePlayer(const RakNet::SystemAddress& addr);
+
+	// Simulates one tick and sends the results to both players. deadline is
+	// the SimClock time the tick was scheduled for. Called from a worker.
+	void tick(const uint64_t deadline);
+
+	// Records that the match fell behind and ticks were skipped.
+	void dropTicks(const uint64_t ticks);
+
+	// Getters
+
+	// Returns true if addr is one of this match's players.
+	const bool hasPlayer(const RakNet::SystemAddress& addr) const;
+
+	// Returns the match ID.
+	const Uint32 getID(void) const;
+
+	// Returns the player on the given side (MatchSim::RED or MatchSim::BLUE).
+	const MatchPlayer& getPlayer(const int fighter) const;
+
+	// Returns true once a player has won or left.
+	const bool isOver(void) const;
+
+	// Returns a copy of the timing stats.
+	const MatchStats getStats(void) const;
+
+	// How often the last processed inputs are resent (ms).
+	static const Uint32 ResyncInterval = 3000;
+
+private:
+	// Sends a bitstream to both players.
+	void send(const RakNet::BitStream& bit, const PacketPriority priority, 
+			  const PacketReliability reliability);
+
+	// Takes a WorldSnapshot of the tick and sends it to the players whose
+	// SnapshotRate is due one, delta-encoded against the last snapshot each
+	// acknowledged. Players not due one may get a repeat of their last.
+	void sendSnapshot(void);
+
+	// Sends the last processed inputs.
+	void sendResync(void);
+
+	// Sends MATCH_OVER and marks the match as over.
+	void end(const int victor);
+
+	Uint32 m_id;
+	Transport* m_transport;
+	MatchPlayer m_players[MatchSim::NUM_FIGHTERS];
+	MatchSim m_sim;
+
+	// Input state shared with the network thread.
+	mutable std::mutex m_inputMutex;
+	// Each player's inputs, one consumed per tick along with the tick they 
+	// saw their opponent at, for lag compensation.
+	InputQueue m_inputs[MatchSim::NUM_FIGHTERS];
+	// The seq of the input each player's last tick used.
+	Uint32 m_lastProcessedInput[MatchSim::NUM_FIGHTERS];
+	// The tick simulated last, for clock sync.
+	Uint32 m_tick;
+	Uint16 m_snapshotAcks[MatchSim::NUM_FIGHTERS];
+	bool m_hasSnapshotAck[MatchSim::NUM_FIGHTERS];
+	bool m_over;
+
+	// Snapshots sent to both players, how often each gets one, and the 
+	// last packet each was sent. Only used by tick().
+	SnapshotChannel m_snapshots;
+	std::shared_ptr<SnapshotRate> m_pRates[MatchSim::NUM_FIGHTERS];
+	std::shared_ptr<const RakNet::BitStream> m_pLastPackets[MatchSim::NUM_FIGHTERS];
+
+	// Ticks until the next resync is sent.
+	uint32_t m_resyncTicks;
+
+	mutable std::mutex m_statsMutex;
+	MatchStats m_stats;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 MatchInstance::getID(void) const{
+	return m_id;
+}
+
+inline const MatchPlayer& MatchInstance::getPlayer(const int fighter) const{
+	return m_players[fighter];
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
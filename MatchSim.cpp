@@ -0,0 +1,847 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: MatchSim.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements MatchSim class.
+// ================================================ //
+
+#include "MatchSim.hpp"
+#include "SimFixed.hpp"
+
+#include <type_traits>
+
+// ================================================ //
+
+namespace{
+	// Bitmask of states each state may transition to (see 
+	// Player::loadFighterData() for the equivalent FSM).
+	#define STATE_BIT(s) (1u << FighterState::s)
+	const uint32_t Transitions[FighterState::END_STATES] = {
+		// IDLE
+		STATE_BIT(WALKING_FORWARD) | STATE_BIT(WALKING_BACK) | STATE_BIT(JUMPING) |
+		STATE_BIT(CROUCHING) | STATE_BIT(ATTACK_LP),
+		// WALKING_FORWARD
+		STATE_BIT(IDLE) | STATE_BIT(WALKING_BACK) | STATE_BIT(JUMPING) |
+		STATE_BIT(CROUCHING) | STATE_BIT(ATTACK_LP),
+		// WALKING_BACK
+		STATE_BIT(IDLE) | STATE_BIT(WALKING_FORWARD) | STATE_BIT(JUMPING) |
+		STATE_BIT(CROUCHING) | STATE_BIT(ATTACK_LP),
+		// JUMPING
+		0,
+		// CROUCHING
+		STATE_BIT(IDLE) | STATE_BIT(CROUCHED) | STATE_BIT(JUMPING),
+		// CROUCHED
+		STATE_BIT(UNCROUCHING) | STATE_BIT(JUMPING),
+		// UNCROUCHING
+		STATE_BIT(JUMPING),
+		// ATTACK_LP
+		0,
+		// STUNNED_JUMP
+		0,
+		// STUNNED_HIT
+		0,
+		// STUNNED_BLOCK
+		0
+	};
+	#undef STATE_BIT
+}
+
+// ================================================ //
+
+static_assert(std::is_trivially_copyable<MatchState>::value, "MatchState must be trivially copyable");
+static_assert(sizeof(MatchState) == sizeof(SimFighterState) * 2 + sizeof(SimCamera) + sizeof(uint32_t),
+			  "MatchState must not contain implicit padding");
+
+// ================================================ //
+
+const double MatchSim::TickLength = 1.0 / static_cast<double>(MatchSim::TickRate);
+
+// ================================================ //
+
+SimConfig::SimConfig(void) :
+viewWidth(854),
+viewHeight(480),
+stageViewWidth(854),
+cameraRightBound(343),
+cameraSpeed(400),
+cameraStartX(0),
+startingOffset(40),
+floorOffset(26),
+lagCompensationTicks(0)
+{
+
+}
+
+// ================================================ //
+
+MatchSim::MatchSim(std::shared_ptr<const FighterData> red,
+				   std::shared_ptr<const FighterData> blue,
+				   const SimConfig& config) :
+m_config(config),
+m_state(),
+m_events()
+{
+	m_pData[RED] = red;
+	m_pData[BLUE] = blue;
+
+	if (m_config.lagCompensationTicks >= MatchSim::HistoryTicks){
+		m_config.lagCompensationTicks = MatchSim::HistoryTicks - 1;
+	}
+
+	for (int n = 0; n < NUM_FIGHTERS; ++n){
+		this->buildPhysics(n);
+	}
+
+	this->reset();
+}
+
+// ================================================ //
+
+MatchSim::~MatchSim(void)
+{
+
+}
+
+// ================================================ //
+
+void MatchSim::buildPhysics(const int n)
+{
+	const FighterData& data = *m_pData[n];
+	Physics& p = m_physics[n];
+
+	p.xAccel = SimFixed::toSubPixelsPerTick(data.xAccel, MatchSim::TickRate);
+	p.xMax = SimFixed::toSubPixelsPerTick(data.xMax, MatchSim::TickRate);
+	// Jumping moves at 1.75x max walking speed.
+	p.xJumpMax = SimFixed::divRound(p.xMax * 7, 4);
+
+	// Tabulate sin(phase) * jumpStrength for each tick until the phase reaches PI.
+	p.jumpArc.clear();
+	const int32_t step = SimFixed::toAnglePerTick(data.jumpSpeed, MatchSim::TickRate);
+	if (step <= 0){
+		p.jumpArc.push_back(0);
+		return;
+	}
+	for (int32_t angle = 0; angle < SimFixed::HalfTurn; angle += step){
+		const int32_t height = SimFixed::sinHalfTurn(angle) * data.jumpStrength;
+		p.jumpArc.push_back(SimFixed::divRound(height, SimFixed::One));
+	}
+}
+
+// ================================================ //
+
+void MatchSim::reset(void)
+{
+	memset(&m_state, 0, sizeof(m_state));
+
+	for (int n = 0; n < NUM_FIGHTERS; ++n){
+		SimFighterState& f = m_state.fighters[n];
+
+		f.w = m_pData[n]->w;
+		f.h = m_pData[n]->h;
+		f.y = this->getFloor(n);
+		f.hp = m_pData[n]->hp;
+		f.state = FighterState::IDLE;
+		f.move = FighterState::IDLE;
+		f.lpReactivated = 1;
+	}
+
+	// Set default starting sides and positions.
+	m_state.fighters[RED].side = MatchSim::LEFT;
+	m_state.fighters[RED].x = m_config.startingOffset;
+	m_state.fighters[BLUE].side = MatchSim::RIGHT;
+	m_state.fighters[BLUE].x = m_config.viewWidth - m_state.fighters[BLUE].w - m_config.startingOffset;
+
+	this->panCamera(m_config.cameraStartX);
+	m_state.camera.x = m_state.camera.lastX = m_state.camera.panX;
+
+	for (int n = 0; n < NUM_FIGHTERS; ++n){
+		this->updateHitboxes(n);
+	}
+
+	memset(m_historyValid, 0, sizeof(m_historyValid));
+	memset(m_rewind, 0, sizeof(m_rewind));
+	m_compensatedHits = 0;
+	this->recordHurtboxes();
+
+	m_events.clear();
+}
+
+// ================================================ //
+
+void MatchSim::step(const SimInput inputs[NUM_FIGHTERS])
+{
+	m_events.clear();
+
+	this->updateCamera();
+
+	// Store x values for calculating distance moved.
+	const int32_t redOldX = m_state.fighters[RED].x;
+	const int32_t blueOldX = m_state.fighters[BLUE].x;
+	const uint32_t oldStates[NUM_FIGHTERS] = { m_state.fighters[RED].state, m_state.fighters[BLUE].state };
+
+	for (int n = 0; n < NUM_FIGHTERS; ++n){
+		this->processInput(n, inputs[n]);
+		this->applyInput(n);
+	}
+
+	// Hitboxes are from the end of the last tick.
+	this->testHits();
+
+	for (int n = 0; n < NUM_FIGHTERS; ++n){
+		this->updateMove(n);
+		this->clampToView(n);
+		this->updateHitboxes(n);
+	}
+
+	this->resolvePositions(redOldX, blueOldX);
+
+	for (int n = 0; n < NUM_FIGHTERS; ++n){
+		if (m_state.fighters[n].state != oldStates[n]){
+			SimEvent e;
+			e.tick = m_state.tick;
+			e.type = SimEvent::STATE_CHANGE;
+			e.fighter = n;
+			e.damage = 0;
+			e.stun = m_state.fighters[n].stun;
+			e.state = m_state.fighters[n].state;
+			m_events.push_back(e);
+		}
+	}
+
+	++m_state.tick;
+
+	if (m_config.lagCompensationTicks > 0){
+		this->recordHurtboxes();
+	}
+}
+
+// ================================================ //
+
+const MatchState& MatchSim::fastForward(const SimInput* inputs, const uint32_t count, 
+										SimEventList* pLog)
+{
+	for (uint32_t t = 0; t < count; ++t){
+		this->step(&inputs[t * NUM_FIGHTERS]);
+		if (pLog && !m_events.empty()){
+			pLog->insert(pLog->end(), m_events.begin(), m_events.end());
+		}
+	}
+
+	return m_state;
+}
+
+// ================================================ //
+
+void MatchSim::save(MatchState& state) const
+{
+	memcpy(&state, &m_state, sizeof(MatchState));
+}
+
+// ================================================ //
+
+void MatchSim::load(const MatchState& state)
+{
+	memcpy(&m_state, &state, sizeof(MatchState));
+	m_events.clear();
+
+	// The history no longer matches the state.
+	memset(m_historyValid, 0, sizeof(m_historyValid));
+}
+
+// ================================================ //
+
+void MatchSim::setViewTick(const int n, const uint32_t tick)
+{
+	const uint32_t ticks = (tick != 0 && tick < m_state.tick) ? m_state.tick - tick : 0;
+	m_rewind[n] = (ticks < m_config.lagCompensationTicks) ? ticks : m_config.lagCompensationTicks;
+}
+
+// ================================================ //
+
+uint32_t MatchSim::Checksum(const MatchState& state)
+{
+	// FNV-1a.
+	const uint8_t* p = reinterpret_cast<const uint8_t*>(&state);
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < sizeof(MatchState); ++i){
+		hash ^= p[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+// ================================================ //
+
+void MatchSim::processInput(const int n, const SimInput input)
+{
+	SimFighterState& f = m_state.fighters[n];
+	const Physics& p = m_physics[n];
+
+	// Enter jumping state if up is pressed and is possible.
+	if (input & SimButton::UP){
+		// Prevent x velocity modification in the air.
+		if (f.state != FighterState::JUMPING){
+			if (this->stateTransition(f, FighterState::JUMPING)){
+				if (input & SimButton::RIGHT){
+					f.xJumpVel = p.xJumpMax;
+				}
+				else if (input & SimButton::LEFT){
+					f.xJumpVel = -p.xJumpMax;
+				}
+				else{
+					f.xJumpVel = 0;
+				}
+			}
+		}
+	}
+	// Enter crouching state if possible.
+	else if (input & SimButton::DOWN){
+		if (f.state != FighterState::CROUCHED){
+			this->stateTransition(f, FighterState::CROUCHING);
+		}
+	}
+	// Uncrouch if crouched and no longer holding down.
+	else if (f.state == FighterState::CROUCHED){
+		this->stateTransition(f, FighterState::UNCROUCHING);
+	}
+
+	// Process attack buttons. LP must be released between attacks.
+	if (input & SimButton::LP){
+		if (f.state != FighterState::ATTACK_LP && f.lpReactivated){
+			this->stateTransition(f, FighterState::ATTACK_LP);
+			// Allow this move's hitboxes to connect.
+			f.hitboxesActive = 1;
+			f.lpReactivated = 0;
+		}
+	}
+	else{
+		f.lpReactivated = 1;
+	}
+
+	const bool left = ((input & SimButton::LEFT) != 0);
+	const bool right = ((input & SimButton::RIGHT) != 0);
+
+	// Process general movement.
+	switch (f.state){
+	// Checking both left and right cancels out movement if both are held.
+	default:
+	case FighterState::IDLE:
+	case FighterState::WALKING_BACK:
+	case FighterState::WALKING_FORWARD:
+		if (left && !right){
+			f.xVel -= p.xAccel;
+			if (f.xVel < -p.xMax){
+				f.xVel = -p.xMax;
+			}
+
+			this->stateTransition(f, (f.side == MatchSim::LEFT) ? FighterState::WALKING_BACK :
+								  FighterState::WALKING_FORWARD);
+			if (f.state == FighterState::WALKING_BACK){
+				f.xVel = (f.xVel * 9) / 10;
+			}
+		}
+		else if (right && !left){
+			f.xVel += p.xAccel;
+			if (f.xVel > p.xMax){
+				f.xVel = p.xMax;
+			}
+
+			this->stateTransition(f, (f.side == MatchSim::LEFT) ? FighterState::WALKING_FORWARD :
+								  FighterState::WALKING_BACK);
+			if (f.state == FighterState::WALKING_BACK){
+				f.xVel = (f.xVel * 9) / 10;
+			}
+		}
+		else{
+			f.xVel = 0;
+
+			this->stateTransition(f, FighterState::IDLE);
+		}
+		break;
+
+	// Process jumping mechanics.
+	case FighterState::JUMPING:
+		++f.jump;
+		if (f.jump >= static_cast<int32_t>(p.jumpArc.size())){
+			f.state = FighterState::STUNNED_JUMP;
+			f.jump = 0;
+		}
+		break;
+
+	case FighterState::CROUCHING:
+	case FighterState::CROUCHED:
+	case FighterState::ATTACK_LP:
+	case FighterState::STUNNED_JUMP:
+	case FighterState::STUNNED_HIT:
+	case FighterState::STUNNED_BLOCK:
+		f.xVel = 0;
+		break;
+	}
+}
+
+// ================================================ //
+
+void MatchSim::applyInput(const int n)
+{
+	SimFighterState& f = m_state.fighters[n];
+
+	// Move by whole pixels, carrying the sub-pixel remainder to the next tick.
+	const int32_t vel = (f.state == FighterState::JUMPING) ? f.xJumpVel : f.xVel;
+	const int32_t moved = f.xFrac + vel;
+	f.translateX = SimFixed::divFloor(moved, SimFixed::SubPixels);
+	f.xFrac = moved - (f.translateX * SimFixed::SubPixels);
+	f.x += f.translateX;
+
+	f.y = this->getFloor(n) - m_physics[n].jumpArc[f.jump];
+}
+
+// ================================================ //
+
+void MatchSim::updateMove(const int n)
+{
+	SimFighterState& f = m_state.fighters[n];
+	const FighterData& data = *m_pData[n];
+
+	// Start the new move from its first frame if the state has changed.
+	if (f.move != static_cast<int32_t>(f.state)){
+		f.move = f.state;
+		f.frame = 0;
+		f.frameTicks = 0;
+		f.w = data.w; 
+		f.h = data.h;
+		this->applyFrameSize(n);
+	}
+
+	const FighterMove& move = data.moves[f.move];
+	const int32_t numFrames = static_cast<int32_t>(move.numFrames);
+	if (numFrames == 0){
+		return;
+	}
+
+	++f.frameTicks;
+
+	// Process move-specific instructions.
+	switch (f.move){
+	default:
+		// If this frame has been shown for its full gap (ticks).
+		if (f.frameTicks >= move.frameGap){
+			// Increment to the next frame in this move.
+			if (f.frame < numFrames){
+				++f.frame;
+			}
+
+			// If we have reached the end of the move, process move instructions.
+			if (f.frame >= numFrames){
+				if (move.repeat){
+					// Roll back to the repeat frame.
+					f.frame = move.repeatFrame;
+				}
+				else if (move.transition >= 0){
+					// Change the move now to avoid frame locks (when the input is 
+					// held and the move stays in the last frame).
+					f.state = f.move = move.transition;
+					f.frame = 0;
+					f.w = data.w;
+					f.h = data.h;
+				}
+				else{
+					// This move doesn't repeat or transition, so stay on the last frame.
+					f.frame = numFrames - 1;
+				}
+			}
+
+			f.frameTicks = 0;
+			this->applyFrameSize(n);
+		}
+		break;
+
+	case FighterState::STUNNED_HIT:
+	case FighterState::STUNNED_BLOCK:
+		// If the fighter has been stunned for the assigned amount of time, switch out.
+		if (f.frameTicks >= f.stun){
+			f.state = (move.transition >= 0) ? move.transition : FighterState::IDLE;
+			f.frameTicks = 0;
+		}
+		break;
+	}
+}
+
+// ================================================ //
+
+void MatchSim::applyFrameSize(const int n)
+{
+	SimFighterState& f = m_state.fighters[n];
+	const FighterMove& move = m_pData[n]->moves[f.move];
+	if (move.numFrames == 0){
+		return;
+	}
+
+	const FighterFrame& frame = m_pData[n]->getFrame(move, f.frame);
+	const FighterFrame& first = m_pData[n]->getFrame(move, 0);
+
+	// Modify rendering width and height of fighter to current frame settings.
+	if (frame.src.w >= first.src.w){
+		f.w += frame.rw;
+		// Adjust position when the rendering is flipped.
+		if (f.side == MatchSim::RIGHT){
+			f.x -= frame.rw * 2;
+		}
+	}
+	if (frame.src.h >= first.src.h){
+		f.h += frame.rh;
+	}
+}
+
+// ================================================ //
+
+void MatchSim::clampToView(const int n)
+{
+	SimFighterState& f = m_state.fighters[n];
+
+	const int32_t renderX = f.x - m_state.camera.x + (f.w / 2);
+	const int32_t maxX = m_config.viewWidth - m_pData[n]->w;
+
+	if (renderX < 0){
+		f.x -= f.translateX;
+
+		// Prevent fighter's hitboxes from being pushed past edge of stage.
+		const int32_t bound = -(f.w / 2);
+		if (f.x < bound){
+			f.x = bound;
+		}
+	}
+	else if (renderX > maxX){
+		f.x -= f.translateX;
+
+		const int32_t bound = m_config.stageViewWidth + m_state.camera.x + (f.w / 2);
+		if (f.x > bound){
+			f.x = bound;
+		}
+	}
+
+	f.translateX = 0;
+}
+
+// ================================================ //
+
+void MatchSim::updateHitboxes(const int n)
+{
+	SimFighterState& f = m_state.fighters[n];
+	const FighterMove& move = m_pData[n]->moves[f.move];
+	if (move.numFrames == 0){
+		memset(f.hitboxes, 0, sizeof(f.hitboxes));
+		return;
+	}
+
+	const FighterFrame& frame = m_pData[n]->getFrame(move, f.frame);
+	const int32_t xCenter = f.x + (f.w / 2);
+	const int32_t yCenter = f.y + (f.h / 2);
+
+	// Each hitbox originates from the fighter's center, so a hitbox of 
+	// (50, 0, 50, 50) will be 50x50 and 50 units in front of the center.
+	for (int i = 0; i < SimHitbox::NUM_HITBOXES; ++i){
+		SimRect offset = frame.hitboxes[i];
+		if (f.side == MatchSim::LEFT){
+			offset.x += f.w / 2;
+		}
+		else{
+			offset.x -= f.w / 2;
+			offset.x = -offset.x;
+		}
+
+		f.hitboxes[i].x = xCenter - (offset.w / 2) + offset.x;
+		f.hitboxes[i].y = yCenter - (offset.h / 2) + offset.y;
+		f.hitboxes[i].w = offset.w;
+		f.hitboxes[i].h = offset.h;
+	}
+}
+
+// ================================================ //
+
+void MatchSim::testHits(void)
+{
+	SimFighterState& red = m_state.fighters[RED];
+	SimFighterState& blue = m_state.fighters[BLUE];
+
+	for (int i = SimHitbox::DBOX1; i <= SimHitbox::DBOX2; ++i){
+		for (int j = SimHitbox::HBOX_LOWER; j <= SimHitbox::HBOX_HEAD; ++j){
+			if (red.hitboxesActive && this->testHit(RED, i, j)){
+				red.hitboxesActive = 0;
+				this->takeHit(BLUE, m_pData[RED]->moves[red.move]);
+			}
+			if (blue.hitboxesActive && this->testHit(BLUE, i, j)){
+				blue.hitboxesActive = 0;
+				this->takeHit(RED, m_pData[BLUE]->moves[blue.move]);
+			}
+		}
+	}
+}
+
+// ================================================ //
+
+bool MatchSim::testHit(const int n, const int i, const int j)
+{
+	const SimRect& box = m_state.fighters[n].hitboxes[i];
+	const SimRect& hurtbox = m_state.fighters[(n == RED) ? BLUE : RED].hitboxes[j];
+	if (m_rewind[n] == 0 || m_rewind[n] > m_state.tick){
+		return SimRectIntersects(box, hurtbox);
+	}
+
+	// Test against the hurtbox as n's client saw it, if still in the history.
+	const uint32_t tick = m_state.tick - m_rewind[n];
+	const uint32_t slot = tick % MatchSim::HistoryTicks;
+	if (!m_historyValid[slot] || m_historyTick[slot] != tick){
+		return SimRectIntersects(box, hurtbox);
+	}
+
+	const PackedRect& packed = m_hurtboxHistory[slot][(n == RED) ? BLUE : RED][j];
+	SimRect rewound;
+	rewound.x = packed.x;
+	rewound.y = packed.y;
+	rewound.w = packed.w;
+	rewound.h = packed.h;
+	if (!SimRectIntersects(box, rewound)){
+		return false;
+	}
+
+	if (!SimRectIntersects(box, hurtbox)){
+		++m_compensatedHits;
+	}
+	return true;
+}
+
+// ================================================ //
+
+void MatchSim::recordHurtboxes(void)
+{
+	const uint32_t slot = m_state.tick % MatchSim::HistoryTicks;
+	for (int n = 0; n < NUM_FIGHTERS; ++n){
+		for (int j = 0; j < MatchSim::NumHurtboxes; ++j){
+			const SimRect& rect = m_state.fighters[n].hitboxes[SimHitbox::HBOX_LOWER + j];
+			PackedRect& packed = m_hurtboxHistory[slot][n][j];
+			packed.x = static_cast<int16_t>(rect.x);
+			packed.y = static_cast<int16_t>(rect.y);
+			packed.w = static_cast<int16_t>(rect.w);
+			packed.h = static_cast<int16_t>(rect.h);
+		}
+	}
+	m_historyTick[slot] = m_state.tick;
+	m_historyValid[slot] = true;
+}
+
+// ================================================ //
+
+bool MatchSim::takeHit(const int n, const FighterMove& move)
+{
+	SimFighterState& f = m_state.fighters[n];
+
+	SimEvent e;
+	e.tick = m_state.tick;
+	e.fighter = n;
+
+	// Block if walking back.
+	if (f.state == FighterState::WALKING_BACK){
+		f.stun = move.blockstun;
+		f.state = FighterState::STUNNED_BLOCK;
+
+		e.type = SimEvent::BLOCK;
+		e.damage = 0;
+		e.stun = f.stun;
+		e.state = f.state;
+		m_events.push_back(e);
+		return false;
+	}
+
+	f.stun = move.hitstun;
+	f.state = FighterState::STUNNED_HIT;
+	if (move.damage != 0){
+		f.hp -= move.damage;
+		if (f.hp < 0){
+			f.hp = 0;
+		}
+		else if (f.hp > m_pData[n]->hp){
+			f.hp = m_pData[n]->hp;
+		}
+	}
+
+	e.type = SimEvent::HIT;
+	e.damage = move.damage;
+	e.stun = f.stun;
+	e.state = f.state;
+	m_events.push_back(e);
+	return true;
+}
+
+// ================================================ //
+
+void MatchSim::updateCamera(void)
+{
+	const int32_t snapRange = 1;
+	const int32_t speed = m_config.cameraSpeed / static_cast<int32_t>(MatchSim::TickRate);
+
+	// Pan to x-position.
+	if (m_state.camera.x < m_state.camera.panX){
+		m_state.camera.x += speed;
+		if (m_state.camera.x > (m_state.camera.panX - snapRange)){
+			m_state.camera.x = m_state.camera.panX;
+		}
+	}
+	else if (m_state.camera.x > m_state.camera.panX){
+		m_state.camera.x -= speed;
+		if (m_state.camera.x < (m_state.camera.panX + snapRange)){
+			m_state.camera.x = m_state.camera.panX;
+		}
+	}
+
+	// Pan to y-position.
+	if (m_state.camera.y < m_state.camera.panY){
+		m_state.camera.y += speed;
+		if (m_state.camera.y > (m_state.camera.panY - snapRange)){
+			m_state.camera.y = m_state.camera.panY;
+		}
+	}
+	else if (m_state.camera.y > m_state.camera.panY){
+		m_state.camera.y -= speed;
+		if (m_state.camera.y < (m_state.camera.panY + snapRange)){
+			m_state.camera.y = m_state.camera.panY;
+		}
+	}
+}
+
+// ================================================ //
+
+void MatchSim::panCamera(const int32_t x)
+{
+	m_state.camera.lastX = m_state.camera.x;
+
+	m_state.camera.panX = x;
+	if (m_state.camera.panX < 0){
+		m_state.camera.panX = 0;
+	}
+	else if (m_state.camera.panX > m_config.cameraRightBound){
+		m_state.camera.panX = m_config.cameraRightBound;
+	}
+}
+
+// ================================================ //
+
+void MatchSim::resolvePositions(const int32_t redOldX, const int32_t blueOldX)
+{
+	SimFighterState& red = m_state.fighters[RED];
+	SimFighterState& blue = m_state.fighters[BLUE];
+
+	int32_t redX = red.x;
+	int32_t blueX = blue.x;
+
+	const int32_t redMoved = redX - redOldX;
+	const int32_t blueMoved = blueX - blueOldX;
+	const bool bothLeft = (redMoved < 0 && blueMoved < 0);
+	const bool bothRight = (redMoved > 0 && blueMoved > 0);
+	const int32_t panX = (redX + this->getRenderWidthDiff(RED) +
+						  blueX + this->getRenderWidthDiff(BLUE)) / 2
+						  - m_config.stageViewWidth / 2;
+
+	this->panCamera(panX);
+
+	const bool betweenBounds = (m_state.camera.panX > 0 && m_state.camera.panX < m_config.cameraRightBound);
+
+	// Re-position the non-moving fighter if only one is moving.
+	if ((redMoved == 0 && blueMoved != 0) || (blueMoved == 0 && redMoved != 0)){
+		if (betweenBounds){
+			if (redMoved == 0){
+				redX += m_state.camera.lastX - panX;
+			}
+			if (blueMoved == 0){
+				blueX += m_state.camera.lastX - panX;
+			}
+		}
+	}
+	else if (bothLeft || bothRight){
+		if (betweenBounds){
+			// Keep the camera from moving too quickly while maintaining apparent
+			// movement speed.
+			redX -= SimFixed::divRound(blueMoved, 3);
+			blueX -= SimFixed::divRound(redMoved, 3);
+		}
+	}
+
+	// Push fighters apart if their normal hitboxes collide.
+	for (int i = SimHitbox::HBOX_LOWER; i <= SimHitbox::HBOX_HEAD; ++i){
+		for (int j = SimHitbox::HBOX_LOWER; j <= SimHitbox::HBOX_HEAD; ++j){
+			if (!SimRectIntersects(red.hitboxes[i], blue.hitboxes[j])){
+				continue;
+			}
+
+			// Calculate distance between each fighter's x component of this hitbox.
+			const int32_t offset = 300;
+			int32_t dist = (red.side == MatchSim::LEFT) ?
+				std::abs(blue.hitboxes[j].x - red.hitboxes[i].x - red.hitboxes[i].w) :
+				std::abs(red.hitboxes[i].x - blue.hitboxes[j].x - blue.hitboxes[j].w);
+			// Re-calculate the distance the fighter(s) should move based on collision.
+			if (dist > 0){
+				dist = (offset + dist) / static_cast<int32_t>(MatchSim::TickRate);
+			}
+			else{
+				dist = -((offset + dist) / static_cast<int32_t>(MatchSim::TickRate));
+			}
+
+			// Only push a jumping fighter if the other isn't jumping.
+			const bool redJumping = (red.state == FighterState::JUMPING);
+			const bool blueJumping = (blue.state == FighterState::JUMPING);
+			if (redJumping == blueJumping){
+				redX += (red.side == MatchSim::LEFT) ? -dist : dist;
+				blueX += (red.side == MatchSim::LEFT) ? dist : -dist;
+			}
+			else if (redJumping){
+				redX += (red.side == MatchSim::LEFT) ? -dist : dist;
+			}
+			else{
+				blueX += (red.side == MatchSim::LEFT) ? dist : -dist;
+			}
+		}
+	}
+
+	// Switch sides if necessary.
+	if (redX > blueX){
+		red.side = MatchSim::RIGHT;
+		blue.side = MatchSim::LEFT;
+	}
+	else if (blueX > redX){
+		blue.side = MatchSim::RIGHT;
+		red.side = MatchSim::LEFT;
+	}
+
+	red.x = redX;
+	blue.x = blueX;
+}
+
+// ================================================ //
+
+bool MatchSim::stateTransition(SimFighterState& f, const uint32_t state)
+{
+	if (f.state < FighterState::END_STATES &&
+		(Transitions[f.state] & (1u << state)) != 0){
+		f.state = state;
+	}
+
+	return (f.state == state);
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,373 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: MatchSim.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines MatchSim class, along with SimConfig, SimFighterState, 
+// SimCamera, and SimEvent structs.
+// ================================================ //
+
+#ifndef __MATCHSIM_HPP__
+#define __MATCHSIM_HPP__
+
+// ================================================ //
+
+#include "FighterData.hpp"
+
+// ================================================ //
+
+// The environment a match is simulated in. Filled out by the game from
+// the engine settings and the loaded Stage, or by hand when headless.
+struct SimConfig{
+	// Initializes to the engine's default settings.
+	explicit SimConfig(void);
+
+	// Virtual viewport size (pixels).
+	int32_t viewWidth, viewHeight;
+	// Width of the visible portion of the stage (first layer's src.w).
+	int32_t stageViewWidth;
+	// The farmost right position of the camera (Stage::getRightEdge()).
+	int32_t cameraRightBound;
+	// Pixels per second the camera pans.
+	int32_t cameraSpeed;
+	// Starting camera x-position.
+	int32_t cameraStartX;
+	// Distance from each edge of the viewport at which the fighters start.
+	int32_t startingOffset;
+	// Distance of the floor from the bottom of the viewport.
+	int32_t floorOffset;
+	// How many ticks a fighter's hits may be rewound to match what its 
+	// client saw (0 disables lag compensation, see MatchSim::setViewTick()).
+	uint32_t lagCompensationTicks;
+};
+
+// ================================================ //
+
+// Everything that changes about a fighter during a match.
+struct SimFighterState{
+	// Destination rect (Player::getPosition() equivalent).
+	int32_t x, y, w, h;
+	// Velocities (sub-pixels per tick, see SimFixed).
+	int32_t xVel, xJumpVel;
+	// Sub-pixel remainder of x, in [0, SimFixed::SubPixels).
+	int32_t xFrac;
+	// Ticks into the jump arc.
+	int32_t jump;
+	// The amount moved this tick (pixels).
+	int32_t translateX;
+
+	uint32_t state;
+	uint32_t side;
+	int32_t hp;
+	// Length of the current stun (ticks).
+	uint32_t stun;
+
+	// Active move (FighterState ID), frame, and ticks spent in that frame.
+	int32_t move;
+	int32_t frame;
+	uint32_t frameTicks;
+
+	// True if the current move's damage boxes can still connect.
+	uint8_t hitboxesActive;
+	// True if LP has been released since the last attack.
+	uint8_t lpReactivated;
+	// Explicit padding, always zero, so the struct can be compared and hashed bytewise.
+	uint8_t padding[2];
+
+	// Absolute hitbox rects for the current frame, indexed by SimHitbox.
+	SimRect hitboxes[SimHitbox::NUM_HITBOXES];
+};
+
+// The simulated Camera.
+struct SimCamera{
+	int32_t x, y;
+	int32_t panX, panY;
+	int32_t lastX;
+};
+
+// Something notable that happened during a tick.
+struct SimEvent{
+	enum Type{
+		HIT = 0,
+		BLOCK,
+		// The fighter's state differs from the previous tick's.
+		STATE_CHANGE
+	};
+
+	uint32_t tick;
+	uint32_t type;
+	// The fighter that was hit or changed state (MatchSim::RED or MatchSim::BLUE).
+	uint32_t fighter;
+	int32_t damage;
+	// Stun applied (ticks).
+	uint32_t stun;
+	// The fighter's state after the event (FighterState).
+	uint32_t state;
+};
+
+typedef std::vector<SimEvent> SimEventList;
+
+// Everything that changes during a match, in one trivially copyable block 
+// with no pointers or implicit padding. Saving, restoring, and comparing a
+// match is a memcpy()/memcmp() of this struct; Players and the Camera are
+// views rebuilt from it (see PlayerManager::syncFromSim()).
+struct MatchState{
+	SimFighterState fighters[2];
+	SimCamera camera;
+	uint32_t tick;
+};
+
+// ================================================ //
+
+// Simulates a match between two fighters at a fixed tick rate. Has no
+// knowledge of SDL, rendering, networking or any singleton, so it can be 
+// stepped as fast as the CPU allows. The client, server, and local game
+// all drive it with step(), and Player objects render its state.
+class MatchSim
+{
+public:
+	enum{
+		RED = 0,
+		BLUE,
+
+		NUM_FIGHTERS
+	};
+
+	enum Side{
+		LEFT = 0,
+		RIGHT
+	};
+
+	// Stores the fighter data and config, converts each fighter's physics 
+	// to fixed-point, then calls reset().
+	explicit MatchSim(std::shared_ptr<const FighterData> red, 
+					  std::shared_ptr<const FighterData> blue, 
+					  const SimConfig& config);
+
+	// Empty destructor.
+	~MatchSim(void);
+
+	// Places both fighters at their starting positions with full HP.
+	void reset(void);
+
+	// Advances the match by exactly one tick using one input per fighter.
+	void step(const SimInput inputs[NUM_FIGHTERS]);
+
+	// Advances the match by count ticks as fast as possible, where 
+	// inputs[t * NUM_FIGHTERS + n] is fighter n's input on tick t. If pLog
+	// is not null, every tick's events are appended to it. Used for replay
+	// seeking, AI lookahead and regression runs. Returns the final state.
+	const MatchState& fastForward(const SimInput* inputs, const uint32_t count, 
+								  SimEventList* pLog = nullptr);
+
+	// Copies the current state of the match into state.
+	void save(MatchState& state) const;
+
+	// Restores the match to state.
+	void load(const MatchState& state);
+
+	// Lag compensation: fighter n's client is showing the other fighter at
+	// tick (0 if unknown). Until changed, n's damage boxes are tested 
+	// against the other fighter's hurtboxes from that many ticks ago, at 
+	// most the config's lagCompensationTicks. Only for an authoritative 
+	// server; the hurtbox history isn't part of MatchState, so rollback 
+	// peers must not use it.
+	void setViewTick(const int n, const uint32_t tick);
+
+	// Getters
+
+	// Returns the number of ticks simulated since reset().
+	const uint32_t getTick(void) const;
+
+	// Returns the entire mutable state of the match.
+	const MatchState& getState(void) const;
+
+	// Returns the state of fighter n (RED or BLUE).
+	const SimFighterState& getFighterState(const int n) const;
+
+	// Returns the data fighter n was built from.
+	const FighterData& getFighterData(const int n) const;
+
+	// Returns the simulated camera.
+	const SimCamera& getCamera(void) const;
+
+	// Returns the events produced by the last call to step() (or the last
+	// tick of fastForward()).
+	const SimEventList& getEvents(void) const;
+
+	// Returns the config the match was created with.
+	const SimConfig& getConfig(void) const;
+
+	// Returns the difference between fighter n's current and default render
+	// width, doubled, when on the right side (see Player::getRenderWidthDiff()).
+	const int32_t getRenderWidthDiff(const int n) const;
+
+	// Returns the number of hits that only connected because they were 
+	// tested against rewound hurtboxes, since reset().
+	const uint32_t getCompensatedHits(void) const;
+
+	// --- //
+
+	// Returns a hash of state for detecting desyncs between peers.
+	static uint32_t Checksum(const MatchState& state);
+
+	// Ticks per second.
+	static const uint32_t TickRate = 60;
+
+	// Length of one tick (seconds).
+	static const double TickLength;
+
+	// Length of one tick (microseconds, truncated). Used instead of 
+	// TickLength inside the simulation so it never touches floating-point.
+	static const uint32_t TickMicroseconds = 1000000 / TickRate;
+
+	// Ticks of hurtbox history kept for lag compensation, about 533 ms at 
+	// TickRate. lagCompensationTicks is limited to one less than this 
+	// (about 517 ms).
+	static const uint32_t HistoryTicks = 32;
+
+private:
+	// A fighter's physics converted to per-tick integer values.
+	struct Physics{
+		int32_t xAccel, xMax, xJumpMax;
+		// Height above the floor (pixels) for each tick of a jump.
+		std::vector<int32_t> jumpArc;
+	};
+
+	// Builds the fixed-point Physics for fighter n from its FighterData.
+	void buildPhysics(const int n);
+
+	// Adjusts fighter state and velocity from buttons held this tick.
+	void processInput(const int n, const SimInput input);
+
+	// Moves the fighter using its velocity and jump arc.
+	void applyInput(const int n);
+
+	// Advances animation of the current move, handling transitions and stun.
+	void updateMove(const int n);
+
+	// Applies the render size change of the fighter's current frame.
+	void applyFrameSize(const int n);
+
+	// Keeps the fighter within the viewport.
+	void clampToView(const int n);
+
+	// Recalculates the absolute hitbox rects for the current frame.
+	void updateHitboxes(const int n);
+
+	// Tests damage boxes against normal hitboxes and applies hits.
+	void testHits(void);
+
+	// Returns true if damage box i of fighter n touches the other fighter's
+	// hurtbox j, rewound by n's lag compensation.
+	bool testHit(const int n, const int i, const int j);
+
+	// Stores both fighters' hurtboxes for the current tick.
+	void recordHurtboxes(void);
+
+	// Applies a hit from move to fighter n. Returns true if it was not blocked.
+	bool takeHit(const int n, const FighterMove& move);
+
+	// Pans the camera toward its destination.
+	void updateCamera(void);
+
+	// Sets the camera's destination x-position, within bounds.
+	void panCamera(const int32_t x);
+
+	// Pans the camera to the fighters' midpoint, pushes colliding fighters 
+	// apart and switches sides if they crossed over.
+	void resolvePositions(const int32_t redOldX, const int32_t blueOldX);
+
+	// Moves the fighter into state if its current state allows it. Returns
+	// true if the fighter is now in that state.
+	bool stateTransition(SimFighterState& f, const uint32_t state);
+
+	// Returns the y-position of the floor for fighter n.
+	const int32_t getFloor(const int n) const;
+
+	std::shared_ptr<const FighterData> m_pData[NUM_FIGHTERS];
+	Physics m_physics[NUM_FIGHTERS];
+	SimConfig m_config;
+	MatchState m_state;
+	SimEventList m_events;
+
+	// A hurtbox rect packed for the history.
+	struct PackedRect{
+		int16_t x, y, w, h;
+	};
+
+	// Ring of each fighter's hurtboxes (HBOX_LOWER through HBOX_HEAD) by 
+	// tick, and the tick each slot holds.
+	static const int NumHurtboxes = SimHitbox::HBOX_HEAD + 1;
+	PackedRect m_hurtboxHistory[HistoryTicks][NUM_FIGHTERS][NumHurtboxes];
+	uint32_t m_historyTick[HistoryTicks];
+	bool m_historyValid[HistoryTicks];
+	uint32_t m_rewind[NUM_FIGHTERS];
+	uint32_t m_compensatedHits;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const uint32_t MatchSim::getTick(void) const{
+	return m_state.tick;
+}
+
+inline const MatchState& MatchSim::getState(void) const{
+	return m_state;
+}
+
+inline const SimFighterState& MatchSim::getFighterState(const int n) const{
+	return m_state.fighters[n];
+}
+
+inline const FighterData& MatchSim::getFighterData(const int n) const{
+	return *m_pData[n];
+}
+
+inline const SimCamera& MatchSim::getCamera(void) const{
+	return m_state.camera;
+}
+
+inline const SimEventList& MatchSim::getEvents(void) const{
+	return m_events;
+}
+
+inline const SimConfig& MatchSim::getConfig(void) const{
+	return m_config;
+}
+
+inline const int32_t MatchSim::getRenderWidthDiff(const int n) const{
+	return (m_state.fighters[n].side == MatchSim::LEFT) ? 0 : 
+		(m_state.fighters[n].w - m_pData[n]->w) * 2;
+}
+
+inline const uint32_t MatchSim::getCompensatedHits(void) const{
+	return m_compensatedHits;
+}
+
+inline const int32_t MatchSim::getFloor(const int n) const{
+	return m_config.viewHeight - m_pData[n]->h - m_config.floorOffset;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -54,7 +54,6 @@ transition(-1),
 cancels(),
 xVel(0),
 yVel(0),
-currentFrame(0),
 frames()
 {
 
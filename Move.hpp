@@ -27,6 +27,7 @@
 // ================================================ //
 
 #include "stdafx.hpp"
+#include "SimTypes.hpp"
 
 // ================================================ //
 
@@ -55,8 +56,6 @@ namespace MoveID{
 
 // ================================================ //
 
-typedef std::vector<SDL_Rect> HitboxRectList;
-
 // A single frame of animation during a move.
 struct Frame{
 	int x;
@@ -68,11 +67,11 @@ struct Frame{
 	int rw;
 	int rh;
 
-	// Frame gap.
+	// Frame gap (ticks, converted from ms at load).
 	Uint32 gap;
 
 	// Converts this frames coordinates to a SDL_Rect.
-	SDL_Rect toSDLRect(void){
+	SDL_Rect toSDLRect(void) const{
 		SDL_Rect r;
 		r.x = this->x;
 		r.y = this->y;
@@ -81,8 +80,9 @@ struct Frame{
 		return r;
 	}
 
-	// All hitboxes for a frame.
-	HitboxRectList hitboxes;
+	// All hitboxes for a frame, indexed like Hitbox (and SimHitbox). Fixed
+	// so a frame needs no allocation of its own.
+	SDL_Rect hitboxes[SimHitbox::NUM_HITBOXES];
 };
 
 typedef std::vector<Frame> FrameList;
@@ -101,10 +101,11 @@ struct Move
 	int id;
 	std::string name;
 	int numFrames;
-	// How long to wait between frames(ms).
+	// How long to wait between frames (ticks, converted from ms at load).
 	Uint32 frameGap;	
 	int startupFrames, hitFrames, recoveryFrames;
 	int damage;
+	// Stun durations (ticks, converted from ms at load).
 	int hitstun, blockstun;
 	int knockback;
 	// How the attacking player is moved back upon landing a hit.
@@ -117,8 +118,6 @@ struct Move
 	std::vector<int> cancels; 
 	int xVel, yVel;
 
-	// Active frame from the frame list.
-	int currentFrame;
 	FrameList frames;
 };
 
@@ -21,6 +21,11 @@
 // Defines NetMessage enumerations.
 // ================================================ //
 
+#ifndef __NETMESSAGE_HPP__
+#define __NETMESSAGE_HPP__
+
+// ================================================ //
+
 #include "stdafx.hpp"
 
 // ================================================ //
@@ -40,20 +45,22 @@ namespace NetMessage{
 		PLAYING_RED, // Let's a client know they are playing next match.
 		PLAYING_BLUE,
 		SERVER_STARTING_GAME,
-		UPDATE_RED_PLAYER,
-		UPDATE_BLUE_PLAYER,
-		UPDATE_PLAYERS,
-		PAN_CAMERA,
+		WORLD_SNAPSHOT, // Both fighters, camera, HP and stun for one server tick.
 		CLIENT_INPUT,
 		LAST_PROCESSED_INPUT_SEQUENCE,
-		RED_TAKE_HIT,
-		BLUE_TAKE_HIT,
-		RED_TAKE_HIT_BLOCK,
-		BLUE_TAKE_HIT_BLOCK,
 		MATCH_OVER,
+		PEER_INPUT, // A playing peer's input for one rollback or lockstep frame, relayed by the server.
+		SNAPSHOT_ACK, // The newest world snapshot a client decoded, used as the server's delta baseline.
+		CLOCK_PING, // A client's clock, for the server to echo back.
+		CLOCK_PONG, // The echoed client clock, with the server's clock and tick.
+		SPECTATOR_BATCH, // Delayed WORLD_SNAPSHOT packets for a spectator, sent in full.
 
 		END
 	};
 }
 
+// ================================================ //
+
+#endif
+
 // ================================================ //
\ No newline at end of file
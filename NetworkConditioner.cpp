@@ -0,0 +1,205 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: NetworkConditioner.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements NetworkConditions struct and NetworkConditioner class.
+// ================================================ //
+
+#include "NetworkConditioner.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+namespace{
+	// Resends a lost reliable packet at most this many times; the last one
+	// always gets through.
+	const int MaxResends = 8;
+
+	// Weight of each packet in the recent loss (about the last 32 packets).
+	const double RecentLossGain = 1.0 / 32.0;
+}
+
+// ================================================ //
+
+NetworkConditions::NetworkConditions(void) :
+latency(0),
+jitter(0),
+spikeChance(0.0),
+spikeLatency(0),
+reorderChance(0.0),
+reorderDelay(0),
+duplicateChance(0.0),
+lossChance(0.0),
+burstLength(1.0),
+bandwidth(0)
+{
+
+}
+
+// ================================================ //
+// ================================================ //
+
+NetworkConditioner::NetworkConditioner(const NetworkConditions& conditions, const uint64_t seed) :
+m_conditions(conditions),
+m_state(0),
+m_burst(false),
+m_busyUntil(0),
+m_recentLoss(0.0)
+{
+	// Spread the seed over the state (splitmix64), which must not be zero.
+	uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	m_state = z ^ (z >> 31);
+	if (m_state == 0){
+		m_state = 1;
+	}
+
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+// ================================================ //
+
+NetworkConditioner::~NetworkConditioner(void)
+{
+
+}
+
+// ================================================ //
+
+int NetworkConditioner::schedule(const uint64_t now, const Uint32 bytes, const bool reliable, uint64_t arrivals[2])
+{
+	++m_stats.packets;
+	m_stats.bytes += bytes;
+
+	// Queue behind the packets still being sent.
+	uint64_t departure = now;
+	if (m_conditions.bandwidth > 0){
+		const uint64_t start = (m_busyUntil > now) ? m_busyUntil : now;
+		m_stats.queuedTime += start - now;
+		m_busyUntil = start + (static_cast<uint64_t>(bytes) * 1000000) / m_conditions.bandwidth;
+		departure = m_busyUntil;
+	}
+
+	// A lost reliable packet is resent after about a round trip.
+	uint64_t arrival = departure + this->sampleLatency();
+	bool lost = false;
+	for (int i = 0; this->sampleLoss(); ++i){
+		m_recentLoss += (1.0 - m_recentLoss) * RecentLossGain;
+		lost = true;
+		if (!reliable){
+			++m_stats.lost;
+			return 0;
+		}
+		if (i == MaxResends){
+			break;
+		}
+
+		++m_stats.resent;
+		arrival += (m_conditions.latency * 2) + this->sampleLatency();
+	}
+	if (!lost){
+		m_recentLoss -= m_recentLoss * RecentLossGain;
+	}
+
+	if (m_conditions.reorderChance > 0.0 && this->random() < m_conditions.reorderChance){
+		++m_stats.reordered;
+		arrival += m_conditions.reorderDelay;
+	}
+
+	arrivals[0] = arrival;
+	if (!reliable && m_conditions.duplicateChance > 0.0 && this->random() < m_conditions.duplicateChance){
+		++m_stats.duplicated;
+		arrivals[1] = departure + this->sampleLatency();
+		return 2;
+	}
+
+	return 1;
+}
+
+// ================================================ //
+
+double NetworkConditioner::random(void)
+{
+	// xorshift64*, top 53 bits.
+	m_state ^= m_state >> 12;
+	m_state ^= m_state << 25;
+	m_state ^= m_state >> 27;
+	return static_cast<double>((m_state * 0x2545f4914f6cdd1dULL) >> 11) / 9007199254740992.0;
+}
+
+// ================================================ //
+
+uint64_t NetworkConditioner::sampleLatency(void)
+{
+	double latency = static_cast<double>(m_conditions.latency);
+	if (m_conditions.jitter > 0){
+		// Normally distributed around the latency (Box-Muller).
+		const double u = 1.0 - this->random();
+		const double v = this->random();
+		latency += static_cast<double>(m_conditions.jitter) * std::sqrt(-2.0 * std::log(u)) * 
+			std::cos(6.283185307179586 * v);
+		if (latency < 0.0){
+			latency = 0.0;
+		}
+	}
+
+	if (m_conditions.spikeChance > 0.0 && this->random() < m_conditions.spikeChance){
+		++m_stats.spikes;
+		latency += static_cast<double>(m_conditions.spikeLatency);
+	}
+
+	return static_cast<uint64_t>(latency);
+}
+
+// ================================================ //
+
+bool NetworkConditioner::sampleLoss(void)
+{
+	if (!m_burst){
+		if (m_conditions.lossChance <= 0.0 || this->random() >= m_conditions.lossChance){
+			return false;
+		}
+		m_burst = true;
+	}
+
+	// Each packet in a burst is lost, and ends it with chance 1 / burstLength.
+	if (m_conditions.burstLength <= 1.0 || this->random() < 1.0 / m_conditions.burstLength){
+		m_burst = false;
+	}
+
+	return true;
+}
+
+// ================================================ //
+
+std::string NetworkConditioner::FormatStats(const ConditionerStats& stats)
+{
+	if (stats.packets == 0){
+		return "no packets";
+	}
+
+	return Engine::toString(stats.packets) + " packets (" + Engine::toString(stats.bytes) + " bytes), " + 
+		Engine::toString(stats.lost) + " lost, " + Engine::toString(stats.resent) + " resent, " + 
+		Engine::toString(stats.duplicated) + " duplicated, " + Engine::toString(stats.reordered) + 
+		" reordered, " + Engine::toString(stats.spikes) + " spikes, " + 
+		Engine::toString(stats.queuedTime / stats.packets) + " us/packet queued";
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,149 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: NetworkConditioner.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines NetworkConditions and ConditionerStats structs, and NetworkConditioner class.
+// ================================================ //
+
+#ifndef __NETWORKCONDITIONER_HPP__
+#define __NETWORKCONDITIONER_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+
+// ================================================ //
+
+// The impairments of one direction of a link. Times are in microseconds,
+// chances from 0 to 1.
+struct NetworkConditions{
+	// Perfect link by default.
+	explicit NetworkConditions(void);
+
+	// One-way latency, and the standard deviation of its jitter.
+	uint64_t latency, jitter;
+	// Chance of a latency spike, and how much it adds (a heavy tail).
+	double spikeChance;
+	uint64_t spikeLatency;
+	// Chance a packet is held back by reorderDelay, so later ones pass it.
+	double reorderChance;
+	uint64_t reorderDelay;
+	// Chance an unreliable packet is delivered twice.
+	double duplicateChance;
+	// Chance a loss burst starts, and the mean packets lost per burst.
+	double lossChance;
+	double burstLength;
+	// Link capacity, bytes per second (0 is unlimited). Packets queue 
+	// behind each other, which adds latency once the link is saturated.
+	Uint32 bandwidth;
+};
+
+// What a NetworkConditioner did to the packets sent through it.
+struct ConditionerStats{
+	uint64_t packets, bytes;
+	// Unreliable packets lost, and reliable ones delayed by a resend.
+	uint64_t lost, resent;
+	uint64_t duplicated, reordered, spikes;
+	// Time packets spent queued behind the bandwidth cap (us).
+	uint64_t queuedTime;
+};
+
+// ================================================ //
+
+// Decides when (and whether) each packet on one direction of a link 
+// arrives. Every random choice comes from its own generator, seeded in the
+// constructor, so the same seed and sends always give the same arrivals.
+class NetworkConditioner
+{
+public:
+	// Applies conditions, with random choices seeded by seed.
+	explicit NetworkConditioner(const NetworkConditions& conditions, const uint64_t seed);
+
+	// Empty destructor.
+	~NetworkConditioner(void);
+
+	// Schedules a packet of the given size sent at now. Fills arrivals with
+	// the times it arrives at (none if lost, two if duplicated) and returns
+	// how many there are. Reliable packets are never lost, only delayed by
+	// the time a resend would take.
+	int schedule(const uint64_t now, const Uint32 bytes, const bool reliable, uint64_t arrivals[2]);
+
+	// Getters
+
+	// Returns the conditions applied.
+	const NetworkConditions& getConditions(void) const;
+
+	// Returns what was done to the packets sent so far.
+	const ConditionerStats& getStats(void) const;
+
+	// Returns the fraction of recent packets lost or resent (0 to 1).
+	const double getRecentLoss(void) const;
+
+	// Returns the bytes still queued behind the bandwidth cap at now.
+	const Uint32 getQueuedBytes(const uint64_t now) const;
+
+	// Returns a one-line report of stats, for the log.
+	static std::string FormatStats(const ConditionerStats& stats);
+
+private:
+	// Returns a uniformly distributed number in [0, 1).
+	double random(void);
+
+	// Returns the latency of one packet, jitter and spikes included.
+	uint64_t sampleLatency(void);
+
+	// Returns true if the packet is lost, advancing the loss bursts.
+	bool sampleLoss(void);
+
+	NetworkConditions m_conditions;
+	uint64_t m_state;
+	// In a loss burst.
+	bool m_burst;
+	// When the link finishes sending the packets queued on it.
+	uint64_t m_busyUntil;
+	double m_recentLoss;
+	ConditionerStats m_stats;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const NetworkConditions& NetworkConditioner::getConditions(void) const{
+	return m_conditions;
+}
+
+inline const ConditionerStats& NetworkConditioner::getStats(void) const{
+	return m_stats;
+}
+
+inline const double NetworkConditioner::getRecentLoss(void) const{
+	return m_recentLoss;
+}
+
+inline const Uint32 NetworkConditioner::getQueuedBytes(const uint64_t now) const{
+	return (m_busyUntil > now) ? 
+		static_cast<Uint32>(((m_busyUntil - now) * m_conditions.bandwidth) / 1000000) : 0;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -31,6 +31,7 @@
 
 Object::Object(void) :
 m_pTexture(nullptr),
+m_pSharedTexture(nullptr),
 m_src(),
 m_dst(),
 m_flip(SDL_FLIP_NONE),
@@ -55,7 +56,7 @@ m_pFSM(new FSM(0))
 
 Object::~Object(void)
 {
-	if (m_pTexture != nullptr)
+	if (m_pTexture != nullptr && m_pTexture != m_pSharedTexture.get())
 		Engine::getSingletonPtr()->destroyTexture(m_pTexture);
 
 	Log::getSingletonPtr()->logMessage("Destroyed Object \"" + m_name + "\"");
@@ -74,10 +75,22 @@ void Object::setTexture(SDL_Texture* pTex)
 
 // ================================================ //
 
+void Object::setTexture(std::shared_ptr<SDL_Texture> pTex)
+{
+	if (m_pTexture != nullptr && m_pTexture != m_pSharedTexture.get())
+		Engine::getSingletonPtr()->destroyTexture(m_pTexture);
+
+	m_pSharedTexture = pTex;
+	this->setTexture(pTex.get());
+}
+
+// ================================================ //
+
 bool Object::setTextureFile(const std::string& filename)
 {
-	if (m_pTexture != nullptr)
+	if (m_pTexture != nullptr && m_pTexture != m_pSharedTexture.get())
 		Engine::getSingletonPtr()->destroyTexture(m_pTexture);
+	m_pSharedTexture.reset();
 
 	Log::getSingletonPtr()->logMessage("Setting texture \"" + std::string(filename) +
 		"\" for Object \"" + m_name + "\"");
@@ -73,7 +73,8 @@ public:
 	// Sets the main SDL_Texture's pointer directly.
 	virtual void setTexture(SDL_Texture* pTex);
 
-	// Sets the main SDL_Texture's pointer directly.
+	// Sets the main SDL_Texture to one shared with other Objects, which
+	// this Object keeps alive but doesn't destroy.
 	virtual void setTexture(std::shared_ptr<SDL_Texture> pTex);
 
 	// Loads the main SDL_Texture's by loading it from the specified filename.
@@ -107,6 +108,8 @@ public:
 
 protected:
 	SDL_Texture*		m_pTexture;
+	// Set when m_pTexture is shared.
+	std::shared_ptr<SDL_Texture> m_pSharedTexture;
 	SDL_Rect			m_src;
 	SDL_Rect			m_dst;
 	SDL_RendererFlip	m_flip;
@@ -152,10 +155,6 @@ inline Label* Object::getLabel(void) const{
 
 // Setters
 
-inline void Object::setTexture(std::shared_ptr<SDL_Texture> pTex){
-	return this->setTexture(pTex.get());
-}
-
 inline void Object::setPosition(const int x, const int y){
 	m_dst.x = x; m_dst.y = y;
 }
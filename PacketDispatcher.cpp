@@ -0,0 +1,139 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: PacketDispatcher.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements PacketView and PacketDispatcher classes.
+// ================================================ //
+
+#include "PacketDispatcher.hpp"
+#include "SimClock.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+PacketView::PacketView(RakNet::Packet* packet) :
+m_packet(packet),
+m_bit(packet->data, packet->length, false)
+{
+	m_bit.IgnoreBytes(sizeof(RakNet::MessageID));
+}
+
+// ================================================ //
+
+PacketView::~PacketView(void)
+{
+
+}
+
+// ================================================ //
+
+const std::string PacketView::readString(void)
+{
+	RakNet::RakString rs;
+	if (!m_bit.Read(rs)){
+		return std::string();
+	}
+
+	return std::string(rs.C_String());
+}
+
+// ================================================ //
+// ================================================ //
+
+PacketDispatcher::PacketDispatcher(void)
+{
+	this->clear();
+}
+
+// ================================================ //
+
+PacketDispatcher::~PacketDispatcher(void)
+{
+
+}
+
+// ================================================ //
+
+void PacketDispatcher::registerHandler(const RakNet::MessageID id, const char* name, const Handler& handler)
+{
+	m_handlers[id] = handler;
+	m_names[id] = name;
+}
+
+// ================================================ //
+
+void PacketDispatcher::clear(void)
+{
+	for (int i = 0; i < PacketDispatcher::NumMessageIDs; ++i){
+		m_handlers[i] = nullptr;
+		m_names[i] = nullptr;
+	}
+	memset(m_stats, 0, sizeof(m_stats));
+}
+
+// ================================================ //
+
+bool PacketDispatcher::dispatch(RakNet::Packet* packet)
+{
+	if (packet->length == 0){
+		return false;
+	}
+
+	const RakNet::MessageID id = packet->data[0];
+	PacketStats& stats = m_stats[id];
+	++stats.count;
+	stats.bytes += packet->length;
+	if (!m_handlers[id]){
+		return false;
+	}
+
+	const uint64_t start = SimClock::now();
+	PacketView view(packet);
+	m_handlers[id](view);
+
+	const uint64_t elapsed = SimClock::now() - start;
+	stats.totalTime += elapsed;
+	if (elapsed > stats.maxTime){
+		stats.maxTime = elapsed;
+	}
+
+	return true;
+}
+
+// ================================================ //
+
+void PacketDispatcher::logStats(const std::string& name) const
+{
+	for (int i = 0; i < PacketDispatcher::NumMessageIDs; ++i){
+		const PacketStats& stats = m_stats[i];
+		if (stats.count == 0){
+			continue;
+		}
+
+		const std::string id = (m_names[i] != nullptr) ? std::string(m_names[i]) : 
+			"ID " + Engine::toString(i) + " (unhandled)";
+		Log::getSingletonPtr()->logMessage(name + " packets: " + id + ": " + 
+			Engine::toString(stats.count) + " received, " + 
+			Engine::toString(stats.bytes) + " bytes, handler avg/max " + 
+			Engine::toString(stats.totalTime / stats.count) + "/" + 
+			Engine::toString(stats.maxTime) + " us");
+	}
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,150 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: PacketDispatcher.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines PacketView and PacketDispatcher classes.
+// ================================================ //
+
+#ifndef __PACKETDISPATCHER_HPP__
+#define __PACKETDISPATCHER_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+
+#include <functional>
+
+// ================================================ //
+
+// A received packet, with its payload read in place from the packet's 
+// data. The MessageID has already been skipped.
+class PacketView
+{
+public:
+	// Wraps packet without copying its data.
+	explicit PacketView(RakNet::Packet* packet);
+
+	// Empty destructor.
+	~PacketView(void);
+
+	// Reads a string from the payload, or returns an empty string.
+	const std::string readString(void);
+
+	// Getters
+
+	// Returns the wrapped packet.
+	RakNet::Packet* getPacket(void) const;
+
+	// Returns the address the packet came from.
+	const RakNet::SystemAddress& getAddress(void) const;
+
+	// Returns the packet's MessageID.
+	const RakNet::MessageID getID(void) const;
+
+	// Returns the payload, positioned after the MessageID.
+	RakNet::BitStream& getBitStream(void);
+
+private:
+	RakNet::Packet* m_packet;
+	RakNet::BitStream m_bit;
+};
+
+// ================================================ //
+
+// Receive counters and handler time for one MessageID.
+struct PacketStats{
+	// Packets received, and their total size (bytes).
+	uint64_t count, bytes;
+	// Time spent in the handler (us), in total and for the slowest packet.
+	uint64_t totalTime, maxTime;
+};
+
+// ================================================ //
+
+// Routes received packets to the handler registered for their MessageID,
+// through a table indexed by the ID. Each AppState registers its own 
+// handlers for the current game mode when it's entered.
+class PacketDispatcher
+{
+public:
+	typedef std::function<void(PacketView&)> Handler;
+
+	// Empty constructor.
+	explicit PacketDispatcher(void);
+
+	// Empty destructor.
+	~PacketDispatcher(void);
+
+	// Sets the handler for id, replacing any previous one. The name is only
+	// used by logStats() and must outlive the dispatcher.
+	void registerHandler(const RakNet::MessageID id, const char* name, const Handler& handler);
+
+	// Removes all handlers and resets the stats.
+	void clear(void);
+
+	// Counts the packet and calls its handler, timing it. Returns false if 
+	// no handler is registered for its MessageID.
+	bool dispatch(RakNet::Packet* packet);
+
+	// Logs the stats of every MessageID received, prefixed by name.
+	void logStats(const std::string& name) const;
+
+	// Getters
+
+	// Returns the receive counters and handler time for id.
+	const PacketStats& getStats(const RakNet::MessageID id) const;
+
+	// One table entry per possible MessageID.
+	static const int NumMessageIDs = 256;
+
+private:
+	Handler m_handlers[NumMessageIDs];
+	const char* m_names[NumMessageIDs];
+	PacketStats m_stats[NumMessageIDs];
+};
+
+// ================================================ //
+
+// Getters
+
+inline RakNet::Packet* PacketView::getPacket(void) const{
+	return m_packet;
+}
+
+inline const RakNet::SystemAddress& PacketView::getAddress(void) const{
+	return m_packet->systemAddress;
+}
+
+inline const RakNet::MessageID PacketView::getID(void) const{
+	return m_packet->data[0];
+}
+
+inline RakNet::BitStream& PacketView::getBitStream(void){
+	return m_bit;
+}
+
+inline const PacketStats& PacketDispatcher::getStats(const RakNet::MessageID id) const{
+	return m_stats[id];
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -25,9 +25,8 @@
 #include "Player.hpp"
 #include "Hitbox.hpp"
 #include "Input.hpp"
-#include "Timer.hpp"
 #include "FSM.hpp"
-#include "FighterMetadata.hpp"
+#include "FighterCache.hpp"
 #include "Engine.hpp"
 #include "Move.hpp"
 #include "MessageRouter.hpp"
@@ -37,11 +36,21 @@
 #include "StageManager.hpp"
 #include "Stage.hpp"
 #include "Camera.hpp"
+#include "FighterData.hpp"
+#include "MatchSim.hpp"
+#include "SimFixed.hpp"
 
 // ================================================ //
 
 const double PI = 3.14159265359;
 
+// Player states and hitbox indices are passed to and from MatchSim directly.
+static_assert(Player::State::STUNNED_BLOCK == FighterState::STUNNED_BLOCK &&
+			  MoveID::END_MOVES == FighterState::END_STATES, 
+			  "Player::State and MoveID must match FighterState");
+static_assert(Hitbox::CBOX2 + 1 == SimHitbox::NUM_HITBOXES, 
+			  "Hitbox indices must match SimHitbox");
+
 // ================================================ //
 
 Player::Player(const std::string& fighterFile, const std::string& buttonMapFile, const int mode) :
@@ -67,10 +76,13 @@ m_currentHP(m_maxHP),
 m_currentStun(0),
 m_pHealthBar(nullptr),
 m_pInput(new Input(buttonMapFile)),
+m_pFighter(nullptr),
+m_pFighterData(nullptr),
 m_moves(),
 m_hitboxes(),
 m_pCurrentMove(nullptr),
-m_pMoveTimer(new Timer()),
+m_currentFrame(0),
+m_moveTicks(0),
 m_drawHitboxes(false),
 m_maxXPos(0),
 m_colliding(false),
@@ -158,7 +170,7 @@ void Player::serverReconciliation(void)
 			}
 			else{
 				// Input is still unprocessed by the server, re-apply it.
-				m_pInput->setButton(itr->input, itr->value);
+				m_pInput->setSimInput(itr->buttons);
 				this->processReplayedInput(itr->dt);
 
 				// Apply the input.
@@ -371,12 +383,19 @@ void Player::update(double dt)
 
 void Player::render(void)
 {
-	this->updateMove();
+	SDL_RenderCopyEx(Engine::getSingletonPtr()->getRenderer(), m_pTexture, &m_src, &m_render, 0, nullptr, m_flip);
 
-	if (m_pFSM->getCurrentStateID() == Player::State::IDLE){		
-		//m_dst.x += Camera::getSingletonPtr()->getLastX() - Camera::getSingletonPtr()->getPanX();
+	if (m_drawHitboxes){
+		for (Uint32 i = 0; i < m_hitboxes.size(); ++i){
+			m_hitboxes[i]->render();
+		}
 	}
+}
+
+// ================================================ //
 
+void Player::clampToViewport(void)
+{
 	// Modify the rendering rect for final position.
 	m_render = m_dst;
 	m_render.x -= Camera::getSingletonPtr()->getX() - m_dst.w / 2;
@@ -403,33 +422,75 @@ void Player::render(void)
 	}
 
 	m_translateX = m_translateY = 0;
-	
-	SDL_RenderCopyEx(Engine::getSingletonPtr()->getRenderer(), m_pTexture, &m_src, &m_render, 0, nullptr, m_flip);
+}
 
-	if (m_drawHitboxes){
-		for (Uint32 i = 0; i < m_hitboxes.size(); ++i){
-			m_hitboxes[i]->render();
+// ================================================ //
+
+void Player::syncFromSim(const SimFighterState& state, const SimCamera& camera)
+{
+	m_dst.x = state.x;
+	m_dst.y = state.y;
+	m_dst.w = state.w;
+	m_dst.h = state.h;
+	m_xVel = SimFixed::toPixelsPerSecond(state.xVel, MatchSim::TickRate);
+	m_xJumpVel = SimFixed::toPixelsPerSecond(state.xJumpVel, MatchSim::TickRate);
+	m_currentStun = state.stun;
+	m_hitboxesActive = (state.hitboxesActive != 0);
+
+	if (m_pFSM->getCurrentStateID() != state.state){
+		m_pFSM->setCurrentState(state.state);
+	}
+	if (m_side != state.side){
+		this->setSide(static_cast<int>(state.side));
+	}
+	if (m_currentHP != state.hp){
+		m_currentHP = state.hp;
+		if (m_pHealthBar != nullptr){
+			this->updateHP(m_currentHP);
 		}
 	}
+
+	// Clip the sprite sheet using the simulated move and frame.
+	m_pCurrentMove = m_moves[state.move];
+	m_currentFrame = state.frame;
+	m_src = m_pCurrentMove->frames[state.frame].toSDLRect();
+
+	// The simulation has already kept the fighter in bounds, so only the 
+	// render rect needs clamping.
+	m_render = m_dst;
+	m_render.x -= camera.x - m_dst.w / 2;
+	if (m_render.x < 0){
+		m_render.x = 0;
+	}
+	else if (m_render.x > m_maxXPos){
+		m_render.x = m_maxXPos;
+	}
+
+	// Simulated hitboxes are in world coordinates, convert them to screen coordinates.
+	for (Uint32 i = 0; i < m_hitboxes.size(); ++i){
+		const SimRect& rc = state.hitboxes[i];
+		m_hitboxes[i]->setRect(rc.x - camera.x, rc.y - camera.y, rc.w, rc.h);
+	}
 }
 
 // ================================================ //
 
-void Player::updateMove(void)
+void Player::updateMove(const Uint32 ticks)
 {
 	// Force current animation to stop if the state has changed.
 	if (m_pCurrentMove != m_moves[m_pFSM->getCurrentStateID()]){
-		// Reset new move's current frame to starting frame.
-		m_pCurrentMove->currentFrame = 0;		
+		// Reset current frame to new move's starting frame.
+		m_currentFrame = 0;		
 
 		// Reset rendering width and height.
 		m_dst.w = m_rW; m_dst.h = m_rH;
 
-		// Reset timer to begin processing new moves frames.
-		m_pMoveTimer->restart();
-		//m_pMoveTimer->setStartTicks(0); // Why did I do this?!
+		// Reset clock to begin processing new moves frames.
+		m_moveTicks = 0;
 	}
 
+	m_moveTicks += ticks;
+
 	switch (m_pFSM->getCurrentStateID()){
 	default:
 	case Player::State::IDLE:
@@ -478,67 +539,67 @@ void Player::updateMove(void)
 	}
 
 	if (m_side == Player::Side::LEFT){
-		printf("Current move/frame: %d/%d..%d\n", m_pCurrentMove->id, m_pCurrentMove->currentFrame,
-			m_pCurrentMove->frames[m_pCurrentMove->currentFrame].rw);
+		printf("Current move/frame: %d/%d..%d\n", m_pCurrentMove->id, m_currentFrame,
+			m_pCurrentMove->frames[m_currentFrame].rw);
 	}
 
 	// Update the clipping of the sprite sheet using current frame.
-	m_src = m_pCurrentMove->frames[m_pCurrentMove->currentFrame].toSDLRect();
+	m_src = m_pCurrentMove->frames[m_currentFrame].toSDLRect();
 	// Modify rendering width and height of player to current frame settings.
-	if (m_pCurrentMove->frames[m_pCurrentMove->currentFrame].w >= m_pCurrentMove->frames[0].w){
-		m_dst.w += static_cast<int>(m_pCurrentMove->frames[m_pCurrentMove->currentFrame].rw * Engine::getSingletonPtr()->getClockSpeed());
+	if (m_pCurrentMove->frames[m_currentFrame].w >= m_pCurrentMove->frames[0].w){
+		m_dst.w += static_cast<int>(m_pCurrentMove->frames[m_currentFrame].rw * Engine::getSingletonPtr()->getClockSpeed());
 		// Adjust position when the rendering is flipped.
 		if (m_side == Player::Side::LEFT){
 			
 		}
 		else{
-			m_dst.x -= static_cast<int>(m_pCurrentMove->frames[m_pCurrentMove->currentFrame].rw * Engine::getSingletonPtr()->getClockSpeed()) * 2;
+			m_dst.x -= static_cast<int>(m_pCurrentMove->frames[m_currentFrame].rw * Engine::getSingletonPtr()->getClockSpeed()) * 2;
 		}
 	}
-	if (m_pCurrentMove->frames[m_pCurrentMove->currentFrame].h >= m_pCurrentMove->frames[0].h){
-		m_dst.h += static_cast<int>(m_pCurrentMove->frames[m_pCurrentMove->currentFrame].rh * Engine::getSingletonPtr()->getClockSpeed());
+	if (m_pCurrentMove->frames[m_currentFrame].h >= m_pCurrentMove->frames[0].h){
+		m_dst.h += static_cast<int>(m_pCurrentMove->frames[m_currentFrame].rh * Engine::getSingletonPtr()->getClockSpeed());
 	}	
 
 	// Process move-specific instructions.
 	switch (m_pCurrentMove->id){
 	default:
-		// If this frame has exceeded its time limit (milliseconds).
-		if (m_pMoveTimer->getTicks() > m_pCurrentMove->frameGap){
+		// If this frame has been shown for its full gap (ticks).
+		if (m_moveTicks >= m_pCurrentMove->frameGap){
 			// Increment to the next frame in this move.
-			if (m_pCurrentMove->currentFrame < m_pCurrentMove->numFrames){
-				++m_pCurrentMove->currentFrame;
+			if (m_currentFrame < m_pCurrentMove->numFrames){
+				++m_currentFrame;
 			}
 
 			// If we have reached the end of the move, process move instructions.
-			if (m_pCurrentMove->currentFrame >= m_pCurrentMove->numFrames){
+			if (m_currentFrame >= m_pCurrentMove->numFrames){
 				if (m_pCurrentMove->repeat == true){
 					// Roll back to the repeat frame.
-					m_pCurrentMove->currentFrame = m_pCurrentMove->repeatFrame;
+					m_currentFrame = m_pCurrentMove->repeatFrame;
 				}
 				else if (m_pCurrentMove->transition >= 0){
 					// Since this is a transition, change the move now to avoid frame locks
 					// (when the player holds down the input and the move stays in the last frame).
 					m_pFSM->setCurrentState(m_pCurrentMove->transition);
-					m_pCurrentMove->currentFrame = 0;
+					m_currentFrame = 0;
 					m_pCurrentMove = m_moves[m_pFSM->getCurrentStateID()];
 				}
 				else{
 					// This move doesn't repeat or transition, so roll back to last frame.
-					m_pCurrentMove->currentFrame -= 1;
+					m_currentFrame -= 1;
 				}
 			}
 
-			// Restart timer for next frame.
-			m_pMoveTimer->restart();
+			// Restart clock for next frame.
+			m_moveTicks = 0;
 		}
 		break;
 
 	case MoveID::STUNNED_HIT:
 	case MoveID::STUNNED_BLOCK:
 		// If the player has been stunned for assigned amount of time, switch out.
-		if (m_pMoveTimer->getTicks() > m_currentStun){
+		if (m_moveTicks >= m_currentStun){
 			m_pFSM->setCurrentState(m_pCurrentMove->transition);
-			m_pMoveTimer->restart();
+			m_moveTicks = 0;
 		}
 		break;
 	}
@@ -550,7 +611,7 @@ void Player::updateMove(void)
 	// of the character's center.
 	for (Uint32 i = 0; i < m_hitboxes.size(); ++i){
 		SDL_Rect offset = { 0, 0, 0, 0 };
-		offset = m_pCurrentMove->frames[m_pCurrentMove->currentFrame].hitboxes[i];
+		offset = m_pCurrentMove->frames[m_currentFrame].hitboxes[i];
 		if (m_side == Player::Side::LEFT){
 			offset.x += m_dst.w / 2;
 		}
@@ -571,28 +632,27 @@ void Player::updateMove(void)
 
 void Player::loadFighterData(const std::string& file)
 {
-	FighterMetadata m(file);
-
-	if (!m.isLoaded()){
-		throw std::exception(std::string("Failed to load fighter file " + file).c_str());
-	}
+	// Get the moveset, sprite sheet and the data used by the simulation, 
+	// loading them only if no other Player has.
+	m_pFighter = FighterCache::getSingletonPtr()->load(file);
+	m_moves = m_pFighter->moves;
+	this->setTexture(m_pFighter->pTexture);
 
-	// Assign the sprite sheet.
-	this->setTextureFile(Engine::getSingletonPtr()->getDataDirectory() + 
-		"/" + m.parseValue("core", "spriteSheet"));
+	std::shared_ptr<const FighterData> pData = m_pFighter->pData;
+	m_pFighterData = pData;
 
 	// Set default rendering size.
-	m_rW = m_dst.w = m.parseIntValue("size", "w");
-	m_rH = m_dst.h = m.parseIntValue("size", "h");
+	m_rW = m_dst.w = pData->w;
+	m_rH = m_dst.h = pData->h;
 
-	// Parse physics.
-	m_xAccel = m.parseIntValue("physics", "xAccel");
-	m_xMax = m.parseIntValue("physics", "xMax");
-	m_jumpStrength = m.parseIntValue("physics", "jumpStrength");
-	m_jumpSpeed = m.parseIntValue("physics", "jumpSpeed");
+	// Physics.
+	m_xAccel = pData->xAccel;
+	m_xMax = pData->xMax;
+	m_jumpStrength = pData->jumpStrength;
+	m_jumpSpeed = pData->jumpSpeed;
 
-	// Parse any gameplay values.
-	m_maxHP = m_currentHP = m.parseIntValue("stats", "HP");
+	// Gameplay values.
+	m_maxHP = m_currentHP = pData->hp;
 
 	// Set player 26 units from bottom adjusting for player height.
 	m_floor = m_dst.y = Engine::getSingletonPtr()->getLogicalWindowHeight() - m_dst.h - 26;
@@ -600,24 +660,10 @@ void Player::loadFighterData(const std::string& file)
 	// Calculate the far right edge at which player movement should stop or move the camera.
 	m_maxXPos = Engine::getSingletonPtr()->getLogicalWindowWidth() - m_dst.w;
 
-	// Load moveset.
-	for (int i = 0; i < MoveID::END_MOVES; ++i){
-		Log::getSingletonPtr()->logMessage("Parsing move \"" + std::string(MoveID::Name[i]) + "\" for " + m_name);
-
-		std::shared_ptr<Move> pMove;
-		pMove = m.parseMove(MoveID::Name[i]);
-		pMove->id = i;
-
-		m_moves.push_back(pMove);
-		if (m_moves.back() == nullptr){
-			throw std::exception(std::string("Unable to load move \"" + std::string(MoveID::Name[i]) + "\" for fighter" +
-				m_name).c_str());
-		}
-	}
-
 	// Setup default IDLE move.
-	m_pMoveTimer->restart();
+	m_moveTicks = 0;
 	m_pCurrentMove = m_moves[MoveID::IDLE];
+	m_currentFrame = 0;
 	m_src = m_moves[MoveID::IDLE]->frames[0].toSDLRect();
 
 	// Setup hitboxes.
@@ -36,9 +36,11 @@
 class Hitbox;
 class Input;
 struct Move;
-class FighterMetadata;
-class Timer;
+struct FighterDefinition;
 class Widget;
+struct FighterData;
+struct SimFighterState;
+struct SimCamera;
 
 typedef std::vector<std::shared_ptr<Move>> MoveList;
 typedef std::vector<std::shared_ptr<Hitbox>> HitboxList;
@@ -110,11 +112,20 @@ public:
 	// Updates the current Move, handles collision.
 	virtual void update(double dt);
 
-	// Renders the Player sprite.
+	// Renders the Player sprite at the last synced or clamped position. 
+	// Does not modify any gameplay state.
 	virtual void render(void);
 
-	// Process animation updates for the current move.
-	void updateMove(void);
+	// Process animation updates for the current move, advancing its clock
+	// by the number of simulation ticks elapsed.
+	void updateMove(const Uint32 ticks);
+
+	// Keeps the player within the viewport and calculates the render rect.
+	// Only used when the Player is updated directly (not by a MatchSim).
+	void clampToViewport(void);
+
+	// Copies a fighter's simulated state into this Player for rendering.
+	void syncFromSim(const SimFighterState& state, const SimCamera& camera);
 
 	// Loads textures, moves, etc.
 	void loadFighterData(const std::string& file);
@@ -131,6 +142,9 @@ public:
 	// Returns the Input object.
 	Input* getInput(void) const;
 
+	// Returns the immutable fighter data used by the simulation.
+	std::shared_ptr<const FighterData> getFighterData(void) const;
+
 	// Returns the mode the player is currently in.
 	const Uint32 getMode(void) const;
 
@@ -155,6 +169,9 @@ public:
 	// Returns HP (hit points).
 	const Uint32 getCurrentHP(void) const;
 
+	// Returns the stun length of the last hit or block (ticks).
+	const Uint32 getStun(void) const;
+
 	// Returns hitbox pointer at index n.
 	Hitbox* getHitbox(const int n) const;
 
@@ -162,7 +179,7 @@ public:
 	const int getMaxXPos(void) const;
 
 	// Returns pointer to current move.
-	Move* getCurrentMove(void) const;
+	const Move* getCurrentMove(void) const;
 
 	// Returns true if hitboxes are active.
 	const bool hitboxesActive(void) const;
@@ -246,13 +263,20 @@ private:
 	Uint32 m_mode;
 	int m_maxHP;
 	int m_currentHP;
+	// Stun length (ticks).
 	Uint32 m_currentStun;
 	Widget* m_pHealthBar;
 	std::shared_ptr<Input> m_pInput;
+	// Shared with every Player using the same fighter.
+	std::shared_ptr<const FighterDefinition> m_pFighter;
+	std::shared_ptr<const FighterData> m_pFighterData;
 	MoveList m_moves;
 	HitboxList m_hitboxes;
-	std::shared_ptr<Move> m_pCurrentMove;
-	std::shared_ptr<Timer> m_pMoveTimer;
+	std::shared_ptr<const Move> m_pCurrentMove;
+	// Frame of the current move being shown.
+	int m_currentFrame;
+	// Ticks spent in the current frame (or stun).
+	Uint32 m_moveTicks;
 	bool m_drawHitboxes;
 	int m_maxXPos;
 	bool m_colliding;
@@ -275,6 +299,10 @@ inline Input* Player::getInput(void) const{
 	return m_pInput.get();
 }
 
+inline std::shared_ptr<const FighterData> Player::getFighterData(void) const{
+	return m_pFighterData;
+}
+
 inline const Uint32 Player::getMode(void) const{
 	return m_mode;
 }
@@ -308,6 +336,10 @@ inline const Uint32 Player::getCurrentHP(void) const{
 	return m_currentHP;
 }
 
+inline const Uint32 Player::getStun(void) const{
+	return m_currentStun;
+}
+
 inline Hitbox* Player::getHitbox(const int n) const{
 	return m_hitboxes[n].get();
 }
@@ -316,7 +348,7 @@ inline const int Player::getMaxXPos(void) const{
 	return m_maxXPos;
 }
 
-inline Move* Player::getCurrentMove(void) const{
+inline const Move* Player::getCurrentMove(void) const{
 	return m_pCurrentMove.get();
 }
 
@@ -32,6 +32,12 @@
 #include "Game.hpp"
 #include "Move.hpp"
 #include "Camera.hpp"
+#include "MatchSim.hpp"
+#include "RollbackSession.hpp"
+#include "LockstepSession.hpp"
+#include "Client.hpp"
+#include "Server.hpp"
+#include "AssetLoader.hpp"
 
 // ================================================ //
 
@@ -46,6 +52,13 @@ m_redFighter(0),
 m_blueFighter(0),
 m_redMax(0),
 m_blueMax(0),
+m_pSim(nullptr),
+m_pRollback(nullptr),
+m_pLockstep(nullptr),
+m_simAccumulator(0.0),
+m_redLoad(),
+m_blueLoad(),
+m_onLoaded(nullptr),
 m_fighters()
 {
 	Log::getSingletonPtr()->logMessage("Initializing PlayerManager...");
@@ -101,25 +114,59 @@ bool PlayerManager::load(const std::string& redFighterFile, const std::string& b
 	m_pRedPlayer->setSide(Player::Side::LEFT);
 	m_pBluePlayer->setSide(Player::Side::RIGHT);
 
-	// startingOffset is the virtual pixel width each player starts from the edge of the viewport.
-	const int startingOffset = 40;
-	m_pRedPlayer->setPosition(startingOffset, m_pRedPlayer->getPosition().y);
-	m_pBluePlayer->setPosition(Engine::getSingletonPtr()->getLogicalWindowWidth() - m_pBluePlayer->getPosition().w - startingOffset, 
+	m_pRedPlayer->setPosition(PlayerManager::StartingOffset, m_pRedPlayer->getPosition().y);
+	m_pBluePlayer->setPosition(Engine::getSingletonPtr()->getLogicalWindowWidth() - m_pBluePlayer->getPosition().w - 
+		PlayerManager::StartingOffset, 
 		m_pBluePlayer->getPosition().y);
 
+	// Create the match simulation from the engine settings and loaded stage.
+	m_pSim.reset(new MatchSim(m_pRedPlayer->getFighterData(), m_pBluePlayer->getFighterData(), 
+		this->createSimConfig()));
+	m_pRollback.reset();
+	m_pLockstep.reset();
+	m_simAccumulator = 0.0;
+	this->syncFromSim();
+
 	return (m_pRedPlayer.get() != nullptr) && (m_pBluePlayer.get() != nullptr);
 }
 
 // ================================================ //
 
+const SimConfig PlayerManager::createSimConfig(void) const
+{
+	SimConfig config;
+	config.viewWidth = Engine::getSingletonPtr()->getLogicalWindowWidth();
+	config.viewHeight = Engine::getSingletonPtr()->getLogicalWindowHeight();
+	config.stageViewWidth = StageManager::getSingletonPtr()->getStage()->m_layers[0].src.w;
+	config.cameraRightBound = StageManager::getSingletonPtr()->getStage()->getRightEdge();
+	config.cameraSpeed = Camera::getSingletonPtr()->getSpeed();
+	config.cameraStartX = Camera::getSingletonPtr()->getPanX();
+	config.startingOffset = PlayerManager::StartingOffset;
+
+	// Only the authoritative server rewinds hurtboxes; rollback and lockstep 
+	// peers must simulate identically, so they never compensate.
+	if (Game::getSingletonPtr()->getMode() == Game::SERVER && Game::getSingletonPtr()->useServerUpdates()){
+		Config c(Engine::getSingletonPtr()->getSettingsFile());
+		config.lagCompensationTicks = (c.parseIntValue("net", "lagCompensation") * MatchSim::TickRate) / 1000;
+	}
+
+	return config;
+}
+
+// ================================================ //
+
+const std::string PlayerManager::getFighterFile(const Uint32 fighter) const
+{
+	return Engine::getSingletonPtr()->getDataDirectory() + "/Fighters/" + m_fighters[fighter].file;
+}
+
+// ================================================ //
+
 bool PlayerManager::load(const Uint32 redFighter, const Uint32 blueFighter)
 {
 	Log::getSingletonPtr()->logMessage("Loading fighter files from \"" +
 		Engine::getSingletonPtr()->getDataDirectory() + "/Fighters\"");
-	bool ret = this->load(Engine::getSingletonPtr()->getDataDirectory() + 
-		"/Fighters/" + m_fighters[redFighter].file, 
-		Engine::getSingletonPtr()->getDataDirectory() + 
-		"/Fighters/" + m_fighters[blueFighter].file);
+	bool ret = this->load(this->getFighterFile(redFighter), this->getFighterFile(blueFighter));
 	if (ret){
 		Log::getSingletonPtr()->logMessage("Fighters loaded!");
 	}
@@ -135,6 +182,58 @@ bool PlayerManager::load(const Uint32 redFighter, const Uint32 blueFighter)
 
 // ================================================ //
 
+void PlayerManager::loadAsync(const Uint32 redFighter, const Uint32 blueFighter, 
+	const LoadCallback& onLoaded)
+{
+	Log::getSingletonPtr()->logMessage("Loading fighter files from \"" +
+		Engine::getSingletonPtr()->getDataDirectory() + "/Fighters\" in the background");
+
+	m_redFighter = redFighter;
+	m_blueFighter = blueFighter;
+
+	// A mirror match shares one load.
+	m_redLoad = FighterCache::getSingletonPtr()->loadAsync(this->getFighterFile(redFighter));
+	m_blueLoad = FighterCache::getSingletonPtr()->loadAsync(this->getFighterFile(blueFighter));
+	m_onLoaded = onLoaded;
+}
+
+// ================================================ //
+
+PlayerManager::LoadStatus PlayerManager::updateLoading(void)
+{
+	if (!this->isLoading()){
+		return LOAD_DONE;
+	}
+	if (!AssetLoader::IsReady(m_redLoad) || !AssetLoader::IsReady(m_blueLoad)){
+		return LOAD_PENDING;
+	}
+
+	// Both fighters are cached now (or failed), so load() doesn't read 
+	// anything.
+	bool ret = false;
+	try{
+		m_redLoad.get();
+		m_blueLoad.get();
+		ret = this->load(m_redFighter, m_blueFighter);
+	}
+	catch (const std::exception& e){
+		Log::getSingletonPtr()->logMessage("ERROR: Failed to load fighters: " + std::string(e.what()));
+	}
+
+	m_redLoad = FighterFuture();
+	m_blueLoad = FighterFuture();
+
+	LoadCallback onLoaded = nullptr;
+	std::swap(onLoaded, m_onLoaded);
+	if (onLoaded){
+		onLoaded(ret);
+	}
+
+	return (ret) ? LOAD_DONE : LOAD_FAILED;
+}
+
+// ================================================ //
+
 bool PlayerManager::reload(void)
 {
 	return this->load(m_redFighter, m_blueFighter);
@@ -172,63 +271,210 @@ bool PlayerManager::reset(void)
 
 void PlayerManager::update(double dt)
 {
-	// Store red and blue x values for calculating distance moved.
-	const int redOldX = m_pRedPlayer->getPosition().x;
-	const int blueOldX = m_pBluePlayer->getPosition().x;
-
-	// Perform game mode specific operations.
 	switch (Game::getSingletonPtr()->getMode()){
 	default:
+		this->updateDirect(dt);
+		break;
+
+	case Game::CLIENT:
+		if (this->startPeerSession()){
+			this->updateSim(dt);
+		}
+		else{
+			this->updateDirect(dt);
+		}
 		break;
 
-	// Perform server-side calculations.
 	case Game::SERVER:
+		this->startPeerSession();
+		this->updateSim(dt);
+		break;
+
 	case Game::LOCAL:
-		m_pRedPlayer->update(dt);
-		m_pBluePlayer->update(dt);
-
-		// Test hitbox collisions (this is predicted on the client).
-		for (int i = Hitbox::DBOX1; i <= Hitbox::DBOX2; ++i){
-			for (int j = Hitbox::HBOX_LOWER; j <= Hitbox::HBOX_HEAD; ++j){
-				if (m_pRedPlayer->getHitbox(i)->intersects(m_pBluePlayer->getHitbox(j))){
-					if (m_pRedPlayer->hitboxesActive()){
-						m_pRedPlayer->setHitboxesActive(false);
-						Move* pMove = m_pRedPlayer->getCurrentMove();
-						bool hit = m_pBluePlayer->takeHit(pMove);
-
-						if (Game::getSingletonPtr()->getMode() == Game::SERVER){
-							// Send damage notification to client.
-							if (hit){
-								Server::getSingletonPtr()->broadcastHit(Game::Playing::PLAYING_BLUE,
-																		pMove->damage, pMove->hitstun);
-							}
-							else{
-								Server::getSingletonPtr()->broadcastHitBlock(Game::Playing::PLAYING_BLUE,
-																			 pMove->blockstun);
-							}
-						}
-					}
-				}
-				if (m_pBluePlayer->getHitbox(i)->intersects(m_pRedPlayer->getHitbox(j))){
-					if (m_pBluePlayer->hitboxesActive()){
-						m_pBluePlayer->setHitboxesActive(false);
-						Move* pMove = m_pBluePlayer->getCurrentMove();
-						bool hit = m_pRedPlayer->takeHit(pMove);
-
-						if (Game::getSingletonPtr()->getMode() == Game::SERVER){
-							if (hit){
-								Server::getSingletonPtr()->broadcastHit(Game::Playing::PLAYING_RED,
-																		pMove->damage, pMove->hitstun);
-							}
-							else{
-								Server::getSingletonPtr()->broadcastHitBlock(Game::Playing::PLAYING_RED,
-																			 pMove->blockstun);
-							}
-						}
-					}
-				}
+		this->updateSim(dt);
+		break;
+	}
+
+	// Render the players after all updates.
+	m_pRedPlayer->render();
+	m_pBluePlayer->render();
+}
+
+// ================================================ //
+
+void PlayerManager::updateSim(double dt)
+{
+	m_simAccumulator += dt;
+
+	int ticks = 0;
+	while (m_simAccumulator >= MatchSim::TickLength){
+		if (ticks >= PlayerManager::MaxTicksPerUpdate){
+			m_simAccumulator = 0.0;
+			break;
+		}
+
+		if (m_pRollback){
+			// Only the local player's input is used, the other is predicted.
+			const Uint32 frame = m_pRollback->getFrame();
+			const SimInput input = (m_pRollback->getLocalFighter() == MatchSim::RED) ?
+				m_pRedPlayer->getInput()->getSimInput() : m_pBluePlayer->getInput()->getSimInput();
+			if (!m_pRollback->advance(input)){
+				// Wait for the remote player to catch up.
+				break;
+			}
+
+			this->sendPeerInput(frame, input);
+		}
+		else if (m_pLockstep){
+			// The local input is scheduled inputDelay ticks ahead; the match 
+			// only advances once the remote input for this tick has arrived.
+			Uint32 frame = 0;
+			const SimInput input = (m_pLockstep->getLocalFighter() == MatchSim::RED) ?
+				m_pRedPlayer->getInput()->getSimInput() : m_pBluePlayer->getInput()->getSimInput();
+			if (m_pLockstep->addLocalInput(input, frame)){
+				this->sendPeerInput(frame, input);
+			}
+			if (!m_pLockstep->advance()){
+				// Wait for the remote player's input.
+				break;
 			}
 		}
+		else{
+			if (Game::getSingletonPtr()->getMode() == Game::SERVER){
+				this->applyClientInputs();
+			}
+
+			const SimInput inputs[MatchSim::NUM_FIGHTERS] = { 
+				m_pRedPlayer->getInput()->getSimInput(),
+				m_pBluePlayer->getInput()->getSimInput()
+			};
+			m_pSim->step(inputs);
+		}
+		m_simAccumulator -= MatchSim::TickLength;
+		++ticks;
+	}
+
+	// Keep the camera on the simulated camera even when no tick was run.
+	this->syncFromSim();
+}
+
+// ================================================ //
+
+bool PlayerManager::startPeerSession(void)
+{
+	if (m_pRollback || m_pLockstep){
+		return true;
+	}
+	if (Game::getSingletonPtr()->useServerUpdates()){
+		return false;
+	}
+
+	int local = -1;
+	switch (Game::getSingletonPtr()->getPlaying()){
+	default:
+		// Spectators and dedicated servers don't simulate the match.
+		return false;
+
+	case Game::PLAYING_RED:
+		local = MatchSim::RED;
+		break;
+
+	case Game::PLAYING_BLUE:
+		local = MatchSim::BLUE;
+		break;
+	}
+
+	if (Game::getSingletonPtr()->useRollback()){
+		m_pRollback.reset(new RollbackSession(m_pSim, local, Game::getSingletonPtr()->getRollbackFrames()));
+		Log::getSingletonPtr()->logMessage("Starting rollback match with " + 
+			Engine::toString(m_pRollback->getMaxRollback()) + " frames of rollback");
+	}
+	else{
+		m_pLockstep.reset(new LockstepSession(m_pSim, local, Game::getSingletonPtr()->getInputDelay()));
+		Log::getSingletonPtr()->logMessage("Starting lockstep match with " + 
+			Engine::toString(m_pLockstep->getInputDelay()) + " frames of input delay");
+	}
+
+	return true;
+}
+
+// ================================================ //
+
+void PlayerManager::addPeerInput(const Uint32 frame, const SimInput input)
+{
+	if (!this->startPeerSession()){
+		return;
+	}
+
+	if (m_pRollback){
+		m_pRollback->addRemoteInput(frame, input);
+	}
+	else{
+		m_pLockstep->addRemoteInput(frame, input);
+	}
+}
+
+// ================================================ //
+
+void PlayerManager::sendPeerInput(const Uint32 frame, const SimInput input)
+{
+	if (Game::getSingletonPtr()->getMode() == Game::SERVER){
+		Server::getSingletonPtr()->sendPeerInput(frame, input);
+	}
+	else{
+		Client::getSingletonPtr()->sendPeerInput(frame, input);
+	}
+}
+
+// ================================================ //
+
+void PlayerManager::applyClientInputs(void)
+{
+	Player* players[MatchSim::NUM_FIGHTERS] = { m_pRedPlayer.get(), m_pBluePlayer.get() };
+	InputQueue* queues[MatchSim::NUM_FIGHTERS] = { &Server::getSingletonPtr()->m_redInputs, 
+		&Server::getSingletonPtr()->m_blueInputs };
+	Uint32* lastProcessed[MatchSim::NUM_FIGHTERS] = { &Server::getSingletonPtr()->m_redLastProcessedInput,
+		&Server::getSingletonPtr()->m_blueLastProcessedInput };
+
+	for (int i = 0; i < MatchSim::NUM_FIGHTERS; ++i){
+		if (players[i]->getMode() != Player::Mode::NET){
+			continue;
+		}
+
+		// Exactly one input per tick, repeating the last one if none arrived.
+		players[i]->getInput()->setSimInput(queues[i]->pop());
+		if (queues[i]->getLastConsumed() != *lastProcessed[i]){
+			*lastProcessed[i] = queues[i]->getLastConsumed();
+			m_pSim->setViewTick(i, queues[i]->getViewTick());
+		}
+	}
+}
+
+// ================================================ //
+
+void PlayerManager::syncFromSim(void)
+{
+	const SimCamera& camera = m_pSim->getCamera();
+
+	Camera::getSingletonPtr()->setPosition(camera.x, camera.y);
+	Camera::getSingletonPtr()->panX(camera.panX);
+	Camera::getSingletonPtr()->panY(camera.panY);
+
+	m_pRedPlayer->syncFromSim(m_pSim->getFighterState(MatchSim::RED), camera);
+	m_pBluePlayer->syncFromSim(m_pSim->getFighterState(MatchSim::BLUE), camera);
+}
+
+// ================================================ //
+
+void PlayerManager::updateDirect(double dt)
+{
+	// Store red and blue x values for calculating distance moved.
+	const int redOldX = m_pRedPlayer->getPosition().x;
+	const int blueOldX = m_pBluePlayer->getPosition().x;
+
+	// Perform game mode specific operations.
+	switch (Game::getSingletonPtr()->getMode()){
+	default:
 		break;
 
 	case Game::CLIENT:
@@ -243,9 +489,23 @@ void PlayerManager::update(double dt)
 		break;
 	}
 
-	// Render the players after initial updates.
-	m_pRedPlayer->render();
-	m_pBluePlayer->render();
+	// Animation is clocked in simulation ticks, so count how many have elapsed.
+	m_simAccumulator += dt;
+	Uint32 ticks = 0;
+	while (m_simAccumulator >= MatchSim::TickLength){
+		if (ticks >= PlayerManager::MaxTicksPerUpdate){
+			m_simAccumulator = 0.0;
+			break;
+		}
+		m_simAccumulator -= MatchSim::TickLength;
+		++ticks;
+	}
+
+	// Animate the players and keep them in the viewport.
+	m_pRedPlayer->updateMove(ticks);
+	m_pRedPlayer->clampToViewport();
+	m_pBluePlayer->updateMove(ticks);
+	m_pBluePlayer->clampToViewport();
 
 	// How much the other player shifts for adjustment.
 	SDL_Rect redPos, bluePos;
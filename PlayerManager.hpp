@@ -28,6 +28,16 @@
 
 #include "stdafx.hpp"
 #include "Player.hpp"
+#include "FighterCache.hpp"
+
+#include <functional>
+
+// ================================================ //
+
+class MatchSim;
+class RollbackSession;
+class LockstepSession;
+struct SimConfig;
 
 // ================================================ //
 
@@ -56,6 +66,25 @@ public:
 	// Finds fighter files and calls other load() function with filenames.
 	bool load(const Uint32 redFighter, const Uint32 blueFighter);
 
+	// Called with true if both fighters loaded.
+	typedef std::function<void(const bool)> LoadCallback;
+
+	// Starts loading both fighters on the AssetLoader's workers. The 
+	// Players are created by updateLoading() once both are loaded, then 
+	// onLoaded is called.
+	void loadAsync(const Uint32 redFighter, const Uint32 blueFighter, 
+		const LoadCallback& onLoaded = nullptr);
+
+	enum LoadStatus{
+		LOAD_DONE = 0,
+		LOAD_PENDING,
+		LOAD_FAILED
+	};
+
+	// Creates both Players once loadAsync() has loaded their fighters. The
+	// stage must already be loaded, as the MatchSim is created from it.
+	LoadStatus updateLoading(void);
+
 	// Calls load() with last used fighter file names.
 	bool reload(void);
 
@@ -63,6 +92,10 @@ public:
 	// button maps and gamepads.
 	bool reset(void);
 
+	// Builds the simulation settings from the engine settings, Camera and 
+	// currently loaded stage.
+	const SimConfig createSimConfig(void) const;
+
 	// Getters
 
 	// Returns pointer to Red Player.
@@ -83,22 +116,86 @@ public:
 	// Returns name of the fighter blue player is using.
 	const std::string getBlueFighterName(void) const;
 
+	// Returns the number of fighters available.
+	const Uint32 getNumFighters(void) const;
+
+	// Returns the full path to a fighter's .fighter file.
+	const std::string getFighterFile(const Uint32 fighter) const;
+
+	// Returns the simulation driving the match in LOCAL and SERVER modes.
+	MatchSim* getMatchSim(void) const;
+
+	// Returns the rollback session, or nullptr if not playing a rollback match.
+	RollbackSession* getRollbackSession(void) const;
+
+	// Returns the lockstep session, or nullptr if not playing a lockstep match.
+	LockstepSession* getLockstepSession(void) const;
+
+	// Returns true if fighters from loadAsync() are still loading.
+	const bool isLoading(void) const;
+
 	// --- //
 
-	// Updates Red and Blue Players, and tests for collisions.
+	// Passes the remote player's input for a frame to the rollback or 
+	// lockstep session.
+	void addPeerInput(const Uint32 frame, const SimInput input);
+
+	// --- //
+
+	// Updates Red and Blue Players, and tests for collisions. In LOCAL and 
+	// SERVER modes the MatchSim is stepped at its fixed tick rate and the 
+	// Players only render its state.
 	void update(double dt);
 
+	// Maximum number of simulation ticks to run in a single update() call.
+	// Any remaining time is dropped to avoid a spiral of death.
+	static const int MaxTicksPerUpdate = 8;
+
+	// The virtual pixel width each player starts from the edge of the viewport.
+	static const int StartingOffset = 40;
+
 	std::shared_ptr<Player> m_pRedPlayer;
 	std::shared_ptr<Player> m_pBluePlayer;
 private:
 	// Allocates both Player objects and sets up default data.
 	bool load(const std::string& redFighterFile, const std::string& blueFighterFile);
+
+	// Steps the MatchSim for the elapsed time and syncs both Players to it.
+	void updateSim(double dt);
+
+	// Creates the rollback or lockstep session once this peer knows which 
+	// player it controls. Returns true if a session exists.
+	bool startPeerSession(void);
+
+	// Sends the local player's input for a frame to the other peer.
+	void sendPeerInput(const Uint32 frame, const SimInput input);
+
+	// Sets each remote Player's Input to the next input its client sent, 
+	// and tests its hits where that client showed the other fighter. Used 
+	// by the server before each tick.
+	void applyClientInputs(void);
+
+	// Copies the simulated fighters and camera into the Players and Camera.
+	void syncFromSim(void);
+
+	// Updates the Players directly (used by the client).
+	void updateDirect(double dt);
 	
 	Uint32 m_redFighter, m_blueFighter;
 
 	// The right edge of the screen minus player width (pixels).
 	int m_redMax, m_blueMax; 
 
+	std::shared_ptr<MatchSim> m_pSim;
+	std::shared_ptr<RollbackSession> m_pRollback;
+	std::shared_ptr<LockstepSession> m_pLockstep;
+	// Elapsed time not yet simulated (seconds).
+	double m_simAccumulator;
+
+	// Fighters being loaded by loadAsync().
+	FighterFuture m_redLoad, m_blueLoad;
+	LoadCallback m_onLoaded;
+
 	FighterEntryList m_fighters;
 };
 
@@ -130,6 +227,26 @@ inline const std::string PlayerManager::getBlueFighterName(void) const{
 	return m_fighters[m_blueFighter].name;
 }
 
+inline const Uint32 PlayerManager::getNumFighters(void) const{
+	return m_fighters.size();
+}
+
+inline MatchSim* PlayerManager::getMatchSim(void) const{
+	return m_pSim.get();
+}
+
+inline RollbackSession* PlayerManager::getRollbackSession(void) const{
+	return m_pRollback.get();
+}
+
+inline LockstepSession* PlayerManager::getLockstepSession(void) const{
+	return m_pLockstep.get();
+}
+
+inline const bool PlayerManager::isLoading(void) const{
+	return m_redLoad.valid() || m_blueLoad.valid();
+}
+
 // ================================================ //
 
 #endif
@@ -0,0 +1,207 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: RollbackSession.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements RollbackSession class.
+// ================================================ //
+
+#include "RollbackSession.hpp"
+#include "SimClock.hpp"
+
+// ================================================ //
+
+RollbackSession::RollbackSession(std::shared_ptr<MatchSim> pSim, const int localFighter,
+								 const uint32_t maxRollback) :
+m_pSim(pSim),
+m_local(localFighter),
+m_remote((localFighter == MatchSim::RED) ? MatchSim::BLUE : MatchSim::RED),
+m_maxRollback(maxRollback),
+m_snapshots(),
+m_inputs(),
+m_confirmedFrames(pSim->getTick()),
+m_rollbackFrame(0),
+m_rollbackPending(false),
+m_stats()
+{
+	if (m_maxRollback > RollbackSession::MaxRollbackFrames){
+		m_maxRollback = RollbackSession::MaxRollbackFrames;
+	}
+	else if (m_maxRollback == 0){
+		m_maxRollback = 1;
+	}
+
+	memset(&m_stats, 0, sizeof(m_stats));
+
+	// Snapshots are only needed as far back as a rollback can go, but the
+	// remote peer can also be up to maxRollback frames ahead of us.
+	m_snapshots.resize(m_maxRollback + 1);
+
+	FrameInput empty;
+	memset(&empty, 0, sizeof(empty));
+	empty.frame = UINT32_MAX;
+	m_inputs.resize((m_maxRollback + 1) * 2, empty);
+}
+
+// ================================================ //
+
+RollbackSession::~RollbackSession(void)
+{
+
+}
+
+// ================================================ //
+
+bool RollbackSession::advance(const SimInput localInput)
+{
+	if (m_rollbackPending){
+		this->rollback();
+	}
+
+	// Don't get further ahead of the remote peer than can be rolled back.
+	const uint32_t frame = m_pSim->getTick();
+	if (frame - m_confirmedFrames >= m_maxRollback){
+		++m_stats.stalls;
+		return false;
+	}
+
+	this->getInput(frame).local = localInput;
+	this->step();
+
+	return true;
+}
+
+// ================================================ //
+
+void RollbackSession::addRemoteInput(const uint32_t frame, const SimInput input)
+{
+	const uint32_t current = m_pSim->getTick();
+
+	// Ignore duplicates and inputs outside the window.
+	if (frame < m_confirmedFrames || frame >= current + m_maxRollback + 1){
+		return;
+	}
+
+	FrameInput& slot = this->getInput(frame);
+	if (slot.confirmed){
+		return;
+	}
+
+	// If this frame was simulated with a wrong prediction, rewind to it.
+	if (frame < current && slot.remote != input){
+		++m_stats.mispredictions;
+		if (!m_rollbackPending || frame < m_rollbackFrame){
+			m_rollbackFrame = frame;
+			m_rollbackPending = true;
+		}
+	}
+
+	slot.remote = input;
+	slot.confirmed = true;
+
+	// Advance the confirmed frame past all contiguous received inputs.
+	while (m_confirmedFrames < current + m_maxRollback + 1){
+		const FrameInput& next = m_inputs[m_confirmedFrames % m_inputs.size()];
+		if (next.frame != m_confirmedFrames || !next.confirmed){
+			break;
+		}
+		++m_confirmedFrames;
+	}
+}
+
+// ================================================ //
+
+RollbackSession::FrameInput& RollbackSession::getInput(const uint32_t frame)
+{
+	FrameInput& slot = m_inputs[frame % m_inputs.size()];
+	if (slot.frame != frame){
+		memset(&slot, 0, sizeof(slot));
+		slot.frame = frame;
+	}
+
+	return slot;
+}
+
+// ================================================ //
+
+SimInput RollbackSession::getRemoteInput(const uint32_t frame)
+{
+	FrameInput& slot = this->getInput(frame);
+	if (!slot.confirmed){
+		// Predict that the remote player is still holding the same buttons.
+		slot.remote = 0;
+		if (m_confirmedFrames > 0){
+			const FrameInput& last = m_inputs[(m_confirmedFrames - 1) % m_inputs.size()];
+			if (last.frame == m_confirmedFrames - 1){
+				slot.remote = last.remote;
+			}
+		}
+	}
+
+	return slot.remote;
+}
+
+// ================================================ //
+
+void RollbackSession::step(void)
+{
+	const uint32_t frame = m_pSim->getTick();
+
+	m_pSim->save(m_snapshots[frame % m_snapshots.size()]);
+
+	SimInput inputs[MatchSim::NUM_FIGHTERS];
+	inputs[m_local] = this->getInput(frame).local;
+	inputs[m_remote] = this->getRemoteInput(frame);
+	m_pSim->step(inputs);
+}
+
+// ================================================ //
+
+void RollbackSession::rollback(void)
+{
+	m_rollbackPending = false;
+
+	const uint32_t current = m_pSim->getTick();
+	if (m_rollbackFrame >= current || current - m_rollbackFrame > m_maxRollback){
+		return;
+	}
+
+	const uint64_t start = SimClock::now();
+
+	m_pSim->load(m_snapshots[m_rollbackFrame % m_snapshots.size()]);
+	while (m_pSim->getTick() < current){
+		this->step();
+	}
+
+	const uint32_t depth = current - m_rollbackFrame;
+	const uint64_t elapsed = SimClock::now() - start;
+
+	++m_stats.rollbacks;
+	m_stats.lastDepth = depth;
+	if (depth > m_stats.maxDepth){
+		m_stats.maxDepth = depth;
+	}
+	m_stats.resimulatedFrames += depth;
+	m_stats.lastResimTime = elapsed;
+	if (elapsed > m_stats.maxResimTime){
+		m_stats.maxResimTime = elapsed;
+	}
+	m_stats.totalResimTime += elapsed;
+}
+
+// ================================================ //
\ No newline at end of file
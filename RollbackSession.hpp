@@ -0,0 +1,170 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: RollbackSession.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines RollbackSession class.
+// ================================================ //
+
+#ifndef __ROLLBACKSESSION_HPP__
+#define __ROLLBACKSESSION_HPP__
+
+// ================================================ //
+
+#include "MatchSim.hpp"
+
+// ================================================ //
+
+// Counters describing how much rollback a session has needed.
+struct RollbackStats{
+	// Number of times the session rolled back.
+	uint32_t rollbacks;
+	// Number of remote inputs that differed from the prediction.
+	uint32_t mispredictions;
+	// Number of calls to advance() that stalled waiting on remote input.
+	uint32_t stalls;
+	// Frames resimulated by the last rollback, and the most by any rollback.
+	uint32_t lastDepth, maxDepth;
+	// Total frames resimulated.
+	uint64_t resimulatedFrames;
+	// Time spent resimulating (microseconds) by the last rollback, the 
+	// longest rollback, and in total.
+	uint64_t lastResimTime, maxResimTime, totalResimTime;
+};
+
+// ================================================ //
+
+// Drives a MatchSim for a peer-to-peer match using rollback. The local 
+// input is applied immediately, the remote input is predicted (by repeating
+// the last confirmed input), and a snapshot is saved every tick. When a 
+// remote input arrives that differs from the prediction, the match is 
+// restored to that tick and resimulated up to the present within the same
+// call to advance(). Knows nothing about the transport; the owner sends the
+// local input and passes received remote inputs to addRemoteInput().
+class RollbackSession
+{
+public:
+	// Takes control of pSim from its current tick. localFighter is 
+	// MatchSim::RED or MatchSim::BLUE. maxRollback is clamped to 
+	// MaxRollbackFrames.
+	explicit RollbackSession(std::shared_ptr<MatchSim> pSim, const int localFighter, 
+							 const uint32_t maxRollback = 8);
+
+	// Empty destructor.
+	~RollbackSession(void);
+
+	// Performs any pending rollback, then advances the match one tick with 
+	// localInput. Returns false without advancing if the remote peer is more
+	// than maxRollback ticks behind (the caller should try again next update).
+	bool advance(const SimInput localInput);
+
+	// Records the remote fighter's input for frame. If that frame has already
+	// been simulated with a different predicted input, a rollback is 
+	// scheduled for the next call to advance().
+	void addRemoteInput(const uint32_t frame, const SimInput input);
+
+	// Getters
+
+	// Returns the next frame to be simulated (the MatchSim's tick).
+	const uint32_t getFrame(void) const;
+
+	// Returns the number of frames for which the remote input is known.
+	const uint32_t getConfirmedFrames(void) const;
+
+	// Returns the local fighter (MatchSim::RED or MatchSim::BLUE).
+	const int getLocalFighter(void) const;
+
+	// Returns the maximum number of frames that can be rolled back.
+	const uint32_t getMaxRollback(void) const;
+
+	// Returns rollback statistics.
+	const RollbackStats& getStats(void) const;
+
+	// --- //
+
+	// Hard limit on the rollback window.
+	static const uint32_t MaxRollbackFrames = 30;
+
+private:
+	// Inputs for a single frame.
+	struct FrameInput{
+		uint32_t frame;
+		SimInput local;
+		SimInput remote;
+		// True if remote was received rather than predicted.
+		bool confirmed;
+	};
+
+	// Returns the input ring slot for frame, resetting it if it holds an older frame.
+	FrameInput& getInput(const uint32_t frame);
+
+	// Returns the remote input to use for frame, predicting it if not confirmed.
+	SimInput getRemoteInput(const uint32_t frame);
+
+	// Steps the MatchSim one tick, saving a snapshot of the state before it.
+	void step(void);
+
+	// Restores the snapshot at m_rollbackFrame and resimulates up to the present.
+	void rollback(void);
+
+	std::shared_ptr<MatchSim> m_pSim;
+	int m_local, m_remote;
+	uint32_t m_maxRollback;
+
+	// Ring buffers indexed by frame % size.
+	std::vector<MatchState> m_snapshots;
+	std::vector<FrameInput> m_inputs;
+
+	// Every remote input before this frame has been received.
+	uint32_t m_confirmedFrames;
+	// The earliest frame that needs resimulating, if m_rollbackPending.
+	uint32_t m_rollbackFrame;
+	bool m_rollbackPending;
+
+	RollbackStats m_stats;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const uint32_t RollbackSession::getFrame(void) const{
+	return m_pSim->getTick();
+}
+
+inline const uint32_t RollbackSession::getConfirmedFrames(void) const{
+	return m_confirmedFrames;
+}
+
+inline const int RollbackSession::getLocalFighter(void) const{
+	return m_local;
+}
+
+inline const uint32_t RollbackSession::getMaxRollback(void) const{
+	return m_maxRollback;
+}
+
+inline const RollbackStats& RollbackSession::getStats(void) const{
+	return m_stats;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
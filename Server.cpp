@@ -33,6 +33,10 @@
 #include "Input.hpp"
 #include "Log.hpp"
 #include "Camera.hpp"
+#include "MatchHost.hpp"
+#include "FighterCache.hpp"
+#include "FighterData.hpp"
+#include "SimClock.hpp"
 
 // ================================================ //
 
@@ -42,24 +46,32 @@ template<> Server* Singleton<Server>::msSingleton = nullptr;
 
 Server::Server(const int port) :
 m_peer(RakNet::RakPeerInterface::GetInstance()),
+m_pTransport(new RakNetTransport(m_peer)),
 m_packet(nullptr),
 m_clients(),
 m_tickRate(8),
 m_redAddr(),
 m_blueAddr(),
+m_redInputs(),
+m_blueInputs(),
 m_redLastProcessedInput(0),
 m_blueLastProcessedInput(0),
 m_lastProcessedStageShift(0),
 m_readyQueue(),
-m_pUpdateTimer(new Timer())
+m_pUpdateTimer(new Timer()),
+m_maxHostedMatches(0),
+m_matchWorkers(0),
+m_pMatchHost(nullptr),
+m_snapshots(),
+m_snapshotAcks(),
+m_rateConfig(),
+m_snapshotTargets(),
+m_pSpectators(new SpectatorChannel())
 {
 	Log::getSingletonPtr()->logMessage("Initializing Server...");
 
-	RakNet::SocketDescriptor sd(port, 0);
-	m_peer->Startup(Server::MaxClients, &sd, 1);
-	m_peer->SetMaximumIncomingConnections(Server::MaxClients);
-
 	// Load the tick rate.
+	Uint32 maxSpectators = 0;
 	Config c(Engine::getSingletonPtr()->getSettingsFile());
 	if (c.isLoaded()){
 		Uint32 tick = c.parseIntValue("net", "serverTickRate");
@@ -69,8 +81,40 @@ m_pUpdateTimer(new Timer())
 
 		m_tickRate = static_cast<int>(1000.0 / tick);
 		Log::getSingletonPtr()->logMessage("Server using tick rate of " + Engine::toString(m_tickRate));
+
+		// Load match hosting settings.
+		m_maxHostedMatches = c.parseIntValue("net", "hostMatches");
+		m_matchWorkers = c.parseIntValue("net", "matchWorkers");
+		if (m_maxHostedMatches > 0){
+			Log::getSingletonPtr()->logMessage("Server hosting up to " + Engine::toString(m_maxHostedMatches) + 
+				" concurrent matches");
+		}
+
+		// Load spectator settings.
+		maxSpectators = c.parseIntValue("net", "maxSpectators");
+		m_pSpectators.reset(new SpectatorChannel(c.parseIntValue("net", "spectatorDelay"),
+			c.parseIntValue("net", "spectatorBatch"), c.parseIntValue("net", "spectatorBudget")));
+
+		// Load the bounds each playing client's snapshot rate adapts between.
+		if (c.parseIntValue("net", "snapshotMinInterval") != 0){
+			m_rateConfig.minInterval = c.parseIntValue("net", "snapshotMinInterval");
+		}
+		if (c.parseIntValue("net", "snapshotMaxInterval") != 0){
+			m_rateConfig.maxInterval = c.parseIntValue("net", "snapshotMaxInterval");
+		}
+		if (c.parseIntValue("net", "snapshotRedundancy") != 0){
+			m_rateConfig.maxRedundancy = c.parseIntValue("net", "snapshotRedundancy");
+		}
+		if (c.parseIntValue("net", "snapshotMaxQueue") != 0){
+			m_rateConfig.maxQueuedBytes = c.parseIntValue("net", "snapshotMaxQueue");
+		}
 	}
 
+	// Spectators connect like any other client, so they need room beyond the players'.
+	RakNet::SocketDescriptor sd(port, 0);
+	m_peer->Startup(Server::MaxClients + maxSpectators, &sd, 1);
+	m_peer->SetMaximumIncomingConnections(Server::MaxClients + maxSpectators);
+
 	// Apply simulated lag, using half the ping since it will be applied to both client
 	// and server.
 	if (Game::getSingletonPtr()->useNetSimulator()){
@@ -85,6 +129,8 @@ m_pUpdateTimer(new Timer())
 
 Server::~Server(void)
 {
+	// Stop hosted matches before the peer they send on is destroyed.
+	m_pMatchHost.reset();
 	RakNet::RakPeerInterface::DestroyInstance(m_peer);
 }
 
@@ -93,7 +139,7 @@ Server::~Server(void)
 Uint32 Server::send(const RakNet::BitStream& bit, const RakNet::SystemAddress& addr,
 	const PacketPriority priority, const PacketReliability reliability)
 {
-	return m_peer->Send(&bit, priority, reliability, 0, addr, false);
+	return m_pTransport->send(bit, priority, reliability, addr);
 }
 
 // ================================================ //
@@ -103,7 +149,7 @@ Uint32 Server::broadcast(const RakNet::Packet* packet, const PacketPriority prio
 {
 	RakNet::BitStream bit(packet->data, packet->length, false);
 	
-	return m_peer->Send(&bit, priority, reliability, 0, exclude, true);
+	return m_pTransport->send(bit, priority, reliability, exclude, true);
 }
 
 // ================================================ //
@@ -111,7 +157,7 @@ Uint32 Server::broadcast(const RakNet::Packet* packet, const PacketPriority prio
 Uint32 Server::broadcast(const RakNet::BitStream& bit, const PacketPriority priority, 
 	const PacketReliability reliability, const RakNet::SystemAddress& exclude)
 {
-	return m_peer->Send(&bit, priority, reliability, 0, exclude, true);
+	return m_pTransport->send(bit, priority, reliability, exclude, true);
 }
 
 // ================================================ //
@@ -129,6 +175,11 @@ Uint32 Server::chat(const std::string& msg)
 
 Uint32 Server::ready(const Uint32 fighter)
 {
+	if (this->isHostingMatches()){
+		Log::getSingletonPtr()->logMessage("SERVER: Can't play while hosting matches.");
+		return 0;
+	}
+
 	if (this->addToReadyQueue(Game::getSingletonPtr()->getUsername(), fighter)){
 		RakNet::BitStream bit;
 		bit.Write(static_cast<RakNet::MessageID>(NetMessage::READY));
@@ -144,6 +195,16 @@ Uint32 Server::ready(const Uint32 fighter)
 
 Uint32 Server::startGame(void)
 {
+	// Clients start decoding snapshots from scratch.
+	m_snapshots.reset();
+	m_snapshotAcks.clear();
+	m_snapshotTargets.clear();
+	m_pSpectators->reset();
+	m_redInputs.reset();
+	m_blueInputs.reset();
+	m_redLastProcessedInput = 0;
+	m_blueLastProcessedInput = 0;
+
 	// First let's tell every client that the game is starting.
 	RakNet::BitStream bit;
 	bit.Write(static_cast<RakNet::MessageID>(NetMessage::SERVER_STARTING_GAME));
@@ -166,6 +227,9 @@ Uint32 Server::startGame(void)
 		play.Write(static_cast<RakNet::MessageID>(NetMessage::PLAYING_RED));
 		this->send(play, m_redAddr, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
 	}
+	else{
+		m_redAddr = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+	}
 
 	// Check blue player.
 	if (Game::getSingletonPtr()->getPlaying() != Game::PLAYING_BLUE){
@@ -177,6 +241,16 @@ Uint32 Server::startGame(void)
 		play.Write(static_cast<RakNet::MessageID>(NetMessage::PLAYING_BLUE));
 		this->send(play, m_blueAddr, IMMEDIATE_PRIORITY, RELIABLE_ORDERED);
 	}
+	else{
+		m_blueAddr = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+	}
+
+	// Everyone else watches.
+	for (ClientList::iterator itr = m_clients.begin(); itr != m_clients.end(); ++itr){
+		if (itr->addr != m_redAddr && itr->addr != m_blueAddr){
+			m_pSpectators->addSpectator(itr->addr);
+		}
+	}
 
 	m_pUpdateTimer->restart();
 
@@ -224,120 +298,144 @@ Uint32 Server::sendPlayerList(const RakNet::SystemAddress& addr, const bool broa
 
 // ================================================ //
 
-Uint32 Server::updatePlayers(void)
+void Server::takeSnapshot(void)
 {
-	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>(NetMessage::UPDATE_PLAYERS));
-
-	// Write red player data.
-	PlayerUpdate redPlayer;
-	Player* red = PlayerManager::getSingletonPtr()->getRedPlayer();
-	redPlayer.lastProcessedInput = m_redLastProcessedInput;
-	redPlayer.x = red->getPosition().x;
-	redPlayer.y = red->getPosition().y;
-	redPlayer.xVel = red->getXVelocity();
-	redPlayer.state = red->getCurrentState();
-	bit.Write(redPlayer);
-
-	// Write blue player data.
-	PlayerUpdate bluePlayer;
-	Player* blue = PlayerManager::getSingletonPtr()->getBluePlayer();
-	bluePlayer.lastProcessedInput = m_blueLastProcessedInput;
-	bluePlayer.x = blue->getPosition().x;
-	bluePlayer.y = blue->getPosition().y;
-	bluePlayer.xVel = blue->getXVelocity();
-	bluePlayer.state = blue->getCurrentState();
-	bit.Write(bluePlayer);
-
-	return this->broadcast(bit, IMMEDIATE_PRIORITY, UNRELIABLE_SEQUENCED);
+	WorldSnapshot snapshot;
+	snapshot.tick = PlayerManager::getSingletonPtr()->getMatchSim()->getTick();
+	snapshot.cameraPanX = Camera::getSingletonPtr()->getPanX();
+
+	Player* players[2] = { PlayerManager::getSingletonPtr()->getRedPlayer(), 
+		PlayerManager::getSingletonPtr()->getBluePlayer() };
+	const Uint32 lastProcessedInputs[2] = { m_redLastProcessedInput, m_blueLastProcessedInput };
+	for (int i = 0; i < 2; ++i){
+		PlayerUpdate& update = snapshot.players[i];
+		update.lastProcessedInput = lastProcessedInputs[i];
+		update.x = players[i]->getPosition().x;
+		update.y = players[i]->getPosition().y;
+		update.xVel = players[i]->getXVelocity();
+		update.state = players[i]->getCurrentState();
+		update.hp = players[i]->getCurrentHP();
+		update.stun = players[i]->getStun();
+	}
+	m_snapshots.push(snapshot);
 }
 
 // ================================================ //
 
-Uint32 Server::panCamera(void)
+Uint32 Server::sendSnapshot(void)
 {
-	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>(NetMessage::PAN_CAMERA));
+	const uint64_t now = SimClock::now();
+
+	// Ask each playing client's rate what it is due.
+	RakNet::SystemAddress addrs[2];
+	SnapshotRate::Action actions[2];
+	int numPlayers = 0;
+	bool due = false;
+	for (ClientList::iterator itr = m_clients.begin(); itr != m_clients.end() && numPlayers < 2; ++itr){
+		if (itr->addr != m_redAddr && itr->addr != m_blueAddr){
+			continue;
+		}
 
-	bit.Write(Camera::getSingletonPtr()->getPanX());
+		SnapshotTarget& target = m_snapshotTargets[itr->addr];
+		if (!target.pRate){
+			target.pRate.reset(new SnapshotRate(m_rateConfig, m_tickRate));
+		}
+		target.pRate->update(m_pTransport.get(), itr->addr, now);
 
-	return this->broadcast(bit, HIGH_PRIORITY, RELIABLE);
-}
+		addrs[numPlayers] = itr->addr;
+		actions[numPlayers] = target.pRate->poll(now);
+		due |= (actions[numPlayers] == SnapshotRate::SEND_NEW);
+		++numPlayers;
+	}
 
-// ================================================ //
+	// Spectators share the full snapshots taken, which unacknowledged players may use as well.
+	if (due || (numPlayers == 0 && m_pSpectators->getNumSpectators() > 0)){
+		this->takeSnapshot();
+		if (m_pSpectators->getNumSpectators() > 0){
+			m_pSpectators->push(m_snapshots.getPacket(false, 0), now);
+		}
+	}
 
-Uint32 Server::updateRedPlayer(const bool sendToBlue)
-{
-	PlayerUpdate redPlayer;
-	Player* red = PlayerManager::getSingletonPtr()->getRedPlayer();
-	redPlayer.lastProcessedInput = m_redLastProcessedInput;
-	redPlayer.x = red->getPosition().x;
-	redPlayer.y = red->getPosition().y;
-	redPlayer.xVel = red->getXVelocity();
-	redPlayer.state = red->getCurrentState();
+	// Clients that acknowledged the same snapshot share one encoded packet.
+	Uint32 ret = 0;
+	for (int i = 0; i < numPlayers; ++i){
+		SnapshotTarget& target = m_snapshotTargets[addrs[i]];
+		if (actions[i] == SnapshotRate::SEND_NEW){
+			std::map<RakNet::SystemAddress, Uint16>::const_iterator ack = m_snapshotAcks.find(addrs[i]);
+			target.pLastPacket = (ack != m_snapshotAcks.end()) ?
+				m_snapshots.getPacket(true, ack->second) : m_snapshots.getPacket(false, 0);
+		}
+		else if (actions[i] == SnapshotRate::SKIP || !target.pLastPacket){
+			continue;
+		}
 
-	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>(NetMessage::UPDATE_RED_PLAYER));
-	bit.Write(redPlayer);
+		ret = this->send(*target.pLastPacket, addrs[i], IMMEDIATE_PRIORITY, UNRELIABLE_SEQUENCED);
+	}
+
+	m_pSpectators->update(m_pTransport.get(), now);
 
-	return this->send(bit, (sendToBlue == true) ? m_blueAddr : m_redAddr, IMMEDIATE_PRIORITY);
+	return ret;
 }
 
 // ================================================ //
 
-Uint32 Server::updateBluePlayer(const bool sendToRed)
+const SnapshotRateStats Server::getSnapshotRateStats(const RakNet::SystemAddress& addr) const
 {
-	PlayerUpdate bluePlayer;
-	Player* blue = PlayerManager::getSingletonPtr()->getBluePlayer();
-	bluePlayer.lastProcessedInput = m_blueLastProcessedInput;
-	bluePlayer.x = blue->getPosition().x;
-	bluePlayer.y = blue->getPosition().y;
-	bluePlayer.xVel = blue->getXVelocity();
-	bluePlayer.state = blue->getCurrentState();
+	std::map<RakNet::SystemAddress, SnapshotTarget>::const_iterator itr = m_snapshotTargets.find(addr);
+	if (itr != m_snapshotTargets.end()){
+		return itr->second.pRate->getStats();
+	}
 
-	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>(NetMessage::UPDATE_BLUE_PLAYER));
-	bit.Write(bluePlayer);
+	SnapshotRateStats stats;
+	memset(&stats, 0, sizeof(stats));
+	return stats;
+}
+
+// ================================================ //
 
-	return this->send(bit, (sendToRed == true) ? m_redAddr : m_blueAddr, IMMEDIATE_PRIORITY);
+void Server::ackSnapshot(const RakNet::Packet* packet)
+{
+	RakNet::BitStream bit(packet->data, packet->length, false);
+	bit.IgnoreBytes(sizeof(RakNet::MessageID));
+	Uint16 seq = 0;
+	if (bit.Read(seq)){
+		m_snapshotAcks[packet->systemAddress] = seq;
+	}
 }
 
 // ================================================ //
 
-Uint32 Server::broadcastHit(const int player, const Uint32 damage, const Uint32 stun)
+Uint32 Server::sendLastProcessedInput(void)
 {
 	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>((player == Game::Playing::PLAYING_RED) ?
-		NetMessage::RED_TAKE_HIT : NetMessage::BLUE_TAKE_HIT));
-	// Write HP for client to set directly.
-	bit.Write((player == Game::PLAYING_RED) ? PlayerManager::getSingletonPtr()->getRedPlayer()->getCurrentHP() :
-		PlayerManager::getSingletonPtr()->getBluePlayer()->getCurrentHP());
-	bit.Write(stun);
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::LAST_PROCESSED_INPUT_SEQUENCE));
+	bit.Write(m_redLastProcessedInput);
 
-	return this->broadcast(bit, HIGH_PRIORITY, RELIABLE_ORDERED);
+	return this->send(bit, m_redAddr);
 }
 
 // ================================================ //
 
-Uint32 Server::broadcastHitBlock(const int player, const Uint32 stun)
+Uint32 Server::sendClockPong(const RakNet::Packet* ping, const Uint32 tick)
 {
 	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>((player == Game::Playing::PLAYING_RED) ?
-		NetMessage::RED_TAKE_HIT_BLOCK : NetMessage::BLUE_TAKE_HIT_BLOCK));
-	bit.Write(stun);
+	if (!ClockSync::WritePong(ping, bit, SimClock::now(), tick)){
+		return 0;
+	}
 
-	return this->broadcast(bit, HIGH_PRIORITY, RELIABLE_ORDERED);
+	return this->send(bit, ping->systemAddress, IMMEDIATE_PRIORITY, UNRELIABLE);
 }
 
 // ================================================ //
 
-Uint32 Server::sendLastProcessedInput(void)
+Uint32 Server::sendPeerInput(const Uint32 frame, const SimInput input)
 {
 	RakNet::BitStream bit;
-	bit.Write(static_cast<RakNet::MessageID>(NetMessage::LAST_PROCESSED_INPUT_SEQUENCE));
-	bit.Write(m_redLastProcessedInput);
+	bit.Write(static_cast<RakNet::MessageID>(NetMessage::PEER_INPUT));
+	bit.Write(frame);
+	bit.Write(input);
 
-	return this->send(bit, m_redAddr);
+	return this->broadcast(bit, HIGH_PRIORITY, RELIABLE_ORDERED);
 }
 
 // ================================================ //
@@ -355,6 +453,8 @@ void Server::registerClient(const char* username, const RakNet::SystemAddress& a
 void Server::removeClient(const RakNet::SystemAddress& addr)
 {
 	m_clients.erase(m_clients.begin() + this->getClient(addr));
+	m_pSpectators->removeSpectator(addr);
+	m_snapshotTargets.erase(addr);
 }
 
 // ================================================ //
@@ -379,7 +479,8 @@ bool Server::isUsernameInUse(const std::string& username)
 
 const bool Server::validateInput(const Client::NetInput& input) const
 {
-	if (input.dt > 0.035){ // This value is under question.
+	// Only buttons the client could have pressed.
+	if ((input.buttons >> Input::NUM_BUTTONS) != 0){
 		return false;
 	}
 
@@ -388,6 +489,65 @@ const bool Server::validateInput(const Client::NetInput& input) const
 
 // ================================================ //
 
+void Server::updateHostedMatches(void)
+{
+	if (!this->isHostingMatches()){
+		return;
+	}
+
+	while (m_readyQueue.size() >= 2){
+		if (m_pMatchHost == nullptr){
+			// Hosted matches use the same stage the clients load.
+			StageManager::getSingletonPtr()->load(Engine::getSingletonPtr()->getDataDirectory() + "/Stages/test.stage");
+			m_pMatchHost.reset(new MatchHost(m_pTransport.get(), PlayerManager::getSingletonPtr()->createSimConfig(),
+				m_rateConfig, m_maxHostedMatches, m_matchWorkers));
+		}
+		if (m_pMatchHost->getNumMatches() >= m_pMatchHost->getMaxMatches()){
+			break;
+		}
+
+		const ReadyClient red = this->getNextRedPlayer();
+		const ReadyClient blue = this->getNextBluePlayer();
+		m_readyQueue.pop_front();
+		m_readyQueue.pop_front();
+
+		const int redClient = this->getClient(red.username);
+		const int blueClient = this->getClient(blue.username);
+		if (redClient == -1 || blueClient == -1 ||
+			red.fighter >= PlayerManager::getSingletonPtr()->getNumFighters() ||
+			blue.fighter >= PlayerManager::getSingletonPtr()->getNumFighters()){
+			Log::getSingletonPtr()->logMessage("SERVER: Invalid ready clients " + red.username + 
+				" and " + blue.username + ", not starting match.");
+			continue;
+		}
+
+		MatchPlayer redPlayer, bluePlayer;
+		redPlayer.addr = m_clients[redClient].addr;
+		redPlayer.username = red.username;
+		redPlayer.fighter = red.fighter;
+		bluePlayer.addr = m_clients[blueClient].addr;
+		bluePlayer.username = blue.username;
+		bluePlayer.fighter = blue.fighter;
+
+		m_pMatchHost->createMatch(redPlayer, bluePlayer, 
+			this->getFighterData(red.fighter), this->getFighterData(blue.fighter));
+	}
+
+	if (m_pMatchHost){
+		m_pMatchHost->update();
+	}
+}
+
+// ================================================ //
+
+std::shared_ptr<const FighterData> Server::getFighterData(const Uint32 fighter)
+{
+	// Hosted matches share the data with the local Players.
+	return FighterCache::getSingletonPtr()->load(PlayerManager::getSingletonPtr()->getFighterFile(fighter))->pData;
+}
+
+// ================================================ //
+
 void Server::dbgPrintAllConnectedClients(void)
 {
 	if (m_clients.size() == 0){
@@ -28,6 +28,10 @@
 
 #include "stdafx.hpp"
 #include "Client.hpp"
+#include "SnapshotChannel.hpp"
+#include "SpectatorChannel.hpp"
+#include "SnapshotRate.hpp"
+#include "InputQueue.hpp"
 
 // ================================================ //
 
@@ -47,6 +51,8 @@ struct Packet;
 typedef std::vector<ClientConnection> ClientList;
 typedef std::list<ReadyClient> ReadyQueue;
 class Timer;
+class MatchHost;
+struct FighterData;
 
 // ================================================ //
 
@@ -86,29 +92,25 @@ public:
 	// is added to the client list.
 	Uint32 sendPlayerList(const RakNet::SystemAddress& addr, const bool broadcast = false);
 	
-	// Broadcasts all relevant player information to clients.
-	Uint32 updatePlayers(void);
-	
-	// Broadcasts a PAN_CAMERA message, clients will adjust stage view.
-	Uint32 panCamera(void);
-
-	// Sends a PlayerUpdate only to the client playing the red player.
-	// If sendToBlue is true, the update is send directly to blue's address.
-	Uint32 updateRedPlayer(const bool sendToBlue = false);
-
-	// Sends a PlayerUpdate only to the client playing the blue player.
-	// If sendToRed is true, the update is send directly to red's address.
-	Uint32 updateBluePlayer(const bool sendToRed = false);
+	// Sends a WorldSnapshot of the current tick to each playing client whose
+	// SnapshotRate is due one, delta-encoded against the last snapshot it
+	// acknowledged; the others may get their last one again. Spectating 
+	// clients get the snapshots taken later, batched by the SpectatorChannel.
+	// Should be called every getUpdateInterval() ms.
+	Uint32 sendSnapshot(void);
 
-	// Broadcasts damage of specified player, e.g., Game::PLAYING_BLUE or Game::PLAYING_RED.
-	Uint32 broadcastHit(const int player, const Uint32 damage, const Uint32 stun);
-
-	// Broadcasts block state of player and blockstun.
-	Uint32 broadcastHitBlock(const int player, const Uint32 stun);
+	// Applies a SNAPSHOT_ACK packet from a client.
+	void ackSnapshot(const RakNet::Packet* packet);
 
 	// Sends the last processed input sequence number to playing clients.
 	Uint32 sendLastProcessedInput(void);
 
+	// Answers a CLOCK_PING packet with the server's clock and tick.
+	Uint32 sendClockPong(const RakNet::Packet* ping, const Uint32 tick);
+
+	// Broadcasts the server player's input for a rollback or lockstep frame.
+	Uint32 sendPeerInput(const Uint32 frame, const SimInput input);
+
 	// Adds a client to the list of connected clients.
 	void registerClient(const char* username, const RakNet::SystemAddress& addr);
 
@@ -128,6 +130,10 @@ public:
 	// Removes a client from the ready queue.
 	void removeFromReadyQueue(const std::string& username);
 
+	// When hosting matches, starts a match for each pair of clients in the 
+	// ready queue (while there is room) and removes finished matches.
+	void updateHostedMatches(void);
+
 	// Returns true if client input seems valid.
 	const bool validateInput(const Client::NetInput& input) const;
 
@@ -166,12 +172,37 @@ public:
 	// Returns pointer to internal RakNet RakPeerInterface.
 	RakNet::RakPeerInterface* getPeer(void);
 
+	// Returns the transport packets are sent and received on.
+	Transport* getTransport(void);
+
 	// Returns pointer to internal RakNet Packet.
 	RakNet::Packet* getPacket(void);
 
 	// Returns the tick rate (update frequency) in milliseconds.
 	const Uint32 getTickRate(void) const;
 
+	// Returns the shortest interval (ms) between snapshots to a client, 
+	// which sendSnapshot() should be called at. Clients start at the tick
+	// rate and adapt between this and a configured maximum.
+	const Uint32 getUpdateInterval(void) const;
+
+	// Returns true if the server hosts concurrent matches between clients
+	// instead of playing a single match in GameState.
+	const bool isHostingMatches(void) const;
+
+	// Returns the MatchHost, or nullptr if no match has been hosted yet.
+	MatchHost* getMatchHost(void) const;
+
+	// Returns the bandwidth used by snapshots since the game started.
+	const SnapshotStats& getSnapshotStats(void) const;
+
+	// Returns the fan-out to spectators since the game started.
+	const SpectatorStats& getSpectatorStats(void) const;
+
+	// Returns the snapshot rate of a playing client this game, or zeros if
+	// it hasn't been sent any snapshots.
+	const SnapshotRateStats getSnapshotRateStats(const RakNet::SystemAddress& addr) const;
+
 	// Returns a string of the first set of data of the last packet (skipping
 	// the first byte).
 	const char* getPacketStrData(void) const;
@@ -180,13 +211,7 @@ public:
 
 	// --- //
 
-	typedef struct{
-		Uint32 lastProcessedInput;
-		RakNet::Time timestamp;
-		int x, y;
-		int xVel;
-		Uint32 state;
-	} PlayerUpdate;
+	typedef ::PlayerUpdate PlayerUpdate;
 
 	// --- //
 
@@ -194,11 +219,15 @@ public:
 
 public:
 	RakNet::RakPeerInterface* m_peer;
+	std::shared_ptr<Transport> m_pTransport;
 	RakNet::Packet* m_packet;
 	ClientList m_clients;
 	Uint32 m_tickRate;
 
 	RakNet::SystemAddress m_redAddr, m_blueAddr;
+	// Inputs received from the playing clients, applied one per tick, and 
+	// the seq of the one each player's last tick used.
+	InputQueue m_redInputs, m_blueInputs;
 	Uint32 m_redLastProcessedInput, m_blueLastProcessedInput;
 	Uint32 m_lastProcessedStageShift;
 
@@ -208,8 +237,35 @@ public:
 	// The std::string should specify the username.
 	ReadyQueue m_readyQueue;
 
-	// The timer which controls when player updates are sent to the clients.
+	// The timer which controls when snapshots are sent to the clients.
 	std::shared_ptr<Timer> m_pUpdateTimer;
+
+	// Maximum concurrent hosted matches (0 disables hosting) and worker threads.
+	Uint32 m_maxHostedMatches, m_matchWorkers;
+	std::shared_ptr<MatchHost> m_pMatchHost;
+
+private:
+	// Returns the simulation data for a fighter from the FighterCache.
+	std::shared_ptr<const FighterData> getFighterData(const Uint32 fighter);
+
+	// Pushes a WorldSnapshot of the current tick to m_snapshots.
+	void takeSnapshot(void);
+
+	// Snapshots sent this game, and the newest one each client acknowledged.
+	SnapshotChannel m_snapshots;
+	std::map<RakNet::SystemAddress, Uint16> m_snapshotAcks;
+
+	// How often each playing client gets a snapshot, and the last one sent.
+	typedef struct{
+		std::shared_ptr<SnapshotRate> pRate;
+		std::shared_ptr<const RakNet::BitStream> pLastPacket;
+	} SnapshotTarget;
+
+	SnapshotRateConfig m_rateConfig;
+	std::map<RakNet::SystemAddress, SnapshotTarget> m_snapshotTargets;
+
+	// Delayed, batched snapshots for the clients not playing.
+	std::shared_ptr<SpectatorChannel> m_pSpectators;
 };
 
 // ================================================ //
@@ -319,6 +375,10 @@ inline RakNet::RakPeerInterface* Server::getPeer(void){
 	return m_peer;
 }
 
+inline Transport* Server::getTransport(void){
+	return m_pTransport.get();
+}
+
 inline RakNet::Packet* Server::getPacket(void){
 	return m_packet;
 }
@@ -327,6 +387,26 @@ inline const Uint32 Server::getTickRate(void) const{
 	return m_tickRate;
 }
 
+inline const Uint32 Server::getUpdateInterval(void) const{
+	return std::min(m_tickRate, m_rateConfig.minInterval);
+}
+
+inline const bool Server::isHostingMatches(void) const{
+	return (m_maxHostedMatches > 0);
+}
+
+inline MatchHost* Server::getMatchHost(void) const{
+	return m_pMatchHost.get();
+}
+
+inline const SnapshotStats& Server::getSnapshotStats(void) const{
+	return m_snapshots.getStats();
+}
+
+inline const SpectatorStats& Server::getSpectatorStats(void) const{
+	return m_pSpectators->getStats();
+}
+
 // Setters
 
 // ================================================ //
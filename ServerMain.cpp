@@ -0,0 +1,64 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: ServerMain.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Entry point of the headless dedicated server.
+// ================================================ //
+
+#include "stdafx.hpp"
+#include "DedicatedServer.hpp"
+
+#include <csignal>
+#include <iostream>
+
+// ================================================ //
+
+// Stops the server loop on Ctrl+C or termination.
+static void onSignal(int)
+{
+	if (DedicatedServer::getSingletonPtr()){
+		DedicatedServer::getSingletonPtr()->stop();
+	}
+}
+
+// ================================================ //
+
+int main(int argc, char** argv)
+{
+	try{
+		new Log();
+		new DedicatedServer();
+
+		std::signal(SIGINT, onSignal);
+		std::signal(SIGTERM, onSignal);
+
+		DedicatedServer::getSingletonPtr()->run();
+
+		delete DedicatedServer::getSingletonPtr();
+		delete Log::getSingletonPtr();
+	}
+	catch (std::exception& e){
+		std::cerr << "An exception has occured: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,54 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SimClock.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines SimClock namespace, a high resolution clock usable without SDL.
+// ================================================ //
+
+#ifndef __SIMCLOCK_HPP__
+#define __SIMCLOCK_HPP__
+
+// ================================================ //
+
+#include <chrono>
+#include <cstdint>
+
+// ================================================ //
+
+// Timing for code that can't depend on SDL (e.g., profiling the 
+// simulation). Never used to drive the simulation itself.
+namespace SimClock{
+	// Returns a monotonic timestamp in microseconds.
+	inline uint64_t now(void){
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// Returns a monotonic timestamp in nanoseconds, for timing single ticks.
+	inline uint64_t nowNs(void){
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,130 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SimFixed.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements SimFixed namespace.
+// ================================================ //
+
+#include "SimFixed.hpp"
+
+// ================================================ //
+
+namespace{
+	// sin(i * PI / 256) in Q15 for i = 0..128 (the first quarter turn).
+	const int32_t SinTable[129] = {
+	0, 402, 804, 1206, 1608, 2009, 2411, 2811,
+	3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998,
+	6393, 6787, 7180, 7571, 7962, 8351, 8740, 9127,
+	9512, 9896, 10279, 10660, 11039, 11417, 11793, 12167,
+	12540, 12910, 13279, 13646, 14010, 14373, 14733, 15091,
+	15447, 15800, 16151, 16500, 16846, 17190, 17531, 17869,
+	18205, 18538, 18868, 19195, 19520, 19841, 20160, 20475,
+	20788, 21097, 21403, 21706, 22006, 22302, 22595, 22884,
+	23170, 23453, 23732, 24008, 24279, 24548, 24812, 25073,
+	25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020,
+	27246, 27467, 27684, 27897, 28106, 28311, 28511, 28707,
+	28899, 29086, 29269, 29448, 29622, 29792, 29957, 30118,
+	30274, 30425, 30572, 30715, 30853, 30986, 31114, 31238,
+	31357, 31471, 31581, 31686, 31786, 31881, 31972, 32058,
+	32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568,
+	32610, 32647, 32679, 32706, 32729, 32746, 32758, 32766,
+	32768
+	};
+
+	// PI to 9 decimal places, as a ratio of integers.
+	const int64_t PiNumerator = 3141592654LL;
+	const int64_t PiDenominator = 1000000000LL;
+}
+
+// ================================================ //
+
+int32_t SimFixed::divFloor(const int32_t a, const int32_t b)
+{
+	// Integer division truncates towards zero, so adjust negative quotients.
+	const int32_t q = a / b;
+	return ((a % b) != 0 && a < 0) ? q - 1 : q;
+}
+
+// ================================================ //
+
+int32_t SimFixed::divRound(const int32_t a, const int32_t b)
+{
+	return (a >= 0) ? (a + b / 2) / b : -((-a + b / 2) / b);
+}
+
+// ================================================ //
+
+int32_t SimFixed::sinHalfTurn(const int32_t angle)
+{
+	if (angle <= 0 || angle >= SimFixed::HalfTurn){
+		return 0;
+	}
+
+	// The table has 256 steps per half turn, with 8 fractional bits between them.
+	int32_t index = angle >> 8;
+	const int32_t frac = angle & 0xFF;
+
+	// Mirror the second quarter turn onto the first.
+	int32_t a = 0, b = 0;
+	if (index < 128){
+		a = SinTable[index];
+		b = SinTable[index + 1];
+	}
+	else{
+		index = 256 - index;
+		a = SinTable[index];
+		b = SinTable[index - 1];
+	}
+
+	return a + SimFixed::divFloor((b - a) * frac, 256);
+}
+
+// ================================================ //
+
+int32_t SimFixed::toSubPixelsPerTick(const int32_t pixelsPerSecond, const uint32_t tickRate)
+{
+	return SimFixed::divRound(pixelsPerSecond * SimFixed::SubPixels, static_cast<int32_t>(tickRate));
+}
+
+// ================================================ //
+
+int32_t SimFixed::toPixelsPerSecond(const int32_t subPixelsPerTick, const uint32_t tickRate)
+{
+	return SimFixed::divRound(subPixelsPerTick * static_cast<int32_t>(tickRate), SimFixed::SubPixels);
+}
+
+// ================================================ //
+
+int32_t SimFixed::toAnglePerTick(const int32_t radiansPerSecond, const uint32_t tickRate)
+{
+	// angle = (rad/s / tickRate) / PI * HalfTurn
+	const int64_t num = static_cast<int64_t>(radiansPerSecond) * SimFixed::HalfTurn * PiDenominator;
+	const int64_t den = static_cast<int64_t>(tickRate) * PiNumerator;
+	return static_cast<int32_t>((num + den / 2) / den);
+}
+
+// ================================================ //
+
+uint32_t SimFixed::msToTicks(const uint32_t ms, const uint32_t tickRate)
+{
+	const uint64_t num = static_cast<uint64_t>(ms) * tickRate;
+	return static_cast<uint32_t>((num + 500) / 1000);
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,79 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SimFixed.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines SimFixed namespace, the integer math used by MatchSim.
+// ================================================ //
+
+#ifndef __SIMFIXED_HPP__
+#define __SIMFIXED_HPP__
+
+// ================================================ //
+
+#include "SimTypes.hpp"
+
+// ================================================ //
+
+// Integer and fixed-point helpers for the simulation. Everything here uses
+// only integer operations with fully defined rounding, so results are 
+// bit-identical on every compiler, CPU, and build configuration.
+namespace SimFixed{
+	enum{
+		// Positions and velocities are tracked in 1/256ths of a pixel.
+		SubPixelBits = 8,
+		SubPixels = 1 << SubPixelBits,
+
+		// Angles are expressed so that HalfTurn represents PI radians.
+		HalfTurn = 1 << 16,
+
+		// Results of sin() are scaled by One (Q15).
+		OneBits = 15,
+		One = 1 << OneBits
+	};
+
+	// Returns a / b rounded towards negative infinity (b must be positive).
+	int32_t divFloor(const int32_t a, const int32_t b);
+
+	// Returns a / b rounded to the nearest integer, halves away from zero
+	// (b must be positive).
+	int32_t divRound(const int32_t a, const int32_t b);
+
+	// Returns sin(angle) as a Q15 value for an angle in [0, HalfTurn],
+	// linearly interpolated from a fixed table.
+	int32_t sinHalfTurn(const int32_t angle);
+
+	// Converts a rate in pixels per second to sub-pixels per tick.
+	int32_t toSubPixelsPerTick(const int32_t pixelsPerSecond, const uint32_t tickRate);
+
+	// Converts a rate in sub-pixels per tick back to pixels per second.
+	int32_t toPixelsPerSecond(const int32_t subPixelsPerTick, const uint32_t tickRate);
+
+	// Converts radians per second (integral, as stored in .fighter files) 
+	// to HalfTurn units per tick.
+	int32_t toAnglePerTick(const int32_t radiansPerSecond, const uint32_t tickRate);
+
+	// Converts a duration in milliseconds to the nearest whole number of ticks.
+	uint32_t msToTicks(const uint32_t ms, const uint32_t tickRate);
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
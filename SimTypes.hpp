@@ -0,0 +1,125 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SimTypes.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines SimRect struct, SimInput type, and the state, button,
+// and hitbox enumerations shared by the simulation core.
+// ================================================ //
+
+#ifndef __SIMTYPES_HPP__
+#define __SIMTYPES_HPP__
+
+// ================================================ //
+
+// The simulation core must not depend on SDL, so only the C++ standard
+// library is included here (see stdafx.hpp for the game's headers).
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <memory>
+
+// ================================================ //
+
+// A plain rectangle, equivalent to SDL_Rect.
+struct SimRect{
+	int32_t x;
+	int32_t y;
+	int32_t w;
+	int32_t h;
+};
+
+// Returns true if rects a and b overlap. Empty rects never intersect,
+// matching SDL_HasIntersection().
+inline bool SimRectIntersects(const SimRect& a, const SimRect& b){
+	if (a.w <= 0 || a.h <= 0 || b.w <= 0 || b.h <= 0){
+		return false;
+	}
+
+	return (a.x < b.x + b.w && b.x < a.x + a.w &&
+			a.y < b.y + b.h && b.y < a.y + a.h);
+}
+
+// ================================================ //
+
+// All states a fighter can be in. Each state indexes the fighter's move of
+// the same ID, so this must stay in the same order as Player::State and MoveID.
+namespace FighterState{
+	enum{
+		IDLE = 0,
+		WALKING_FORWARD,
+		WALKING_BACK,
+		JUMPING,
+
+		CROUCHING,
+		CROUCHED,
+		UNCROUCHING,
+
+		ATTACK_LP,
+
+		STUNNED_JUMP,
+		STUNNED_HIT,
+		STUNNED_BLOCK,
+
+		END_STATES
+	};
+}
+
+// Hitbox indices for each frame, same order as the Hitbox class.
+namespace SimHitbox{
+	enum{
+		HBOX_LOWER = 0,
+		HBOX_MIDDLE,
+		HBOX_UPPER,
+		HBOX_HEAD,
+		TBOX,
+		DBOX1,
+		DBOX2,
+		CBOX1,
+		CBOX2,
+
+		NUM_HITBOXES
+	};
+}
+
+// ================================================ //
+
+// The state of every button for one fighter during one tick. Bit n is set
+// if Input button n (e.g., Input::BUTTON_LEFT) is held.
+typedef uint16_t SimInput;
+
+namespace SimButton{
+	enum{
+		UP = 1 << 0,
+		DOWN = 1 << 1,
+		LEFT = 1 << 2,
+		RIGHT = 1 << 3,
+		START = 1 << 4,
+		SELECT = 1 << 5,
+		BACK = 1 << 6,
+		LP = 1 << 7
+	};
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,153 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SnapshotBuffer.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements SnapshotBuffer class.
+// ================================================ //
+
+#include "SnapshotBuffer.hpp"
+#include "MatchSim.hpp"
+
+// ================================================ //
+
+const double SnapshotBuffer::MinDelay = 1.0 / 60.0;
+const double SnapshotBuffer::MaxDelay = 0.25;
+const double SnapshotBuffer::JitterScale = 3.0;
+const double SnapshotBuffer::DelayAdjustRate = 0.1;
+
+namespace{
+	// Gains of the interval and jitter filters (as in RFC 3550's jitter).
+	const double IntervalGain = 1.0 / 8.0;
+	const double JitterGain = 1.0 / 16.0;
+	// How fast the clock offset estimate may rise (seconds per second).
+	const double OffsetRelaxRate = 0.01;
+
+	int lerp(const int a, const int b, const double t){
+		return a + static_cast<int>(floor((b - a) * t + 0.5));
+	}
+}
+
+// ================================================ //
+
+SnapshotBuffer::SnapshotBuffer(void) :
+m_entries()
+{
+	this->reset();
+}
+
+// ================================================ //
+
+SnapshotBuffer::~SnapshotBuffer(void)
+{
+
+}
+
+// ================================================ //
+
+void SnapshotBuffer::reset(void)
+{
+	m_entries.clear();
+	m_offset = 0.0;
+	m_interval = MatchSim::TickLength;
+	m_jitter = 0.0;
+	m_delay = MinDelay;
+	m_lastArrival = 0.0;
+	m_lastSample = 0.0;
+	m_underruns = 0;
+	m_renderTick = 0;
+}
+
+// ================================================ //
+
+void SnapshotBuffer::push(const Uint32 tick, const PlayerUpdate& update, const double arrival)
+{
+	const double time = tick * MatchSim::TickLength;
+	const double offset = arrival - time;
+	if (m_entries.empty()){
+		m_offset = offset;
+	}
+	else{
+		if (time <= m_entries.back().time){
+			return;
+		}
+
+		m_offset = std::min(offset, m_offset + (arrival - m_lastArrival) * OffsetRelaxRate);
+		m_interval += ((time - m_entries.back().time) - m_interval) * IntervalGain;
+		m_jitter += ((offset - m_offset) - m_jitter) * JitterGain;
+	}
+	m_lastArrival = arrival;
+
+	Entry entry;
+	entry.tick = tick;
+	entry.time = time;
+	entry.update = update;
+	m_entries.push_back(entry);
+	if (m_entries.size() > static_cast<size_t>(SnapshotBuffer::Capacity)){
+		m_entries.pop_front();
+	}
+}
+
+// ================================================ //
+
+bool SnapshotBuffer::sample(const double now, PlayerUpdate& update)
+{
+	if (m_entries.empty()){
+		return false;
+	}
+
+	// Move the delay toward its target without jumping.
+	const double target = std::max(MinDelay, std::min(MaxDelay, m_interval + JitterScale * m_jitter));
+	if (m_lastSample == 0.0){
+		m_delay = target;
+	}
+	else{
+		const double step = (now - m_lastSample) * DelayAdjustRate;
+		m_delay = (target > m_delay) ? std::min(target, m_delay + step) : std::max(target, m_delay - step);
+	}
+	m_lastSample = now;
+
+	// The server time to render.
+	const double time = now - m_offset - m_delay;
+
+	// Drop snapshots that are no longer needed to interpolate.
+	while (m_entries.size() > 1 && m_entries[1].time <= time){
+		m_entries.pop_front();
+	}
+
+	const Entry& from = m_entries.front();
+	m_renderTick = from.tick;
+	if (m_entries.size() == 1 || time <= from.time){
+		if (time > from.time){
+			++m_underruns;
+		}
+		update = from.update;
+		return true;
+	}
+
+	const Entry& to = m_entries[1];
+	const double t = (time - from.time) / (to.time - from.time);
+	update = from.update;
+	update.x = lerp(from.update.x, to.update.x, t);
+	update.y = lerp(from.update.y, to.update.y, t);
+	update.xVel = lerp(from.update.xVel, to.update.xVel, t);
+
+	return true;
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,136 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SnapshotBuffer.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines SnapshotBuffer class.
+// ================================================ //
+
+#ifndef __SNAPSHOTBUFFER_HPP__
+#define __SNAPSHOTBUFFER_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+#include "SnapshotChannel.hpp"
+
+// ================================================ //
+
+// Client-side buffer of one remote fighter's snapshots, each stamped with
+// its server tick and the local time it arrived. The fighter is rendered
+// an interpolation delay behind the newest snapshot, between the two 
+// snapshots around that time, so its motion is smooth however unevenly 
+// packets arrive. The delay adapts to the measured arrival jitter: it 
+// covers one snapshot interval plus a few times the jitter, and changes 
+// gradually so playback never visibly speeds up or skips.
+class SnapshotBuffer
+{
+public:
+	// Starts empty, with the minimum delay.
+	explicit SnapshotBuffer(void);
+
+	// Empty destructor.
+	~SnapshotBuffer(void);
+
+	// Forgets all snapshots and jitter measurements.
+	void reset(void);
+
+	// Adds the fighter's update from the snapshot of tick, received at the
+	// local time arrival (seconds). Snapshots no newer than the newest one
+	// are ignored.
+	void push(const Uint32 tick, const PlayerUpdate& update, const double arrival);
+
+	// Writes the update to render at the local time now (seconds): position
+	// and velocity are interpolated, the rest is taken from the older of the
+	// two snapshots. Holds the newest snapshot if the buffer runs dry. 
+	// Returns false if nothing has been received.
+	bool sample(const double now, PlayerUpdate& update);
+
+	// Getters
+
+	// Returns the current interpolation delay (seconds).
+	const double getDelay(void) const;
+
+	// Returns the smoothed arrival jitter (seconds).
+	const double getJitter(void) const;
+
+	// Returns the number of times sample() ran past the newest snapshot.
+	const Uint32 getUnderruns(void) const;
+
+	// Returns the tick of the older snapshot used by the last sample(), 
+	// i.e., the server tick the fighter is being shown at.
+	const Uint32 getRenderTick(void) const;
+
+	// Snapshots kept, enough to cover MaxDelay at the server's tick rate.
+	static const int Capacity = 32;
+
+	// Bounds of the interpolation delay (seconds).
+	static const double MinDelay;
+	static const double MaxDelay;
+	// The delay covers the snapshot interval plus this many times the jitter.
+	static const double JitterScale;
+	// How fast the delay may follow its target, as a fraction of elapsed 
+	// time, i.e., playback runs at most this much faster or slower.
+	static const double DelayAdjustRate;
+
+private:
+	struct Entry{
+		Uint32 tick;
+		// Server time of the snapshot (seconds).
+		double time;
+		PlayerUpdate update;
+	};
+
+	std::deque<Entry> m_entries;
+
+	// Smallest observed (arrival - server time), i.e., the clock offset of
+	// a packet with no queuing delay. Relaxed slowly to follow clock drift.
+	double m_offset;
+	// Smoothed time between snapshots and lateness of arrivals (seconds).
+	double m_interval, m_jitter;
+	double m_delay;
+	double m_lastArrival, m_lastSample;
+	Uint32 m_underruns;
+	Uint32 m_renderTick;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const double SnapshotBuffer::getDelay(void) const{
+	return m_delay;
+}
+
+inline const double SnapshotBuffer::getJitter(void) const{
+	return m_jitter;
+}
+
+inline const Uint32 SnapshotBuffer::getUnderruns(void) const{
+	return m_underruns;
+}
+
+inline const Uint32 SnapshotBuffer::getRenderTick(void) const{
+	return m_renderTick;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,376 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SnapshotChannel.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements SnapshotChannel class.
+// ================================================ //
+
+#include "SnapshotChannel.hpp"
+#include "NetMessage.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+namespace{
+	// Bits of the distance between a packet and its baseline (History - 1).
+	const int BaselineBits = 5;
+
+	// Writes the low bits of value.
+	void writeBits(RakNet::BitStream& bit, const Uint32 value, const int bits){
+		const unsigned char bytes[4] = {
+			static_cast<unsigned char>(value & 0xff),
+			static_cast<unsigned char>((value >> 8) & 0xff),
+			static_cast<unsigned char>((value >> 16) & 0xff),
+			static_cast<unsigned char>((value >> 24) & 0xff)
+		};
+		bit.WriteBits(bytes, bits, true);
+	}
+
+	// Reads bits written by writeBits().
+	bool readBits(RakNet::BitStream& bit, Uint32& value, const int bits){
+		unsigned char bytes[4] = { 0, 0, 0, 0 };
+		if (!bit.ReadBits(bytes, bits, true)){
+			return false;
+		}
+		value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<Uint32>(bytes[3]) << 24);
+		return true;
+	}
+
+	// Reads a signed field written as value - min.
+	bool readBits(RakNet::BitStream& bit, int& value, const int bits, const int min){
+		Uint32 bits32 = 0;
+		if (!readBits(bit, bits32, bits)){
+			return false;
+		}
+		value = static_cast<int>(bits32) + min;
+		return true;
+	}
+
+	// Clamps value to the range of a quantized field.
+	int clampToRange(const int value, const int min, const int bits){
+		const int max = min + (1 << bits) - 1;
+		return (value < min) ? min : ((value > max) ? max : value);
+	}
+
+	Uint32 clampToRange(const Uint32 value, const int bits){
+		const Uint32 max = (1u << bits) - 1;
+		return (value > max) ? max : value;
+	}
+
+	// Writes a position, as a short delta from base when it is close.
+	void writePosition(RakNet::BitStream& bit, const int value, const int base){
+		const int delta = value - base;
+		const int half = 1 << (SnapshotChannel::SmallDeltaBits - 1);
+		const bool small = (delta >= -half && delta < half);
+		bit.Write(small);
+		if (small){
+			writeBits(bit, static_cast<Uint32>(delta + half), SnapshotChannel::SmallDeltaBits);
+		}
+		else{
+			writeBits(bit, static_cast<Uint32>(value - SnapshotChannel::PositionMin), 
+					  SnapshotChannel::PositionBits);
+		}
+	}
+
+	// Reads a position written by writePosition().
+	bool readPosition(RakNet::BitStream& bit, int& value, const int base){
+		bool small = false;
+		if (!bit.Read(small)){
+			return false;
+		}
+		if (small){
+			if (!readBits(bit, value, SnapshotChannel::SmallDeltaBits, -(1 << (SnapshotChannel::SmallDeltaBits - 1)))){
+				return false;
+			}
+			value += base;
+			return true;
+		}
+
+		return readBits(bit, value, SnapshotChannel::PositionBits, SnapshotChannel::PositionMin);
+	}
+
+	// Writes a sequence number (tick or input), as a short delta from base 
+	// when it is a little ahead of it.
+	void writeSeq(RakNet::BitStream& bit, const Uint32 value, const Uint32 base){
+		const Uint32 delta = value - base;
+		const bool small = (delta < (1u << SnapshotChannel::SeqDeltaBits));
+		bit.Write(small);
+		writeBits(bit, (small) ? delta : value, (small) ? SnapshotChannel::SeqDeltaBits : 32);
+	}
+
+	// Reads a sequence number written by writeSeq().
+	bool readSeq(RakNet::BitStream& bit, Uint32& value, const Uint32 base){
+		bool small = false;
+		if (!bit.Read(small) || !readBits(bit, value, (small) ? SnapshotChannel::SeqDeltaBits : 32)){
+			return false;
+		}
+		if (small){
+			value += base;
+		}
+
+		return true;
+	}
+}
+
+// ================================================ //
+
+SnapshotChannel::SnapshotChannel(void) :
+m_packets()
+{
+	this->reset();
+}
+
+// ================================================ //
+
+SnapshotChannel::~SnapshotChannel(void)
+{
+
+}
+
+// ================================================ //
+
+void SnapshotChannel::reset(void)
+{
+	memset(m_history, 0, sizeof(m_history));
+	memset(&m_stats, 0, sizeof(m_stats));
+	m_nextSeq = 0;
+	m_packets.clear();
+}
+
+// ================================================ //
+
+void SnapshotChannel::push(const WorldSnapshot& snapshot)
+{
+	Entry& entry = m_history[m_nextSeq % History];
+	entry.seq = m_nextSeq++;
+	entry.valid = true;
+
+	// Baselines hold what recipients decode, so store the quantized values.
+	WorldSnapshot& s = entry.snapshot;
+	s.tick = snapshot.tick;
+	s.cameraPanX = clampToRange(snapshot.cameraPanX, 0, CameraBits);
+	for (int i = 0; i < 2; ++i){
+		const PlayerUpdate& in = snapshot.players[i];
+		PlayerUpdate& p = s.players[i];
+		p.lastProcessedInput = in.lastProcessedInput;
+		p.x = clampToRange(in.x, PositionMin, PositionBits);
+		p.y = clampToRange(in.y, PositionMin, PositionBits);
+		p.xVel = clampToRange(in.xVel, VelocityMin, VelocityBits);
+		p.state = in.state & ((1 << StateBits) - 1);
+		p.hp = clampToRange(in.hp, HPBits);
+		p.stun = clampToRange(in.stun, StunBits);
+	}
+
+	m_packets.clear();
+	++m_stats.snapshots;
+}
+
+// ================================================ //
+
+std::shared_ptr<const RakNet::BitStream> SnapshotChannel::getPacket(const bool hasAck, const Uint16 acked)
+{
+	const Entry* pBase = (hasAck) ? this->findEntry(acked) : nullptr;
+	// The newest snapshot can't be its own baseline.
+	if (pBase && pBase->seq == static_cast<Uint16>(m_nextSeq - 1)){
+		pBase = nullptr;
+	}
+	const int key = (pBase) ? pBase->seq : -1;
+
+	std::shared_ptr<RakNet::BitStream> pPacket;
+	for (size_t i = 0; i < m_packets.size(); ++i){
+		if (m_packets[i].first == key){
+			pPacket = m_packets[i].second;
+			break;
+		}
+	}
+	if (!pPacket){
+		pPacket.reset(new RakNet::BitStream());
+		pPacket->Write(static_cast<RakNet::MessageID>(NetMessage::WORLD_SNAPSHOT));
+		this->encode(*pPacket, pBase);
+		m_packets.push_back(std::make_pair(key, pPacket));
+		++m_stats.encodes;
+	}
+
+	++m_stats.packets;
+	m_stats.rawBytes += sizeof(RakNet::MessageID) + sizeof(WorldSnapshot);
+	m_stats.packedBytes += pPacket->GetNumberOfBytesUsed();
+	if (pBase){
+		++m_stats.deltaPackets;
+	}
+
+	return pPacket;
+}
+
+// ================================================ //
+
+void SnapshotChannel::encode(RakNet::BitStream& bit, const Entry* pBase) const
+{
+	const Uint16 seq = static_cast<Uint16>(m_nextSeq - 1);
+	const WorldSnapshot& s = m_history[seq % History].snapshot;
+
+	writeBits(bit, seq, 16);
+	bit.Write(pBase != nullptr);
+	if (!pBase){
+		writeBits(bit, s.tick, 32);
+		writeBits(bit, static_cast<Uint32>(s.cameraPanX), CameraBits);
+		for (int i = 0; i < 2; ++i){
+			const PlayerUpdate& p = s.players[i];
+			writeBits(bit, p.lastProcessedInput, 32);
+			writeBits(bit, static_cast<Uint32>(p.x - PositionMin), PositionBits);
+			writeBits(bit, static_cast<Uint32>(p.y - PositionMin), PositionBits);
+			writeBits(bit, static_cast<Uint32>(p.xVel - VelocityMin), VelocityBits);
+			writeBits(bit, p.state, StateBits);
+			writeBits(bit, p.hp, HPBits);
+			writeBits(bit, p.stun, StunBits);
+		}
+		return;
+	}
+
+	// Otherwise, each field is preceded by a bit that is set if it changed.
+	const WorldSnapshot& b = pBase->snapshot;
+	writeBits(bit, static_cast<Uint16>(seq - pBase->seq) - 1, BaselineBits);
+	writeSeq(bit, s.tick, b.tick);
+	bit.Write(s.cameraPanX != b.cameraPanX);
+	if (s.cameraPanX != b.cameraPanX){
+		writeBits(bit, static_cast<Uint32>(s.cameraPanX), CameraBits);
+	}
+	for (int i = 0; i < 2; ++i){
+		const PlayerUpdate& p = s.players[i];
+		const PlayerUpdate& pb = b.players[i];
+		bit.Write(p.lastProcessedInput != pb.lastProcessedInput);
+		if (p.lastProcessedInput != pb.lastProcessedInput){
+			writeSeq(bit, p.lastProcessedInput, pb.lastProcessedInput);
+		}
+		bit.Write(p.x != pb.x);
+		if (p.x != pb.x){
+			writePosition(bit, p.x, pb.x);
+		}
+		bit.Write(p.y != pb.y);
+		if (p.y != pb.y){
+			writePosition(bit, p.y, pb.y);
+		}
+		bit.Write(p.xVel != pb.xVel);
+		if (p.xVel != pb.xVel){
+			writeBits(bit, static_cast<Uint32>(p.xVel - VelocityMin), VelocityBits);
+		}
+		bit.Write(p.state != pb.state);
+		if (p.state != pb.state){
+			writeBits(bit, p.state, StateBits);
+		}
+		bit.Write(p.hp != pb.hp);
+		if (p.hp != pb.hp){
+			writeBits(bit, p.hp, HPBits);
+		}
+		bit.Write(p.stun != pb.stun);
+		if (p.stun != pb.stun){
+			writeBits(bit, p.stun, StunBits);
+		}
+	}
+}
+
+// ================================================ //
+
+bool SnapshotChannel::read(RakNet::BitStream& bit, WorldSnapshot& snapshot, Uint16& seq)
+{
+	Uint32 value = 0;
+	bool hasBase = false;
+	if (!readBits(bit, value, 16) || !bit.Read(hasBase)){
+		return false;
+	}
+	seq = static_cast<Uint16>(value);
+
+	WorldSnapshot& s = snapshot;
+	if (!hasBase){
+		if (!readBits(bit, s.tick, 32) || !readBits(bit, s.cameraPanX, CameraBits, 0)){
+			return false;
+		}
+		for (int i = 0; i < 2; ++i){
+			PlayerUpdate& p = s.players[i];
+			if (!readBits(bit, p.lastProcessedInput, 32) || !readBits(bit, p.x, PositionBits, PositionMin) ||
+				!readBits(bit, p.y, PositionBits, PositionMin) || !readBits(bit, p.xVel, VelocityBits, VelocityMin) ||
+				!readBits(bit, p.state, StateBits) || !readBits(bit, p.hp, HPBits) || !readBits(bit, p.stun, StunBits)){
+				return false;
+			}
+		}
+	}
+	else{
+		if (!readBits(bit, value, BaselineBits)){
+			return false;
+		}
+		const Entry* pBase = this->findEntry(static_cast<Uint16>(seq - value - 1));
+		if (!pBase){
+			return false;
+		}
+
+		s = pBase->snapshot;
+		bool changed = false;
+		if (!readSeq(bit, s.tick, s.tick) || !bit.Read(changed) ||
+			(changed && !readBits(bit, s.cameraPanX, CameraBits, 0))){
+			return false;
+		}
+		for (int i = 0; i < 2; ++i){
+			PlayerUpdate& p = s.players[i];
+			if (!bit.Read(changed) || (changed && !readSeq(bit, p.lastProcessedInput, p.lastProcessedInput)) ||
+				!bit.Read(changed) || (changed && !readPosition(bit, p.x, p.x)) ||
+				!bit.Read(changed) || (changed && !readPosition(bit, p.y, p.y)) ||
+				!bit.Read(changed) || (changed && !readBits(bit, p.xVel, VelocityBits, VelocityMin)) ||
+				!bit.Read(changed) || (changed && !readBits(bit, p.state, StateBits)) ||
+				!bit.Read(changed) || (changed && !readBits(bit, p.hp, HPBits)) ||
+				!bit.Read(changed) || (changed && !readBits(bit, p.stun, StunBits))){
+				return false;
+			}
+		}
+	}
+
+	// Keep what was decoded as a possible baseline for later packets.
+	Entry& entry = m_history[seq % History];
+	entry.seq = seq;
+	entry.valid = true;
+	entry.snapshot = s;
+
+	return true;
+}
+
+// ================================================ //
+
+const SnapshotChannel::Entry* SnapshotChannel::findEntry(const Uint16 seq) const
+{
+	const Entry& entry = m_history[seq % History];
+	return (entry.valid && entry.seq == seq) ? &entry : nullptr;
+}
+
+// ================================================ //
+
+std::string SnapshotChannel::FormatStats(const SnapshotStats& stats)
+{
+	if (stats.packets == 0){
+		return "no snapshots sent";
+	}
+
+	// Averages to one decimal place.
+	const double raw = static_cast<double>((stats.rawBytes * 10) / stats.packets) / 10.0;
+	const double packed = static_cast<double>((stats.packedBytes * 10) / stats.packets) / 10.0;
+	return Engine::toString(stats.snapshots) + " snapshots, " + Engine::toString(stats.packets) + 
+		" packets (" + Engine::toString(stats.encodes) + " encoded), " + Engine::toString(raw) + 
+		" bytes/packet unpacked -> " + Engine::toString(packed) + " bytes/packet packed (" + 
+		Engine::toString(static_cast<int>(100.0 - (packed * 100.0) / raw)) + "% saved, " + 
+		Engine::toString((stats.deltaPackets * 100) / stats.packets) + "% delta-encoded)";
+}
+
+// ================================================ //
\ No newline at end of file
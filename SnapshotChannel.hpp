@@ -0,0 +1,170 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SnapshotChannel.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines PlayerUpdate and WorldSnapshot structs, and SnapshotChannel class.
+// ================================================ //
+
+#ifndef __SNAPSHOTCHANNEL_HPP__
+#define __SNAPSHOTCHANNEL_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+
+// ================================================ //
+
+// The authoritative state of one player in a WorldSnapshot.
+struct PlayerUpdate{
+	Uint32 lastProcessedInput;
+	int x, y;
+	int xVel;
+	Uint32 state;
+	Uint32 hp;
+	// Stun length of the last hit or block (ticks).
+	Uint32 stun;
+};
+
+// Everything a client shows of one server tick, sent as a single 
+// WORLD_SNAPSHOT message and applied at once.
+struct WorldSnapshot{
+	// Simulation tick the snapshot was taken on.
+	Uint32 tick;
+	// Camera pan destination.
+	int cameraPanX;
+	// Indexed by MatchSim::RED and MatchSim::BLUE.
+	PlayerUpdate players[2];
+};
+
+// Bandwidth used by a SnapshotChannel's packets.
+struct SnapshotStats{
+	// Snapshots taken, and packets sent for them (one per recipient).
+	uint64_t snapshots, packets;
+	// Packets actually encoded; recipients with the same baseline share one.
+	uint64_t encodes;
+	// Bytes the packets would have taken as whole WorldSnapshot structs.
+	uint64_t rawBytes;
+	// Bytes actually sent.
+	uint64_t packedBytes;
+	// Packets sent against an acknowledged baseline.
+	uint64_t deltaPackets;
+};
+
+// ================================================ //
+
+// A stream of WorldSnapshots from the server. Snapshots are bit-packed:
+// positions, velocities, HP and stun are quantized to fixed ranges and the
+// state fits in a few bits. Each snapshot is numbered, and once a recipient
+// acknowledges one, later packets to it only carry the fields that changed
+// since that baseline. The server keeps one channel per match and tracks 
+// each recipient's ack; clients keep one channel to decode with.
+class SnapshotChannel
+{
+public:
+	// Starts with no snapshots, so the first packets are sent in full.
+	explicit SnapshotChannel(void);
+
+	// Empty destructor.
+	~SnapshotChannel(void);
+
+	// Forgets all snapshots, e.g., when a new match starts.
+	void reset(void);
+
+	// Sender: numbers snapshot and makes it the newest.
+	void push(const WorldSnapshot& snapshot);
+
+	// Sender: returns the newest snapshot as a WORLD_SNAPSHOT packet for a 
+	// recipient whose newest acknowledged snapshot is acked (if hasAck). It
+	// is delta-encoded against acked while that is still in the history. 
+	// Each baseline is encoded once per snapshot and shared by every 
+	// recipient that uses it.
+	std::shared_ptr<const RakNet::BitStream> getPacket(const bool hasAck, const Uint16 acked);
+
+	// Receiver: reads a packet from getPacket() (after the message ID).
+	// Returns false if the packet is malformed or its baseline is no longer
+	// known, in which case it should be dropped. On success, seq is the 
+	// sequence to acknowledge.
+	bool read(RakNet::BitStream& bit, WorldSnapshot& snapshot, Uint16& seq);
+
+	// Getters
+
+	// Returns the bandwidth used by getPacket() since the last reset().
+	const SnapshotStats& getStats(void) const;
+
+	// Returns a one-line bandwidth report of stats, for the log.
+	static std::string FormatStats(const SnapshotStats& stats);
+
+	// Number of snapshots remembered as possible baselines. An ack older
+	// than this is ignored and the next packet is sent in full.
+	static const int History = 32;
+
+	// Quantized ranges. Positions cover the largest supported logical 
+	// resolution (1920x1080) with room for fighters partly off screen.
+	static const int PositionMin = -1024;
+	static const int PositionBits = 12;
+	// Camera pan destination, from 0 to the stage's right edge.
+	static const int CameraBits = 13;
+	// Horizontal velocity, pixels per second.
+	static const int VelocityMin = -4096;
+	static const int VelocityBits = 13;
+	// Player::State, see FighterState::END_STATES.
+	static const int StateBits = 4;
+	static const int HPBits = 12;
+	static const int StunBits = 8;
+	// Position changes smaller than this are sent as a short delta.
+	static const int SmallDeltaBits = 6;
+	// Bits of the change in the last processed input or tick from the 
+	// baseline when sent as a short delta.
+	static const int SeqDeltaBits = 6;
+
+private:
+	struct Entry{
+		Uint16 seq;
+		bool valid;
+		WorldSnapshot snapshot;
+	};
+
+	// Returns the history entry for seq, or nullptr if it has been overwritten.
+	const Entry* findEntry(const Uint16 seq) const;
+
+	// Writes the newest snapshot to bit, against pBase if not null.
+	void encode(RakNet::BitStream& bit, const Entry* pBase) const;
+
+	Entry m_history[History];
+	Uint16 m_nextSeq;
+
+	// Packets encoded for the newest snapshot, by baseline (-1 for none).
+	std::vector<std::pair<int, std::shared_ptr<RakNet::BitStream>>> m_packets;
+
+	SnapshotStats m_stats;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const SnapshotStats& SnapshotChannel::getStats(void) const{
+	return m_stats;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
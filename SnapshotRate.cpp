@@ -0,0 +1,156 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SnapshotRate.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements SnapshotRateConfig and SnapshotRate classes.
+// ================================================ //
+
+#include "SnapshotRate.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+SnapshotRateConfig::SnapshotRateConfig(void) :
+minInterval(8),
+maxInterval(100),
+maxRedundancy(2),
+maxQueuedBytes(1024),
+redundancyLoss(0.02),
+congestionLoss(0.25),
+adjustInterval(250)
+{
+
+}
+
+// ================================================ //
+// ================================================ //
+
+SnapshotRate::SnapshotRate(const SnapshotRateConfig& config, const Uint32 interval) :
+m_config(config),
+m_next(0),
+m_nextAdjust(0),
+m_repeats(0),
+m_stats()
+{
+	if (m_config.minInterval == 0){
+		m_config.minInterval = 1;
+	}
+	if (m_config.maxInterval < m_config.minInterval){
+		m_config.maxInterval = m_config.minInterval;
+	}
+	if (m_config.maxRedundancy == 0){
+		m_config.maxRedundancy = 1;
+	}
+
+	memset(&m_stats, 0, sizeof(m_stats));
+	m_stats.interval = std::min(std::max(interval, m_config.minInterval), m_config.maxInterval);
+	m_stats.redundancy = 1;
+}
+
+// ================================================ //
+
+SnapshotRate::~SnapshotRate(void)
+{
+
+}
+
+// ================================================ //
+
+void SnapshotRate::update(Transport* transport, const RakNet::SystemAddress& addr, const uint64_t now)
+{
+	if (now < m_nextAdjust){
+		return;
+	}
+
+	ConnectionStats connection;
+	if (!transport->getConnectionStats(addr, connection)){
+		m_nextAdjust = now + static_cast<uint64_t>(m_config.adjustInterval) * 1000;
+		return;
+	}
+	m_stats.connection = connection;
+
+	Uint32& interval = m_stats.interval;
+	if (connection.queuedBytes > m_config.maxQueuedBytes || connection.loss > m_config.congestionLoss){
+		// Back off quickly, and don't add repeats to a congested connection.
+		const Uint32 slower = std::min(interval + std::max(interval / 2, static_cast<Uint32>(1)), 
+			m_config.maxInterval);
+		if (slower != interval){
+			interval = slower;
+			++m_stats.decreases;
+		}
+		m_stats.redundancy = 1;
+	}
+	else{
+		// Speed up slowly while the connection keeps up.
+		if (connection.queuedBytes <= m_config.maxQueuedBytes / 2 && interval > m_config.minInterval){
+			interval = std::max(interval - std::max(interval / 8, static_cast<Uint32>(1)), m_config.minInterval);
+			++m_stats.increases;
+		}
+
+		if (connection.loss > m_config.redundancyLoss){
+			m_stats.redundancy = std::min(m_stats.redundancy + 1, m_config.maxRedundancy);
+		}
+		else if (connection.loss < m_config.redundancyLoss / 2 && m_stats.redundancy > 1){
+			--m_stats.redundancy;
+		}
+	}
+
+	m_nextAdjust = now + static_cast<uint64_t>(std::max(m_config.adjustInterval, connection.rtt)) * 1000;
+}
+
+// ================================================ //
+
+SnapshotRate::Action SnapshotRate::poll(const uint64_t now)
+{
+	if (now >= m_next){
+		// Keep the average rate when offers don't line up with the interval,
+		// but don't burst to catch up after falling behind.
+		m_next += static_cast<uint64_t>(m_stats.interval) * 1000;
+		if (m_next < now){
+			m_next = now;
+		}
+
+		m_repeats = m_stats.redundancy - 1;
+		++m_stats.sent;
+		return SnapshotRate::SEND_NEW;
+	}
+
+	if (m_repeats > 0){
+		--m_repeats;
+		++m_stats.repeated;
+		return SnapshotRate::SEND_REPEAT;
+	}
+
+	++m_stats.skipped;
+	return SnapshotRate::SKIP;
+}
+
+// ================================================ //
+
+std::string SnapshotRate::FormatStats(const SnapshotRateStats& stats)
+{
+	return "every " + Engine::toString(stats.interval) + " ms, redundancy " + Engine::toString(stats.redundancy) + 
+		", " + Engine::toString(stats.sent) + " sent, " + Engine::toString(stats.repeated) + " repeated, " + 
+		Engine::toString(stats.skipped) + " skipped, " + Engine::toString(stats.increases) + " increases, " + 
+		Engine::toString(stats.decreases) + " decreases (RTT " + Engine::toString(stats.connection.rtt) + 
+		" ms, loss " + Engine::toString(static_cast<int>(stats.connection.loss * 100.0)) + "%, " + 
+		Engine::toString(stats.connection.queuedBytes) + " bytes queued)";
+}
+
+// ================================================ //
\ No newline at end of file
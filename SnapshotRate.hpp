@@ -0,0 +1,136 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SnapshotRate.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines SnapshotRateConfig, SnapshotRateStats and SnapshotRate classes.
+// ================================================ //
+
+#ifndef __SNAPSHOTRATE_HPP__
+#define __SNAPSHOTRATE_HPP__
+
+// ================================================ //
+
+#include "Transport.hpp"
+
+// ================================================ //
+
+// Bounds a SnapshotRate adapts between, read from [net] in ExtMF.cfg.
+struct SnapshotRateConfig{
+	// Defaults suit a 60 Hz simulation.
+	explicit SnapshotRateConfig(void);
+
+	// Shortest and longest time between new snapshots (ms).
+	Uint32 minInterval, maxInterval;
+	// Most times each snapshot is sent on a lossy connection.
+	Uint32 maxRedundancy;
+	// Bytes queued on a connection above which it is congested.
+	Uint32 maxQueuedBytes;
+	// Loss above which snapshots are repeated, and above which the 
+	// connection is treated as congested (0 to 1).
+	double redundancyLoss, congestionLoss;
+	// Shortest time between adjustments (ms). Never less than one RTT, so
+	// the effect of the last adjustment is measured before the next.
+	Uint32 adjustInterval;
+};
+
+// What a SnapshotRate has measured and decided for one connection.
+struct SnapshotRateStats{
+	// The current interval (ms) and times each snapshot is sent.
+	Uint32 interval, redundancy;
+	// The connection when last measured.
+	ConnectionStats connection;
+	// New snapshots sent, repeats of them, and chances to send skipped.
+	uint64_t sent, repeated, skipped;
+	// Times the rate was raised and lowered.
+	Uint32 increases, decreases;
+};
+
+// ================================================ //
+
+// Decides when one connection gets a snapshot. The server offers a 
+// snapshot to every connection on each of its updates; each connection
+// takes a new one once its interval has passed, and otherwise may take a 
+// repeat of the last one. The interval and redundancy adapt to the 
+// connection's RTT, loss and send queue: the rate falls quickly while 
+// snapshots are queuing up or being lost to congestion, so a poor 
+// connection isn't flooded with updates that are stale before they are 
+// sent, and rises slowly while the connection keeps up. Random loss on an
+// uncongested connection repeats snapshots instead, so one loss doesn't 
+// cost a whole interval.
+class SnapshotRate
+{
+public:
+	enum Action{
+		SKIP = 0,
+		SEND_NEW,
+		SEND_REPEAT
+	};
+
+	// Starts at interval (ms), clamped to the config's bounds.
+	explicit SnapshotRate(const SnapshotRateConfig& config, const Uint32 interval);
+
+	// Empty destructor.
+	~SnapshotRate(void);
+
+	// Measures the connection to addr when an adjustment is due and adapts
+	// the interval and redundancy. now is in microseconds.
+	void update(Transport* transport, const RakNet::SystemAddress& addr, const uint64_t now);
+
+	// Returns what to send the connection at now: a new snapshot, a repeat 
+	// of the last one sent, or nothing.
+	Action poll(const uint64_t now);
+
+	// Getters
+
+	// Returns the current interval (ms).
+	const Uint32 getInterval(void) const;
+
+	// Returns the measurements and decisions so far.
+	const SnapshotRateStats& getStats(void) const;
+
+	// Returns a one-line report of stats, for the log.
+	static std::string FormatStats(const SnapshotRateStats& stats);
+
+private:
+	SnapshotRateConfig m_config;
+	// When the next new snapshot is due, and the next adjustment (us).
+	uint64_t m_next;
+	uint64_t m_nextAdjust;
+	// Repeats left of the last snapshot sent.
+	Uint32 m_repeats;
+	SnapshotRateStats m_stats;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 SnapshotRate::getInterval(void) const{
+	return m_stats.interval;
+}
+
+inline const SnapshotRateStats& SnapshotRate::getStats(void) const{
+	return m_stats;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
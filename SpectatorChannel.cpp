@@ -0,0 +1,219 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SpectatorChannel.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements SpectatorChannel class.
+// ================================================ //
+
+#include "SpectatorChannel.hpp"
+#include "NetMessage.hpp"
+#include "Engine.hpp"
+
+// ================================================ //
+
+SpectatorChannel::SpectatorChannel(const Uint32 delay, const Uint32 batchInterval, const Uint32 budget) :
+m_delay(static_cast<uint64_t>(delay) * 1000),
+m_batchInterval(static_cast<uint64_t>(batchInterval) * 1000),
+m_budget(static_cast<double>(budget)),
+m_queue(),
+m_spectators(),
+m_lastBatch(0)
+{
+	this->reset();
+}
+
+// ================================================ //
+
+SpectatorChannel::~SpectatorChannel(void)
+{
+
+}
+
+// ================================================ //
+
+void SpectatorChannel::reset(void)
+{
+	m_queue.clear();
+	m_spectators.clear();
+	m_lastBatch = 0;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+// ================================================ //
+
+void SpectatorChannel::addSpectator(const RakNet::SystemAddress& addr)
+{
+	for (std::vector<Spectator>::iterator itr = m_spectators.begin(); itr != m_spectators.end(); ++itr){
+		if (itr->addr == addr){
+			return;
+		}
+	}
+
+	// Start with a full second of budget.
+	Spectator spectator;
+	spectator.addr = addr;
+	spectator.tokens = m_budget;
+	m_spectators.push_back(spectator);
+}
+
+// ================================================ //
+
+void SpectatorChannel::removeSpectator(const RakNet::SystemAddress& addr)
+{
+	for (std::vector<Spectator>::iterator itr = m_spectators.begin(); itr != m_spectators.end(); ++itr){
+		if (itr->addr == addr){
+			m_spectators.erase(itr);
+			return;
+		}
+	}
+}
+
+// ================================================ //
+
+void SpectatorChannel::push(std::shared_ptr<const RakNet::BitStream> pPacket, const uint64_t now)
+{
+	Entry entry;
+	entry.time = now;
+	entry.pPacket = pPacket;
+	m_queue.push_back(entry);
+	++m_stats.snapshots;
+}
+
+// ================================================ //
+
+Uint32 SpectatorChannel::update(Transport* transport, const uint64_t now)
+{
+	if (now < m_lastBatch + m_batchInterval){
+		return 0;
+	}
+	const double elapsed = (m_lastBatch == 0) ? 0.0 : static_cast<double>(now - m_lastBatch) / 1000000.0;
+	m_lastBatch = now;
+
+	// Take the snapshots that have been delayed long enough. Nobody is 
+	// watching yet, so they'd only pile up.
+	int due = 0;
+	while (due < static_cast<int>(m_queue.size()) && m_queue[due].time + m_delay <= now){
+		++due;
+	}
+	if (m_spectators.empty() || due == 0){
+		m_queue.erase(m_queue.begin(), m_queue.begin() + due);
+		return 0;
+	}
+
+	// Encode the batch once for everyone, and its newest snapshot alone for
+	// spectators that can't afford all of it.
+	const int count = (due > SpectatorChannel::MaxBatch) ? SpectatorChannel::MaxBatch : due;
+	std::shared_ptr<const RakNet::BitStream> pBatch = this->encode(due - count, count);
+	std::shared_ptr<const RakNet::BitStream> pThinned = (count > 1) ? this->encode(due - 1, 1) : pBatch;
+	m_queue.erase(m_queue.begin(), m_queue.begin() + due);
+	++m_stats.batches;
+
+	const double batchBytes = static_cast<double>(pBatch->GetNumberOfBytesUsed());
+	const double thinnedBytes = static_cast<double>(pThinned->GetNumberOfBytesUsed());
+	Uint32 sent = 0;
+	for (std::vector<Spectator>::iterator itr = m_spectators.begin(); itr != m_spectators.end(); ++itr){
+		itr->tokens += m_budget * elapsed;
+		if (itr->tokens > m_budget){
+			itr->tokens = m_budget;
+		}
+
+		const RakNet::BitStream* pPacket = nullptr;
+		if (m_budget == 0.0 || itr->tokens >= batchBytes){
+			pPacket = pBatch.get();
+			itr->tokens -= batchBytes;
+		}
+		else if (itr->tokens >= thinnedBytes){
+			pPacket = pThinned.get();
+			itr->tokens -= thinnedBytes;
+			++m_stats.thinnedSends;
+		}
+		else{
+			++m_stats.skippedSends;
+			continue;
+		}
+
+		// Low priority, so spectators never hold up the players' packets.
+		transport->send(*pPacket, LOW_PRIORITY, UNRELIABLE_SEQUENCED, itr->addr);
+		m_stats.bytes += pPacket->GetNumberOfBytesUsed();
+		++m_stats.sends;
+		++sent;
+	}
+
+	return sent;
+}
+
+// ================================================ //
+
+std::shared_ptr<const RakNet::BitStream> SpectatorChannel::encode(const int first, const int count) const
+{
+	std::shared_ptr<RakNet::BitStream> pBit(new RakNet::BitStream());
+	pBit->Write(static_cast<RakNet::MessageID>(NetMessage::SPECTATOR_BATCH));
+	pBit->Write(static_cast<Uint8>(count));
+	for (int i = first; i < first + count; ++i){
+		const RakNet::BitStream& packet = *m_queue[i].pPacket;
+		pBit->Write(static_cast<Uint16>(packet.GetNumberOfBytesUsed()));
+		pBit->WriteAlignedBytes(packet.GetData(), packet.GetNumberOfBytesUsed());
+	}
+
+	return pBit;
+}
+
+// ================================================ //
+
+bool SpectatorChannel::ReadCount(RakNet::BitStream& bit, Uint8& count)
+{
+	return bit.Read(count);
+}
+
+// ================================================ //
+
+bool SpectatorChannel::ReadPacket(RakNet::BitStream& bit, unsigned char*& data, Uint32& length)
+{
+	Uint16 bytes = 0;
+	if (!bit.Read(bytes)){
+		return false;
+	}
+
+	bit.AlignReadToByteBoundary();
+	if (bytes == 0 || bit.GetNumberOfUnreadBits() < BYTES_TO_BITS(bytes)){
+		return false;
+	}
+
+	data = bit.GetData() + BITS_TO_BYTES(bit.GetReadOffset());
+	length = bytes;
+	bit.IgnoreBytes(bytes);
+	return true;
+}
+
+// ================================================ //
+
+std::string SpectatorChannel::FormatStats(const SpectatorStats& stats)
+{
+	if (stats.batches == 0){
+		return "no batches sent";
+	}
+
+	const uint64_t sends = (stats.sends == 0) ? 1 : stats.sends;
+	return Engine::toString(stats.snapshots) + " snapshots in " + Engine::toString(stats.batches) + 
+		" batches, " + Engine::toString(stats.sends) + " sends (" + Engine::toString(stats.thinnedSends) + 
+		" thinned, " + Engine::toString(stats.skippedSends) + " skipped over budget), " + 
+		Engine::toString(stats.bytes / sends) + " bytes/send";
+}
+
+// ================================================ //
\ No newline at end of file
@@ -0,0 +1,144 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: SpectatorChannel.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines SpectatorStats struct and SpectatorChannel class.
+// ================================================ //
+
+#ifndef __SPECTATORCHANNEL_HPP__
+#define __SPECTATORCHANNEL_HPP__
+
+// ================================================ //
+
+#include "Transport.hpp"
+
+// ================================================ //
+
+// Fan-out of a SpectatorChannel since the last reset.
+struct SpectatorStats{
+	// Snapshots queued, and batches encoded from them.
+	uint64_t snapshots, batches;
+	// Batches sent, summed over spectators. Thinned sends only carried the
+	// newest snapshot of the batch; skipped ones were over budget.
+	uint64_t sends, thinnedSends, skippedSends;
+	// Bytes sent to all spectators.
+	uint64_t bytes;
+};
+
+// ================================================ //
+
+// Sends a match to its spectators, delayed and in batches. Each snapshot
+// packet is encoded once by the match's SnapshotChannel and only its 
+// refcounted buffer is queued here. Every batch interval, the snapshots 
+// older than the delay are packed into one SPECTATOR_BATCH packet, which 
+// is encoded once and sent to every spectator. Spectators are limited to
+// an outgoing budget (bytes per second); one that can't afford a batch is
+// sent just its newest snapshot, or nothing. Snapshots in a batch are
+// never delta-encoded, so skipping one costs a spectator nothing but 
+// smoothness.
+class SpectatorChannel
+{
+public:
+	// Delay and batch interval are in ms, budget in bytes per second (0 is
+	// unlimited).
+	explicit SpectatorChannel(const Uint32 delay = 2000, const Uint32 batchInterval = 100, 
+							  const Uint32 budget = 8000);
+
+	// Empty destructor.
+	~SpectatorChannel(void);
+
+	// Forgets all spectators and queued snapshots, and resets the stats.
+	void reset(void);
+
+	// Adds a spectator, who receives batches from the next one sent.
+	void addSpectator(const RakNet::SystemAddress& addr);
+
+	// Removes a spectator, if it is one.
+	void removeSpectator(const RakNet::SystemAddress& addr);
+
+	// Queues a WORLD_SNAPSHOT packet taken at now (us). It must not be 
+	// delta-encoded, and is never modified after this.
+	void push(std::shared_ptr<const RakNet::BitStream> pPacket, const uint64_t now);
+
+	// Sends a batch to every spectator when one is due. Returns the number
+	// of spectators sent to.
+	Uint32 update(Transport* transport, const uint64_t now);
+
+	// Receiver: reads the count of a SPECTATOR_BATCH (after the message ID).
+	static bool ReadCount(RakNet::BitStream& bit, Uint8& count);
+
+	// Receiver: finds the next WORLD_SNAPSHOT packet in a SPECTATOR_BATCH,
+	// pointing data at it within bit's data instead of copying it. Returns
+	// false if the batch is malformed.
+	static bool ReadPacket(RakNet::BitStream& bit, unsigned char*& data, Uint32& length);
+
+	// Getters
+
+	// Returns the number of spectators.
+	const Uint32 getNumSpectators(void) const;
+
+	// Returns the fan-out since the last reset().
+	const SpectatorStats& getStats(void) const;
+
+	// Returns a one-line fan-out report of stats, for the log.
+	static std::string FormatStats(const SpectatorStats& stats);
+
+	// Most snapshots sent in one batch; older ones are dropped.
+	static const int MaxBatch = 32;
+
+private:
+	// Encodes the given queued snapshots as a SPECTATOR_BATCH packet.
+	std::shared_ptr<const RakNet::BitStream> encode(const int first, const int count) const;
+
+	struct Entry{
+		uint64_t time;
+		std::shared_ptr<const RakNet::BitStream> pPacket;
+	};
+
+	struct Spectator{
+		RakNet::SystemAddress addr;
+		// Bytes the spectator may still be sent.
+		double tokens;
+	};
+
+	uint64_t m_delay, m_batchInterval;
+	double m_budget;
+	std::deque<Entry> m_queue;
+	std::vector<Spectator> m_spectators;
+	uint64_t m_lastBatch;
+	SpectatorStats m_stats;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const Uint32 SpectatorChannel::getNumSpectators(void) const{
+	return static_cast<Uint32>(m_spectators.size());
+}
+
+inline const SpectatorStats& SpectatorChannel::getStats(void) const{
+	return m_stats;
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -31,11 +31,13 @@
 
 // ================================================ //
 
-Stage::Stage(const std::string& stageFile) :
+Stage::Stage(const std::string& stageFile, const bool async) :
 Object(),
 m_layers(),
 m_rightEdge(0),
-m_shiftUpdates()
+m_shiftUpdates(),
+m_pendingTextures(),
+m_loaded(false)
 {
 	Config c(stageFile);
 	if (!c.isLoaded()){
@@ -51,20 +53,14 @@ m_shiftUpdates()
 	for (int i = 1; i <= numLayers; ++i){
 		StageLayer layer;
 		std::string layerName = (std::string("layer") + Engine::toString(i));
+		const std::string textureFile = Engine::getSingletonPtr()->getDataDirectory() + "/" + 
+			c.parseValue(layerName, "texture");
 
-		layer.pTexture = Engine::getSingletonPtr()->loadTexture(
-			Engine::getSingletonPtr()->getDataDirectory() + "/" + c.parseValue(layerName, "texture"));
 		///f: re-organize the layer struct to be more understandable
 		layer.src.w = c.parseIntValue(layerName, "w");
 		layer.src.h = c.parseIntValue(layerName, "h");
-
-		// Get texture data.
-		SDL_QueryTexture(layer.pTexture, nullptr, nullptr, &layer.w, &layer.h);
-		layer.src.x = 0;
-		layer.src.y = layer.h - layer.src.h;
-
-		// Set default camera position.
-		Camera::getSingletonPtr()->panX((layer.w / 2) - (layer.src.w / 2));
+		layer.src.x = layer.src.y = 0;
+		layer.w = layer.h = 0;
 
 		layer.dst.x = layer.dst.y = 0;
 		// Render the texture with virtual width/height by default.
@@ -75,23 +71,84 @@ m_shiftUpdates()
 		layer.Effect.scrollY = c.parseIntValue(layerName, "scrollY");
 
 		m_layers.push_back(layer);
-	}
 
-	m_rightEdge = m_layers[0].w - m_layers[0].src.w;
-	Camera::getSingletonPtr()->setRightBound(m_rightEdge);
+		// Decode every layer at once on the AssetLoader's workers.
+		if (async){
+			m_pendingTextures.push_back(AssetLoader::getSingletonPtr()->loadTexture(textureFile));
+		}
+		else{
+			this->setLayerTexture(m_layers.size() - 1, AssetLoader::CreateTexture(AssetLoader::LoadSurface(textureFile)));
+		}
+	}
 
-	Log::getSingletonPtr()->logMessage("Stage loaded with " + Engine::toString(numLayers) + " layer(s)!");
+	if (!async){
+		this->finishLoading();
+	}
 }
 
 // ================================================ //
 
 Stage::~Stage(void)
 {
-	for (StageLayerList::iterator itr = m_layers.begin();
-		itr != m_layers.end();
-		++itr){
-		Engine::getSingletonPtr()->destroyTexture(itr->pTexture);
+
+}
+
+// ================================================ //
+
+bool Stage::updateLoading(void)
+{
+	if (m_loaded){
+		return true;
+	}
+
+	bool pending = false;
+	for (size_t i = 0; i < m_pendingTextures.size(); ++i){
+		if (AssetLoader::IsReady(m_pendingTextures[i])){
+			this->setLayerTexture(i, m_pendingTextures[i].get());
+			m_pendingTextures[i] = TextureFuture();
+		}
+		else if (m_pendingTextures[i].valid()){
+			pending = true;
+		}
+	}
+
+	if (!pending){
+		m_pendingTextures.clear();
+		this->finishLoading();
+	}
+
+	return m_loaded;
+}
+
+// ================================================ //
+
+void Stage::setLayerTexture(const size_t layer, const std::shared_ptr<SDL_Texture>& pTexture)
+{
+	StageLayer& l = m_layers[layer];
+	l.pTexture = pTexture;
+
+	// Get texture data.
+	SDL_QueryTexture(l.pTexture.get(), nullptr, nullptr, &l.w, &l.h);
+	l.src.x = 0;
+	l.src.y = l.h - l.src.h;
+}
+
+// ================================================ //
+
+void Stage::finishLoading(void)
+{
+	if (m_layers.empty()){
+		return;
 	}
+
+	// Set default camera position.
+	Camera::getSingletonPtr()->panX((m_layers.back().w / 2) - (m_layers.back().src.w / 2));
+
+	m_rightEdge = m_layers[0].w - m_layers[0].src.w;
+	Camera::getSingletonPtr()->setRightBound(m_rightEdge);
+	m_loaded = true;
+
+	Log::getSingletonPtr()->logMessage("Stage loaded with " + Engine::toString(m_layers.size()) + " layer(s)!");
 }
 
 // ================================================ //
@@ -178,7 +235,7 @@ void Stage::update(double dt)
 		}
 
 		SDL_RenderCopyEx(Engine::getSingletonPtr()->getRenderer(),
-			m_layers[i].pTexture, &m_layers[i].src, &m_layers[i].dst, 0, nullptr, SDL_FLIP_NONE);
+			m_layers[i].pTexture.get(), &m_layers[i].src, &m_layers[i].dst, 0, nullptr, SDL_FLIP_NONE);
 
 		// Process stage effects.
 		if (m_layers[i].Effect.scrollX || m_layers[i].Effect.scrollY){
@@ -195,7 +252,7 @@ void Stage::update(double dt)
 
 			// Render a second time with offset.
 			SDL_RenderCopyEx(Engine::getSingletonPtr()->getRenderer(),
-				m_layers[i].pTexture, &m_layers[i].src, &dst2, 0, nullptr, SDL_FLIP_NONE);
+				m_layers[i].pTexture.get(), &m_layers[i].src, &dst2, 0, nullptr, SDL_FLIP_NONE);
 
 			// Wrap back around to beginning.
 			if (dst2.x >= 0){
@@ -28,6 +28,7 @@
 
 #include "Object.hpp"
 #include "StageLayer.hpp"
+#include "AssetLoader.hpp"
 
 // ================================================ //
 
@@ -43,12 +44,18 @@ public:
 		Uint32 lastProcessedShift;
 	} ShiftUpdate;
 
-	// Loads the .stage file and parses each layer.
-	explicit Stage(const std::string& stageFile);
+	// Loads the .stage file and parses each layer. If async is true, the
+	// layer textures are loaded by the AssetLoader, and the Stage can't be
+	// used until updateLoading() returns true.
+	explicit Stage(const std::string& stageFile, const bool async = false);
 
-	// Frees any textures allocated by the Stage.
+	// Empty destructor.
 	virtual ~Stage(void);
 
+	// Takes any layer textures the AssetLoader has finished. Returns true 
+	// once every layer has its texture.
+	bool updateLoading(void);
+
 	// Shifts the stage view left or right by amount x.
 	void shift(const int x);
 
@@ -74,10 +81,25 @@ public:
 	// Returns farmost right edge at which the stage can be shifted.
 	const int getRightEdge(void) const;
 
+	// Returns true once every layer has its texture.
+	const bool isLoaded(void) const;
+
+private:
+	// Sets a layer's texture and the size of the layer from it.
+	void setLayerTexture(const size_t layer, const std::shared_ptr<SDL_Texture>& pTexture);
+
+	// Sets the Camera and right edge from the layers once all are loaded.
+	void finishLoading(void);
+
 public:
 	StageLayerList m_layers;
 	int m_rightEdge;
 	std::queue<ShiftUpdate> m_shiftUpdates;
+
+private:
+	// Textures still being loaded, indexed by layer.
+	std::vector<TextureFuture> m_pendingTextures;
+	bool m_loaded;
 };
 
 // ================================================ //
@@ -92,6 +114,10 @@ inline const int Stage::getRightEdge(void) const{
 	return m_rightEdge;
 }
 
+inline const bool Stage::isLoaded(void) const{
+	return m_loaded;
+}
+
 // ================================================ //
 
 #endif
@@ -33,7 +33,8 @@
 // A layer that is rendered in a Stage. Can be the background,
 // scrolling translucent fog, etc.
 struct StageLayer{
-	SDL_Texture* pTexture;
+	// Destroyed with the last copy of the layer.
+	std::shared_ptr<SDL_Texture> pTexture;
 	SDL_Rect src, dst;
 	int w, h;
 
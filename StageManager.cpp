@@ -59,6 +59,31 @@ bool StageManager::load(const std::string& stageFile)
 
 // ================================================ //
 
+bool StageManager::loadAsync(const std::string& stageFile)
+{
+	m_stageFile.assign(stageFile);
+
+	m_pStage.reset(new Stage(stageFile, true));
+
+	return (m_pStage.get() != nullptr);
+}
+
+// ================================================ //
+
+bool StageManager::updateLoading(void)
+{
+	return (m_pStage == nullptr) || m_pStage->updateLoading();
+}
+
+// ================================================ //
+
+const bool StageManager::isLoading(void) const
+{
+	return (m_pStage != nullptr) && !m_pStage->isLoaded();
+}
+
+// ================================================ //
+
 bool StageManager::reload(void)
 {
 	return this->load(m_stageFile);
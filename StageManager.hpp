@@ -47,6 +47,14 @@ public:
 	// Allocates Stage object with stageFile, returns true if successful.
 	bool load(const std::string& stageFile);
 
+	// Allocates Stage object with stageFile, loading its textures with the
+	// AssetLoader. The Stage can't be used until updateLoading() returns 
+	// true.
+	bool loadAsync(const std::string& stageFile);
+
+	// Calls Stage::updateLoading(). Returns true once the Stage is loaded.
+	bool updateLoading(void);
+
 	// Calls load() with last used stageFile.
 	bool reload(void);
 
@@ -55,6 +63,9 @@ public:
 	// Returns pointer to currently loaded stage.
 	Stage* getStage(void) const;
 
+	// Returns true if a Stage from loadAsync() is still loading.
+	const bool isLoading(void) const;
+
 	// Calls Stage::update().
 	void update(double dt);
 
@@ -0,0 +1,118 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: ThreadPool.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements ThreadPool class.
+// ================================================ //
+
+#include "ThreadPool.hpp"
+
+// ================================================ //
+
+ThreadPool::ThreadPool(const uint32_t numThreads) :
+m_threads(),
+m_jobs(),
+m_mutex(),
+m_jobReady(),
+m_idle(),
+m_running(0),
+m_shutdown(false)
+{
+	uint32_t n = numThreads;
+	if (n == 0){
+		n = std::thread::hardware_concurrency();
+		if (n == 0){
+			n = 1;
+		}
+	}
+
+	m_threads.reserve(n);
+	for (uint32_t i = 0; i < n; ++i){
+		m_threads.push_back(std::thread(&ThreadPool::workerLoop, this));
+	}
+}
+
+// ================================================ //
+
+ThreadPool::~ThreadPool(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_jobReady.notify_all();
+
+	for (std::vector<std::thread>::iterator itr = m_threads.begin();
+		 itr != m_threads.end();
+		 ++itr){
+		itr->join();
+	}
+}
+
+// ================================================ //
+
+void ThreadPool::enqueue(const Job& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(job);
+	}
+	m_jobReady.notify_one();
+}
+
+// ================================================ //
+
+void ThreadPool::wait(void)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_jobs.empty() || m_running != 0){
+		m_idle.wait(lock);
+	}
+}
+
+// ================================================ //
+
+void ThreadPool::workerLoop(void)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;){
+		while (m_jobs.empty() && !m_shutdown){
+			m_jobReady.wait(lock);
+		}
+		// Queued jobs are still run when shutting down.
+		if (m_jobs.empty()){
+			return;
+		}
+
+		Job job = m_jobs.front();
+		m_jobs.pop_front();
+		++m_running;
+
+		lock.unlock();
+		job();
+		lock.lock();
+
+		--m_running;
+		if (m_jobs.empty() && m_running == 0){
+			m_idle.notify_all();
+		}
+	}
+}
+
+// ================================================ //
\ No newline at end of file
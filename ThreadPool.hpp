@@ -0,0 +1,92 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: ThreadPool.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines ThreadPool class.
+// ================================================ //
+
+#ifndef __THREADPOOL_HPP__
+#define __THREADPOOL_HPP__
+
+// ================================================ //
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <cstdint>
+
+// ================================================ //
+
+// A fixed set of worker threads that run queued jobs in FIFO order. Jobs 
+// must not throw. Has no dependency on SDL, so it can be used by the 
+// dedicated server and benchmarks.
+class ThreadPool
+{
+public:
+	typedef std::function<void(void)> Job;
+
+	// Starts numThreads workers. If numThreads is 0, one worker per hardware
+	// thread is started.
+	explicit ThreadPool(const uint32_t numThreads = 0);
+
+	// Finishes all queued jobs, then joins the workers.
+	~ThreadPool(void);
+
+	// Queues a job to run on the next free worker.
+	void enqueue(const Job& job);
+
+	// Blocks until the queue is empty and no job is running.
+	void wait(void);
+
+	// Getters
+
+	// Returns the number of worker threads.
+	const uint32_t getNumThreads(void) const;
+
+private:
+	// Runs jobs until the pool is shut down.
+	void workerLoop(void);
+
+	std::vector<std::thread> m_threads;
+	std::deque<Job> m_jobs;
+	std::mutex m_mutex;
+	// Signalled when a job is queued or the pool shuts down.
+	std::condition_variable m_jobReady;
+	// Signalled when the pool becomes idle.
+	std::condition_variable m_idle;
+	uint32_t m_running;
+	bool m_shutdown;
+};
+
+// ================================================ //
+
+// Getters
+
+inline const uint32_t ThreadPool::getNumThreads(void) const{
+	return static_cast<uint32_t>(m_threads.size());
+}
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
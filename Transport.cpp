@@ -0,0 +1,89 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: Transport.cpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Implements RakNetTransport class.
+// ================================================ //
+
+#include "Transport.hpp"
+
+#include <RakNetStatistics.h>
+
+// ================================================ //
+
+RakNetTransport::RakNetTransport(RakNet::RakPeerInterface* peer) :
+m_peer(peer)
+{
+
+}
+
+// ================================================ //
+
+RakNetTransport::~RakNetTransport(void)
+{
+
+}
+
+// ================================================ //
+
+Uint32 RakNetTransport::send(const RakNet::BitStream& bit, const PacketPriority priority, 
+							 const PacketReliability reliability, const RakNet::SystemAddress& addr, 
+							 const bool broadcast)
+{
+	return m_peer->Send(&bit, priority, reliability, 0, addr, broadcast);
+}
+
+// ================================================ //
+
+RakNet::Packet* RakNetTransport::receive(void)
+{
+	return m_peer->Receive();
+}
+
+// ================================================ //
+
+void RakNetTransport::deallocatePacket(RakNet::Packet* packet)
+{
+	m_peer->DeallocatePacket(packet);
+}
+
+// ================================================ //
+
+bool RakNetTransport::getConnectionStats(const RakNet::SystemAddress& addr, ConnectionStats& stats)
+{
+	RakNet::RakNetStatistics rns;
+	if (!m_peer->GetStatistics(addr, &rns)){
+		return false;
+	}
+
+	const int ping = m_peer->GetAveragePing(addr);
+	stats.rtt = (ping > 0) ? static_cast<Uint32>(ping) : 0;
+	stats.loss = rns.packetlossLastSecond;
+
+	// Everything RakNet is holding back, whatever its priority.
+	double queued = 0.0;
+	for (int i = 0; i < NUMBER_OF_PRIORITIES; ++i){
+		queued += rns.bytesInSendBuffer[i];
+	}
+	stats.queuedBytes = static_cast<Uint32>(queued);
+
+	return true;
+}
+
+// ================================================ //
\ No newline at end of file
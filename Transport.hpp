@@ -0,0 +1,101 @@
+// ========================================================================= //
+// Fighting game framework (2D) with online multiplayer.
+// Copyright(C) 2014 Jordan Sparks <unixunited@live.com>
+//
+// This program is free software; you can redistribute it and / or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or(at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+// ========================================================================= //
+// File: Transport.hpp
+// Author: Jordan Sparks <unixunited@live.com>
+// ================================================ //
+// Defines Transport interface and RakNetTransport class.
+// ================================================ //
+
+#ifndef __TRANSPORT_HPP__
+#define __TRANSPORT_HPP__
+
+// ================================================ //
+
+#include "stdafx.hpp"
+
+// ================================================ //
+
+// Recent measurements of one connection, for adapting what is sent on it.
+struct ConnectionStats{
+	// Average round trip time (ms).
+	Uint32 rtt;
+	// Fraction of packets lost recently (0 to 1).
+	double loss;
+	// Bytes waiting to be sent on the connection.
+	Uint32 queuedBytes;
+};
+
+// ================================================ //
+
+// Sends and receives the game's packets. Match code only talks to a 
+// Transport, so it can run over RakNet or in-process (see LoopbackNetwork).
+// Connection setup stays with whoever owns the underlying peer. Sending 
+// must be safe from any thread.
+class Transport
+{
+public:
+	// Empty destructor.
+	virtual ~Transport(void){}
+
+	// Sends bit to addr, or to everyone else connected except addr if 
+	// broadcast is true. Returns zero on failure.
+	virtual Uint32 send(const RakNet::BitStream& bit, const PacketPriority priority, 
+						const PacketReliability reliability, const RakNet::SystemAddress& addr, 
+						const bool broadcast = false) = 0;
+
+	// Returns the next received packet, or nullptr if there are none. Pass
+	// it to deallocatePacket() when done.
+	virtual RakNet::Packet* receive(void) = 0;
+
+	// Frees a packet returned by receive().
+	virtual void deallocatePacket(RakNet::Packet* packet) = 0;
+
+	// Fills stats with the connection to addr. Returns false if there is
+	// no such connection.
+	virtual bool getConnectionStats(const RakNet::SystemAddress& addr, ConnectionStats& stats) = 0;
+};
+
+// ================================================ //
+
+// A Transport over a RakNet peer, which it doesn't own.
+class RakNetTransport : public Transport
+{
+public:
+	// Sends and receives through peer.
+	explicit RakNetTransport(RakNet::RakPeerInterface* peer);
+
+	// Empty destructor.
+	~RakNetTransport(void);
+
+	// Transport
+	Uint32 send(const RakNet::BitStream& bit, const PacketPriority priority, 
+				const PacketReliability reliability, const RakNet::SystemAddress& addr, 
+				const bool broadcast = false);
+	RakNet::Packet* receive(void);
+	void deallocatePacket(RakNet::Packet* packet);
+	bool getConnectionStats(const RakNet::SystemAddress& addr, ConnectionStats& stats);
+
+private:
+	RakNet::RakPeerInterface* m_peer;
+};
+
+// ================================================ //
+
+#endif
+
+// ================================================ //
\ No newline at end of file
@@ -50,8 +50,10 @@
 
 // SDL
 #include <SDL.h>
+#ifndef DEDICATED_SERVER
 #include <SDL_image.h>
 #include <SDL_ttf.h>
+#endif
 
 // RakNet
 #include <RakPeerInterface.h>